@@ -0,0 +1,142 @@
+/**
+ * @file arena_bench.cc
+ * @author alongnice
+ * @brief 不同 arena 块大小(以及大页模式)下跳表插入的吞吐和 dTLB miss 对比
+ *  用法: arena_bench [插入条数]
+ *  dTLB miss 通过 perf_event_open 读取, 没有权限或非 linux 时显示 n/a
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "arena.h"
+#include "bench_util.h"
+#include "random.h"
+#include "skiplist.h"
+
+namespace leveldb {
+
+typedef uint64_t Key;
+
+struct KeyComparator {
+    int operator()(const Key& a, const Key& b) const {
+        if(a < b) return -1;
+        else if(a > b) return +1;
+        else return 0;
+    }
+};
+
+/**
+ * @brief dTLB 读 miss 计数器
+ */
+class TlbCounter {
+public:
+    TlbCounter() : fd_(-1) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~TlbCounter() {
+#if defined(__linux__)
+        if(fd_ >= 0) close(fd_);
+#endif
+    }
+
+    void Start() {
+#if defined(__linux__)
+        if(fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // 返回 -1 表示计数器不可用
+    long long Stop() {
+#if defined(__linux__)
+        if(fd_ < 0) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if(read(fd_, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+private:
+    int fd_;
+};
+
+static void Run(const char* label, size_t block_size, size_t huge_page_size,
+                const std::vector<Key>& keys) {
+    Arena arena(block_size, huge_page_size);
+    SkipList<Key, KeyComparator> list(KeyComparator(), &arena);
+    TlbCounter tlb;
+
+    tlb.Start();
+    uint64_t start = bench::NowMicros();
+    for(size_t i = 0; i < keys.size(); i++) list.Insert(keys[i]);
+    uint64_t insert_micros = bench::NowMicros() - start;
+    long long insert_misses = tlb.Stop();
+
+    // 插入后再做一轮随机查找, 这一阶段节点分布对 TLB 的影响最明显
+    tlb.Start();
+    start = bench::NowMicros();
+    size_t found = 0;
+    for(size_t i = 0; i < keys.size(); i++) found += list.Contains(keys[keys.size() - 1 - i]);
+    uint64_t lookup_micros = bench::NowMicros() - start;
+    long long lookup_misses = tlb.Stop();
+    if(found != keys.size()) std::fprintf(stderr, "%s: lookup mismatch\n", label);
+
+    std::string name = std::string(label) + "/insert";
+    bench::Report(name.c_str(), keys.size(), insert_micros);
+    name = std::string(label) + "/lookup";
+    bench::Report(name.c_str(), keys.size(), lookup_micros);
+    std::printf("%-36s : blocks(mmap)=%zu mem=%zuKB dtlb_miss insert=%s lookup=%s\n", label,
+                arena.MmapBlockCount(), arena.MemoryUsage() >> 10,
+                insert_misses < 0 ? "n/a" : std::to_string(insert_misses).c_str(),
+                lookup_misses < 0 ? "n/a" : std::to_string(lookup_misses).c_str());
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector<leveldb::Key> keys;
+    keys.reserve(n);
+    leveldb::Random rnd(301);
+    for(int i = 0; i < n; i++) {
+        keys.push_back(static_cast<leveldb::Key>(rnd.Next()) << 32 | static_cast<uint32_t>(i));
+    }
+
+    leveldb::Run("block:4KB", 4096, 0, keys);
+    leveldb::Run("block:64KB", 64 << 10, 0, keys);
+    leveldb::Run("block:2MB", 2 << 20, 0, keys);
+    leveldb::Run("block:2MB_hugepage", 2 << 20, leveldb::Arena::kDefaultHugePageSize, keys);
+    return 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file bench_util.h
+ * @author alongnice
+ * @brief 性能测试的公共工具: 计时和结果输出
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace leveldb {
+namespace bench {
+
+// 当前时间(微秒)
+inline uint64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 输出一行结果: 名称, 单次操作耗时, 吞吐
+inline void Report(const char* name, uint64_t ops, uint64_t micros) {
+    if(micros == 0) micros = 1;
+    std::printf("%-36s : %10.3f ns/op %12.0f ops/s\n", name,
+                micros * 1e3 / ops, ops * 1e6 / micros);
+}
+
+// 输出一行吞吐结果: 名称, 处理的总字节数换算成 MB/s
+inline void ReportBytes(const char* name, uint64_t bytes, uint64_t micros) {
+    if(micros == 0) micros = 1;
+    std::printf("%-36s : %10.1f MB/s\n", name, bytes / 1048576.0 * 1e6 / micros);
+}
+
+}   // namespace bench
+}   // namespace leveldb
@@ -0,0 +1,76 @@
+/**
+ * @file block_bench.cc
+ * @author alongnice
+ * @brief 块内 Seek 延迟与重启间隔的关系: 间隔越大块越小, 但二分之后线性扫描的键越多
+ *  用法: block_bench [每组 Seek 次数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "block.h"
+#include "block_builder.h"
+#include "comparator.h"
+#include "format.h"
+#include "options.h"
+#include "random.h"
+
+namespace leveldb {
+
+// 一个 4KB 左右的块: 16 字节有序键 + 16 字节值, 键之间共享较长的前缀
+static void Run(int restart_interval, int ops) {
+    Options options;
+    options.block_restart_interval = restart_interval;
+    BlockBuilder builder(&options);
+    std::vector<std::string> keys;
+    char buf[32];
+    for(int i = 0; builder.CurrentSizeEstimate() < options.block_size; i++) {
+        std::snprintf(buf, sizeof(buf), "user%012d", i * 7);
+        keys.push_back(buf);
+        builder.Add(keys.back(), "vvvvvvvvvvvvvvvv");
+    }
+    std::string storage = builder.Finish().ToString();
+    BlockContents contents;
+    contents.data = Slice(storage);
+    contents.cachable = false;
+    contents.heap_allocated = false;
+    Block block(contents);
+
+    Random rnd(301);
+    std::vector<std::string> targets;
+    for(int i = 0; i < 1024; i++) targets.push_back(keys[rnd.Uniform(static_cast<int>(keys.size()))]);
+
+    size_t sink = 0;
+    uint64_t start = bench::NowMicros();
+    for(int i = 0; i < ops; i++) {
+        // 每次用新的迭代器, 测的是完整的二分 + 扫描, 与点查时的用法一致
+        Iterator* iter = block.NewIterator(BytewiseComparator());
+        iter->Seek(targets[i & 1023]);
+        sink += iter->value().size();
+        delete iter;
+    }
+    uint64_t micros = bench::NowMicros() - start;
+
+    std::printf("restart_interval:%-4d keys:%-4zu block:%-6zu ", restart_interval, keys.size(),
+                storage.size());
+    bench::Report("seek", ops, micros);
+    if(sink == 42) std::printf("\n");  // 防止循环被优化掉
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int ops = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int intervals[] = {1, 2, 4, 8, 16, 32, 64, 128};
+    for(size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+        leveldb::Run(intervals[i], ops);
+    }
+    return 0;
+}
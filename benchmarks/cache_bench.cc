@@ -0,0 +1,193 @@
+/**
+ * @file cache_bench.cc
+ * @author alongnice
+ * @brief 块缓存: LRU 对比 W-TinyLFU 的命中率和吞吐
+ *  按访问序列回放: 先 Lookup, 未命中再 Insert, 与表读取使用块缓存的方式相同
+ *  内置三种序列: zipf 分布、zipf 中间穿插大范围扫描、比容量略大的循环访问
+ *  用法: cache_bench [序列文件] ; 序列文件每行一个键, 给出时额外回放这个序列
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "cache.h"
+#include "coding.h"
+
+namespace leveldb {
+
+static const size_t kCapacity = 10000;
+static const int kKeySpace = 100000;
+static const int kOps = 2000000;
+
+typedef Cache* (*CacheFactory)(size_t capacity);
+
+static void NoopDeleter(const Slice&, void*) {}
+
+// 按 zipf(theta) 分布生成 [0, n) 中的键, 小的键更热
+class ZipfGenerator {
+public:
+    ZipfGenerator(int n, double theta, uint64_t seed) : cdf_(n), rnd_(seed), uniform_(0.0, 1.0) {
+        double sum = 0;
+        for(int i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(i + 1, theta);
+            cdf_[i] = sum;
+        }
+        for(int i = 0; i < n; i++) cdf_[i] /= sum;
+    }
+
+    uint32_t Next() {
+        const double u = uniform_(rnd_);
+        return std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin();
+    }
+
+private:
+    std::vector<double> cdf_;
+    std::mt19937_64 rnd_;
+    std::uniform_real_distribution<double> uniform_;
+};
+
+static std::vector<uint64_t> ZipfTrace() {
+    ZipfGenerator zipf(kKeySpace, 0.99, 301);
+    std::vector<uint64_t> trace(kOps);
+    for(int i = 0; i < kOps; i++) trace[i] = zipf.Next();
+    return trace;
+}
+
+// 每 20 万次 zipf 访问后扫描 2 倍容量的新键, 模拟范围查询和后台遍历
+static std::vector<uint64_t> ZipfScanTrace() {
+    ZipfGenerator zipf(kKeySpace, 0.99, 301);
+    std::vector<uint64_t> trace;
+    trace.reserve(kOps + kOps / 10);
+    uint64_t next_scan_key = kKeySpace;
+    for(int i = 0; i < kOps; i++) {
+        trace.push_back(zipf.Next());
+        if(i % 200000 == 199999) {
+            for(size_t k = 0; k < 2 * kCapacity; k++) trace.push_back(next_scan_key++);
+        }
+    }
+    return trace;
+}
+
+// 循环访问比容量多 20% 的键, LRU 每次都恰好淘汰下一个要访问的键
+static std::vector<uint64_t> LoopTrace() {
+    const uint64_t n = kCapacity + kCapacity / 5;
+    std::vector<uint64_t> trace(kOps);
+    for(int i = 0; i < kOps; i++) trace[i] = i % n;
+    return trace;
+}
+
+// 每行一个键, 相同的字符串映射成相同的编号
+static bool ReadTraceFile(const char* path, std::vector<uint64_t>* trace) {
+    std::ifstream in(path);
+    if(!in) return false;
+    std::unordered_map<std::string, uint64_t> ids;
+    std::string line;
+    while(std::getline(in, line)) {
+        if(line.empty()) continue;
+        auto it = ids.insert(std::make_pair(line, ids.size())).first;
+        trace->push_back(it->second);
+    }
+    return true;
+}
+
+static void Replay(const char* trace_name, const std::vector<uint64_t>& trace, const char* cache_name,
+                   CacheFactory factory) {
+    Cache* cache = (*factory)(kCapacity);
+    char buf[8];
+    const uint64_t start = bench::NowMicros();
+    for(size_t i = 0; i < trace.size(); i++) {
+        EncodeFixed64(buf, trace[i]);
+        const Slice key(buf, sizeof(buf));
+        Cache::Handle* h = cache->Lookup(key);
+        if(h == nullptr) h = cache->Insert(key, nullptr, 1, &NoopDeleter);
+        cache->Release(h);
+    }
+    const uint64_t micros = bench::NowMicros() - start;
+
+    const Cache::Stats stats = cache->GetStats();
+    const std::string name = std::string(cache_name) + "/" + trace_name;
+    bench::Report(name.c_str(), trace.size(), micros);
+    std::printf("%-36s : %9.2f%% hit\n", "", stats.hits * 100.0 / (stats.hits + stats.misses));
+    delete cache;
+}
+
+// 所有键都在缓存中, 多个线程同时 Lookup/Release, 比较命中路径的争用
+static void ParallelHits(const char* cache_name, CacheFactory factory, int threads) {
+    Cache* cache = (*factory)(kCapacity);
+    const int kHotKeys = 1000;
+    char buf[8];
+    for(int k = 0; k < kHotKeys; k++) {
+        EncodeFixed64(buf, k);
+        cache->Release(cache->Insert(Slice(buf, sizeof(buf)), nullptr, 1, &NoopDeleter));
+    }
+
+    const int ops_per_thread = kOps / threads;
+    std::vector<std::thread> workers;
+    const uint64_t start = bench::NowMicros();
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([cache, t, ops_per_thread]() {
+            ZipfGenerator zipf(kHotKeys, 0.99, 17 + t);
+            char key[8];
+            for(int i = 0; i < ops_per_thread; i++) {
+                EncodeFixed64(key, zipf.Next());
+                Cache::Handle* h = cache->Lookup(Slice(key, sizeof(key)));
+                if(h != nullptr) cache->Release(h);
+            }
+        });
+    }
+    for(size_t t = 0; t < workers.size(); t++) workers[t].join();
+    const uint64_t micros = bench::NowMicros() - start;
+
+    const std::string name = std::string(cache_name) + "/hits/threads:" + std::to_string(threads);
+    bench::Report(name.c_str(), static_cast<uint64_t>(ops_per_thread) * threads, micros);
+    delete cache;
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    using namespace leveldb;
+
+    struct Trace {
+        const char* name;
+        std::vector<uint64_t> keys;
+    };
+    std::vector<Trace> traces;
+    traces.push_back(Trace{"zipf", ZipfTrace()});
+    traces.push_back(Trace{"zipf+scan", ZipfScanTrace()});
+    traces.push_back(Trace{"loop", LoopTrace()});
+    if(argc > 1) {
+        Trace file{argv[1], {}};
+        if(!ReadTraceFile(argv[1], &file.keys)) {
+            std::fprintf(stderr, "cannot read trace file %s\n", argv[1]);
+            return 1;
+        }
+        traces.push_back(file);
+    }
+
+    std::printf("capacity: %zu entries\n", kCapacity);
+    for(size_t i = 0; i < traces.size(); i++) {
+        Replay(traces[i].name, traces[i].keys, "lru", &NewLRUCache);
+        Replay(traces[i].name, traces[i].keys, "tinylfu", &NewTinyLFUCache);
+    }
+
+    const int max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for(int threads = 1; threads <= max_threads; threads *= 2) {
+        ParallelHits("lru", &NewLRUCache, threads);
+        ParallelHits("tinylfu", &NewTinyLFUCache, threads);
+    }
+    return 0;
+}
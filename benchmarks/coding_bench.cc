@@ -0,0 +1,69 @@
+/**
+ * @file coding_bench.cc
+ * @author alongnice
+ * @brief varint32 解析: 逐个调用 GetVarint32Ptr 对比 GetVarint32Batch
+ *  用法: coding_bench [每组 varint 个数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "coding.h"
+#include "random.h"
+
+namespace leveldb {
+
+// max_bits 控制值的分布: 7 位以内全是单字节, 越大多字节的值越多
+static void Run(const char* label, int max_bits, int count) {
+    Random rnd(301);
+    std::string data;
+    for(int i = 0; i < count; i++) {
+        uint32_t bits = rnd.Uniform(max_bits) + 1;
+        PutVarint32(&data, rnd.Next() & ((bits >= 32) ? 0xffffffffu : ((1u << bits) - 1)));
+    }
+    std::vector<uint32_t> values(count);
+    const char* limit = data.data() + data.size();
+    // 按数据块中一个重启区间的规模分组解析: 16 条记录 x 每条 3 个长度
+    const int kGroup = 48;
+    const int rounds = 20;
+    uint64_t sink = 0;
+
+    uint64_t start = bench::NowMicros();
+    for(int r = 0; r < rounds; r++) {
+        const char* p = data.data();
+        for(int i = 0; i < count; i++) p = GetVarint32Ptr(p, limit, &values[i]);
+        sink += values[count - 1];
+    }
+    std::string name = std::string("scalar/") + label;
+    bench::Report(name.c_str(), static_cast<uint64_t>(count) * rounds, bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    for(int r = 0; r < rounds; r++) {
+        const char* p = data.data();
+        int i = 0;
+        for(; i + kGroup <= count; i += kGroup) p = GetVarint32Batch(p, limit, &values[i], kGroup);
+        p = GetVarint32Batch(p, limit, &values[i], count - i);
+        sink += values[count - 1];
+    }
+    name = std::string("batch/") + label;
+    bench::Report(name.c_str(), static_cast<uint64_t>(count) * rounds, bench::NowMicros() - start);
+
+    if(sink == 42) std::printf("\n");  // 防止循环被优化掉
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    leveldb::Run("1byte", 7, count);
+    leveldb::Run("1-2byte", 14, count);
+    leveldb::Run("mixed", 32, count);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file compaction_bench.cc
+ * @author alongnice
+ * @brief 持续随机写入: memtable 不断落盘, 后台逐层压缩, 观察写吞吐是否稳定以及各层的文件数
+ *  每写入 10% 输出一次这一段的吞吐和各层文件数; 写完后做一轮随机点查
+ *  用法: compaction_bench [写入条数] [数据库目录]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "bench_util.h"
+#include "db_impl.h"
+#include "env.h"
+#include "random.h"
+
+namespace leveldb {
+
+static const int kValueSize = 100;
+
+static void DestroyDir(const std::string& dbname) {
+    Env* env = Env::Default();
+    std::vector<std::string> children;
+    if(!env->GetChildren(dbname, &children).ok()) return;
+    for(size_t i = 0; i < children.size(); i++) {
+        if(children[i] != "." && children[i] != "..") env->RemoveFile(dbname + "/" + children[i]);
+    }
+    ::rmdir(dbname.c_str());
+}
+
+static void Key(int k, char* buf) { std::snprintf(buf, 32, "%016d", k); }
+
+static void Run(const std::string& dbname, int num) {
+    DestroyDir(dbname);
+    DBImpl* db = new DBImpl(Options(), dbname);
+    if(!db->Open().ok()) {
+        std::fprintf(stderr, "open %s failed\n", dbname.c_str());
+        std::exit(1);
+    }
+
+    // 键在 [0, num) 中均匀随机, 有覆盖写, 压缩时会丢弃旧版本
+    Random rnd(301);
+    const std::string value(kValueSize, 'v');
+    char key[32];
+    const int step = num / 10 > 0 ? num / 10 : 1;
+    const uint64_t start = bench::NowMicros();
+    uint64_t segment_start = start;
+    for(int i = 0; i < num; i++) {
+        Key(rnd.Uniform(num), key);
+        if(!db->Put(WriteOptions(), key, value).ok()) {
+            std::fprintf(stderr, "put failed\n");
+            std::exit(1);
+        }
+        if((i + 1) % step == 0) {
+            const uint64_t now = bench::NowMicros();
+            const std::string name = "fillrandom/" + std::to_string((i + 1) / step * 10) + "%";
+            bench::Report(name.c_str(), step, now - segment_start);
+            std::printf("%-36s : %s\n", "", db->LevelSummary().c_str());
+            segment_start = now;
+        }
+    }
+    const uint64_t micros = bench::NowMicros() - start;
+    bench::Report("fillrandom/total", num, micros);
+    bench::ReportBytes("fillrandom/total", static_cast<uint64_t>(num) * (16 + kValueSize), micros);
+
+    // 写入过程中的点查要经过 memtable 和各层文件
+    const int reads = num / 10 > 0 ? num / 10 : 1;
+    std::string result;
+    int found = 0;
+    uint64_t read_start = bench::NowMicros();
+    for(int i = 0; i < reads; i++) {
+        Key(rnd.Uniform(num), key);
+        if(db->Get(key, &result).ok()) found++;
+    }
+    bench::Report("readrandom", reads, bench::NowMicros() - read_start);
+    std::printf("%-36s : %d of %d found\n", "", found, reads);
+
+    // 全部压缩到最底层之后再读
+    const uint64_t compact_start = bench::NowMicros();
+    db->CompactRange(nullptr, nullptr);
+    std::printf("%-36s : %10.1f ms\n", "compact_all", (bench::NowMicros() - compact_start) / 1e3);
+    std::printf("%-36s : %s\n", "", db->LevelSummary().c_str());
+    read_start = bench::NowMicros();
+    for(int i = 0; i < reads; i++) {
+        Key(rnd.Uniform(num), key);
+        db->Get(key, &result);
+    }
+    bench::Report("readrandom/compacted", reads, bench::NowMicros() - read_start);
+
+    delete db;
+    DestroyDir(dbname);
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int num = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const std::string dbname = argc > 2 ? argv[2] : "/tmp/leveldb_compaction_bench";
+    leveldb::Run(dbname, num);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file comparator_bench.cc
+ * @author alongnice
+ * @brief 跳表查找时 虚函数比较器(VirtualCompare) 对比 编译期比较器(BytewiseCompare)
+ *  用法: comparator_bench [键个数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "arena.h"
+#include "bench_util.h"
+#include "comparator.h"
+#include "random.h"
+#include "skiplist.h"
+
+namespace leveldb {
+
+// 生成 16 字节的键, 前 8 字节相同, 模拟带公共前缀的短键
+static std::vector<std::string> MakeKeys(int n) {
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    Random rnd(301);
+    for(int i = 0; i < n; i++) {
+        std::string key = "user0000";
+        for(int j = 0; j < 8; j++) key.push_back(static_cast<char>('a' + rnd.Uniform(26)));
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+template <class Compare>
+static void Run(const char* label, Compare cmp, const std::vector<std::string>& keys) {
+    Arena arena;
+    SkipList<Slice, Compare> list(cmp, &arena);
+    for(size_t i = 0; i < keys.size(); i++) {
+        if(!list.Contains(keys[i])) list.Insert(keys[i]);
+    }
+
+    uint64_t start = bench::NowMicros();
+    size_t found = 0;
+    for(size_t i = 0; i < keys.size(); i++) found += list.Contains(keys[keys.size() - 1 - i]);
+    std::string name = std::string(label) + "/lookup";
+    bench::Report(name.c_str(), keys.size(), bench::NowMicros() - start);
+    if(found != keys.size()) std::fprintf(stderr, "%s: lookup mismatch\n", label);
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector<std::string> keys = leveldb::MakeKeys(n);
+    leveldb::Run("virtual", leveldb::VirtualCompare(leveldb::BytewiseComparator()), keys);
+    leveldb::Run("bytewise_inline", leveldb::BytewiseCompare(), keys);
+    return 0;
+}
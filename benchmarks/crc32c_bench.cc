@@ -0,0 +1,52 @@
+/**
+ * @file crc32c_bench.cc
+ * @author alongnice
+ * @brief crc32c 吞吐: 查表实现对比 crc32 指令(三路交错)
+ *  用法: crc32c_bench [每组处理的总 MB 数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "bench_util.h"
+#include "crc32c.h"
+#include "random.h"
+
+namespace leveldb {
+
+// 块大小覆盖日志记录(百字节级)、数据块(4KB)和整块写入(1MB)
+static void Run(size_t block, uint64_t total_bytes) {
+    Random rnd(301);
+    std::string data(block, '\0');
+    for(size_t i = 0; i < block; i++) data[i] = static_cast<char>(rnd.Uniform(256));
+    const uint64_t iters = total_bytes / block + 1;
+    uint32_t sink = 0;
+
+    uint64_t start = bench::NowMicros();
+    for(uint64_t i = 0; i < iters; i++) sink ^= crc32c::ExtendPortable(0, data.data(), block);
+    std::string name = "portable/" + std::to_string(block);
+    bench::ReportBytes(name.c_str(), iters * block, bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    for(uint64_t i = 0; i < iters; i++) sink ^= crc32c::Value(data.data(), block);
+    name = (crc32c::IsHardwareAccelerated() ? "sse42/" : "extend/") + std::to_string(block);
+    bench::ReportBytes(name.c_str(), iters * block, bench::NowMicros() - start);
+
+    if(sink == 42) std::printf("\n");  // 防止循环被优化掉
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const uint64_t mb = argc > 1 ? std::atoi(argv[1]) : 1024;
+    const size_t blocks[] = {100, 4096, 65536, 1 << 20};
+    for(size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); i++) {
+        leveldb::Run(blocks[i], mb << 20);
+    }
+    return 0;
+}
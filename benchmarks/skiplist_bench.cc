@@ -0,0 +1,177 @@
+/**
+ * @file skiplist_bench.cc
+ * @author alongnice
+ * @brief 跳表写入的扩展性测试: 全局锁 + Insert 对比 InsertConcurrently
+ *  并发插入分别使用 Arena(节点分配加锁) 和 ConcurrentArena(无锁分配)
+ *  另外对比有序键的逐条插入、批量插入和 O(n) 构造, 以及正反向遍历和相邻 Seek
+ *  用法: skiplist_bench [总插入条数] [最大线程数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "bench_util.h"
+#include "concurrent_arena.h"
+#include "random.h"
+#include "skiplist.h"
+
+namespace leveldb {
+
+typedef uint64_t Key;
+
+struct KeyComparator {
+    int operator()(const Key& a, const Key& b) const {
+        if(a < b) return -1;
+        else if(a > b) return +1;
+        else return 0;
+    }
+};
+
+typedef SkipList<Key, KeyComparator> List;
+
+// 每个线程生成自己的键, 键空间按线程交错避免重复
+static std::vector<Key> MakeKeys(int thread, int threads, int n) {
+    std::vector<Key> keys;
+    keys.reserve(n);
+    Random rnd(301 + thread);
+    for(int i = 0; i < n; i++) {
+        keys.push_back((static_cast<Key>(rnd.Next()) << 20 | i) * threads + thread);
+    }
+    return keys;
+}
+
+static void RunLocked(int threads, int total) {
+    Arena arena;
+    List list(KeyComparator(), &arena);
+    std::mutex mu;
+    std::vector<std::vector<Key>> keys;
+    for(int t = 0; t < threads; t++) keys.push_back(MakeKeys(t, threads, total / threads));
+
+    uint64_t start = bench::NowMicros();
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for(size_t i = 0; i < keys[t].size(); i++) {
+                std::lock_guard<std::mutex> l(mu);
+                list.Insert(keys[t][i]);
+            }
+        });
+    }
+    for(size_t t = 0; t < workers.size(); t++) workers[t].join();
+    std::string name = "locked_insert/threads:" + std::to_string(threads);
+    bench::Report(name.c_str(), total / threads * threads, bench::NowMicros() - start);
+}
+
+template <class Allocator>
+static void RunConcurrent(const char* label, int threads, int total) {
+    Allocator arena;
+    SkipList<Key, KeyComparator, Allocator> list(KeyComparator(), &arena);
+    std::vector<std::vector<Key>> keys;
+    for(int t = 0; t < threads; t++) keys.push_back(MakeKeys(t, threads, total / threads));
+
+    uint64_t start = bench::NowMicros();
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for(size_t i = 0; i < keys[t].size(); i++) list.InsertConcurrently(keys[t][i]);
+        });
+    }
+    for(size_t t = 0; t < workers.size(); t++) workers[t].join();
+    std::string name = std::string(label) + "/threads:" + std::to_string(threads);
+    bench::Report(name.c_str(), total / threads * threads, bench::NowMicros() - start);
+}
+
+// 有序键: 逐条 Insert 对比 InsertBatch 和 BuildFromSorted
+static void RunSorted(int total) {
+    std::vector<Key> keys;
+    keys.reserve(total);
+    for(int i = 0; i < total; i++) keys.push_back(static_cast<Key>(i) * 2);
+
+    {
+        Arena arena;
+        List list(KeyComparator(), &arena);
+        uint64_t start = bench::NowMicros();
+        for(size_t i = 0; i < keys.size(); i++) list.Insert(keys[i]);
+        bench::Report("sorted/insert", keys.size(), bench::NowMicros() - start);
+    }
+    {
+        Arena arena;
+        List list(KeyComparator(), &arena);
+        uint64_t start = bench::NowMicros();
+        list.InsertBatch(keys.data(), keys.size());
+        bench::Report("sorted/insert_batch", keys.size(), bench::NowMicros() - start);
+    }
+    {
+        Arena arena;
+        List list(KeyComparator(), &arena);
+        uint64_t start = bench::NowMicros();
+        list.BuildFromSorted(keys.data(), keys.size());
+        bench::Report("sorted/build_from_sorted", keys.size(), bench::NowMicros() - start);
+    }
+}
+
+// 遍历和相邻 Seek: 迭代器保存各层前驱, 反向遍历与正向遍历代价相近
+static void RunScan(int total) {
+    Arena arena;
+    List list(KeyComparator(), &arena);
+    std::vector<Key> keys;
+    for(int i = 0; i < total; i++) keys.push_back(static_cast<Key>(i) * 2);
+    list.BuildFromSorted(keys.data(), keys.size());
+
+    List::Iterator iter(&list);
+    size_t count = 0;
+    uint64_t start = bench::NowMicros();
+    for(iter.SeekToFirst(); iter.Valid(); iter.Next()) count++;
+    bench::Report("scan/forward", count, bench::NowMicros() - start);
+
+    count = 0;
+    start = bench::NowMicros();
+    for(iter.SeekToLast(); iter.Valid(); iter.Prev()) count++;
+    bench::Report("scan/reverse", count, bench::NowMicros() - start);
+
+    // 每次向后跳 0~63 个键
+    Random rnd(301);
+    start = bench::NowMicros();
+    iter.SeekToFirst();
+    Key target = 0;
+    int seeks = 0;
+    while(iter.Valid()) {
+        target += 2 * rnd.Uniform(64);
+        iter.Seek(target);
+        seeks++;
+    }
+    bench::Report("seek/nearby", seeks, bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    for(int i = 0; i < seeks; i++) {
+        List::Iterator fresh(&list);
+        fresh.Seek(static_cast<Key>(rnd.Uniform(total)) * 2);
+    }
+    bench::Report("seek/random", seeks, bench::NowMicros() - start);
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    int total = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2])
+                               : static_cast<int>(std::thread::hardware_concurrency());
+    if(max_threads <= 0) max_threads = 1;
+    leveldb::RunSorted(total);
+    leveldb::RunScan(total);
+    for(int threads = 1; threads <= max_threads; threads *= 2) {
+        leveldb::RunLocked(threads, total);
+        leveldb::RunConcurrent<leveldb::Arena>("concurrent_insert", threads, total);
+        leveldb::RunConcurrent<leveldb::ConcurrentArena>("concurrent_insert_carena", threads, total);
+    }
+    return 0;
+}
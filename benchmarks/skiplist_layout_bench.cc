@@ -0,0 +1,87 @@
+/**
+ * @file skiplist_layout_bench.cc
+ * @author alongnice
+ * @brief 节点内联键前缀对跳表查找的影响
+ *  键是指向节点外 16 字节记录的指针, 与 memtable 的内部键布局类似
+ *  用法: skiplist_layout_bench [键个数, 默认 1000 万]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "arena.h"
+#include "bench_util.h"
+#include "random.h"
+#include "skiplist.h"
+#include "slice.h"
+
+namespace leveldb {
+
+static const size_t kKeySize = 16;
+
+// 只比较节点外的键
+struct OutOfLineComparator {
+    int operator()(const char* a, const char* b) const { return CompareBytes(a, b, kKeySize); }
+};
+
+// 额外提供 8 字节大端前缀, 节点中缓存后大多数比较不必访问节点外的键
+struct PrefixedComparator {
+    int operator()(const char* a, const char* b) const { return CompareBytes(a, b, kKeySize); }
+    uint64_t KeyPrefix(const char* k) const {
+        uint64_t v;
+        std::memcpy(&v, k, sizeof(v));
+        return __builtin_bswap64(v);
+    }
+};
+
+template <class Compare>
+static void Run(const char* label, const std::vector<const char*>& keys,
+                const std::vector<const char*>& lookups) {
+    Arena arena(1 << 20);
+    SkipList<const char*, Compare> list(Compare(), &arena);
+
+    uint64_t start = bench::NowMicros();
+    for(size_t i = 0; i < keys.size(); i++) list.Insert(keys[i]);
+    std::string name = std::string(label) + "/insert";
+    bench::Report(name.c_str(), keys.size(), bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    size_t found = 0;
+    for(size_t i = 0; i < lookups.size(); i++) found += list.Contains(lookups[i]);
+    name = std::string(label) + "/lookup";
+    bench::Report(name.c_str(), lookups.size(), bench::NowMicros() - start);
+    if(found != lookups.size()) std::fprintf(stderr, "%s: lookup mismatch\n", label);
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000000;
+    // 所有键放在一块连续内存中, 插入顺序随机
+    std::vector<char> storage(n * leveldb::kKeySize);
+    std::vector<const char*> keys(n);
+    leveldb::Random rnd(301);
+    for(size_t i = 0; i < n; i++) {
+        char* k = &storage[i * leveldb::kKeySize];
+        for(size_t j = 0; j < leveldb::kKeySize; j += 4) {
+            uint32_t r = rnd.Next();
+            std::memcpy(k + j, &r, 4);
+        }
+        const uint64_t id = i;
+        std::memcpy(k + 8, &id, sizeof(id));  // 后 8 字节写入序号, 保证唯一
+        keys[i] = k;
+    }
+    std::vector<const char*> lookups(keys);
+    for(size_t i = lookups.size(); i > 1; i--) std::swap(lookups[i - 1], lookups[rnd.Uniform(static_cast<int>(i))]);
+
+    leveldb::Run<leveldb::OutOfLineComparator>("out_of_line_key", keys, lookups);
+    leveldb::Run<leveldb::PrefixedComparator>("inline_prefix", keys, lookups);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file slice_bench.cc
+ * @author alongnice
+ * @brief 短键比较: memcmp 对比 CompareBytes, 以及 SharedPrefixLength 的开销
+ *  用法: slice_bench [每组比较次数]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "random.h"
+#include "slice.h"
+
+namespace leveldb {
+
+// 生成 count 个长度为 len 的键, 键之间共享一段随机长度的前缀, 模拟有序键的比较
+static std::vector<std::string> MakeKeys(size_t len, int count) {
+    std::vector<std::string> keys;
+    Random rnd(301);
+    std::string prefix(len, 'k');
+    for(int i = 0; i < count; i++) {
+        std::string key = prefix;
+        size_t shared = rnd.Uniform(static_cast<int>(len));
+        for(size_t j = shared; j < len; j++) key[j] = static_cast<char>(rnd.Uniform(256));
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+static void Run(size_t len, int ops) {
+    const int kKeys = 1024;
+    std::vector<std::string> keys = MakeKeys(len, kKeys);
+    int sink = 0;
+
+    uint64_t start = bench::NowMicros();
+    for(int i = 0; i < ops; i++) {
+        const std::string& a = keys[i & (kKeys - 1)];
+        const std::string& b = keys[(i * 7 + 1) & (kKeys - 1)];
+        sink += memcmp(a.data(), b.data(), len) < 0;
+    }
+    std::string name = "memcmp/len:" + std::to_string(len);
+    bench::Report(name.c_str(), ops, bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    for(int i = 0; i < ops; i++) {
+        const std::string& a = keys[i & (kKeys - 1)];
+        const std::string& b = keys[(i * 7 + 1) & (kKeys - 1)];
+        sink += CompareBytes(a.data(), b.data(), len) < 0;
+    }
+    name = "CompareBytes/len:" + std::to_string(len);
+    bench::Report(name.c_str(), ops, bench::NowMicros() - start);
+
+    start = bench::NowMicros();
+    for(int i = 0; i < ops; i++) {
+        const std::string& a = keys[i & (kKeys - 1)];
+        const std::string& b = keys[(i * 7 + 1) & (kKeys - 1)];
+        sink += static_cast<int>(SharedPrefixLength(Slice(a), Slice(b)));
+    }
+    name = "SharedPrefixLength/len:" + std::to_string(len);
+    bench::Report(name.c_str(), ops, bench::NowMicros() - start);
+
+    if(sink == 42) std::printf("\n");  // 防止循环被优化掉
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int ops = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    const size_t lengths[] = {8, 16, 24, 32, 64};
+    for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        leveldb::Run(lengths[i], ops);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file table_read_bench.cc
+ * @author alongnice
+ * @brief 表文件读取: pread 对比 mmap 的随机点查和顺序遍历
+ *  文件刚写完, 内容都在页缓存中, 比较的是拷贝和系统调用的开销
+ *  用法: table_read_bench [条目数] [表文件路径]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "bench_util.h"
+#include "env.h"
+#include "random.h"
+#include "table.h"
+#include "table_builder.h"
+
+namespace leveldb {
+
+static std::string Key(int i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key%012d", i);
+    return buf;
+}
+
+static void BuildTable(const std::string& fname, int num_entries) {
+    WritableFile* file;
+    if(!Env::Default()->NewWritableFile(fname, &file).ok()) {
+        std::fprintf(stderr, "create %s failed\n", fname.c_str());
+        std::exit(1);
+    }
+    Options options;
+    TableBuilder builder(options, file);
+    const std::string value(100, 'v');
+    for(int i = 0; i < num_entries; i++) builder.Add(Key(i), value);
+    if(!builder.Finish().ok() || !file->Close().ok()) {
+        std::fprintf(stderr, "write %s failed\n", fname.c_str());
+        std::exit(1);
+    }
+    delete file;
+}
+
+static void CountResult(void* arg, const Slice&, const Slice&) { ++*reinterpret_cast<int*>(arg); }
+
+static void Run(const char* mode, int mmap_limit, const std::string& fname, int num_entries) {
+    SetReadOnlyMmapLimit(mmap_limit);
+    Env* env = Env::Default();
+    uint64_t size;
+    RandomAccessFile* file;
+    Table* table;
+    if(!env->GetFileSize(fname, &size).ok() || !env->NewRandomAccessFile(fname, &file).ok() ||
+       !Table::Open(Options(), file, size, &table).ok()) {
+        std::fprintf(stderr, "open %s failed\n", fname.c_str());
+        std::exit(1);
+    }
+
+    ReadOptions options;
+    Random rnd(301);
+    int found = 0;
+    const int lookups = num_entries;
+    uint64_t start = bench::NowMicros();
+    for(int i = 0; i < lookups; i++) {
+        table->InternalGet(options, Key(rnd.Uniform(num_entries)), &found, &CountResult);
+    }
+    std::string name = std::string(mode) + "/random_get";
+    bench::Report(name.c_str(), lookups, bench::NowMicros() - start);
+    if(found != lookups) std::printf("  missing keys!\n");
+
+    uint64_t bytes = 0;
+    start = bench::NowMicros();
+    Iterator* iter = table->NewIterator(options);
+    for(iter->SeekToFirst(); iter->Valid(); iter->Next()) bytes += iter->key().size() + iter->value().size();
+    delete iter;
+    name = std::string(mode) + "/scan";
+    bench::ReportBytes(name.c_str(), bytes, bench::NowMicros() - start);
+
+    delete table;
+    delete file;
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    using namespace leveldb;
+    const int num_entries = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const std::string fname = argc > 2 ? argv[2] : "/tmp/leveldb_table_read_bench.ldb";
+
+    BuildTable(fname, num_entries);
+    Run("pread", 0, fname, num_entries);
+    Run("mmap", 1000, fname, num_entries);
+    Env::Default()->RemoveFile(fname);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file write_bench.cc
+ * @author alongnice
+ * @brief 同步写吞吐: 1/8/64 个写线程, 每次写入都要求落盘, 组提交把并发写合并成一次 fdatasync
+ *  用法: write_bench [每组总写入次数] [数据库目录]
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "bench_util.h"
+#include "db_impl.h"
+#include "env.h"
+
+namespace leveldb {
+
+// 删除数据库目录中的所有文件, 每组都从空数据库开始
+static void DestroyDir(const std::string& dbname) {
+    Env* env = Env::Default();
+    std::vector<std::string> children;
+    if(!env->GetChildren(dbname, &children).ok()) return;
+    for(size_t i = 0; i < children.size(); i++) {
+        if(children[i] != "." && children[i] != "..") env->RemoveFile(dbname + "/" + children[i]);
+    }
+    ::rmdir(dbname.c_str());
+}
+
+static void Run(const std::string& dbname, int threads, int total, bool sync) {
+    DBImpl* db = new DBImpl(Options(), dbname);
+    if(!db->Open().ok()) {
+        std::fprintf(stderr, "open %s failed\n", dbname.c_str());
+        std::exit(1);
+    }
+    WriteOptions options;
+    options.sync = sync;
+    const int per_thread = total / threads;
+    const std::string value(100, 'v');
+
+    uint64_t start = bench::NowMicros();
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.emplace_back([db, t, per_thread, &options, &value]() {
+            char key[32];
+            for(int i = 0; i < per_thread; i++) {
+                std::snprintf(key, sizeof(key), "%04d%012d", t, i);
+                db->Put(options, key, value);
+            }
+        });
+    }
+    for(size_t i = 0; i < workers.size(); i++) workers[i].join();
+    uint64_t micros = bench::NowMicros() - start;
+
+    std::string name = std::string(sync ? "sync" : "nosync") + "/threads:" + std::to_string(threads);
+    bench::Report(name.c_str(), static_cast<uint64_t>(per_thread) * threads, micros);
+    delete db;
+    DestroyDir(dbname);
+}
+
+}   // namespace leveldb
+
+int main(int argc, char** argv) {
+    const int total = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const std::string dbname = argc > 2 ? argv[2] : "/tmp/leveldb_write_bench";
+    const int threads[] = {1, 8, 64};
+    for(size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        leveldb::Run(dbname, threads[i], total, true);
+    }
+    leveldb::Run(dbname, 1, total, false);
+    return 0;
+}
@@ -15,16 +15,80 @@
 #include <cassert>
 #include <cstdint>
 #include <cstddef>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 
 namespace leveldb {
+
+/**
+ * @brief 一个内存块的描述, 释放时需要知道它是 new char[] 还是 mmap 申请的
+ */
+struct ArenaBlock {
+    char* data;
+    size_t size;
+    bool mmapped;
+};
+
+/**
+ * @brief 进程级的内存块回收站, 线程安全
+ *  arena 释放的普通块先放到这里, 下一个 arena 可以直接取用, 避免反复 new/delete 和缺页
+ *  只缓存有限的字节数, 超出部分直接释放
+ */
+class BlockRecycler {
+public:
+    explicit BlockRecycler(size_t capacity);
+    BlockRecycler(const BlockRecycler&) = delete;
+    BlockRecycler& operator=(const BlockRecycler&) = delete;
+    ~BlockRecycler();
+
+    /**
+     * @brief 取一个大小和类型都匹配的块
+     * @return true 取到了, 写入 block
+     * @return false 没有可用的块
+     */
+    bool Take(size_t size, bool mmapped, ArenaBlock* block);
+
+    /**
+     * @brief 归还一个块
+     * @return true 回收站接收了该块
+     * @return false 已达容量上限, 调用方自己释放
+     */
+    bool Give(const ArenaBlock& block);
+
+    /**
+     * @brief 当前缓存的字节数
+     * @return size_t
+     */
+    size_t RetainedBytes() const;
+
+    /**
+     * @brief 进程内默认的回收站, 容量 kDefaultCapacity, 不得删除
+     * @return BlockRecycler*
+     */
+    static BlockRecycler* Default();
+
+    static const size_t kDefaultCapacity = 64u << 20;
+
+private:
+    const size_t capacity_;
+    mutable std::mutex mu_;
+    size_t retained_bytes_;
+    std::vector<ArenaBlock> blocks_;
+};
+
 class Arena {
 public:
     /**
-     * @brief 默认构造函数
+     * @brief 构造函数
+     * @param block_size 普通内存块大小, 会被修正到 [kMinBlockSize, kMaxBlockSize] 并按 8 字节对齐
+     * @param huge_page_size 非 0 时普通内存块通过 mmap 申请并按该大小对齐, 同时 madvise(MADV_HUGEPAGE)
+     *  block_size 会被向上取整为它的整数倍; 系统不支持或 mmap 失败时自动退回 new char[]
+     * @param recycler 非空时普通块从回收站取, 析构或 Reset 多余的普通块还给回收站
      */
-    Arena();
+    explicit Arena(size_t block_size = kDefaultBlockSize, size_t huge_page_size = 0,
+                   BlockRecycler* recycler = nullptr);
     Arena(const Arena&) = delete; // 禁止拷贝构造
     /**
      * @brief 析构函数
@@ -47,6 +111,21 @@ public:
      */
     char* AllocateAligned(size_t bytes);
 
+    /**
+     * @brief 取一个完整的普通块(BlockSize() 字节), 由调用方自己切分, 不影响 Allocate 正在使用的块
+     *  与 Allocate 的大块不同, 这个块析构时可以还给回收站
+     * @return char*
+     */
+    char* AllocateBlock() { return AllocateRegularBlock(); }
+
+    /**
+     * @brief 释放之前分配的所有内存, arena 可以继续使用
+     *  最多保留 max_retained_bytes 字节的普通块在本地复用, 其余还给回收站或直接释放
+     *  调用前必须保证没有人再引用之前分配的内存
+     * @param max_retained_bytes 本地保留的上限
+     */
+    void Reset(size_t max_retained_bytes = kDefaultMaxRetainedBytes);
+
     /**
      * @brief 返回内存块大小
      * @return size_t 
@@ -55,6 +134,30 @@ public:
         return memory_usage_.load(std::memory_order_relaxed);
     }
 
+    /**
+     * @brief 修正后的普通内存块大小
+     * @return size_t
+     */
+    size_t BlockSize() const { return block_size_; }
+
+    /**
+     * @brief 通过 mmap 申请的内存块个数, 用于确认大页模式是否生效
+     * @return size_t
+     */
+    size_t MmapBlockCount() const;
+
+    /**
+     * @brief Reset 之后本地保留、等待复用的字节数, 不计入 MemoryUsage
+     * @return size_t
+     */
+    size_t RetainedBytes() const { return free_blocks_.size() * block_size_; }
+
+    static const size_t kDefaultBlockSize = 4096;
+    static const size_t kMinBlockSize = 4096;
+    static const size_t kMaxBlockSize = 2u << 30;
+    static const size_t kDefaultHugePageSize = 2u << 20;  // x86_64 透明大页 2MB
+    static const size_t kDefaultMaxRetainedBytes = 64u << 20;
+
 private:
     /**
      * @brief 分配回退
@@ -71,6 +174,35 @@ private:
      */
     char* AllocateNewBlock(size_t block_bytes);
 
+    /**
+     * @brief 通过 mmap 申请按 huge_page_size_ 对齐的内存块, 失败返回 nullptr
+     *
+     * @param block_bytes
+     * @return char*
+     */
+    char* AllocateMmapBlock(size_t block_bytes);
+
+    /**
+     * @brief 取一个普通块: 本地空闲块 -> 回收站 -> 大页 -> new char[]
+     *
+     * @return char*
+     */
+    char* AllocateRegularBlock();
+
+    /**
+     * @brief 释放一个块, 普通块优先还给回收站
+     *
+     * @param block
+     */
+    void ReleaseBlock(const ArenaBlock& block);
+
+    /**
+     * @brief 块大小和大页参数
+     */
+    const size_t block_size_;
+    const size_t huge_page_size_;
+    BlockRecycler* const recycler_;
+
     /**
      * @brief 分配状态
      */
@@ -78,10 +210,16 @@ private:
     size_t alloc_bytes_remaining_;
 
     /**
-     * @brief 内存块数组
+     * @brief 内存块数组(包含 new char[] 和 mmap 申请的块)
      * 
      */
-    std::vector<char*> blocks_;
+    std::vector<ArenaBlock> blocks_;
+
+    /**
+     * @brief Reset 之后保留下来的空闲普通块
+     *
+     */
+    std::vector<ArenaBlock> free_blocks_;
 
 
     /**
@@ -119,20 +257,32 @@ inline char* Arena::Allocate(size_t bytes){
  * 
  * 
  * 基本流程
- * 小内存申请（如 < kBlockSize/4）
+ * 小内存申请（如 < block_size_/4）
  * 优先从当前块分配（Allocate）
- * 当前块空间不足时，AllocateFallback 分配新块（kBlockSize），并更新 alloc_ptr_ 和 alloc_bytes_remaining_
- * 大内存申请（如 > kBlockSize/4）
+ * 当前块空间不足时，AllocateFallback 分配新块（block_size_），并更新 alloc_ptr_ 和 alloc_bytes_remaining_
+ * 大内存申请（如 > block_size_/4）
  * 直接分配一个独立的新块（AllocateNewBlock），避免浪费主块空间
  * 
  * 
  * 增删改查说明
  * 增（Allocate/AllocateAligned）：分配新内存，更新指针和剩余空间
- * 删（~Arena）：析构时统一释放所有 blocks_ 指向的内存
+ * 删（~Arena/Reset）：析构时统一释放所有 blocks_ 指向的内存; Reset 清空分配状态但保留部分普通块复用
  * 改：无直接“改”操作，分配后由外部使用者管理
  * 查（MemoryUsage）：查询当前内存池总分配量
  * 
  * 
+ * 块大小（block_size_）
+ * 默认 4096, 大的 memtable 应该调大, 否则 64MB 的数据需要上万次 new char[], 节点也会散落在大量页中
+ * 大页模式下普通块用 mmap 申请并 madvise(MADV_HUGEPAGE), 一个 2MB 块只占一个 TLB 表项
+ * 大块申请依然走 new char[], 它们本身是独立使用的, 没有必要占用大页
+ *
+ *
+ * 块复用（Reset/BlockRecycler）
+ * memtable 每次轮转都会丢弃整个 arena, 重新申请同样多的块并再次触发缺页
+ * Reset 把普通块留在本地下次直接用; 多余的块和析构时的块交给 BlockRecycler, 下一个 arena 从中领取
+ * 只有普通块参与复用, 大块大小不固定, 直接释放
+ *
+ *
  * 对齐分配（AllocateAligned）
  * 预留接口，后续可实现按 8 字节或更高对齐分配，保证特殊场景下的性能和正确性
  * 总结：
@@ -0,0 +1,93 @@
+/**
+ * @file cache.h
+ * @author alongnice
+ * @brief 键值缓存接口, 内部自带同步, 多个线程可以同时访问
+ *  每个条目带有调用方指定的 charge(占用量), 总占用超过容量时淘汰条目
+ *  表读取用它缓存解析好的数据块, 重复读取热点块时不必再读文件
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "slice.h"
+
+namespace leveldb {
+
+class Cache;
+
+/**
+ * @brief 创建一个容量固定、按最近最少使用淘汰的缓存
+ *  内部按键的哈希分成 16 个分片, 每个分片各有一把锁, 容量平均分给各分片
+ */
+Cache* NewLRUCache(size_t capacity);
+
+/**
+ * @brief 创建一个按 W-TinyLFU 淘汰的缓存, 分片方式与 NewLRUCache 相同
+ *  新条目要比被挤掉的条目访问更频繁才能长期留下, 一次性的大范围扫描不会冲掉热点数据
+ *  命中只需要读锁, 释放句柄不加锁, 多线程读热点时比 LRU 的争用少
+ */
+Cache* NewTinyLFUCache(size_t capacity);
+
+class Cache {
+public:
+    Cache() = default;
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    // 对所有条目调用插入时传入的 deleter
+    virtual ~Cache();
+
+    // 缓存中条目的不透明句柄
+    struct Handle {};
+
+    /**
+     * @brief 插入 key -> value, 占用 charge, 返回新条目的句柄; 不再使用时调用方必须 Release
+     *  条目被淘汰或删除且没有句柄引用时, 调用 deleter(key, value)
+     */
+    virtual Handle* Insert(const Slice& key, void* value, size_t charge,
+                           void (*deleter)(const Slice& key, void* value)) = 0;
+
+    // 没有 key 对应的条目时返回 nullptr, 否则返回句柄, 不再使用时调用方必须 Release
+    virtual Handle* Lookup(const Slice& key) = 0;
+
+    // 释放 Lookup/Insert 返回的句柄, 要求该句柄还没有被释放
+    virtual void Release(Handle* handle) = 0;
+
+    // 句柄对应条目的值, 要求该句柄还没有被释放
+    virtual void* Value(Handle* handle) = 0;
+
+    // 删除 key 对应的条目; 仍被句柄引用的条目会在所有句柄释放后才真正删除
+    virtual void Erase(const Slice& key) = 0;
+
+    /**
+     * @brief 返回一个新的数字 id
+     *  多个使用者共享一个缓存时, 各自用不同的 id 作为键的前缀来划分键空间
+     */
+    virtual uint64_t NewId() = 0;
+
+    // 删除所有没有被引用的条目
+    virtual void Prune() {}
+
+    // 所有条目的 charge 之和
+    virtual size_t TotalCharge() const = 0;
+
+    /**
+     * @brief 命中统计, 用来确定缓存应该设多大
+     */
+    struct Stats {
+        uint64_t hits = 0;       // Lookup 找到条目的次数
+        uint64_t misses = 0;     // Lookup 没有找到条目的次数
+        uint64_t inserts = 0;    // Insert 的次数
+        uint64_t evictions = 0;  // 因为容量不足被淘汰的条目数
+    };
+    virtual Stats GetStats() const = 0;
+};
+
+}   // namespace leveldb
@@ -0,0 +1,117 @@
+/**
+ * @file coding.h
+ * @author alongnice
+ * @brief 编码工具, 定长整数统一按小端序存放, 变长整数使用 varint 编码
+ *  memtable 的内部键和后续的磁盘格式都依赖这里的编解码
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "slice.h"
+
+namespace leveldb {
+
+// 追加到 string 末尾
+void PutFixed32(std::string* dst, uint32_t value);
+void PutFixed64(std::string* dst, uint64_t value);
+void PutVarint32(std::string* dst, uint32_t value);
+void PutVarint64(std::string* dst, uint64_t value);
+// varint32 长度前缀 + 内容
+void PutLengthPrefixedSlice(std::string* dst, const Slice& value);
+
+// 从 input 头部解析, 成功时 input 前移到解析结束的位置, 失败返回 false
+bool GetVarint32(Slice* input, uint32_t* value);
+bool GetVarint64(Slice* input, uint64_t* value);
+bool GetLengthPrefixedSlice(Slice* input, Slice* result);
+
+// 返回 v 的 varint 编码长度
+int VarintLength(uint64_t v);
+
+// 直接写入 dst, 返回写入之后的下一个位置; 调用方保证空间足够
+char* EncodeVarint32(char* dst, uint32_t value);
+char* EncodeVarint64(char* dst, uint64_t value);
+
+// 从 [p, limit) 中解析一个 varint, 成功返回解析结束的位置, 失败返回 nullptr
+const char* GetVarint64Ptr(const char* p, const char* limit, uint64_t* value);
+const char* GetVarint32PtrFallback(const char* p, const char* limit, uint32_t* value);
+inline const char* GetVarint32Ptr(const char* p, const char* limit, uint32_t* value) {
+    // 单字节的快速路径, 内部键的长度前缀绝大多数都小于 128
+    if(p < limit) {
+        uint32_t result = *(reinterpret_cast<const uint8_t*>(p));
+        if((result & 128) == 0) {
+            *value = result;
+            return p + 1;
+        }
+    }
+    return GetVarint32PtrFallback(p, limit, value);
+}
+
+/**
+ * @brief 批量解析 n 个连续存放的 varint32, 用于一次解出整段记录头(如重启区间内的各项长度)
+ *  支持 SSE2 时每次检查 16 字节的续位, 单字节的值整批展开, 多字节的值按掩码定位后无分支拼接
+ *  不足 16 字节的尾部和其他平台逐个解析, 结果与逐个调用 GetVarint32Ptr 完全一致
+ * @param values 输出, 至少 n 个元素
+ * @return 成功返回解析结束的位置, 数据不足或编码非法返回 nullptr
+ */
+const char* GetVarint32Batch(const char* p, const char* limit, uint32_t* values, size_t n);
+
+/**
+ * @brief 定长编码, 逐字节写入保证与主机字节序无关
+ *  编译器能识别该模式并在小端机器上合并成一条 mov 指令
+ */
+inline void EncodeFixed32(char* dst, uint32_t value) {
+    uint8_t* const buffer = reinterpret_cast<uint8_t*>(dst);
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+    buffer[2] = static_cast<uint8_t>(value >> 16);
+    buffer[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void EncodeFixed64(char* dst, uint64_t value) {
+    uint8_t* const buffer = reinterpret_cast<uint8_t*>(dst);
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+    buffer[2] = static_cast<uint8_t>(value >> 16);
+    buffer[3] = static_cast<uint8_t>(value >> 24);
+    buffer[4] = static_cast<uint8_t>(value >> 32);
+    buffer[5] = static_cast<uint8_t>(value >> 40);
+    buffer[6] = static_cast<uint8_t>(value >> 48);
+    buffer[7] = static_cast<uint8_t>(value >> 56);
+}
+
+inline uint32_t DecodeFixed32(const char* ptr) {
+    const uint8_t* const buffer = reinterpret_cast<const uint8_t*>(ptr);
+    return (static_cast<uint32_t>(buffer[0])) |
+           (static_cast<uint32_t>(buffer[1]) << 8) |
+           (static_cast<uint32_t>(buffer[2]) << 16) |
+           (static_cast<uint32_t>(buffer[3]) << 24);
+}
+
+inline uint64_t DecodeFixed64(const char* ptr) {
+    const uint8_t* const buffer = reinterpret_cast<const uint8_t*>(ptr);
+    return (static_cast<uint64_t>(buffer[0])) |
+           (static_cast<uint64_t>(buffer[1]) << 8) |
+           (static_cast<uint64_t>(buffer[2]) << 16) |
+           (static_cast<uint64_t>(buffer[3]) << 24) |
+           (static_cast<uint64_t>(buffer[4]) << 32) |
+           (static_cast<uint64_t>(buffer[5]) << 40) |
+           (static_cast<uint64_t>(buffer[6]) << 48) |
+           (static_cast<uint64_t>(buffer[7]) << 56);
+}
+
+}   // namespace leveldb
+
+/**
+ * varint 编码: 每个字节低 7 位存数据, 最高位为 1 表示后面还有字节
+ * 0~127 只占 1 个字节, uint32 最多 5 字节, uint64 最多 10 字节
+ *
+ * 定长编码统一小端序, 这样文件在不同机器之间可以直接拷贝使用
+ */
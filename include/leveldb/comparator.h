@@ -22,8 +22,9 @@
 #pragma once
 #include <string>
 
+#include "slice.h"
+
 namespace leveldb {
-class Slice;
 
 class Comparator {
 public:
@@ -50,6 +51,23 @@ public:
 
 // 返回一个内置的比较器，该比较器使用按字节排序的词典。结果仍然是该模块的属性，不得删除。
 const Comparator* BytewiseComparator();
+
+/**
+ * @brief 编译期确定的字典序比较函子, 与 BytewiseComparator() 的顺序完全一致
+ *  作为 SkipList 等模板的比较器参数时比较可以被内联, 省掉每次跳转的虚函数调用
+ */
+struct BytewiseCompare {
+    int operator()(const Slice& a, const Slice& b) const { return a.compare(b); }
+};
+
+/**
+ * @brief 运行时比较器的函子包装, 用于比较器在编译期未知的场景
+ */
+struct VirtualCompare {
+    explicit VirtualCompare(const Comparator* c) : cmp(c) {}
+    int operator()(const Slice& a, const Slice& b) const { return cmp->Compare(a, b); }
+    const Comparator* cmp;
+};
 }
 
 // 全纯虚函数允许不同的比较策略
@@ -72,6 +90,11 @@ const Comparator* BytewiseComparator();
 // abc b作为后继 abc < b
 
 
+// BytewiseCompare / VirtualCompare
+// 模板参数是函子类型时, 编译器在实例化时就知道调用目标, 可以把比较内联进查找循环
+// 运行时才能确定的比较器用 VirtualCompare 包装, 行为与直接调用 Compare 相同
+// 需要在两者之间切换时, 由调用方判断比较器是否为 BytewiseComparator() 再选择路径
+
 // 深层思考 findShortestSeparator 和 findShortSuccessor 的设计意图
 // 存储优化降低磁盘空间 内存优化减少索引大小 查询优化更短的键比较
 
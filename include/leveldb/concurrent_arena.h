@@ -0,0 +1,157 @@
+/**
+ * @file concurrent_arena.h
+ * @author alongnice
+ * @brief 线程安全的内存池, 给并发写入的跳表使用
+ *  每个线程映射到一个分片, 分片从共享的 Arena 中批量切出一段区域自己做指针递增
+ *  快路径只有一次原子读和一次 CAS, 不需要加锁; 区域用完时才进入加锁的慢路径
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "arena.h"
+
+namespace leveldb {
+
+class ConcurrentArena {
+public:
+    /**
+     * @brief 构造函数
+     * @param shard_block_size 每次给分片切出的区域大小
+     * @param arena_block_size 后备 Arena 的块大小, 不小于一个分片区域
+     * @param huge_page_size 后备 Arena 的大页大小, 0 表示不使用大页
+     * @param recycler 后备 Arena 的块回收站, 可以为空
+     */
+    explicit ConcurrentArena(size_t shard_block_size = kDefaultShardBlockSize,
+                             size_t arena_block_size = Arena::kDefaultBlockSize,
+                             size_t huge_page_size = 0, BlockRecycler* recycler = nullptr);
+
+    ConcurrentArena(const ConcurrentArena&) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+    ~ConcurrentArena();
+
+    /**
+     * @brief 申请内存, 可被多个线程同时调用
+     * @param bytes 申请内存块大小
+     * @return char*
+     */
+    char* Allocate(size_t bytes) { return AllocateImpl(bytes, 1); }
+
+    /**
+     * @brief 申请按指针宽度(至少 8 字节)对齐的内存, 可被多个线程同时调用
+     * @param bytes 申请内存块大小
+     * @return char*
+     */
+    char* AllocateAligned(size_t bytes) { return AllocateImpl(bytes, kAlign); }
+
+    /**
+     * @brief 从系统申请的总字节数, 已经包含了所有分片中尚未用完的部分
+     * @return size_t
+     */
+    size_t MemoryUsage() const { return arena_.MemoryUsage(); }
+
+    /**
+     * @brief 各分片已经切出但还没有分配出去的字节数之和
+     * @return size_t
+     */
+    size_t AllocatedAndUnused() const;
+
+    static const size_t kDefaultShardBlockSize = 8192;
+
+private:
+    static const size_t kAlign = (sizeof(void*) > 8) ? sizeof(void*) : 8;
+
+    /**
+     * @brief 分片当前使用的一段连续区域, 区域结构体本身也放在 arena 中
+     *  区域只在 arena 析构时释放, 因此读到旧区域指针的线程不会访问到已释放内存
+     */
+    struct Region {
+        char* base;
+        size_t size;
+        std::atomic<size_t> used;
+    };
+
+    /**
+     * @brief 分片, 尾部填充一个缓存行防止相邻分片伪共享
+     *  (c++11 的 new 不保证 alignas(64) 的对齐, 所以用填充代替)
+     */
+    struct Shard {
+        std::atomic<Region*> current;
+        std::mutex refill_mu;  // 只在切换区域时使用
+        char padding[64];
+        Shard() : current(nullptr) {}
+    };
+
+    char* AllocateImpl(size_t bytes, size_t align);
+
+    // 在区域中无锁分配, 空间不足返回 nullptr
+    static char* TryAllocate(Region* r, size_t bytes, size_t align);
+
+    // 慢路径: 替换分片的区域或者直接从共享 arena 分配大块
+    char* AllocateSlow(Shard* s, Region* seen, size_t bytes, size_t align);
+
+    Shard* CurrentShard();
+
+    // 后备 Arena 实际使用的块大小, 至少放得下一个区域
+    static size_t BackingBlockSize(size_t shard_block_size, size_t arena_block_size);
+
+    const size_t shard_block_size_;
+    size_t shard_mask_;
+    std::unique_ptr<Shard[]> shards_;
+
+    std::mutex arena_mu_;  // 保护 arena_
+    Arena arena_;
+};
+
+inline char* ConcurrentArena::TryAllocate(Region* r, size_t bytes, size_t align) {
+    size_t used = r->used.load(std::memory_order_relaxed);
+    while(true) {
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(r->base) + used;
+        const size_t slop = (align - (addr & (align - 1))) & (align - 1);
+        const size_t needed = slop + bytes;
+        if(needed > r->size - used) return nullptr;
+        // 失败时 used 会被更新为最新值, 重新计算
+        if(r->used.compare_exchange_weak(used, used + needed, std::memory_order_relaxed)) {
+            return r->base + used + slop;
+        }
+    }
+}
+
+inline char* ConcurrentArena::AllocateImpl(size_t bytes, size_t align) {
+    assert(bytes > 0);
+    Shard* s = CurrentShard();
+    Region* r = s->current.load(std::memory_order_acquire);
+    if(r != nullptr) {
+        char* result = TryAllocate(r, bytes, align);
+        if(result != nullptr) return result;
+    }
+    return AllocateSlow(s, r, bytes, align);
+}
+
+}   // namespace leveldb
+
+/**
+ * 与 Arena 的关系
+ * ConcurrentArena 内部仍然用一个 Arena 作为后备, 只是把它包在一把锁后面
+ * 每个分片一次从后备 Arena 取 shard_block_size_ 字节, 之后在分片内自己递增
+ * 所以锁的竞争频率约为 平均分配大小 / shard_block_size_
+ * 后备 Arena 超过块大小 1/4 的申请会单独分配一个不定长的块, 这种块不会交给回收站
+ * 所以区域放不进块的 1/4 时直接占用一个完整的普通块(AllocateBlock), memtable 轮转时块可以被下一个 memtable 复用
+ *
+ * 线程到分片的映射
+ * 每个线程第一次使用时按轮转分配一个编号, 编号 & shard_mask_ 即为分片下标
+ * 线程数不超过分片数时每个线程独占一个分片, 超过时多个线程在同一个分片上 CAS
+ *
+ * 大块申请(超过 shard_block_size_/4)直接加锁从后备 Arena 分配, 不浪费分片区域
+ */
@@ -0,0 +1,62 @@
+/**
+ * @file crc32c.h
+ * @author alongnice
+ * @brief CRC32C(Castagnoli) 校验, 日志记录和数据块都用它做完整性检查
+ *  x86-64 上运行时检测 SSE4.2, 支持时使用 crc32 指令, 否则退回查表实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace leveldb {
+namespace crc32c {
+
+/**
+ * @brief 计算 concat(A, data[0, n-1]) 的 crc32c, 其中 init_crc 是某段数据 A 的 crc32c
+ *  用于分段计算一整段数据的校验值
+ */
+uint32_t Extend(uint32_t init_crc, const char* data, size_t n);
+
+// 查表实现, 与 Extend 结果相同; 单独导出用于测试和性能对比
+uint32_t ExtendPortable(uint32_t init_crc, const char* data, size_t n);
+
+// 当前机器上 Extend 是否使用了 crc32 指令
+bool IsHardwareAccelerated();
+
+// 返回 data[0, n-1] 的 crc32c
+inline uint32_t Value(const char* data, size_t n) { return Extend(0, data, n); }
+
+static const uint32_t kMaskDelta = 0xa282ead8ul;
+
+/**
+ * @brief 返回掩码后的 crc
+ *  对包含内嵌 crc 的数据再计算 crc 容易出问题, 所以存储的 crc 都要先掩码
+ */
+inline uint32_t Mask(uint32_t crc) {
+    // 循环右移 15 位再加上常数
+    return ((crc >> 15) | (crc << 17)) + kMaskDelta;
+}
+
+// Mask 的逆操作
+inline uint32_t Unmask(uint32_t masked_crc) {
+    uint32_t rot = masked_crc - kMaskDelta;
+    return ((rot >> 17) | (rot << 15));
+}
+
+}   // namespace crc32c
+}   // namespace leveldb
+
+/**
+ * 两条实现路径:
+ *  查表: slicing-by-4, 每次处理 4 字节, 表在第一次使用时由多项式生成
+ *  crc32 指令: 指令延迟 3 个周期但每周期可以发射一条, 长数据切成三段交错计算,
+ *   三段各自的 crc 再用"追加 n 个 0 字节"的线性变换合并; 变换预先展开成按字节查的表
+ *
+ * 两条路径的结果逐位相同, 写入的文件可以在任意机器上校验
+ */
@@ -0,0 +1,178 @@
+/**
+ * @file env.h
+ * @author alongnice
+ * @brief 操作系统环境的抽象, 数据库访问文件都通过这里的接口
+ *  测试可以用内存实现替换, 默认实现基于 posix
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "status.h"
+
+namespace leveldb {
+
+class IOQueue;
+class RandomAccessFile;
+class SequentialFile;
+class WritableFile;
+
+class Env {
+public:
+    Env() = default;
+    Env(const Env&) = delete;
+    Env& operator=(const Env&) = delete;
+    virtual ~Env();
+
+    // 进程内共享的默认环境, 不能删除
+    static Env* Default();
+
+    // 打开只读的顺序文件, 文件不存在时返回 NotFound
+    virtual Status NewSequentialFile(const std::string& fname, SequentialFile** result) = 0;
+
+    /**
+     * @brief 打开只读的随机访问文件, 文件不存在时返回 NotFound; 返回的对象可以被多个线程同时使用
+     *  默认实现可能把整个文件映射到内存, 只适合打开后不再修改的文件
+     */
+    virtual Status NewRandomAccessFile(const std::string& fname, RandomAccessFile** result) = 0;
+
+    // 创建新文件, 已存在的同名文件会被清空
+    virtual Status NewWritableFile(const std::string& fname, WritableFile** result) = 0;
+
+    // 打开文件并在末尾追加, 文件不存在时新建
+    virtual Status NewAppendableFile(const std::string& fname, WritableFile** result) = 0;
+
+    virtual bool FileExists(const std::string& fname) = 0;
+    // 目录下所有文件名(不含路径), 覆盖 result 原有内容
+    virtual Status GetChildren(const std::string& dir, std::vector<std::string>* result) = 0;
+    // 创建目录, 已存在时返回 OK
+    virtual Status CreateDir(const std::string& dirname) = 0;
+    virtual Status RemoveFile(const std::string& fname) = 0;
+    // 把 src 改名为 target, target 已存在时被原子地替换
+    virtual Status RenameFile(const std::string& src, const std::string& target) = 0;
+    virtual Status GetFileSize(const std::string& fname, uint64_t* file_size) = 0;
+
+    /**
+     * @brief 创建异步 I/O 队列, depth 是队列中最多同时存在的请求数, 调用方负责删除
+     *  默认实现在加入请求时就同步执行
+     */
+    virtual Status NewIOQueue(int depth, IOQueue** result);
+};
+
+/**
+ * @brief 默认环境同时保持的只读文件映射数上限, 达到上限后新打开的随机访问文件改用 pread
+ *  映射的文件读取时直接返回指向映射内存的 Slice, 省去一次拷贝和一次系统调用
+ *  64 位系统默认 1000, 32 位系统地址空间有限, 默认 0(不使用 mmap); 只影响之后打开的文件
+ */
+void SetReadOnlyMmapLimit(int limit);
+
+/**
+ * @brief 默认环境的 NewIOQueue 是否尝试使用 io_uring, 默认是
+ *  关闭或内核不支持时退回同步的 pread/pwrite; 只影响之后创建的队列
+ */
+void SetUseIOUring(bool use);
+
+/**
+ * @brief 顺序读取的文件, 需要外部同步
+ */
+class SequentialFile {
+public:
+    SequentialFile() = default;
+    SequentialFile(const SequentialFile&) = delete;
+    SequentialFile& operator=(const SequentialFile&) = delete;
+    virtual ~SequentialFile();
+
+    /**
+     * @brief 最多读取 n 字节, result 可能指向 scratch[0, n-1], 因此 result 使用期间 scratch 必须有效
+     *  到达文件末尾时返回 OK 且 result 为空
+     */
+    virtual Status Read(size_t n, Slice* result, char* scratch) = 0;
+
+    // 跳过 n 字节, 不会比直接读出来更慢
+    virtual Status Skip(uint64_t n) = 0;
+};
+
+/**
+ * @brief 随机读取的文件, 多个线程可以同时调用 Read
+ */
+class RandomAccessFile {
+public:
+    RandomAccessFile() = default;
+    RandomAccessFile(const RandomAccessFile&) = delete;
+    RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+    virtual ~RandomAccessFile();
+
+    /**
+     * @brief 从 offset 开始最多读取 n 字节, result 可能指向 scratch[0, n-1], 因此 result 使用期间 scratch 必须有效
+     *  读到文件末尾时 result 比 n 短
+     */
+    virtual Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const = 0;
+};
+
+/**
+ * @brief 顺序写入的文件, 实现必须自带缓冲, 调用方会频繁地追加小段数据
+ */
+class WritableFile {
+public:
+    WritableFile() = default;
+    WritableFile(const WritableFile&) = delete;
+    WritableFile& operator=(const WritableFile&) = delete;
+    virtual ~WritableFile();
+
+    virtual Status Append(const Slice& data) = 0;
+    virtual Status Close() = 0;
+    // 把缓冲区写入操作系统
+    virtual Status Flush() = 0;
+    // 把数据持久化到磁盘, 返回之后掉电也不会丢失
+    virtual Status Sync() = 0;
+};
+
+/**
+ * @brief 异步请求的结果, 由调用方分配, 请求被 Wait 返回之前不能释放或复用
+ */
+struct IORequest {
+    Slice result;         // 读请求读到的数据, 可能指向 scratch 也可能指向文件自己的内存; 读到末尾时较短
+    Status status;
+    void* arg = nullptr;  // 调用方自用, 队列不会修改
+};
+
+/**
+ * @brief 异步 I/O 队列: 请求先加入队列, Submit 一次提交整批, 之后用 Wait 逐个取回完成的请求
+ *  一个线程用一个队列就能让很多读请求同时在途, 适合压缩和批量点查
+ *  完成的顺序不一定是加入的顺序; 队列需要外部同步, 析构前必须取回所有请求
+ */
+class IOQueue {
+public:
+    IOQueue() = default;
+    IOQueue(const IOQueue&) = delete;
+    IOQueue& operator=(const IOQueue&) = delete;
+    virtual ~IOQueue();
+
+    // 读 file 的 [offset, offset + n) 到 scratch, scratch 在请求完成前必须有效
+    virtual void AddRead(const RandomAccessFile* file, uint64_t offset, size_t n, char* scratch,
+                         IORequest* req) = 0;
+
+    /**
+     * @brief 把 data 追加到 file, data 在请求完成前必须有效
+     *  写入位置在加入时确定: 同一文件的写入按加入的顺序排列, 之后直接调用 Append 的数据接在后面
+     */
+    virtual void AddWrite(WritableFile* file, const Slice& data, IORequest* req) = 0;
+
+    // 在 file 之前加入的写请求都完成之后把 file 落盘
+    virtual void AddSync(WritableFile* file, IORequest* req) = 0;
+
+    // 提交所有已加入还没提交的请求; 队列满时 Add 也会自动提交
+    virtual void Submit() = 0;
+
+    // 先提交未提交的请求, 再等待并返回一个完成的请求; 没有未取回的请求时返回 nullptr
+    virtual IORequest* Wait() = 0;
+};
+
+}   // namespace leveldb
@@ -0,0 +1,62 @@
+/**
+ * @file filter_policy.h
+ * @author alongnice
+ * @brief 过滤策略: 为一组键生成一段小的摘要(过滤器), 点查时先问过滤器, 键一定不存在时就不必读数据块
+ *  数据库可以在打开时指定一个过滤策略, 最常用的是 NewBloomFilterPolicy
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <string>
+
+#include "slice.h"
+
+namespace leveldb {
+
+class FilterPolicy {
+public:
+    virtual ~FilterPolicy();
+
+    // 策略的名称, 会写入表文件; 过滤器的编码方式不兼容地改变时必须换一个名称
+    // 否则旧的过滤器会被错误地交给新的实现解读
+    virtual const char* Name() const = 0;
+
+    /**
+     * @brief 为 keys[0, n-1] 生成过滤器, 追加到 dst 末尾, 不能修改 dst 原有的内容
+     *  keys 按比较器有序, 可能包含重复的键
+     */
+    virtual void CreateFilter(const Slice* keys, int n, std::string* dst) const = 0;
+
+    /**
+     * @brief filter 是 CreateFilter 生成的内容
+     *  key 在生成时的键列表中则必须返回 true; 不在时应当尽量返回 false
+     */
+    virtual bool KeyMayMatch(const Slice& key, const Slice& filter) const = 0;
+};
+
+/**
+ * @brief 布隆过滤器的编码格式, 格式记录在每个过滤器的末尾, 读取时不依赖当前的设置
+ */
+enum BloomFilterFormat {
+    // 经典格式: k 个探测位分布在整个位数组上, 一次查找最多 k 次缓存未命中
+    kLegacyBloomFormat = 0,
+    // 分块格式: 一个键的所有探测位都在同一个 64 字节的缓存行内, 一次查找只有一次缓存未命中,
+    // 探测位用 SIMD 一次检查完; 代价是同样的位数下误判率略高, 且每个过滤器至少占一行并按行对齐
+    // 过滤器越大(每个过滤器覆盖的键越多)收益越明显, 只有几十个键的过滤器本来就只占一两个缓存行
+    kBlockedBloomFormat = 1,
+};
+
+/**
+ * @brief 返回布隆过滤器策略, 每个键大约占 bits_per_key 位, 10 时误判率约 1%
+ *  format 只决定新生成的过滤器的格式, 两种格式的过滤器都能读取
+ *  调用方负责删除返回的对象, 并且要等到使用它的数据库关闭之后
+ *  使用自定义比较器并且会忽略键的某些部分时, 不能直接使用这个策略, 需要包装一层先去掉被忽略的部分
+ */
+const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
+                                         BloomFilterFormat format = kLegacyBloomFormat);
+
+}   // namespace leveldb
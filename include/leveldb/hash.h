@@ -0,0 +1,21 @@
+/**
+ * @file hash.h
+ * @author alongnice
+ * @brief 内部使用的简单哈希函数, 用于布隆过滤器等, 结果会写入文件, 不能随意修改
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace leveldb {
+
+// 类似 murmur hash 的 32 位哈希
+uint32_t Hash(const char* data, size_t n, uint32_t seed);
+
+}   // namespace leveldb
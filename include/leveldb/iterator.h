@@ -0,0 +1,83 @@
+/**
+ * @file iterator.h
+ * @author alongnice
+ * @brief 迭代器接口, 按键的顺序遍历一组键值对
+ *  多个线程可以同时调用 const 方法, 非 const 方法需要外部同步
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cassert>
+
+#include "slice.h"
+#include "status.h"
+
+namespace leveldb {
+
+class Iterator {
+public:
+    Iterator();
+
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    virtual ~Iterator();
+
+    // 是否指向某个键值对
+    virtual bool Valid() const = 0;
+
+    // 定位到第一个键, 为空时 Valid() 为 false
+    virtual void SeekToFirst() = 0;
+
+    // 定位到最后一个键, 为空时 Valid() 为 false
+    virtual void SeekToLast() = 0;
+
+    // 定位到第一个 >= target 的键
+    virtual void Seek(const Slice& target) = 0;
+
+    // 以下要求 Valid()
+    virtual void Next() = 0;
+    virtual void Prev() = 0;
+
+    // 返回的数据只在迭代器下一次修改之前有效
+    virtual Slice key() const = 0;
+    virtual Slice value() const = 0;
+
+    // 出错时返回错误, 否则返回 OK
+    virtual Status status() const = 0;
+
+    /**
+     * @brief 注册一个在迭代器析构时调用的清理函数
+     *  用于迭代器引用的资源(如缓存中的块)在迭代器销毁时释放
+     */
+    using CleanupFunction = void (*)(void* arg1, void* arg2);
+    void RegisterCleanup(CleanupFunction function, void* arg1, void* arg2);
+
+private:
+    // 清理函数链表, 头节点内联在迭代器中, 绝大多数迭代器只有一个清理函数
+    struct CleanupNode {
+        bool IsEmpty() const { return function == nullptr; }
+        void Run() {
+            assert(function != nullptr);
+            (*function)(arg1, arg2);
+        }
+
+        CleanupFunction function;
+        void* arg1;
+        void* arg2;
+        CleanupNode* next;
+    };
+    CleanupNode cleanup_head_;
+};
+
+// 空迭代器
+Iterator* NewEmptyIterator();
+
+// 带错误状态的空迭代器
+Iterator* NewErrorIterator(const Status& status);
+
+}   // namespace leveldb
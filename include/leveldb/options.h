@@ -0,0 +1,89 @@
+/**
+ * @file options.h
+ * @author alongnice
+ * @brief 数据库打开和读写时的选项
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+
+namespace leveldb {
+
+class Cache;
+class Comparator;
+class Env;
+class FilterPolicy;
+
+/**
+ * @brief 打开数据库时的选项
+ */
+struct Options {
+    // 默认使用字典序比较器和 posix 环境
+    Options();
+
+    // 用户键的比较器, 同一个数据库每次打开必须使用同名的比较器
+    const Comparator* comparator;
+
+    // 所有文件操作都通过它进行
+    Env* env;
+
+    // 为 true 时恢复过程中遇到损坏的日志记录直接报错, 否则跳过损坏的数据继续打开
+    bool paranoid_checks;
+
+    // memtable 写满这么多字节后转为只读并在后台落盘成 L0 的表文件
+    // 越大写入越快、落盘的文件越少, 但占用内存更多, 重启时重放日志也更慢
+    size_t write_buffer_size;
+
+    // 表缓存最多同时打开的表文件数
+    int max_open_files;
+
+    // 非空时表读取把解析好的数据块放进这个缓存, 重复读取热点块不必再读文件
+    // 通常设为 NewLRUCache 的返回值, 可以在多个表之间共享; 调用方负责删除, 默认为空(不缓存)
+    Cache* block_cache;
+
+    // 数据块的目标大小(未压缩), 实际大小会略微超过
+    size_t block_size;
+
+    // 每隔多少个键设置一个重启点, 重启点处的键完整存储
+    // 越大前缀压缩效果越好, 但块内查找时线性扫描的键越多
+    int block_restart_interval;
+
+    // 非空时每个表文件都为数据块生成过滤器, 点查不存在的键时大多不必读数据块
+    // 通常设为 NewBloomFilterPolicy 的返回值; 调用方负责删除, 默认为空
+    const FilterPolicy* filter_policy;
+
+    // 压缩输出的单个表文件达到这个大小后切换到下一个文件
+    size_t max_file_size;
+};
+
+/**
+ * @brief 读操作的选项
+ */
+struct ReadOptions {
+    ReadOptions() = default;
+
+    // 为 true 时从文件读出的每个块都校验 crc, 发现损坏立即返回 Corruption
+    bool verify_checksums = false;
+
+    // 这次读取的数据块是否放进块缓存; 全量扫描时通常设为 false, 避免把热点块挤出去
+    bool fill_cache = true;
+};
+
+/**
+ * @brief 写操作的选项
+ */
+struct WriteOptions {
+    WriteOptions() = default;
+
+    // 为 true 时写操作返回之前日志已经落盘(fdatasync), 机器崩溃也不会丢失
+    // 为 false 时只保证进程崩溃不丢失, 机器崩溃可能丢失最近的一些写入
+    // 并发的同步写会合并成一次落盘, 见 DBImpl::Write
+    bool sync = false;
+};
+
+}   // namespace leveldb
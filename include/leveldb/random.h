@@ -9,6 +9,7 @@
  * 
  */
 
+#pragma once
 #include <cstdint>
 namespace leveldb {
 class Random{
@@ -14,9 +14,17 @@
 #pragma once
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace leveldb {
 
 class Slice {
@@ -84,6 +92,24 @@ private:
 	size_t size_;       // 数据的长度
 };
 
+/**
+ * @brief 按无符号字节序比较 a, b 的前 n 个字节, 返回值符号与 memcmp 一致
+ *  短键场景下 memcmp 的函数调用开销占比很高, 这里内联展开:
+ *  AVX2/SSE2 可用时每次比较 32/16 字节, 之后每次按大端序比较 8 字节, 最后逐字节
+ */
+inline int CompareBytes(const char* a, const char* b, size_t n);
+
+/**
+ * @brief a, b 前 n 个字节中相同前缀的长度, 供前缀压缩使用
+ */
+inline size_t SharedPrefixLength(const char* a, const char* b, size_t n);
+
+// 两个 Slice 的公共前缀长度
+inline size_t SharedPrefixLength(const Slice& a, const Slice& b) {
+    const size_t n = (a.size() < b.size()) ? a.size() : b.size();
+    return SharedPrefixLength(a.data(), b.data(), n);
+}
+
 // 对比运算符重载
 inline bool operator==(const Slice& a, const Slice& b) {
     return (a.size() == b.size() && memcmp(a.data(), b.data(), a.size()) == 0);
@@ -94,9 +120,109 @@ inline bool operator!=(const Slice& a, const Slice& b) {
     return !(a == b);
 }
 
+namespace slice_detail {
+/**
+ * @brief 在 width 个字节范围内找第一个不同字节的位置, 没有则返回 width
+ *  equal_mask 中第 i 位为 1 表示第 i 个字节相等
+ */
+inline size_t FirstMismatch(uint32_t equal_mask, size_t width) {
+    const uint32_t diff = ~equal_mask & ((width >= 32) ? 0xffffffffu : ((1u << width) - 1));
+    return diff == 0 ? width : static_cast<size_t>(__builtin_ctz(diff));
+}
+
+// 按主机字节序加载 8 字节, memcpy 会被编译成一条非对齐 load
+inline uint64_t LoadWord(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 转成大端后整数的大小关系就等于字节序
+inline uint64_t ToBigEndian(uint64_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return __builtin_bswap64(v);
+#else
+    return v;
+#endif
+}
+
+inline int ByteDiff(char a, char b) {
+    return static_cast<int>(static_cast<uint8_t>(a)) - static_cast<int>(static_cast<uint8_t>(b));
+}
+
+/**
+ * @brief 用 SIMD 跳过相同的前缀, 返回第一个可能不同的位置
+ *  剩余不足一个向量宽度的部分交给调用方处理
+ */
+inline size_t SkipEqualVectors(const char* a, const char* b, size_t n, bool* mismatch) {
+    size_t i = 0;
+    *mismatch = false;
+#if defined(__AVX2__)
+    for(; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if(mask != 0xffffffffu) {
+            *mismatch = true;
+            return i + FirstMismatch(mask, 32);
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for(; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+        if(mask != 0xffffu) {
+            *mismatch = true;
+            return i + FirstMismatch(mask, 16);
+        }
+    }
+#endif
+    (void)a;
+    (void)b;
+    (void)n;
+    return i;
+}
+}   // namespace slice_detail
+
+inline size_t SharedPrefixLength(const char* a, const char* b, size_t n) {
+    bool mismatch;
+    size_t i = slice_detail::SkipEqualVectors(a, b, n, &mismatch);
+    if(mismatch) return i;
+    for(; i + 8 <= n; i += 8) {
+        uint64_t x = slice_detail::LoadWord(a + i) ^ slice_detail::LoadWord(b + i);
+        if(x != 0) {
+            // 大端下第一个不同字节对应最高的非零位
+            return i + (__builtin_clzll(slice_detail::ToBigEndian(x)) >> 3);
+        }
+    }
+    while(i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+inline int CompareBytes(const char* a, const char* b, size_t n) {
+    bool mismatch;
+    size_t i = slice_detail::SkipEqualVectors(a, b, n, &mismatch);
+    if(mismatch) return slice_detail::ByteDiff(a[i], b[i]);
+    for(; i + 8 <= n; i += 8) {
+        uint64_t x = slice_detail::LoadWord(a + i);
+        uint64_t y = slice_detail::LoadWord(b + i);
+        if(x != y) {
+            x = slice_detail::ToBigEndian(x);
+            y = slice_detail::ToBigEndian(y);
+            return (x < y) ? -1 : +1;
+        }
+    }
+    for(; i < n; i++) {
+        if(a[i] != b[i]) return slice_detail::ByteDiff(a[i], b[i]);
+    }
+    return 0;
+}
+
 inline int Slice::compare(const Slice& b) const {
     const size_t min_size = (size_ < b.size_) ? size_ : b.size_;
-    int r = memcmp(data_, b.data_, min_size);
+    int r = CompareBytes(data_, b.data_, min_size);
     if(r == 0 && size_ < b.size_) r=-1;
     if(r == 0 && size_ > b.size_) r=1;
     return r;
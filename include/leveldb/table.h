@@ -0,0 +1,68 @@
+/**
+ * @file table.h
+ * @author alongnice
+ * @brief 不可变的有序表, 打开之后多个线程可以同时读取, 不需要外部同步
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+#include "iterator.h"
+#include "options.h"
+
+namespace leveldb {
+
+class Footer;
+class RandomAccessFile;
+
+class Table {
+public:
+    /**
+     * @brief 打开 file 中前 file_size 字节组成的表, 成功时 *table 指向新表, 调用方负责删除
+     *  file 必须在表存活期间一直有效; 表不会删除 file
+     * @return 失败时 *table 为 nullptr
+     */
+    static Status Open(const Options& options, RandomAccessFile* file, uint64_t file_size,
+                       Table** table);
+
+    Table(const Table&) = delete;
+    Table& operator=(const Table&) = delete;
+
+    ~Table();
+
+    // 遍历表中所有键值对, 返回的迭代器初始无效, 使用前需要先 Seek
+    Iterator* NewIterator(const ReadOptions& options) const;
+
+    /**
+     * @brief 估算 key 所在数据在文件中的偏移, 不在表中的键返回它应在的位置附近
+     */
+    uint64_t ApproximateOffsetOf(const Slice& key) const;
+
+    /**
+     * @brief 查找第一个 >= key 的记录, 找到时调用 handle_result(arg, 找到的键, 值)
+     *  只读取一个数据块, 不需要创建两层迭代器; 供数据库内部的点查使用
+     *  设置了过滤策略时, 过滤器判定 key 不在候选块中就直接返回, 不读数据块也不调用 handle_result
+     */
+    Status InternalGet(const ReadOptions& options, const Slice& key, void* arg,
+                       void (*handle_result)(void* arg, const Slice& k, const Slice& v));
+
+private:
+    struct Rep;
+
+    static Iterator* BlockReader(void* arg, const ReadOptions& options, const Slice& index_value);
+
+    explicit Table(Rep* rep) : rep_(rep) {}
+
+    // 读取元数据索引块, 目前只用来找过滤块
+    void ReadMeta(const Footer& footer);
+    void ReadFilter(const Slice& filter_handle_value);
+
+    Rep* const rep_;
+};
+
+}   // namespace leveldb
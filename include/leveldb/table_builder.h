@@ -0,0 +1,69 @@
+/**
+ * @file table_builder.h
+ * @author alongnice
+ * @brief 构造不可变的有序表文件, 格式见 src/table/format.h
+ *  多个线程可以同时调用 const 方法, 非 const 方法需要外部同步
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+#include "options.h"
+#include "status.h"
+
+namespace leveldb {
+
+class BlockBuilder;
+class BlockHandle;
+class WritableFile;
+
+class TableBuilder {
+public:
+    /**
+     * @brief 构造一个写入 file 的表, 调用方负责在 Finish 之后关闭文件
+     *  file 必须在 TableBuilder 存活期间一直有效
+     */
+    TableBuilder(const Options& options, WritableFile* file);
+
+    TableBuilder(const TableBuilder&) = delete;
+    TableBuilder& operator=(const TableBuilder&) = delete;
+
+    // 要求: 已经调用过 Finish 或 Abandon
+    ~TableBuilder();
+
+    // 加入一个键值对, 要求 key 按比较器大于之前加入的所有键, 且没有调用过 Finish/Abandon
+    void Add(const Slice& key, const Slice& value);
+
+    // 把缓冲的键值对作为一个数据块立即写出, 一般不需要调用, 可以用来保证相邻两次加入的键不在同一个块
+    void Flush();
+
+    // 非 OK 表示之前的写入出错
+    Status status() const;
+
+    // 写出剩余的数据块、元数据和文件尾, 之后不能再使用这个对象
+    Status Finish();
+
+    // 放弃构造, 已写出的内容保持原样由调用方处理
+    void Abandon();
+
+    // 已加入的键值对数
+    uint64_t NumEntries() const;
+
+    // 到目前为止生成的文件大小, Finish 成功之后就是最终的文件大小
+    uint64_t FileSize() const;
+
+private:
+    bool ok() const { return status().ok(); }
+    void WriteBlock(BlockBuilder* block, BlockHandle* handle);
+    void WriteRawBlock(const Slice& data, int type, BlockHandle* handle);
+
+    struct Rep;
+    Rep* rep_;
+};
+
+}   // namespace leveldb
@@ -0,0 +1,89 @@
+/**
+ * @file write_batch.h
+ * @author alongnice
+ * @brief 原子写入的一组更新, 按加入的顺序生效
+ *  多个线程可以同时调用 const 方法, 非 const 方法需要外部同步
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <string>
+
+#include "slice.h"
+#include "status.h"
+
+namespace leveldb {
+
+class WriteBatch {
+public:
+    /**
+     * @brief 遍历批次时按顺序接收每一条更新
+     */
+    class Handler {
+    public:
+        virtual ~Handler();
+        virtual void Put(const Slice& key, const Slice& value) = 0;
+        virtual void Delete(const Slice& key) = 0;
+    };
+
+    WriteBatch();
+
+    WriteBatch(const WriteBatch&) = default;
+    WriteBatch& operator=(const WriteBatch&) = default;
+
+    ~WriteBatch();
+
+    // 写入 key->value
+    void Put(const Slice& key, const Slice& value);
+
+    // 删除 key, 不存在时什么也不做
+    void Delete(const Slice& key);
+
+    // 清空所有更新
+    void Clear();
+
+    /**
+     * @brief 把 source 中的更新追加到本批次之后, 记录内容只拷贝一次
+     *  同一个批次里后面的更新覆盖前面的, 所以合并后的效果与依次写入两个批次相同
+     */
+    void Append(const WriteBatch& source);
+
+    /**
+     * @brief 按加入的顺序把每一条更新交给 handler, key/value 直接指向批次内部, 不做拷贝
+     * @return Status 批次内容损坏(如从日志中读出的数据有误)时返回 Corruption
+     */
+    Status Iterate(Handler* handler) const;
+
+    /**
+     * @brief 批次编码后的大小, 即写入日志的字节数
+     * @return size_t
+     */
+    size_t ApproximateSize() const;
+
+private:
+    friend class WriteBatchInternal;
+
+    std::string rep_;  // 格式见文件末尾
+};
+
+}   // namespace leveldb
+
+/**
+ * rep_ 的格式:
+ *  sequence : fixed64  // 第一条更新的序列号, 之后的更新依次加一
+ *  count    : fixed32  // 更新条数
+ *  data     : record[count]
+ * record :=
+ *  kTypeValue varstring varstring  |
+ *  kTypeDeletion varstring
+ * varstring :=
+ *  len  : varint32
+ *  data : uint8[len]
+ *
+ * 同一份字节既直接追加到日志, 恢复时又直接解析后插入 memtable, 中间不需要再做序列化
+ * 记录部分不依赖头部, 组提交时各批次的记录部分直接拼在新头部之后写入日志, 不需要合并拷贝
+ */
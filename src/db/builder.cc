@@ -0,0 +1,68 @@
+/**
+ * @file builder.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "builder.h"
+
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/iterator.h"
+#include "../../include/leveldb/table_builder.h"
+#include "filename.h"
+#include "table_cache.h"
+#include "version_edit.h"
+
+namespace leveldb {
+
+Status BuildTable(const std::string& dbname, Env* env, const Options& options, TableCache* table_cache,
+                  Iterator* iter, FileMetaData* meta) {
+    Status s;
+    meta->file_size = 0;
+    iter->SeekToFirst();
+
+    const std::string fname = TableFileName(dbname, meta->number);
+    if(iter->Valid()) {
+        WritableFile* file;
+        s = env->NewWritableFile(fname, &file);
+        if(!s.ok()) return s;
+
+        TableBuilder* builder = new TableBuilder(options, file);
+        meta->smallest.DecodeFrom(iter->key());
+        for(; iter->Valid(); iter->Next()) {
+            const Slice key = iter->key();
+            meta->largest.DecodeFrom(key);
+            builder->Add(key, iter->value());
+        }
+
+        s = builder->Finish();
+        if(s.ok()) {
+            meta->file_size = builder->FileSize();
+            assert(meta->file_size > 0);
+        }
+        delete builder;
+
+        if(s.ok()) s = file->Sync();
+        if(s.ok()) s = file->Close();
+        delete file;
+
+        if(s.ok()) {
+            // 确认文件可以正常打开
+            Iterator* it = table_cache->NewIterator(ReadOptions(), meta->number, meta->file_size);
+            s = it->status();
+            delete it;
+        }
+    }
+
+    if(!iter->status().ok()) s = iter->status();
+
+    if(!s.ok() || meta->file_size == 0) env->RemoveFile(fname);
+    return s;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,33 @@
+/**
+ * @file builder.h
+ * @author alongnice
+ * @brief 把一个迭代器的内容写成表文件, 用于 memtable 落盘
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <string>
+
+#include "status.h"
+
+namespace leveldb {
+
+struct FileMetaData;
+
+class Env;
+class Iterator;
+class TableCache;
+struct Options;
+
+/**
+ * @brief 把 iter 的全部内容写成编号为 meta->number 的表文件, 写完之后通过 table_cache 打开检查一遍
+ *  成功时填好 meta 的其余字段; iter 为空时不生成文件, meta->file_size 为 0
+ */
+Status BuildTable(const std::string& dbname, Env* env, const Options& options, TableCache* table_cache,
+                  Iterator* iter, FileMetaData* meta);
+
+}   // namespace leveldb
@@ -0,0 +1,879 @@
+/**
+ * @file db_impl.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "db_impl.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/table_builder.h"
+#include "builder.h"
+#include "filename.h"
+#include "memtable.h"
+#include "table_cache.h"
+#include "version_set.h"
+#include "write_batch_internal.h"
+
+namespace leveldb {
+
+/**
+ * @brief 写者队列中的一项, 位于写线程的栈上
+ */
+struct DBImpl::Writer {
+    Writer(WriteBatch* b, bool s) : batch(b), sync(s), done(false), insert(false) {}
+
+    WriteBatch* batch;
+    bool sync;
+    bool done;    // 组长已经完成了整组写入, status 为结果
+    bool insert;  // 日志已写好, 由写者自己把 batch 插入 memtable
+    Status status;
+    std::condition_variable cv;
+};
+
+// 手动压缩的请求, 位于发起线程的栈上
+struct DBImpl::ManualCompaction {
+    int level;
+    bool done;
+    const InternalKey* begin;  // 为空表示从最小的键开始
+    const InternalKey* end;    // 为空表示到最大的键为止
+    InternalKey tmp_storage;   // 记录压缩进行到的位置
+};
+
+// 一次压缩的进行状态
+struct DBImpl::CompactionState {
+    // 一个输出文件
+    struct Output {
+        uint64_t number;
+        uint64_t file_size;
+        InternalKey smallest, largest;
+    };
+
+    explicit CompactionState(Compaction* c)
+        : compaction(c), smallest_snapshot(0), outfile(nullptr), builder(nullptr), total_bytes(0) {}
+
+    Output* current_output() { return &outputs[outputs.size() - 1]; }
+
+    Compaction* const compaction;
+
+    // 序列号不超过它的记录只需要保留每个用户键的最新版本
+    SequenceNumber smallest_snapshot;
+
+    std::vector<Output> outputs;
+
+    // 正在生成的输出文件
+    WritableFile* outfile;
+    TableBuilder* builder;
+
+    uint64_t total_bytes;
+};
+
+DBImpl::DBImpl(const Options& options, const std::string& dbname)
+    : internal_comparator_(options.comparator), internal_filter_policy_(options.filter_policy),
+      options_(options), table_options_(options), dbname_(dbname),
+      table_cache_(new TableCache(dbname, table_options_, options.max_open_files)), shutting_down_(false),
+      mem_(nullptr), imm_(nullptr), has_imm_(false), logfile_(nullptr), logfile_number_(0), log_(nullptr),
+      last_sequence_(0), pending_inserts_(0),
+      versions_(new VersionSet(dbname, &table_options_, table_cache_, &internal_comparator_)),
+      background_compaction_scheduled_(false), manual_compaction_(nullptr) {
+    static_assert(sizeof(group_header_) == WriteBatchInternal::kHeaderSize, "");
+    table_options_.comparator = &internal_comparator_;
+    table_options_.filter_policy = (options.filter_policy != nullptr ? &internal_filter_policy_ : nullptr);
+}
+
+DBImpl::~DBImpl() {
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        shutting_down_.store(true, std::memory_order_release);
+        background_work_cv_.notify_one();
+    }
+    // 后台线程发现关闭标志后放弃正在进行的压缩, 等它退出
+    if(background_thread_.joinable()) background_thread_.join();
+
+    std::lock_guard<std::mutex> l(mutex_);
+    assert(writers_.empty());
+    delete versions_;
+    delete log_;
+    if(logfile_ != nullptr) logfile_->Close();
+    delete logfile_;
+    if(mem_ != nullptr) mem_->Unref();
+    if(imm_ != nullptr) imm_->Unref();
+    delete table_cache_;
+}
+
+Status DBImpl::NewDB() {
+    VersionEdit new_db;
+    new_db.SetComparatorName(options_.comparator->Name());
+    new_db.SetLogNumber(0);
+    new_db.SetNextFile(2);
+    new_db.SetLastSequence(0);
+
+    const std::string manifest = DescriptorFileName(dbname_, 1);
+    WritableFile* file;
+    Status s = options_.env->NewWritableFile(manifest, &file);
+    if(!s.ok()) return s;
+    {
+        log::Writer log(file);
+        std::string record;
+        new_db.EncodeTo(&record);
+        s = log.AddRecord(record);
+        if(s.ok()) s = file->Sync();
+        if(s.ok()) s = file->Close();
+    }
+    delete file;
+    if(s.ok()) {
+        s = SetCurrentFile(options_.env, dbname_, 1);
+    } else {
+        options_.env->RemoveFile(manifest);
+    }
+    return s;
+}
+
+Status DBImpl::Open() {
+    std::unique_lock<std::mutex> l(mutex_);
+    Status s = options_.env->CreateDir(dbname_);
+    if(!s.ok()) return s;
+
+    if(!options_.env->FileExists(CurrentFileName(dbname_))) {
+        s = NewDB();
+        if(!s.ok()) return s;
+    }
+
+    mem_ = new MemTable(internal_comparator_);
+    mem_->Ref();
+    s = Recover();
+    if(!s.ok()) return s;
+
+    logfile_number_ = versions_->NewFileNumber();
+    s = options_.env->NewWritableFile(LogFileName(dbname_, logfile_number_), &logfile_);
+    if(!s.ok()) return s;
+    log_ = new log::Writer(logfile_);
+
+    // 写出新的描述文件; 重放的数据还在 memtable 里, 日志编号保持不变, 旧日志继续保留
+    VersionEdit edit;
+    versions_->SetLastSequence(last_sequence_);
+    s = versions_->LogAndApply(&edit, &mutex_);
+    if(!s.ok()) return s;
+
+    DeleteObsoleteFiles();
+    background_thread_ = std::thread(&DBImpl::BackgroundThreadMain, this);
+    MaybeScheduleCompaction();
+    return s;
+}
+
+Status DBImpl::Recover() {
+    Status s = versions_->Recover();
+    if(!s.ok()) return s;
+
+    std::vector<std::string> filenames;
+    s = options_.env->GetChildren(dbname_, &filenames);
+    if(!s.ok()) return s;
+    std::set<uint64_t> expected;
+    versions_->AddLiveFiles(&expected);
+    const uint64_t min_log = versions_->LogNumber();
+    std::vector<uint64_t> logs;
+    uint64_t number;
+    FileType type;
+    for(size_t i = 0; i < filenames.size(); i++) {
+        if(ParseFileName(filenames[i], &number, &type)) {
+            expected.erase(number);
+            if(type == kLogFile && number >= min_log) logs.push_back(number);
+        }
+    }
+    if(!expected.empty()) {
+        return Status::Corruption(std::to_string(expected.size()) + " missing files, e.g.",
+                                  TableFileName(dbname_, *expected.begin()));
+    }
+
+    // 必须按日志产生的顺序重放
+    std::sort(logs.begin(), logs.end());
+    for(size_t i = 0; i < logs.size(); i++) {
+        s = ReplayLogFile(options_.env, LogFileName(dbname_, logs[i]), mem_, true,
+                          options_.paranoid_checks, &recovery_stats_);
+        if(!s.ok()) return s;
+        // 描述文件中记录的下一个编号可能比这个日志还旧(日志是在写描述文件期间创建的)
+        versions_->MarkFileNumberUsed(logs[i]);
+    }
+    last_sequence_ = std::max(versions_->LastSequence(), recovery_stats_.max_sequence);
+    return s;
+}
+
+Status DBImpl::Put(const WriteOptions& options, const Slice& key, const Slice& value) {
+    WriteBatch batch;
+    batch.Put(key, value);
+    return Write(options, &batch);
+}
+
+Status DBImpl::Delete(const WriteOptions& options, const Slice& key) {
+    WriteBatch batch;
+    batch.Delete(key);
+    return Write(options, &batch);
+}
+
+Status DBImpl::Write(const WriteOptions& options, WriteBatch* updates) {
+    Writer w(updates, options.sync);
+    std::unique_lock<std::mutex> l(mutex_);
+    writers_.push_back(&w);
+    while(!w.done && !w.insert && &w != writers_.front()) w.cv.wait(l);
+
+    if(w.insert) {
+        // 组长已经写好日志并分配了序列号, 插入和其他组员并发进行
+        l.unlock();
+        Status s = WriteBatchInternal::InsertInto(w.batch, mem_, true);
+        l.lock();
+        w.insert = false;
+        w.status = s;
+        if(--pending_inserts_ == 0) writers_.front()->cv.notify_one();
+        while(!w.done) w.cv.wait(l);
+    }
+    if(w.done) return w.status;
+
+    // 当前写者是组长
+    Status status = MakeRoomForWrite(l, false);
+    Writer* last_writer = &w;
+    if(status.ok()) {
+        const int count = BuildBatchGroup(&last_writer);
+        const SequenceNumber first_sequence = last_sequence_ + 1;
+        WriteBatchInternal::EncodeHeader(group_header_, first_sequence, count);
+        group_parts_[0] = Slice(group_header_, sizeof(group_header_));
+
+        // 日志 I/O 期间放开锁, 新来的写者在队列中排队, 组成下一组
+        {
+            l.unlock();
+            status = log_->AddRecord(group_parts_.data(), group_parts_.size());
+            if(status.ok() && w.sync) status = logfile_->Sync();
+            l.lock();
+        }
+
+        if(status.ok()) {
+            // 按队列顺序给每个批次分配序列号, 与合并后的日志记录一致
+            SequenceNumber seq = first_sequence;
+            int followers = 0;
+            for(std::deque<Writer*>::iterator it = writers_.begin();; ++it) {
+                Writer* member = *it;
+                WriteBatchInternal::SetSequence(member->batch, seq);
+                seq += WriteBatchInternal::Count(member->batch);
+                if(member != &w) {
+                    member->insert = true;
+                    followers++;
+                }
+                if(member == last_writer) break;
+            }
+
+            if(followers == 0) {
+                l.unlock();
+                status = WriteBatchInternal::InsertInto(w.batch, mem_, false);
+                l.lock();
+            } else {
+                pending_inserts_ = followers;
+                for(std::deque<Writer*>::iterator it = writers_.begin() + 1;; ++it) {
+                    (*it)->cv.notify_one();
+                    if(*it == last_writer) break;
+                }
+                l.unlock();
+                status = WriteBatchInternal::InsertInto(w.batch, mem_, true);
+                l.lock();
+                while(pending_inserts_ > 0) w.cv.wait(l);
+            }
+            // 整组插入完成后才发布序列号, 读者看不到半组写入
+            last_sequence_ = seq - 1;
+        } else {
+            bg_error_ = status;
+        }
+    }
+
+    while(true) {
+        Writer* ready = writers_.front();
+        writers_.pop_front();
+        if(ready != &w) {
+            // 组员插入 memtable 的错误优先于整组的状态
+            if(ready->status.ok()) ready->status = status;
+            ready->done = true;
+            ready->cv.notify_one();
+        }
+        if(ready == last_writer) break;
+    }
+
+    // 唤醒下一组的组长
+    if(!writers_.empty()) writers_.front()->cv.notify_one();
+    return status;
+}
+
+int DBImpl::BuildBatchGroup(Writer** last_writer) {
+    assert(!writers_.empty());
+    Writer* first = writers_.front();
+    assert(first->batch != nullptr);
+
+    size_t size = WriteBatchInternal::ByteSize(first->batch);
+    int count = WriteBatchInternal::Count(first->batch);
+    group_parts_.resize(1);  // 第 0 段留给头部
+    group_parts_.push_back(WriteBatchInternal::Records(first->batch));
+
+    // 组的大小有上限, 组长的批次很小时上限也更小, 避免拖慢小写入
+    size_t max_size = 1 << 20;
+    if(size <= (128 << 10)) max_size = size + (128 << 10);
+
+    *last_writer = first;
+    std::deque<Writer*>::iterator iter = writers_.begin();
+    ++iter;  // 跳过组长
+    for(; iter != writers_.end(); ++iter) {
+        Writer* w = *iter;
+        // FlushMemTable 的占位写者不带批次, 不合并
+        if(w->batch == nullptr) break;
+
+        // 非同步写的组长不合并同步写
+        if(w->sync && !first->sync) break;
+
+        size += WriteBatchInternal::ByteSize(w->batch);
+        if(size > max_size) break;
+
+        count += WriteBatchInternal::Count(w->batch);
+        group_parts_.push_back(WriteBatchInternal::Records(w->batch));
+        *last_writer = w;
+    }
+    return count;
+}
+
+Status DBImpl::MakeRoomForWrite(std::unique_lock<std::mutex>& l, bool force) {
+    bool allow_delay = !force;
+    Status s;
+    while(true) {
+        if(!bg_error_.ok()) {
+            s = bg_error_;
+            break;
+        } else if(allow_delay && versions_->NumLevelFiles(0) >= config::kL0_SlowdownWritesTrigger) {
+            // L0 快要满了, 每次写入让出 1ms 给后台压缩, 把一次长时间的停顿分摊成许多次短的延迟
+            // 每次写入最多延迟一次
+            l.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            allow_delay = false;
+            l.lock();
+        } else if(!force && mem_->ApproximateMemoryUsage() <= options_.write_buffer_size) {
+            // 当前 memtable 还有空间
+            break;
+        } else if(imm_ != nullptr) {
+            // 上一个 memtable 还没有落盘完
+            background_work_finished_signal_.wait(l);
+        } else if(versions_->NumLevelFiles(0) >= config::kL0_StopWritesTrigger) {
+            // L0 的文件太多
+            background_work_finished_signal_.wait(l);
+        } else {
+            // 换一个新的 memtable 和日志, 旧的交给后台线程落盘
+            const uint64_t new_log_number = versions_->NewFileNumber();
+            WritableFile* lfile = nullptr;
+            s = options_.env->NewWritableFile(LogFileName(dbname_, new_log_number), &lfile);
+            if(!s.ok()) {
+                versions_->ReuseFileNumber(new_log_number);
+                break;
+            }
+            delete log_;
+            s = logfile_->Close();
+            if(!s.ok()) {
+                // 旧日志中可能有写入没有保存下来, 不能再继续写
+                RecordBackgroundError(s);
+            }
+            delete logfile_;
+
+            logfile_ = lfile;
+            logfile_number_ = new_log_number;
+            log_ = new log::Writer(lfile);
+            imm_ = mem_;
+            has_imm_.store(true, std::memory_order_release);
+            mem_ = new MemTable(internal_comparator_);
+            mem_->Ref();
+            force = false;  // 已经腾出空间
+            MaybeScheduleCompaction();
+        }
+    }
+    return s;
+}
+
+Status DBImpl::Get(const Slice& key, std::string* value) {
+    MemTable* mem;
+    MemTable* imm;
+    Version* current;
+    SequenceNumber snapshot;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        mem = mem_;
+        imm = imm_;
+        current = versions_->current();
+        mem->Ref();
+        if(imm != nullptr) imm->Ref();
+        current->Ref();
+        snapshot = last_sequence_;
+    }
+
+    // 从新到旧: memtable, 正在落盘的 memtable, 各层的表文件
+    bool have_stat_update = false;
+    Version::GetStats stats;
+    Status s;
+    LookupKey lkey(key, snapshot);
+    if(mem->Get(lkey, value, &s)) {
+        // 找到
+    } else if(imm != nullptr && imm->Get(lkey, value, &s)) {
+        // 找到
+    } else {
+        s = current->Get(ReadOptions(), lkey, value, &stats);
+        have_stat_update = true;
+    }
+
+    std::lock_guard<std::mutex> l(mutex_);
+    if(have_stat_update && current->UpdateStats(stats)) MaybeScheduleCompaction();
+    mem->Unref();
+    if(imm != nullptr) imm->Unref();
+    current->Unref();
+    return s;
+}
+
+void DBImpl::MaybeScheduleCompaction() {
+    if(background_compaction_scheduled_) {
+        // 已经安排过了
+    } else if(shutting_down_.load(std::memory_order_acquire)) {
+        // 正在关闭, 不再安排新的工作
+    } else if(!bg_error_.ok()) {
+        // 出错之后不再改动磁盘上的状态
+    } else if(imm_ == nullptr && manual_compaction_ == nullptr && !versions_->NeedsCompaction()) {
+        // 没有工作
+    } else {
+        background_compaction_scheduled_ = true;
+        background_work_cv_.notify_one();
+    }
+}
+
+void DBImpl::BackgroundThreadMain() {
+    std::unique_lock<std::mutex> l(mutex_);
+    while(true) {
+        while(!background_compaction_scheduled_ && !shutting_down_.load(std::memory_order_acquire)) {
+            background_work_cv_.wait(l);
+        }
+        if(shutting_down_.load(std::memory_order_acquire)) break;
+
+        // 压缩期间会放开锁
+        BackgroundCompaction();
+        background_compaction_scheduled_ = false;
+
+        // 上一轮可能让某一层超标, 需要的话接着压缩
+        MaybeScheduleCompaction();
+        background_work_finished_signal_.notify_all();
+    }
+    background_compaction_scheduled_ = false;
+    background_work_finished_signal_.notify_all();
+}
+
+void DBImpl::RecordBackgroundError(const Status& s) {
+    if(bg_error_.ok()) {
+        bg_error_ = s;
+        background_work_finished_signal_.notify_all();
+    }
+}
+
+void DBImpl::BackgroundCompaction() {
+    if(imm_ != nullptr) {
+        CompactMemTable();
+        return;
+    }
+
+    Compaction* c;
+    ManualCompaction* m = manual_compaction_;
+    InternalKey manual_end;
+    if(m != nullptr) {
+        c = versions_->CompactRange(m->level, m->begin, m->end);
+        m->done = (c == nullptr);
+        if(c != nullptr) manual_end = c->input(0, c->num_input_files(0) - 1)->largest;
+    } else {
+        c = versions_->PickCompaction();
+    }
+
+    Status status;
+    if(c == nullptr) {
+        // 没有要做的
+    } else if(m == nullptr && c->IsTrivialMove()) {
+        // 直接把文件移到下一层, 不读也不写数据
+        FileMetaData* f = c->input(0, 0);
+        c->edit()->RemoveFile(c->level(), f->number);
+        c->edit()->AddFile(c->level() + 1, f->number, f->file_size, f->smallest, f->largest);
+        versions_->SetLastSequence(last_sequence_);
+        status = versions_->LogAndApply(c->edit(), &mutex_);
+        if(!status.ok()) RecordBackgroundError(status);
+    } else {
+        CompactionState* compact = new CompactionState(c);
+        status = DoCompactionWork(compact);
+        if(!status.ok()) RecordBackgroundError(status);
+        CleanupCompaction(compact);
+        c->ReleaseInputs();
+        DeleteObsoleteFiles();
+    }
+    delete c;
+
+    if(m != nullptr && manual_compaction_ == m) {
+        if(!status.ok()) m->done = true;
+        if(!m->done) {
+            // 只压缩了范围的一部分, 下一轮从这里继续
+            m->tmp_storage = manual_end;
+            m->begin = &m->tmp_storage;
+        }
+        manual_compaction_ = nullptr;
+    }
+}
+
+void DBImpl::CompactMemTable(bool level0_only) {
+    assert(imm_ != nullptr);
+
+    VersionEdit edit;
+    Version* base = versions_->current();
+    base->Ref();
+    Status s = WriteLevel0Table(imm_, &edit, level0_only ? nullptr : base);
+    base->Unref();
+
+    if(s.ok() && shutting_down_.load(std::memory_order_acquire)) {
+        s = Status::IOError("Deleting DB during memtable compaction");
+    }
+
+    if(s.ok()) {
+        // imm_ 之前的日志中的数据都已经在表文件里了
+        edit.SetLogNumber(logfile_number_);
+        versions_->SetLastSequence(last_sequence_);
+        s = versions_->LogAndApply(&edit, &mutex_);
+    }
+
+    if(s.ok()) {
+        imm_->Unref();
+        imm_ = nullptr;
+        has_imm_.store(false, std::memory_order_release);
+        DeleteObsoleteFiles();
+    } else {
+        RecordBackgroundError(s);
+    }
+}
+
+Status DBImpl::WriteLevel0Table(MemTable* mem, VersionEdit* edit, Version* base) {
+    FileMetaData meta;
+    meta.number = versions_->NewFileNumber();
+    pending_outputs_.insert(meta.number);
+    Iterator* iter = mem->NewIterator();
+    Status s;
+    {
+        mutex_.unlock();
+        s = BuildTable(dbname_, options_.env, table_options_, table_cache_, iter, &meta);
+        mutex_.lock();
+    }
+    delete iter;
+    pending_outputs_.erase(meta.number);
+
+    // file_size 为 0 表示 memtable 是空的, 不生成文件
+    int level = 0;
+    if(s.ok() && meta.file_size > 0) {
+        const Slice min_user_key = meta.smallest.user_key();
+        const Slice max_user_key = meta.largest.user_key();
+        if(base != nullptr) level = base->PickLevelForMemTableOutput(min_user_key, max_user_key);
+        edit->AddFile(level, meta.number, meta.file_size, meta.smallest, meta.largest);
+    }
+    return s;
+}
+
+Status DBImpl::OpenCompactionOutputFile(CompactionState* compact) {
+    assert(compact != nullptr);
+    assert(compact->builder == nullptr);
+    uint64_t file_number;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        file_number = versions_->NewFileNumber();
+        pending_outputs_.insert(file_number);
+        CompactionState::Output out;
+        out.number = file_number;
+        out.file_size = 0;
+        compact->outputs.push_back(out);
+    }
+
+    const std::string fname = TableFileName(dbname_, file_number);
+    Status s = options_.env->NewWritableFile(fname, &compact->outfile);
+    if(s.ok()) compact->builder = new TableBuilder(table_options_, compact->outfile);
+    return s;
+}
+
+Status DBImpl::FinishCompactionOutputFile(CompactionState* compact, Iterator* input) {
+    assert(compact != nullptr);
+    assert(compact->outfile != nullptr);
+    assert(compact->builder != nullptr);
+
+    const uint64_t output_number = compact->current_output()->number;
+    assert(output_number != 0);
+
+    Status s = input->status();
+    const uint64_t current_entries = compact->builder->NumEntries();
+    if(s.ok()) {
+        s = compact->builder->Finish();
+    } else {
+        compact->builder->Abandon();
+    }
+    const uint64_t current_bytes = compact->builder->FileSize();
+    compact->current_output()->file_size = current_bytes;
+    compact->total_bytes += current_bytes;
+    delete compact->builder;
+    compact->builder = nullptr;
+
+    if(s.ok()) s = compact->outfile->Sync();
+    if(s.ok()) s = compact->outfile->Close();
+    delete compact->outfile;
+    compact->outfile = nullptr;
+
+    if(s.ok() && current_entries > 0) {
+        // 确认文件可以正常打开
+        Iterator* iter = table_cache_->NewIterator(ReadOptions(), output_number, current_bytes);
+        s = iter->status();
+        delete iter;
+    }
+    return s;
+}
+
+Status DBImpl::InstallCompactionResults(CompactionState* compact) {
+    // 输入文件换成输出文件
+    compact->compaction->AddInputDeletions(compact->compaction->edit());
+    const int level = compact->compaction->level();
+    for(size_t i = 0; i < compact->outputs.size(); i++) {
+        const CompactionState::Output& out = compact->outputs[i];
+        compact->compaction->edit()->AddFile(level + 1, out.number, out.file_size, out.smallest, out.largest);
+    }
+    versions_->SetLastSequence(last_sequence_);
+    return versions_->LogAndApply(compact->compaction->edit(), &mutex_);
+}
+
+void DBImpl::CleanupCompaction(CompactionState* compact) {
+    if(compact->builder != nullptr) {
+        // 出错时可能留下没写完的文件
+        compact->builder->Abandon();
+        delete compact->builder;
+    } else {
+        assert(compact->outfile == nullptr);
+    }
+    delete compact->outfile;
+    for(size_t i = 0; i < compact->outputs.size(); i++) pending_outputs_.erase(compact->outputs[i].number);
+    delete compact;
+}
+
+Status DBImpl::DoCompactionWork(CompactionState* compact) {
+    assert(versions_->NumLevelFiles(compact->compaction->level()) > 0);
+    assert(compact->builder == nullptr);
+    assert(compact->outfile == nullptr);
+
+    // 没有快照, 所有记录都只需要保留最新的版本
+    compact->smallest_snapshot = last_sequence_;
+
+    Iterator* input = versions_->MakeInputIterator(compact->compaction);
+
+    // 归并和写文件期间放开锁
+    mutex_.unlock();
+
+    input->SeekToFirst();
+    Status status;
+    ParsedInternalKey ikey;
+    std::string current_user_key;
+    bool has_current_user_key = false;
+    SequenceNumber last_sequence_for_key = kMaxSequenceNumber;
+    const Comparator* ucmp = internal_comparator_.user_comparator();
+    while(input->Valid() && !shutting_down_.load(std::memory_order_acquire)) {
+        // memtable 落盘优先, 否则写者要一直等到这次压缩结束
+        if(has_imm_.load(std::memory_order_relaxed)) {
+            mutex_.lock();
+            if(imm_ != nullptr) {
+                // 正在进行的压缩会往下一层写出新文件, 落盘的文件只能放在 L0, 避免与之重叠
+                CompactMemTable(true);
+                background_work_finished_signal_.notify_all();
+            }
+            mutex_.unlock();
+        }
+
+        const Slice key = input->key();
+        bool drop = false;
+        if(!ParseInternalKey(key, &ikey)) {
+            // 损坏的键原样保留, 也不参与下面的去重
+            current_user_key.clear();
+            has_current_user_key = false;
+            last_sequence_for_key = kMaxSequenceNumber;
+        } else {
+            if(!has_current_user_key || ucmp->Compare(ikey.user_key, Slice(current_user_key)) != 0) {
+                // 一个新的用户键; 只在用户键的边界切换输出文件, 同一个键的所有版本都在一个文件里,
+                // 这样 L0 之外的层里一个用户键只会出现在一个文件中
+                const bool stop = compact->compaction->ShouldStopBefore(key);
+                if(compact->builder != nullptr &&
+                   (stop || compact->builder->FileSize() >= compact->compaction->MaxOutputFileSize())) {
+                    status = FinishCompactionOutputFile(compact, input);
+                    if(!status.ok()) break;
+                }
+                current_user_key.assign(ikey.user_key.data(), ikey.user_key.size());
+                has_current_user_key = true;
+                last_sequence_for_key = kMaxSequenceNumber;
+            }
+
+            if(last_sequence_for_key <= compact->smallest_snapshot) {
+                // 已经输出过这个键更新的版本, 这个版本被覆盖了
+                drop = true;
+            } else if(ikey.type == kTypeDeletion && ikey.sequence <= compact->smallest_snapshot &&
+                      compact->compaction->IsBaseLevelForKey(ikey.user_key)) {
+                // 更深的层没有这个键, 更旧的版本也会在这次压缩中丢弃, 删除标记本身不再需要
+                drop = true;
+            }
+
+            last_sequence_for_key = ikey.sequence;
+        }
+
+        if(!drop) {
+            if(compact->builder == nullptr) {
+                status = OpenCompactionOutputFile(compact);
+                if(!status.ok()) break;
+            }
+            if(compact->builder->NumEntries() == 0) compact->current_output()->smallest.DecodeFrom(key);
+            compact->current_output()->largest.DecodeFrom(key);
+            compact->builder->Add(key, input->value());
+        }
+
+        input->Next();
+    }
+
+    if(status.ok() && shutting_down_.load(std::memory_order_acquire)) {
+        status = Status::IOError("Deleting DB during compaction");
+    }
+    if(status.ok() && compact->builder != nullptr) status = FinishCompactionOutputFile(compact, input);
+    if(status.ok()) status = input->status();
+    delete input;
+    input = nullptr;
+
+    mutex_.lock();
+    if(status.ok()) status = InstallCompactionResults(compact);
+    return status;
+}
+
+void DBImpl::DeleteObsoleteFiles() {
+    // 出错之后不确定新版本有没有生效, 不删任何文件
+    if(!bg_error_.ok()) return;
+
+    // 存活的文件: 某个版本引用的, 或者正在生成的
+    std::set<uint64_t> live = pending_outputs_;
+    versions_->AddLiveFiles(&live);
+
+    std::vector<std::string> filenames;
+    options_.env->GetChildren(dbname_, &filenames);
+    uint64_t number;
+    FileType type;
+    std::vector<std::string> files_to_delete;
+    for(size_t i = 0; i < filenames.size(); i++) {
+        if(!ParseFileName(filenames[i], &number, &type)) continue;
+        bool keep = true;
+        switch(type) {
+            case kLogFile:
+                keep = (number >= versions_->LogNumber());
+                break;
+            case kDescriptorFile:
+                // 保留当前的描述文件
+                keep = (number >= versions_->ManifestFileNumber());
+                break;
+            case kTableFile:
+                keep = (live.find(number) != live.end());
+                break;
+            case kTempFile:
+                // 正在写入的临时文件一定在 live 中
+                keep = (live.find(number) != live.end());
+                break;
+            case kCurrentFile:
+                keep = true;
+                break;
+        }
+
+        if(!keep) {
+            files_to_delete.push_back(filenames[i]);
+            if(type == kTableFile) table_cache_->Evict(number);
+        }
+    }
+
+    // 删除文件期间放开锁, 这些文件已经没有任何人引用
+    mutex_.unlock();
+    for(size_t i = 0; i < files_to_delete.size(); i++) options_.env->RemoveFile(dbname_ + "/" + files_to_delete[i]);
+    mutex_.lock();
+}
+
+Status DBImpl::FlushMemTable() {
+    std::unique_lock<std::mutex> l(mutex_);
+    // 排进写者队列, 轮到时不会有写者在并发插入 memtable
+    Writer w(nullptr, false);
+    writers_.push_back(&w);
+    while(&w != writers_.front()) w.cv.wait(l);
+    Status s = MakeRoomForWrite(l, true);
+    writers_.pop_front();
+    if(!writers_.empty()) writers_.front()->cv.notify_one();
+
+    // 等后台线程把它落盘
+    while(s.ok() && imm_ != nullptr && bg_error_.ok()) background_work_finished_signal_.wait(l);
+    if(s.ok() && imm_ != nullptr) s = bg_error_;
+    return s;
+}
+
+void DBImpl::ManualCompactLevel(int level, const Slice* begin, const Slice* end) {
+    assert(level >= 0);
+    assert(level + 1 < config::kNumLevels);
+
+    InternalKey begin_storage, end_storage;
+    ManualCompaction manual;
+    manual.level = level;
+    manual.done = false;
+    if(begin == nullptr) {
+        manual.begin = nullptr;
+    } else {
+        begin_storage = InternalKey(*begin, kMaxSequenceNumber, kValueTypeForSeek);
+        manual.begin = &begin_storage;
+    }
+    if(end == nullptr) {
+        manual.end = nullptr;
+    } else {
+        end_storage = InternalKey(*end, 0, static_cast<ValueType>(0));
+        manual.end = &end_storage;
+    }
+
+    std::unique_lock<std::mutex> l(mutex_);
+    while(!manual.done && !shutting_down_.load(std::memory_order_acquire) && bg_error_.ok()) {
+        if(manual_compaction_ == nullptr) {
+            // 后台线程每轮压缩一部分, 完成后清空 manual_compaction_
+            manual_compaction_ = &manual;
+            MaybeScheduleCompaction();
+        } else {
+            background_work_finished_signal_.wait(l);
+        }
+    }
+    // 出错退出时后台线程可能还在使用 manual, 等它这一轮结束
+    while(manual_compaction_ == &manual && background_compaction_scheduled_) background_work_finished_signal_.wait(l);
+    if(manual_compaction_ == &manual) manual_compaction_ = nullptr;
+}
+
+void DBImpl::CompactRange(const Slice* begin, const Slice* end) {
+    int max_level_with_files = 1;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        Version* base = versions_->current();
+        for(int level = 1; level < config::kNumLevels; level++) {
+            if(base->OverlapInLevel(level, begin, end)) max_level_with_files = level;
+        }
+    }
+    FlushMemTable();
+    for(int level = 0; level < max_level_with_files; level++) ManualCompactLevel(level, begin, end);
+}
+
+int DBImpl::NumLevelFiles(int level) {
+    std::lock_guard<std::mutex> l(mutex_);
+    return versions_->NumLevelFiles(level);
+}
+
+std::string DBImpl::LevelSummary() {
+    std::lock_guard<std::mutex> l(mutex_);
+    VersionSet::LevelSummaryStorage tmp;
+    return versions_->LevelSummary(&tmp);
+}
+
+}   // namespace leveldb
@@ -0,0 +1,216 @@
+/**
+ * @file db_impl.h
+ * @author alongnice
+ * @brief 数据库实现: 写入先追加到预写日志, 再插入 memtable
+ *  并发的写入经过写者队列合并, 一组写入只追加一次日志、只落盘一次
+ *  写满的 memtable 由后台线程落盘成 L0 的表文件, 同一个线程再把各层的文件逐层压缩下去
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dbformat.h"
+#include "log_replay.h"
+#include "log_writer.h"
+#include "options.h"
+#include "status.h"
+#include "write_batch.h"
+
+namespace leveldb {
+
+class Iterator;
+class MemTable;
+class TableCache;
+class Version;
+class VersionEdit;
+class VersionSet;
+class WritableFile;
+
+class DBImpl {
+public:
+    DBImpl(const Options& options, const std::string& dbname);
+
+    DBImpl(const DBImpl&) = delete;
+    DBImpl& operator=(const DBImpl&) = delete;
+
+    ~DBImpl();
+
+    /**
+     * @brief 创建数据库目录, 从描述文件恢复各层的文件, 按编号顺序重放还没有落盘的日志, 再创建新的日志文件
+     *  重放的数据还只在 memtable 里, 所以旧日志保留不删, 等这个 memtable 落盘之后再删除
+     */
+    Status Open();
+
+    // Open 时重放日志的统计
+    const LogReplayStats& recovery_stats() const { return recovery_stats_; }
+
+    Status Put(const WriteOptions& options, const Slice& key, const Slice& value);
+    Status Delete(const WriteOptions& options, const Slice& key);
+
+    /**
+     * @brief 原子地写入一个批次, 可以被多个线程同时调用
+     * @param updates 写入期间不能被修改; 会被设置上分配到的序列号
+     */
+    Status Write(const WriteOptions& options, WriteBatch* updates);
+
+    /**
+     * @brief 读取最新的值
+     * @return Status 找不到或已删除时返回 NotFound
+     */
+    Status Get(const Slice& key, std::string* value);
+
+    /**
+     * @brief 把 memtable 落盘, 再把与用户键范围 [*begin, *end] 重叠的数据逐层压缩到最底下有数据的一层
+     *  begin 为空表示从最小的键开始, end 为空表示到最大的键为止; 完成后才返回
+     */
+    void CompactRange(const Slice* begin, const Slice* end);
+
+    // 把当前的 memtable 落盘成表文件, 等落盘完成后返回
+    Status FlushMemTable();
+
+    // level 层当前的文件数
+    int NumLevelFiles(int level);
+
+    // 各层文件数的摘要, 形如 "files[ 0 1 2 0 0 0 0 ]"
+    std::string LevelSummary();
+
+private:
+    struct CompactionState;
+    struct ManualCompaction;
+    struct Writer;
+
+    // 新建一个空数据库: 写出第一个描述文件并让 CURRENT 指向它
+    Status NewDB();
+
+    // 从描述文件恢复, 再按编号顺序重放还没有落盘的日志
+    Status Recover();
+
+    /**
+     * @brief 保证 memtable 有空间写入, 由组长在合并批次之前调用
+     *  memtable 写满时换成新的 memtable 和日志, 旧的交给后台线程落盘; L0 文件过多时延迟或暂停写入
+     * @param force 为 true 时即使 memtable 没有写满也切换
+     */
+    Status MakeRoomForWrite(std::unique_lock<std::mutex>& l, bool force);
+
+    // 后台线程的主循环
+    void BackgroundThreadMain();
+    // 有需要时唤醒后台线程
+    void MaybeScheduleCompaction();
+    void BackgroundCompaction();
+    void RecordBackgroundError(const Status& s);
+
+    /**
+     * @brief 把 imm_ 落盘, 成功后删除它对应的旧日志
+     * @param level0_only 为 true 时文件固定放在 L0, 不往更深的层放
+     */
+    void CompactMemTable(bool level0_only = false);
+    // base 为空时文件放在 L0, 否则由 base 决定放在哪一层
+    Status WriteLevel0Table(MemTable* mem, VersionEdit* edit, Version* base);
+
+    Status DoCompactionWork(CompactionState* compact);
+    Status OpenCompactionOutputFile(CompactionState* compact);
+    Status FinishCompactionOutputFile(CompactionState* compact, Iterator* input);
+    Status InstallCompactionResults(CompactionState* compact);
+    void CleanupCompaction(CompactionState* compact);
+
+    // 删除不再被任何版本引用的文件
+    void DeleteObsoleteFiles();
+
+    // 手动压缩 level 层中与用户键范围重叠的文件
+    void ManualCompactLevel(int level, const Slice* begin, const Slice* end);
+
+    /**
+     * @brief 从队首开始把后续写者的批次组成一组, 填好 group_parts_ 中除头部外的各段
+     * @param last_writer 返回组内最后一个写者
+     * @return int 组内更新的总条数
+     */
+    int BuildBatchGroup(Writer** last_writer);
+
+    const InternalKeyComparator internal_comparator_;
+    const InternalFilterPolicy internal_filter_policy_;
+    const Options options_;
+    // 表文件中存的是内部键, 比较器和过滤策略换成内部键的版本
+    Options table_options_;
+    const std::string dbname_;
+
+    // 自带同步
+    TableCache* const table_cache_;
+
+    // 保护以下所有状态
+    std::mutex mutex_;
+    std::atomic<bool> shutting_down_;
+    MemTable* mem_;
+    MemTable* imm_;  // 正在落盘的 memtable
+    std::atomic<bool> has_imm_;  // 后台线程压缩期间不持锁也能发现 imm_ 非空
+    WritableFile* logfile_;
+    uint64_t logfile_number_;
+    log::Writer* log_;
+    SequenceNumber last_sequence_;
+
+    // 写者队列, 队首为当前组长
+    std::deque<Writer*> writers_;
+    // 组内还没有插入完 memtable 的写者个数
+    int pending_inserts_;
+    // 组合并后的日志记录: 新的头部加上各批次的记录部分, 只有组长使用
+    char group_header_[12];
+    std::vector<Slice> group_parts_;
+
+    LogReplayStats recovery_stats_;
+
+    // 正在生成的表文件, 不能被当作无用文件删除
+    std::set<uint64_t> pending_outputs_;
+
+    VersionSet* const versions_;
+
+    std::thread background_thread_;
+    // 通知后台线程有工作或者要关闭
+    std::condition_variable background_work_cv_;
+    bool background_compaction_scheduled_;
+    // 后台线程完成一轮工作或出错时通知等待的写者
+    std::condition_variable background_work_finished_signal_;
+
+    ManualCompaction* manual_compaction_;
+
+    // 日志写入或落盘失败、后台落盘或压缩失败后, 磁盘上的状态不确定, 之后的写入全部拒绝
+    Status bg_error_;
+};
+
+}   // namespace leveldb
+
+/**
+ * 组提交流程(DBImpl::Write)
+ *  1. 写者加入队列并等待, 直到成为队首(组长), 或被组长通知去插入 memtable, 或被告知已完成
+ *  2. 组长合并队列中后续写者的批次, 放开锁后追加一条日志记录, 需要时 fdatasync 一次
+ *     合并不拷贝数据: 日志记录由新的头部和各批次的记录部分直接拼成, 各段直接交给日志文件
+ *  3. 重新加锁, 按队列顺序给每个批次分配连续的序列号; 组内有多个写者时通知它们各自
+ *     并发插入 memtable(MemTable::AddConcurrently), 组长插入自己的批次后等待全部完成
+ *  4. 发布 last_sequence_, 此时整组写入同时对读者可见; 组长唤醒组内写者并把队首交给下一个写者
+ *
+ * 组长做日志 I/O 期间锁是放开的, 新到的写者只能排队, 它们会在下一组被一起提交
+ * 所以写线程越多, 每次落盘分摊的写入越多
+ *
+ * 组的大小限制在 1MB 以内; 组长的批次很小时限制在其大小 + 128KB, 避免小写入的延迟被大组拖长
+ * 非同步写的组长不合并同步写者, 否则同步写者的落盘要求得不到满足
+ *
+ * 后台落盘和压缩(BackgroundThreadMain)
+ *  只有一个后台线程, memtable 落盘优先: 压缩进行中发现 imm_ 非空时先把它落盘, 避免写者长时间等待
+ *  落盘的文件不与 L0 重叠时可以直接放到更深的层(最多 kMaxMemCompactLevel), 省掉之后的压缩
+ *  压缩按 VersionSet::PickCompaction 选出的输入归并, 丢弃被更新版本覆盖的记录;
+ *  删除标记在更深的层都没有这个键时也一并丢弃
+ *  没有快照, 读总是读最新的版本, 所以同一个键只需要保留最新的一个版本
+ *
+ * 写入的流控: L0 的文件数达到 kL0_SlowdownWritesTrigger 时每次写入延迟 1ms,
+ *  达到 kL0_StopWritesTrigger 或上一个 memtable 还没落盘完时等待后台线程
+ */
@@ -0,0 +1,105 @@
+/**
+ * @file dbformat.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "dbformat.h"
+
+namespace leveldb {
+
+void AppendInternalKey(std::string* result, const ParsedInternalKey& key) {
+    result->append(key.user_key.data(), key.user_key.size());
+    PutFixed64(result, PackSequenceAndType(key.sequence, key.type));
+}
+
+bool ParseInternalKey(const Slice& internal_key, ParsedInternalKey* result) {
+    const size_t n = internal_key.size();
+    if(n < 8) return false;
+    uint64_t num = DecodeFixed64(internal_key.data() + n - 8);
+    uint8_t c = num & 0xff;
+    result->sequence = num >> 8;
+    result->type = static_cast<ValueType>(c);
+    result->user_key = Slice(internal_key.data(), n - 8);
+    return (c <= static_cast<uint8_t>(kTypeValue));
+}
+
+const char* InternalKeyComparator::Name() const {
+    return "leveldb.InternalKeyComparator";
+}
+
+int InternalKeyComparator::Compare(const Slice& akey, const Slice& bkey) const {
+    // 按以下顺序排序:
+    //    user_key 升序(用户比较器)
+    //    序列号降序
+    //    值类型降序
+    if(user_is_bytewise_) return CompareInternalKeys(BytewiseCompare(), akey, bkey);
+    return CompareInternalKeys(VirtualCompare(user_comparator_), akey, bkey);
+}
+
+void InternalKeyComparator::FindShortestSeparator(std::string* start, const Slice& limit) const {
+    // 只缩短用户键部分
+    Slice user_start = ExtractUserKey(*start);
+    Slice user_limit = ExtractUserKey(limit);
+    std::string tmp(user_start.data(), user_start.size());
+    user_comparator_->FindShortestSeparator(&tmp, user_limit);
+    if(tmp.size() < user_start.size() &&
+       user_comparator_->Compare(user_start, tmp) < 0) {
+        // 用户键在物理上变短但逻辑上变大了, 补上最大的 tag 使其排在同一用户键的所有版本之前
+        PutFixed64(&tmp, PackSequenceAndType(kMaxSequenceNumber, kValueTypeForSeek));
+        assert(this->Compare(*start, tmp) < 0);
+        assert(this->Compare(tmp, limit) < 0);
+        start->swap(tmp);
+    }
+}
+
+void InternalKeyComparator::FindShortSuccessor(std::string* key) const {
+    Slice user_key = ExtractUserKey(*key);
+    std::string tmp(user_key.data(), user_key.size());
+    user_comparator_->FindShortSuccessor(&tmp);
+    if(tmp.size() < user_key.size() &&
+       user_comparator_->Compare(user_key, tmp) < 0) {
+        PutFixed64(&tmp, PackSequenceAndType(kMaxSequenceNumber, kValueTypeForSeek));
+        assert(this->Compare(*key, tmp) < 0);
+        key->swap(tmp);
+    }
+}
+
+const char* InternalFilterPolicy::Name() const { return user_policy_->Name(); }
+
+void InternalFilterPolicy::CreateFilter(const Slice* keys, int n, std::string* dst) const {
+    // keys 只在这次调用期间使用, 直接在原地把内部键截成用户键
+    Slice* mkey = const_cast<Slice*>(keys);
+    for(int i = 0; i < n; i++) mkey[i] = ExtractUserKey(keys[i]);
+    user_policy_->CreateFilter(keys, n, dst);
+}
+
+bool InternalFilterPolicy::KeyMayMatch(const Slice& key, const Slice& f) const {
+    return user_policy_->KeyMayMatch(ExtractUserKey(key), f);
+}
+
+LookupKey::LookupKey(const Slice& user_key, SequenceNumber s) {
+    size_t usize = user_key.size();
+    size_t needed = usize + 13;  // 保守估计: varint32 最多 5 字节 + tag 8 字节
+    char* dst;
+    if(needed <= sizeof(space_)) {
+        dst = space_;
+    } else {
+        dst = new char[needed];
+    }
+    start_ = dst;
+    dst = EncodeVarint32(dst, usize + 8);
+    kstart_ = dst;
+    std::memcpy(dst, user_key.data(), usize);
+    dst += usize;
+    EncodeFixed64(dst, PackSequenceAndType(s, kValueTypeForSeek));
+    dst += 8;
+    end_ = dst;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,224 @@
+/**
+ * @file dbformat.h
+ * @author alongnice
+ * @brief 内部键格式: user_key + 8字节(序列号 << 8 | 值类型)
+ *  同一个 user_key 的多个版本按序列号降序排列, 保证读到的总是最新写入
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "coding.h"
+#include "comparator.h"
+#include "filter_policy.h"
+#include "slice.h"
+
+namespace leveldb {
+
+// 分层结构的参数
+namespace config {
+static const int kNumLevels = 7;
+
+// L0 的文件数达到这个值时开始压缩
+static const int kL0_CompactionTrigger = 4;
+
+// L0 的文件数达到这个值时每次写入延迟 1ms, 给后台压缩让出 CPU
+static const int kL0_SlowdownWritesTrigger = 8;
+
+// L0 的文件数达到这个值时停止写入, 等待压缩完成
+static const int kL0_StopWritesTrigger = 12;
+
+// memtable 落盘生成的文件不与任何文件重叠时, 最多直接放到这一层
+// 跳过 L0 可以省掉一次 L0->L1 压缩, 但也不宜放得太深, 以免覆盖写把深层的大范围空间浪费掉
+static const int kMaxMemCompactLevel = 2;
+}   // namespace config
+
+/**
+ * @brief 值类型, 编码进内部键的最低字节
+ *  不能随意修改取值, 它们会被写入磁盘
+ */
+enum ValueType { kTypeDeletion = 0x0, kTypeValue = 0x1 };
+
+// 查找时使用的类型: 序列号相同时按类型降序排列, 所以取最大的类型值
+static const ValueType kValueTypeForSeek = kTypeValue;
+
+typedef uint64_t SequenceNumber;
+
+// 低 8 位留给值类型, 序列号只剩 56 位
+static const SequenceNumber kMaxSequenceNumber = ((0x1ull << 56) - 1);
+
+struct ParsedInternalKey {
+    Slice user_key;
+    SequenceNumber sequence;
+    ValueType type;
+
+    ParsedInternalKey() {}  // 不做初始化, 提高效率
+    ParsedInternalKey(const Slice& u, const SequenceNumber& seq, ValueType t)
+        : user_key(u), sequence(seq), type(t) {}
+};
+
+// 内部键的编码长度
+inline size_t InternalKeyEncodingLength(const ParsedInternalKey& key) {
+    return key.user_key.size() + 8;
+}
+
+inline uint64_t PackSequenceAndType(uint64_t seq, ValueType t) {
+    assert(seq <= kMaxSequenceNumber);
+    assert(t <= kValueTypeForSeek);
+    return (seq << 8) | t;
+}
+
+// 将 key 序列化后追加到 result
+void AppendInternalKey(std::string* result, const ParsedInternalKey& key);
+
+// 解析内部键, 格式非法返回 false
+bool ParseInternalKey(const Slice& internal_key, ParsedInternalKey* result);
+
+class InternalKey;
+
+// 去掉尾部 8 字节得到用户键
+inline Slice ExtractUserKey(const Slice& internal_key) {
+    assert(internal_key.size() >= 8);
+    return Slice(internal_key.data(), internal_key.size() - 8);
+}
+
+/**
+ * @brief 内部键比较的模板实现, UserCompare 为用户键比较函子
+ *  先按用户比较器升序比较 user_key, 相同时按 tag(序列号 + 类型)降序
+ */
+template <class UserCompare>
+inline int CompareInternalKeys(const UserCompare& ucmp, const Slice& akey, const Slice& bkey) {
+    int r = ucmp(ExtractUserKey(akey), ExtractUserKey(bkey));
+    if(r == 0) {
+        const uint64_t anum = DecodeFixed64(akey.data() + akey.size() - 8);
+        const uint64_t bnum = DecodeFixed64(bkey.data() + bkey.size() - 8);
+        if(anum > bnum) r = -1;
+        else if(anum < bnum) r = +1;
+    }
+    return r;
+}
+
+/**
+ * @brief 内部键比较器
+ *  先按用户比较器升序比较 user_key, 相同时按序列号降序
+ */
+class InternalKeyComparator : public Comparator {
+public:
+    explicit InternalKeyComparator(const Comparator* c)
+        : user_comparator_(c), user_is_bytewise_(c == BytewiseComparator()) {}
+    const char* Name() const override;
+    int Compare(const Slice& a, const Slice& b) const override;
+    void FindShortestSeparator(std::string* start, const Slice& limit) const override;
+    void FindShortSuccessor(std::string* key) const override;
+
+    int Compare(const InternalKey& a, const InternalKey& b) const;
+
+    const Comparator* user_comparator() const { return user_comparator_; }
+
+    // 用户比较器是否为内置的字典序比较器, 是的话热路径可以走内联的 BytewiseCompare
+    bool user_is_bytewise() const { return user_is_bytewise_; }
+
+private:
+    const Comparator* user_comparator_;
+    bool user_is_bytewise_;
+};
+
+/**
+ * @brief 把用户的过滤策略转换成作用于内部键的策略
+ *  生成和查询时都只取用户键, 这样同一个用户键的任意版本(序列号)都能命中过滤器
+ */
+class InternalFilterPolicy : public FilterPolicy {
+public:
+    explicit InternalFilterPolicy(const FilterPolicy* p) : user_policy_(p) {}
+    const char* Name() const override;
+    void CreateFilter(const Slice* keys, int n, std::string* dst) const override;
+    bool KeyMayMatch(const Slice& key, const Slice& filter) const override;
+
+private:
+    const FilterPolicy* const user_policy_;
+};
+
+/**
+ * @brief 内部键的封装, 避免直接拿 string 当内部键使用而误用用户比较器
+ */
+class InternalKey {
+public:
+    InternalKey() {}  // 空 rep_ 表示非法
+    InternalKey(const Slice& user_key, SequenceNumber s, ValueType t) {
+        AppendInternalKey(&rep_, ParsedInternalKey(user_key, s, t));
+    }
+
+    bool DecodeFrom(const Slice& s) {
+        rep_.assign(s.data(), s.size());
+        return !rep_.empty();
+    }
+
+    Slice Encode() const {
+        assert(!rep_.empty());
+        return rep_;
+    }
+
+    Slice user_key() const { return ExtractUserKey(rep_); }
+
+    void SetFrom(const ParsedInternalKey& p) {
+        rep_.clear();
+        AppendInternalKey(&rep_, p);
+    }
+
+    void Clear() { rep_.clear(); }
+
+private:
+    std::string rep_;
+};
+
+inline int InternalKeyComparator::Compare(const InternalKey& a, const InternalKey& b) const {
+    return Compare(a.Encode(), b.Encode());
+}
+
+/**
+ * @brief MemTable::Get 使用的查找键
+ *  布局: varint32(internal_key 长度) | user_key | 8字节 tag
+ *  短键直接放在栈上的 space_ 中, 避免一次堆分配
+ */
+class LookupKey {
+public:
+    LookupKey(const Slice& user_key, SequenceNumber sequence);
+
+    LookupKey(const LookupKey&) = delete;
+    LookupKey& operator=(const LookupKey&) = delete;
+
+    ~LookupKey();
+
+    // 适合在 MemTable 中查找的带长度前缀的键
+    Slice memtable_key() const { return Slice(start_, end_ - start_); }
+
+    // 内部键(user_key + tag)
+    Slice internal_key() const { return Slice(kstart_, end_ - kstart_); }
+
+    // 用户键
+    Slice user_key() const { return Slice(kstart_, end_ - kstart_ - 8); }
+
+private:
+    // start_      kstart_                  end_
+    //   |            |                       |
+    //   v            v                       v
+    //   [klength varint32][user_key][tag(8B)]
+    const char* start_;
+    const char* kstart_;
+    const char* end_;
+    char space_[200];
+};
+
+inline LookupKey::~LookupKey() {
+    if(start_ != space_) delete[] start_;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,138 @@
+/**
+ * @file filename.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "filename.h"
+
+#include <cassert>
+#include <cstdio>
+
+#include "../../include/leveldb/env.h"
+
+namespace leveldb {
+
+static std::string MakeFileName(const std::string& dbname, uint64_t number, const char* suffix) {
+    char buf[100];
+    std::snprintf(buf, sizeof(buf), "/%06llu.%s", static_cast<unsigned long long>(number), suffix);
+    return dbname + buf;
+}
+
+std::string LogFileName(const std::string& dbname, uint64_t number) {
+    assert(number > 0);
+    return MakeFileName(dbname, number, "log");
+}
+
+std::string TableFileName(const std::string& dbname, uint64_t number) {
+    assert(number > 0);
+    return MakeFileName(dbname, number, "ldb");
+}
+
+std::string DescriptorFileName(const std::string& dbname, uint64_t number) {
+    assert(number > 0);
+    char buf[100];
+    std::snprintf(buf, sizeof(buf), "/MANIFEST-%06llu", static_cast<unsigned long long>(number));
+    return dbname + buf;
+}
+
+std::string CurrentFileName(const std::string& dbname) { return dbname + "/CURRENT"; }
+
+std::string TempFileName(const std::string& dbname, uint64_t number) {
+    assert(number > 0);
+    return MakeFileName(dbname, number, "dbtmp");
+}
+
+// 解析十进制编号, 返回编号之后的位置; 没有数字或溢出时返回 false
+static bool ConsumeDecimalNumber(const std::string& s, size_t* pos, uint64_t* number) {
+    uint64_t num = 0;
+    const size_t start = *pos;
+    while(*pos < s.size() && s[*pos] >= '0' && s[*pos] <= '9') {
+        const uint64_t delta = s[*pos] - '0';
+        if(num > (~static_cast<uint64_t>(0) - delta) / 10) return false;  // 溢出
+        num = num * 10 + delta;
+        (*pos)++;
+    }
+    *number = num;
+    return *pos != start;
+}
+
+bool ParseFileName(const std::string& filename, uint64_t* number, FileType* type) {
+    if(filename == "CURRENT") {
+        *number = 0;
+        *type = kCurrentFile;
+        return true;
+    }
+    const std::string manifest_prefix = "MANIFEST-";
+    if(filename.compare(0, manifest_prefix.size(), manifest_prefix) == 0) {
+        size_t pos = manifest_prefix.size();
+        uint64_t num;
+        if(!ConsumeDecimalNumber(filename, &pos, &num) || pos != filename.size()) return false;
+        *type = kDescriptorFile;
+        *number = num;
+        return true;
+    }
+
+    // 十进制编号 + 后缀
+    uint64_t num;
+    size_t pos = 0;
+    if(!ConsumeDecimalNumber(filename, &pos, &num)) return false;
+
+    const std::string suffix = filename.substr(pos);
+    if(suffix == ".log") {
+        *type = kLogFile;
+    } else if(suffix == ".ldb") {
+        *type = kTableFile;
+    } else if(suffix == ".dbtmp") {
+        *type = kTempFile;
+    } else {
+        return false;
+    }
+    *number = num;
+    return true;
+}
+
+Status SetCurrentFile(Env* env, const std::string& dbname, uint64_t descriptor_number) {
+    // CURRENT 中记录的是不含目录的文件名
+    std::string manifest = DescriptorFileName(dbname, descriptor_number);
+    Slice contents = manifest;
+    contents.remove_prefix(dbname.size() + 1);
+    const std::string tmp = TempFileName(dbname, descriptor_number);
+
+    WritableFile* file;
+    Status s = env->NewWritableFile(tmp, &file);
+    if(!s.ok()) return s;
+    s = file->Append(contents);
+    if(s.ok()) s = file->Append("\n");
+    if(s.ok()) s = file->Sync();
+    if(s.ok()) s = file->Close();
+    delete file;
+    if(s.ok()) s = env->RenameFile(tmp, CurrentFileName(dbname));
+    if(!s.ok()) env->RemoveFile(tmp);
+    return s;
+}
+
+Status ReadFileToString(Env* env, const std::string& fname, std::string* data) {
+    data->clear();
+    SequentialFile* file;
+    Status s = env->NewSequentialFile(fname, &file);
+    if(!s.ok()) return s;
+    static const int kBufferSize = 8192;
+    char* space = new char[kBufferSize];
+    while(true) {
+        Slice fragment;
+        s = file->Read(kBufferSize, &fragment, space);
+        if(!s.ok() || fragment.empty()) break;
+        data->append(fragment.data(), fragment.size());
+    }
+    delete[] space;
+    delete file;
+    return s;
+}
+
+}   // namespace leveldb
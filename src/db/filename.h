@@ -0,0 +1,60 @@
+/**
+ * @file filename.h
+ * @author alongnice
+ * @brief 数据库目录中各类文件的命名
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "status.h"
+
+namespace leveldb {
+
+class Env;
+
+enum FileType {
+    kLogFile,
+    kTableFile,
+    kDescriptorFile,
+    kCurrentFile,
+    kTempFile,
+};
+
+// 编号为 number 的日志文件名, 格式为 dbname/[0-9]+.log
+std::string LogFileName(const std::string& dbname, uint64_t number);
+
+// 编号为 number 的表文件名, 格式为 dbname/[0-9]+.ldb
+std::string TableFileName(const std::string& dbname, uint64_t number);
+
+// 编号为 number 的描述文件(MANIFEST)名, 格式为 dbname/MANIFEST-[0-9]+
+std::string DescriptorFileName(const std::string& dbname, uint64_t number);
+
+// CURRENT 文件的内容是当前描述文件的文件名
+std::string CurrentFileName(const std::string& dbname);
+
+// 临时文件, 写完之后改名成正式的文件
+std::string TempFileName(const std::string& dbname, uint64_t number);
+
+/**
+ * @brief 解析数据库目录下的文件名(不含路径)
+ * @return true 是数据库自己的文件, number 和 type 为解析结果
+ */
+bool ParseFileName(const std::string& filename, uint64_t* number, FileType* type);
+
+/**
+ * @brief 让 CURRENT 指向编号为 descriptor_number 的描述文件
+ *  先写临时文件并落盘, 再改名覆盖 CURRENT, 崩溃时 CURRENT 要么是旧内容要么是新内容
+ */
+Status SetCurrentFile(Env* env, const std::string& dbname, uint64_t descriptor_number);
+
+// 读出整个文件的内容
+Status ReadFileToString(Env* env, const std::string& fname, std::string* data);
+
+}   // namespace leveldb
@@ -0,0 +1,48 @@
+/**
+ * @file log_format.h
+ * @author alongnice
+ * @brief 预写日志的格式, 写入端和读取端共用
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+namespace leveldb {
+namespace log {
+
+enum RecordType {
+    // 0 保留给预分配的文件
+    kZeroType = 0,
+
+    kFullType = 1,
+
+    // 一条记录被拆成多个片段
+    kFirstType = 2,
+    kMiddleType = 3,
+    kLastType = 4
+};
+static const int kMaxRecordType = kLastType;
+
+static const int kBlockSize = 32768;
+
+// 头部: checksum (4 bytes), length (2 bytes), type (1 byte)
+static const int kHeaderSize = 4 + 2 + 1;
+
+}   // namespace log
+}   // namespace leveldb
+
+/**
+ * 日志文件由连续的 32KB 物理块组成, 每个块内依次存放片段:
+ *  checksum : uint32  // 类型和数据的 crc32c, 掩码后存储
+ *  length   : uint16  // 数据长度, 小端序
+ *  type     : uint8   // FULL / FIRST / MIDDLE / LAST
+ *  data     : uint8[length]
+ *
+ * 片段不跨块: 块尾剩余空间不足一个头部(<7 字节)时补 0 跳过
+ * 放不进当前块的记录拆成 FIRST, 若干 MIDDLE 和 LAST
+ * 某个块损坏时, 读取端最多丢失这一块中的记录, 从下一个块重新同步
+ */
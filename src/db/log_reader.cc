@@ -0,0 +1,234 @@
+/**
+ * @file log_reader.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "log_reader.h"
+
+#include <cstdio>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/crc32c.h"
+#include "../../include/leveldb/env.h"
+
+namespace leveldb {
+namespace log {
+
+Reader::Reporter::~Reporter() = default;
+
+Reader::Reader(SequentialFile* file, Reporter* reporter, bool checksum, uint64_t initial_offset)
+    : file_(file), reporter_(reporter), checksum_(checksum),
+      backing_store_(new char[kBlockSize]), buffer_(), eof_(false),
+      last_record_offset_(0), end_of_buffer_offset_(0),
+      initial_offset_(initial_offset), resyncing_(initial_offset > 0) {}
+
+Reader::~Reader() { delete[] backing_store_; }
+
+bool Reader::SkipToInitialBlock() {
+    const size_t offset_in_block = initial_offset_ % kBlockSize;
+    uint64_t block_start_location = initial_offset_ - offset_in_block;
+
+    // 落在块尾的补 0 区域时, 直接从下一个块开始
+    if(offset_in_block > kBlockSize - 6) block_start_location += kBlockSize;
+
+    end_of_buffer_offset_ = block_start_location;
+
+    if(block_start_location > 0) {
+        Status skip_status = file_->Skip(block_start_location);
+        if(!skip_status.ok()) {
+            ReportDrop(block_start_location, skip_status);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Reader::ReadRecord(Slice* record, std::string* scratch) {
+    if(last_record_offset_ < initial_offset_) {
+        if(!SkipToInitialBlock()) return false;
+    }
+
+    scratch->clear();
+    record->clear();
+    bool in_fragmented_record = false;
+    // 正在拼接的记录的起始位置
+    uint64_t prospective_record_offset = 0;
+
+    Slice fragment;
+    while(true) {
+        const unsigned int record_type = ReadPhysicalRecord(&fragment);
+
+        // ReadPhysicalRecord 返回后 buffer_ 中只剩下还没读的数据, 据此算出当前片段的起始位置
+        uint64_t physical_record_offset =
+            end_of_buffer_offset_ - buffer_.size() - kHeaderSize - fragment.size();
+
+        if(resyncing_) {
+            if(record_type == kMiddleType) {
+                continue;
+            } else if(record_type == kLastType) {
+                resyncing_ = false;
+                continue;
+            } else {
+                resyncing_ = false;
+            }
+        }
+
+        switch(record_type) {
+            case kFullType:
+                if(in_fragmented_record) {
+                    // 早期版本的写入端可能在块尾写出空的 FIRST 片段, 这里只在 scratch 非空时才报告
+                    if(!scratch->empty()) ReportCorruption(scratch->size(), "partial record without end(1)");
+                }
+                prospective_record_offset = physical_record_offset;
+                scratch->clear();
+                *record = fragment;
+                last_record_offset_ = prospective_record_offset;
+                return true;
+
+            case kFirstType:
+                if(in_fragmented_record) {
+                    if(!scratch->empty()) ReportCorruption(scratch->size(), "partial record without end(2)");
+                }
+                prospective_record_offset = physical_record_offset;
+                scratch->assign(fragment.data(), fragment.size());
+                in_fragmented_record = true;
+                break;
+
+            case kMiddleType:
+                if(!in_fragmented_record) {
+                    ReportCorruption(fragment.size(), "missing start of fragmented record(1)");
+                } else {
+                    scratch->append(fragment.data(), fragment.size());
+                }
+                break;
+
+            case kLastType:
+                if(!in_fragmented_record) {
+                    ReportCorruption(fragment.size(), "missing start of fragmented record(2)");
+                } else {
+                    scratch->append(fragment.data(), fragment.size());
+                    *record = Slice(*scratch);
+                    last_record_offset_ = prospective_record_offset;
+                    return true;
+                }
+                break;
+
+            case kEof:
+                // 写入端在写完最后一条记录之前崩溃, 不算损坏, 直接丢弃半条记录
+                if(in_fragmented_record) scratch->clear();
+                return false;
+
+            case kBadRecord:
+                if(in_fragmented_record) {
+                    ReportCorruption(scratch->size(), "error in middle of record");
+                    in_fragmented_record = false;
+                    scratch->clear();
+                }
+                break;
+
+            default: {
+                char buf[40];
+                std::snprintf(buf, sizeof(buf), "unknown record type %u", record_type);
+                ReportCorruption((fragment.size() + (in_fragmented_record ? scratch->size() : 0)), buf);
+                in_fragmented_record = false;
+                scratch->clear();
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+uint64_t Reader::LastRecordOffset() { return last_record_offset_; }
+
+void Reader::ReportCorruption(uint64_t bytes, const char* reason) {
+    ReportDrop(bytes, Status::Corruption(reason));
+}
+
+void Reader::ReportDrop(uint64_t bytes, const Status& reason) {
+    // initial_offset 之前的数据调用方并不关心, 不报告
+    if(reporter_ != nullptr && end_of_buffer_offset_ - buffer_.size() - bytes >= initial_offset_) {
+        reporter_->Corruption(static_cast<size_t>(bytes), reason);
+    }
+}
+
+unsigned int Reader::ReadPhysicalRecord(Slice* result) {
+    while(true) {
+        if(buffer_.size() < kHeaderSize) {
+            if(!eof_) {
+                // 上一个块剩下的是补 0 区域, 直接丢弃, 读入下一个块
+                buffer_.clear();
+                Status status = file_->Read(kBlockSize, &buffer_, backing_store_);
+                end_of_buffer_offset_ += buffer_.size();
+                if(!status.ok()) {
+                    buffer_.clear();
+                    ReportDrop(kBlockSize, status);
+                    eof_ = true;
+                    return kEof;
+                } else if(buffer_.size() < kBlockSize) {
+                    eof_ = true;
+                }
+                continue;
+            } else {
+                // 文件末尾不足一个头部: 写入端在写头部时崩溃, 不算损坏
+                buffer_.clear();
+                return kEof;
+            }
+        }
+
+        // 解析头部
+        const char* header = buffer_.data();
+        const uint32_t a = static_cast<uint32_t>(header[4]) & 0xff;
+        const uint32_t b = static_cast<uint32_t>(header[5]) & 0xff;
+        const unsigned int type = header[6];
+        const uint32_t length = a | (b << 8);
+        if(kHeaderSize + length > buffer_.size()) {
+            size_t drop_size = buffer_.size();
+            buffer_.clear();
+            if(!eof_) {
+                ReportCorruption(drop_size, "bad record length");
+                return kBadRecord;
+            }
+            // 文件末尾的片段不完整: 写入端在写数据时崩溃, 不算损坏
+            return kEof;
+        }
+
+        if(type == kZeroType && length == 0) {
+            // 预分配(mmap)的文件中可能出现全 0 的区域, 不报告
+            buffer_.clear();
+            return kBadRecord;
+        }
+
+        if(checksum_) {
+            uint32_t expected_crc = crc32c::Unmask(DecodeFixed32(header));
+            uint32_t actual_crc = crc32c::Value(header + 6, 1 + length);
+            if(actual_crc != expected_crc) {
+                // 长度字段本身可能已经损坏, 按它跳过可能落到一段看起来合法的数据上, 所以丢弃整个块
+                size_t drop_size = buffer_.size();
+                buffer_.clear();
+                ReportCorruption(drop_size, "checksum mismatch");
+                return kBadRecord;
+            }
+        }
+
+        buffer_.remove_prefix(kHeaderSize + length);
+
+        // 跳过 initial_offset 之前开始的片段
+        if(end_of_buffer_offset_ - buffer_.size() - kHeaderSize - length < initial_offset_) {
+            result->clear();
+            return kBadRecord;
+        }
+
+        *result = Slice(header + kHeaderSize, length);
+        return type;
+    }
+}
+
+}   // namespace log
+}   // namespace leveldb
@@ -0,0 +1,99 @@
+/**
+ * @file log_reader.h
+ * @author alongnice
+ * @brief 预写日志的读取端, 把片段重新拼成完整记录, 校验失败的数据通过 Reporter 报告后跳过
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "log_format.h"
+#include "slice.h"
+#include "status.h"
+
+namespace leveldb {
+
+class SequentialFile;
+
+namespace log {
+
+class Reader {
+public:
+    /**
+     * @brief 损坏报告接口, 读取端跳过的每一段数据都会通过它报告
+     */
+    class Reporter {
+    public:
+        virtual ~Reporter();
+
+        // 丢弃了大约 bytes 字节, status 为 Corruption 或读文件时的 IO 错误
+        virtual void Corruption(size_t bytes, const Status& status) = 0;
+    };
+
+    /**
+     * @brief 从 file 读取记录, file 在 Reader 使用期间必须保持有效
+     * @param reporter 非空时报告丢弃的数据
+     * @param checksum 是否校验 crc
+     * @param initial_offset 从文件中第一个起始位置 >= initial_offset 的记录开始读
+     */
+    Reader(SequentialFile* file, Reporter* reporter, bool checksum, uint64_t initial_offset);
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    ~Reader();
+
+    /**
+     * @brief 读取下一条记录
+     * @param record 输出, 只在下一次修改 reader 或 scratch 之前有效
+     * @param scratch 跨块记录的拼接缓冲
+     * @return false 到达文件末尾
+     */
+    bool ReadRecord(Slice* record, std::string* scratch);
+
+    // 上一条 ReadRecord 返回的记录在文件中的物理起始位置
+    uint64_t LastRecordOffset();
+
+private:
+    // ReadPhysicalRecord 除了 RecordType 之外的返回值
+    enum {
+        kEof = kMaxRecordType + 1,
+        // 非法的片段: crc 不匹配, 长度为 0 的预分配区域, 或在 initial_offset 之前
+        kBadRecord = kMaxRecordType + 2
+    };
+
+    // 跳过 initial_offset 之前的所有块
+    bool SkipToInitialBlock();
+
+    unsigned int ReadPhysicalRecord(Slice* result);
+
+    // 向 reporter 报告丢弃的字节
+    void ReportCorruption(uint64_t bytes, const char* reason);
+    void ReportDrop(uint64_t bytes, const Status& reason);
+
+    SequentialFile* const file_;
+    Reporter* const reporter_;
+    bool const checksum_;
+    char* const backing_store_;
+    Slice buffer_;
+    bool eof_;  // 上一次 Read() 读到的数据不足 kBlockSize, 说明已到文件末尾
+
+    // ReadRecord 返回的上一条记录的偏移
+    uint64_t last_record_offset_;
+    // buffer_ 末尾之后的第一个位置
+    uint64_t end_of_buffer_offset_;
+
+    uint64_t const initial_offset_;
+
+    // 从 initial_offset 开始时, 跳过遇到的 MIDDLE/LAST 片段直到下一条完整记录
+    bool resyncing_;
+};
+
+}   // namespace log
+}   // namespace leveldb
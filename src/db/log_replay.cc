@@ -0,0 +1,280 @@
+/**
+ * @file log_replay.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "log_replay.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../include/leveldb/env.h"
+#include "log_reader.h"
+#include "memtable.h"
+#include "write_batch_internal.h"
+
+namespace leveldb {
+
+namespace {
+// 读取线程每攒够这么多记录字节就交给插入线程一次
+const size_t kChunkBytes = 1 << 20;
+// 两个阶段之间最多积压的包数
+const size_t kMaxQueuedChunks = 4;
+
+uint64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 统计损坏, paranoid 模式下记住第一个错误
+ */
+class CorruptionReporter : public log::Reader::Reporter {
+public:
+    explicit CorruptionReporter(bool p) : paranoid(p), dropped_bytes(0) {}
+
+    void Corruption(size_t bytes, const Status& s) override {
+        dropped_bytes += bytes;
+        if(paranoid && status.ok()) status = s;
+    }
+
+    const bool paranoid;
+    uint64_t dropped_bytes;
+    Status status;
+};
+
+/**
+ * @brief 一包连续的记录: 记录内容首尾相接存放在 data 中, ends 为每条记录的结束位置
+ */
+struct Chunk {
+    std::string data;
+    std::vector<size_t> ends;
+
+    void Clear() {
+        data.clear();
+        ends.clear();
+    }
+};
+
+/**
+ * @brief 把批次中的更新暂存进 memtable, 攒够一包之后统一排序插入
+ */
+class PendingInserter : public WriteBatch::Handler {
+public:
+    PendingInserter(SequenceNumber seq, MemTable* mem) : sequence_(seq), mem_(mem) {}
+
+    void Put(const Slice& key, const Slice& value) override {
+        mem_->AddPending(sequence_++, kTypeValue, key, value);
+    }
+    void Delete(const Slice& key) override {
+        mem_->AddPending(sequence_++, kTypeDeletion, key, Slice());
+    }
+
+private:
+    SequenceNumber sequence_;
+    MemTable* const mem_;
+};
+
+/**
+ * @brief 暂存一条记录并更新统计; 损坏的批次可能已经暂存了一部分, 与逐条插入时的行为一致
+ */
+Status ApplyRecord(const Slice& record, MemTable* mem, WriteBatch* batch, LogReplayStats* stats) {
+    if(record.size() < WriteBatchInternal::kHeaderSize) {
+        return Status::Corruption("log record too small");
+    }
+    WriteBatchInternal::SetContents(batch, record);
+    PendingInserter inserter(WriteBatchInternal::Sequence(batch), mem);
+    Status s = batch->Iterate(&inserter);
+    if(!s.ok()) return s;
+    const int count = WriteBatchInternal::Count(batch);
+    const SequenceNumber last_seq = WriteBatchInternal::Sequence(batch) + count - 1;
+    if(count > 0 && last_seq > stats->max_sequence) stats->max_sequence = last_seq;
+    stats->bytes += record.size();
+    stats->records++;
+    stats->updates += count;
+    return Status::OK();
+}
+
+/**
+ * @brief 连接读取线程和插入线程的有限队列, 用完的包从 free 队列回到读取线程
+ */
+class ChunkQueue {
+public:
+    ChunkQueue() : allocated_(0), producer_done_(false), consumer_done_(false) {}
+
+    // 读取线程: 取一个空包, 插入线程已经退出时返回 nullptr
+    Chunk* TakeFree() {
+        std::unique_lock<std::mutex> l(mu_);
+        while(!consumer_done_ && free_.empty() && allocated_ >= kMaxQueuedChunks + 1) cv_.wait(l);
+        if(consumer_done_) return nullptr;
+        if(free_.empty()) {
+            allocated_++;
+            return new Chunk;
+        }
+        Chunk* c = free_.back();
+        free_.pop_back();
+        return c;
+    }
+
+    void PushFull(Chunk* c) {
+        std::lock_guard<std::mutex> l(mu_);
+        full_.push_back(c);
+        cv_.notify_all();
+    }
+
+    void FinishProducing() {
+        std::lock_guard<std::mutex> l(mu_);
+        producer_done_ = true;
+        cv_.notify_all();
+    }
+
+    // 插入线程: 取下一个满包, 读取线程结束且队列为空时返回 nullptr
+    Chunk* TakeFull() {
+        std::unique_lock<std::mutex> l(mu_);
+        while(full_.empty() && !producer_done_) cv_.wait(l);
+        if(full_.empty()) return nullptr;
+        Chunk* c = full_.front();
+        full_.pop_front();
+        return c;
+    }
+
+    void GiveBack(Chunk* c) {
+        c->Clear();
+        std::lock_guard<std::mutex> l(mu_);
+        free_.push_back(c);
+        cv_.notify_all();
+    }
+
+    // 插入线程出错提前退出, 让读取线程尽快停下
+    void FinishConsuming() {
+        std::lock_guard<std::mutex> l(mu_);
+        consumer_done_ = true;
+        cv_.notify_all();
+    }
+
+    ~ChunkQueue() {
+        for(size_t i = 0; i < free_.size(); i++) delete free_[i];
+        for(size_t i = 0; i < full_.size(); i++) delete full_[i];
+    }
+
+private:
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<Chunk*> free_;
+    std::deque<Chunk*> full_;
+    size_t allocated_;  // 已经分配的包数, 包括正在使用的
+    bool producer_done_;
+    bool consumer_done_;
+};
+
+Status ReplaySequential(log::Reader* reader, CorruptionReporter* reporter, MemTable* mem,
+                        LogReplayStats* stats) {
+    std::string scratch;
+    Slice record;
+    WriteBatch batch;
+    size_t pending_bytes = 0;
+    while(reader->ReadRecord(&record, &scratch) && reporter->status.ok()) {
+        Status s = ApplyRecord(record, mem, &batch, stats);
+        if(!s.ok()) {
+            reporter->Corruption(record.size(), s);
+            if(!reporter->status.ok()) break;
+        }
+        pending_bytes += record.size();
+        if(pending_bytes >= kChunkBytes) {
+            mem->InsertPending();
+            pending_bytes = 0;
+        }
+    }
+    mem->InsertPending();
+    return reporter->status;
+}
+
+Status ReplayPipelined(log::Reader* reader, CorruptionReporter* reporter, MemTable* mem,
+                       LogReplayStats* stats) {
+    ChunkQueue queue;
+    // reporter 只由读取线程写入, 插入线程的错误单独记录, 两者在线程汇合之后再合并
+    std::thread producer([reader, reporter, &queue]() {
+        std::string scratch;
+        Slice record;
+        Chunk* chunk = queue.TakeFree();
+        while(chunk != nullptr && reporter->status.ok() && reader->ReadRecord(&record, &scratch)) {
+            chunk->data.append(record.data(), record.size());
+            chunk->ends.push_back(chunk->data.size());
+            if(chunk->data.size() >= kChunkBytes) {
+                queue.PushFull(chunk);
+                chunk = queue.TakeFree();
+            }
+        }
+        if(chunk != nullptr) {
+            if(chunk->ends.empty()) {
+                queue.GiveBack(chunk);
+            } else {
+                queue.PushFull(chunk);
+            }
+        }
+        queue.FinishProducing();
+    });
+
+    Status apply_status;
+    uint64_t apply_dropped = 0;
+    WriteBatch batch;
+    Chunk* chunk;
+    while((chunk = queue.TakeFull()) != nullptr) {
+        size_t start = 0;
+        for(size_t i = 0; i < chunk->ends.size(); i++) {
+            Slice record(chunk->data.data() + start, chunk->ends[i] - start);
+            start = chunk->ends[i];
+            Status s = ApplyRecord(record, mem, &batch, stats);
+            if(!s.ok()) {
+                apply_dropped += record.size();
+                if(reporter->paranoid && apply_status.ok()) apply_status = s;
+            }
+        }
+        queue.GiveBack(chunk);
+        mem->InsertPending();
+        if(!apply_status.ok()) {
+            queue.FinishConsuming();
+            break;
+        }
+    }
+    producer.join();
+    reporter->dropped_bytes += apply_dropped;
+    if(!reporter->status.ok()) return reporter->status;
+    return apply_status;
+}
+}   // namespace
+
+Status ReplayLogFile(Env* env, const std::string& fname, MemTable* mem, bool pipelined,
+                     bool paranoid, LogReplayStats* stats) {
+    const uint64_t start = NowMicros();
+    SequentialFile* file;
+    Status status = env->NewSequentialFile(fname, &file);
+    if(!status.ok()) return status;
+
+    CorruptionReporter reporter(paranoid);
+    // 即使不是 paranoid 模式也校验 crc, 否则损坏的记录会被当成合法数据插入
+    log::Reader reader(file, &reporter, true, 0);
+    if(pipelined) {
+        status = ReplayPipelined(&reader, &reporter, mem, stats);
+    } else {
+        status = ReplaySequential(&reader, &reporter, mem, stats);
+    }
+    delete file;
+
+    stats->files++;
+    stats->dropped_bytes += reporter.dropped_bytes;
+    stats->micros += NowMicros() - start;
+    return status;
+}
+
+}   // namespace leveldb
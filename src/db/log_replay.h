@@ -0,0 +1,60 @@
+/**
+ * @file log_replay.h
+ * @author alongnice
+ * @brief 重放预写日志, 把其中的批次重新插入 memtable, 用于启动时的崩溃恢复
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "dbformat.h"
+#include "status.h"
+
+namespace leveldb {
+
+class Env;
+class MemTable;
+
+/**
+ * @brief 一次重放的统计, 多次重放可以累加到同一个对象上
+ */
+struct LogReplayStats {
+    LogReplayStats()
+        : files(0), bytes(0), records(0), updates(0), dropped_bytes(0), micros(0),
+          max_sequence(0) {}
+
+    uint64_t files;
+    uint64_t bytes;          // 读出的有效记录字节数
+    uint64_t records;        // 批次个数
+    uint64_t updates;        // 更新条数
+    uint64_t dropped_bytes;  // 因损坏被跳过的字节数
+    uint64_t micros;
+    SequenceNumber max_sequence;  // 见到的最大序列号
+};
+
+/**
+ * @brief 把日志文件 fname 中的所有批次插入 mem
+ * @param pipelined 为 true 时由后台线程读文件、校验 crc、切分记录, 当前线程同时解析批次并插入 memtable
+ * @param paranoid 为 true 时遇到损坏立即返回 Corruption, 否则跳过损坏的数据继续重放
+ * @param stats 累加本次重放的统计
+ */
+Status ReplayLogFile(Env* env, const std::string& fname, MemTable* mem, bool pipelined,
+                     bool paranoid, LogReplayStats* stats);
+
+}   // namespace leveldb
+
+/**
+ * 流水线重放
+ *  读取线程: 顺序读 32KB 块, 校验 crc, 拼接跨块记录, 攒够约 1MB 记录打包交给插入线程
+ *  插入线程: 解析 WriteBatch, 按序列号插入 memtable
+ *
+ * 两个阶段之间是一个容量有限的队列, 读得快时读取线程阻塞, 不会把整个日志读进内存
+ * 用完的包回收给读取线程复用, 稳定之后不再分配记录缓冲
+ * memtable 的插入本身只有一个线程, 批次必须按日志顺序插入才能保证同一个键的版本顺序
+ */
@@ -0,0 +1,135 @@
+/**
+ * @file log_writer.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "log_writer.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/crc32c.h"
+#include "../../include/leveldb/env.h"
+
+namespace leveldb {
+namespace log {
+
+static void InitTypeCrc(uint32_t* type_crc) {
+    for(int i = 0; i <= kMaxRecordType; i++) {
+        char t = static_cast<char>(i);
+        type_crc[i] = crc32c::Value(&t, 1);
+    }
+}
+
+Writer::Writer(WritableFile* dest) : dest_(dest), block_offset_(0) { InitTypeCrc(type_crc_); }
+
+Writer::Writer(WritableFile* dest, uint64_t dest_length)
+    : dest_(dest), block_offset_(dest_length % kBlockSize) {
+    InitTypeCrc(type_crc_);
+}
+
+Writer::~Writer() = default;
+
+Status Writer::AddRecord(const Slice& slice) { return AddRecord(&slice, 1); }
+
+Status Writer::AddRecord(const Slice* parts, size_t n) {
+    size_t left = 0;
+    for(size_t i = 0; i < n; i++) left += parts[i].size();
+    size_t part = 0;
+    size_t offset = 0;
+
+    // 必要时切分记录; 空记录也要写出一个长度为 0 的片段
+    Status s;
+    bool begin = true;
+    do {
+        const int leftover = kBlockSize - block_offset_;
+        assert(leftover >= 0);
+        if(leftover < kHeaderSize) {
+            // 块尾放不下头部, 补 0 后换到下一个块
+            if(leftover > 0) {
+                static_assert(kHeaderSize == 7, "");
+                dest_->Append(Slice("\x00\x00\x00\x00\x00\x00", leftover));
+            }
+            block_offset_ = 0;
+        }
+
+        // 这里不会出现块尾剩余空间小于 kHeaderSize 的情况
+        assert(kBlockSize - block_offset_ - kHeaderSize >= 0);
+
+        const size_t avail = kBlockSize - block_offset_ - kHeaderSize;
+        const size_t fragment_length = (left < avail) ? left : avail;
+
+        RecordType type;
+        const bool end = (left == fragment_length);
+        if(begin && end) {
+            type = kFullType;
+        } else if(begin) {
+            type = kFirstType;
+        } else if(end) {
+            type = kLastType;
+        } else {
+            type = kMiddleType;
+        }
+
+        s = EmitPhysicalRecord(type, parts, &part, &offset, fragment_length);
+        left -= fragment_length;
+        begin = false;
+    } while(s.ok() && left > 0);
+    return s;
+}
+
+Status Writer::EmitPhysicalRecord(RecordType t, const Slice* parts, size_t* part, size_t* offset,
+                                  size_t length) {
+    assert(length <= 0xffff);  // 长度必须放得进两个字节
+    assert(block_offset_ + kHeaderSize + length <= static_cast<size_t>(kBlockSize));
+
+    char buf[kHeaderSize];
+    buf[4] = static_cast<char>(length & 0xff);
+    buf[5] = static_cast<char>(length >> 8);
+    buf[6] = static_cast<char>(t);
+
+    // 第一遍计算校验, 覆盖类型和数据; 片段可能由多个 part 的一部分组成
+    uint32_t crc = type_crc_[t];
+    size_t p = *part, o = *offset, remaining = length;
+    while(remaining > 0) {
+        if(o == parts[p].size()) {
+            p++;
+            o = 0;
+            continue;
+        }
+        const size_t take = std::min(remaining, parts[p].size() - o);
+        crc = crc32c::Extend(crc, parts[p].data() + o, take);
+        o += take;
+        remaining -= take;
+    }
+    crc = crc32c::Mask(crc);
+    EncodeFixed32(buf, crc);
+
+    // 第二遍把头部和各段数据交给文件
+    Status s = dest_->Append(Slice(buf, kHeaderSize));
+    remaining = length;
+    while(s.ok() && remaining > 0) {
+        if(*offset == parts[*part].size()) {
+            (*part)++;
+            *offset = 0;
+            continue;
+        }
+        const size_t take = std::min(remaining, parts[*part].size() - *offset);
+        s = dest_->Append(Slice(parts[*part].data() + *offset, take));
+        *offset += take;
+        remaining -= take;
+    }
+    if(s.ok()) s = dest_->Flush();
+    block_offset_ += kHeaderSize + length;
+    return s;
+}
+
+}   // namespace log
+}   // namespace leveldb
@@ -0,0 +1,66 @@
+/**
+ * @file log_writer.h
+ * @author alongnice
+ * @brief 预写日志的写入端, 把记录切成片段写入 32KB 的物理块
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+#include "log_format.h"
+#include "slice.h"
+#include "status.h"
+
+namespace leveldb {
+
+class WritableFile;
+
+namespace log {
+
+class Writer {
+public:
+    /**
+     * @brief 向 dest 追加记录, dest 必须初始为空, 且在 Writer 使用期间保持有效
+     */
+    explicit Writer(WritableFile* dest);
+
+    /**
+     * @brief 向 dest 追加记录, dest 当前长度为 dest_length, 用于接着已有的日志继续写
+     */
+    Writer(WritableFile* dest, uint64_t dest_length);
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    ~Writer();
+
+    // 追加一条记录, 返回之前数据已经交给文件, 是否落盘由调用方决定是否 Sync
+    Status AddRecord(const Slice& slice);
+
+    /**
+     * @brief 把 parts[0, n-1] 依次拼接起来作为一条记录追加, 与先拼接再 AddRecord 写出的字节完全相同
+     *  各段直接交给文件, 调用方不需要先把它们拷贝到一块连续的缓冲里
+     */
+    Status AddRecord(const Slice* parts, size_t n);
+
+private:
+    /**
+     * @brief 从 (*part, *offset) 处取 length 字节写成一个片段, 可以跨越多个 part, 写完后推进位置
+     */
+    Status EmitPhysicalRecord(RecordType type, const Slice* parts, size_t* part, size_t* offset,
+                              size_t length);
+
+    WritableFile* dest_;
+    int block_offset_;  // 当前块内的写入位置
+
+    // 所有类型值预先算好的 crc32c, 减少每个片段的计算量
+    uint32_t type_crc_[kMaxRecordType + 1];
+};
+
+}   // namespace log
+}   // namespace leveldb
@@ -0,0 +1,176 @@
+/**
+ * @file memtable.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "memtable.h"
+
+#include <algorithm>
+
+namespace leveldb {
+
+/**
+ * @brief 解析带长度前缀的 Slice
+ */
+static Slice GetLengthPrefixedSlice(const char* data) {
+    uint32_t len;
+    const char* p = data;
+    p = GetVarint32Ptr(p, p + 5, &len);  // +5: 假定 varint32 合法
+    return Slice(p, len);
+}
+
+// arena 的块交给进程级回收站, 下一个 memtable 可以直接复用, 减少轮转时的分配和缺页
+MemTable::MemTable(const InternalKeyComparator& comparator)
+    : comparator_(comparator), refs_(0),
+      arena_(ConcurrentArena::kDefaultShardBlockSize, Arena::kDefaultBlockSize, 0,
+             BlockRecycler::Default()),
+      table_(comparator_, &arena_) {}
+
+MemTable::~MemTable() { assert(refs_ == 0); }
+
+size_t MemTable::ApproximateMemoryUsage() { return arena_.MemoryUsage(); }
+
+int MemTable::KeyComparator::operator()(const char* aptr, const char* bptr) const {
+    // 解出内部键再比较
+    Slice a = GetLengthPrefixedSlice(aptr);
+    Slice b = GetLengthPrefixedSlice(bptr);
+    // 字典序比较器直接内联, 其他比较器退回虚函数调用; 分支对同一个表恒定, 预测几乎不会失败
+    if(comparator.user_is_bytewise()) return CompareInternalKeys(BytewiseCompare(), a, b);
+    return CompareInternalKeys(VirtualCompare(comparator.user_comparator()), a, b);
+}
+
+uint64_t MemTable::KeyComparator::KeyPrefix(const char* entry) const {
+    if(!comparator.user_is_bytewise()) return 0;
+    Slice user_key = ExtractUserKey(GetLengthPrefixedSlice(entry));
+    // 不足 8 字节的用户键补 0: 补出来的 0 只会让前缀相等, 不会颠倒顺序
+    char buf[8] = {0};
+    std::memcpy(buf, user_key.data(), user_key.size() < 8 ? user_key.size() : 8);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(buf);
+    return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+           (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+           (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+           (static_cast<uint64_t>(p[6]) << 8) | static_cast<uint64_t>(p[7]);
+}
+
+const char* MemTable::EncodeEntry(SequenceNumber s, ValueType type, const Slice& key,
+                                  const Slice& value) {
+    size_t key_size = key.size();
+    size_t val_size = value.size();
+    size_t internal_key_size = key_size + 8;
+    const size_t encoded_len = VarintLength(internal_key_size) + internal_key_size +
+                               VarintLength(val_size) + val_size;
+    // 整条记录一次分配
+    char* buf = arena_.Allocate(encoded_len);
+    char* p = EncodeVarint32(buf, internal_key_size);
+    std::memcpy(p, key.data(), key_size);
+    p += key_size;
+    EncodeFixed64(p, PackSequenceAndType(s, type));
+    p += 8;
+    p = EncodeVarint32(p, val_size);
+    std::memcpy(p, value.data(), val_size);
+    assert(p + val_size == buf + encoded_len);
+    return buf;
+}
+
+void MemTable::Add(SequenceNumber s, ValueType type, const Slice& key, const Slice& value) {
+    table_.Insert(EncodeEntry(s, type, key, value));
+}
+
+void MemTable::AddConcurrently(SequenceNumber s, ValueType type, const Slice& key,
+                               const Slice& value) {
+    table_.InsertConcurrently(EncodeEntry(s, type, key, value));
+}
+
+void MemTable::AddPending(SequenceNumber s, ValueType type, const Slice& key,
+                          const Slice& value) {
+    pending_.push_back(EncodeEntry(s, type, key, value));
+}
+
+void MemTable::InsertPending() {
+    const KeyComparator& cmp = comparator_;
+    std::sort(pending_.begin(), pending_.end(),
+              [&cmp](const char* a, const char* b) { return cmp(a, b) < 0; });
+    table_.InsertBatch(pending_.data(), pending_.size());
+    pending_.clear();
+}
+
+bool MemTable::Get(const LookupKey& key, std::string* value, Status* s) {
+    Slice memkey = key.memtable_key();
+    Table::Iterator iter(&table_);
+    iter.Seek(memkey.data());
+    if(iter.Valid()) {
+        // 记录格式:
+        //    klength  varint32
+        //    userkey  char[klength - 8]
+        //    tag      uint64
+        //    vlength  varint32
+        //    value    char[vlength]
+        // Seek 已经跳过了序列号更大(对当前快照不可见)的版本, 只需确认用户键相同
+        const char* entry = iter.key();
+        uint32_t key_length;
+        const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+        if(comparator_.comparator.user_is_bytewise()
+               ? Slice(key_ptr, key_length - 8) == key.user_key()
+               : comparator_.comparator.user_comparator()->Compare(
+                     Slice(key_ptr, key_length - 8), key.user_key()) == 0) {
+            const uint64_t tag = DecodeFixed64(key_ptr + key_length - 8);
+            switch(static_cast<ValueType>(tag & 0xff)) {
+                case kTypeValue: {
+                    Slice v = GetLengthPrefixedSlice(key_ptr + key_length);
+                    value->assign(v.data(), v.size());
+                    return true;
+                }
+                case kTypeDeletion:
+                    *s = Status::NotFound(Slice());
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 把内部键编码成跳表中的带长度前缀的格式
+static const char* EncodeKey(std::string* scratch, const Slice& target) {
+    scratch->clear();
+    PutVarint32(scratch, target.size());
+    scratch->append(target.data(), target.size());
+    return scratch->data();
+}
+
+class MemTableIterator : public Iterator {
+public:
+    explicit MemTableIterator(MemTable::Table* table) : iter_(table) {}
+
+    MemTableIterator(const MemTableIterator&) = delete;
+    MemTableIterator& operator=(const MemTableIterator&) = delete;
+
+    ~MemTableIterator() override = default;
+
+    bool Valid() const override { return iter_.Valid(); }
+    void Seek(const Slice& k) override { iter_.Seek(EncodeKey(&tmp_, k)); }
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+    void SeekToLast() override { iter_.SeekToLast(); }
+    void Next() override { iter_.Next(); }
+    void Prev() override { iter_.Prev(); }
+    Slice key() const override { return GetLengthPrefixedSlice(iter_.key()); }
+    Slice value() const override {
+        Slice key_slice = GetLengthPrefixedSlice(iter_.key());
+        return GetLengthPrefixedSlice(key_slice.data() + key_slice.size());
+    }
+
+    Status status() const override { return Status::OK(); }
+
+private:
+    MemTable::Table::Iterator iter_;
+    std::string tmp_;  // Seek 时编码目标键
+};
+
+Iterator* MemTable::NewIterator() { return new MemTableIterator(&table_); }
+
+}   // namespace leveldb
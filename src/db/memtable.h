@@ -0,0 +1,131 @@
+/**
+ * @file memtable.h
+ * @author alongnice
+ * @brief 内存表, 基于跳表吸收写入, 所有键值都从 arena 中分配
+ *  除了 arena 的指针递增之外, 每次插入不产生额外的内存分配
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "concurrent_arena.h"
+#include "dbformat.h"
+#include "iterator.h"
+#include "skiplist.h"
+#include "status.h"
+
+namespace leveldb {
+
+class MemTable {
+public:
+    /**
+     * @brief 构造函数, 引用计数初始为 0, 调用方至少要 Ref() 一次
+     * @param comparator 内部键比较器
+     */
+    explicit MemTable(const InternalKeyComparator& comparator);
+
+    MemTable(const MemTable&) = delete;
+    MemTable& operator=(const MemTable&) = delete;
+
+    // 增加引用计数
+    void Ref() { ++refs_; }
+
+    // 减少引用计数, 归零时删除自身
+    void Unref() {
+        --refs_;
+        assert(refs_ >= 0);
+        if(refs_ <= 0) delete this;
+    }
+
+    /**
+     * @brief 估算已使用的内存字节数, 可以在修改过程中调用
+     * @return size_t
+     */
+    size_t ApproximateMemoryUsage();
+
+    /**
+     * @brief 添加一条记录, 删除操作 type 为 kTypeDeletion 且 value 通常为空
+     *  需要外部保证单写者
+     */
+    void Add(SequenceNumber seq, ValueType type, const Slice& key, const Slice& value);
+
+    /**
+     * @brief 与 Add 相同, 但可以被多个写线程同时调用; 同一时间内所有写入必须都走这个接口
+     *  用于组提交: 日志写完后组内各写线程并发插入各自的批次
+     */
+    void AddConcurrently(SequenceNumber seq, ValueType type, const Slice& key, const Slice& value);
+
+    /**
+     * @brief 只把记录编码进 arena, 暂不插入跳表, 之后由 InsertPending 统一插入
+     *  用于日志重放: 攒下一大批记录排序后批量插入, 相邻的插入位置可以沿用前一次的查找结果
+     *  暂存的记录在 InsertPending 之前对 Get 不可见, 需要外部保证单写者
+     */
+    void AddPending(SequenceNumber seq, ValueType type, const Slice& key, const Slice& value);
+
+    // 把所有暂存的记录按内部键排序后批量插入跳表
+    void InsertPending();
+
+    /**
+     * @brief 查找
+     * @param key 查找键
+     * @param value 找到值时写入
+     * @param s 找到删除标记时写入 NotFound
+     * @return true 找到值或删除标记
+     * @return false 表中没有该键的任何版本
+     */
+    bool Get(const LookupKey& key, std::string* value, Status* s);
+
+    /**
+     * @brief 按内部键顺序遍历表中的记录, key() 返回内部键
+     *  调用方负责删除; 迭代器存活期间 memtable 必须保持引用
+     *  表可以同时有写入, 新插入的记录可能看得到也可能看不到
+     */
+    Iterator* NewIterator();
+
+private:
+    friend class MemTableIterator;
+
+    ~MemTable();  // 只能通过 Unref() 删除
+
+    /**
+     * @brief 跳表中存的是带长度前缀的内部键指针, 比较时先解出内部键
+     */
+    struct KeyComparator {
+        const InternalKeyComparator comparator;
+        explicit KeyComparator(const InternalKeyComparator& c) : comparator(c) {}
+        int operator()(const char* a, const char* b) const;
+        // 用户键前 8 字节的大端值, 缓存在跳表节点中; 非字典序比较器返回 0, 总是退回完整比较
+        uint64_t KeyPrefix(const char* entry) const;
+    };
+
+    typedef SkipList<const char*, KeyComparator, ConcurrentArena> Table;
+
+    // 在 arena 中编码一条记录, 返回记录首地址
+    const char* EncodeEntry(SequenceNumber seq, ValueType type, const Slice& key, const Slice& value);
+
+    KeyComparator comparator_;
+    int refs_;
+    ConcurrentArena arena_;
+    Table table_;
+    std::vector<const char*> pending_;  // AddPending 暂存的记录
+};
+
+}   // namespace leveldb
+
+/**
+ * 单条记录在 arena 中的布局:
+ *  key_size     : varint32(internal_key.size())
+ *  key bytes    : char[internal_key.size()]  (user_key + tag)
+ *  value_size   : varint32(value.size())
+ *  value bytes  : char[value.size()]
+ *
+ * 一整条记录一次性从 arena 中分配, 跳表节点只保存指向记录首地址的指针
+ * arena 使用 ConcurrentArena: 单写者时每次分配只多一次无竞争的 CAS, 组提交时多个写线程可以直接并发插入
+ * 读取时通过长度前缀定位 value, 不需要额外的索引结构
+ */
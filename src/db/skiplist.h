@@ -14,17 +14,69 @@
 #include <atomic>
 #include <iterator>
 #include <cassert>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 #include "arena.h"
+#include "concurrent_arena.h"
 #include "random.h"
 
 namespace leveldb {
-template <typename Key, class Comparator>
+
+/**
+ * @brief 检测比较器是否提供 uint64_t KeyPrefix(const Key&) const
+ *  KeyPrefix 必须保序: prefix(a) < prefix(b) 时 a < b, prefix(a) > prefix(b) 时 a > b,
+ *  相等时不做任何保证, 由完整比较决定
+ */
+template <class Comparator, typename Key>
+struct HasKeyPrefix {
+private:
+    template <class C>
+    static auto Test(int) -> decltype(std::declval<const C&>().KeyPrefix(std::declval<const Key&>()),
+                                      std::true_type());
+    template <class C>
+    static std::false_type Test(...);
+public:
+    static const bool value = decltype(Test<Comparator>(0))::value;
+};
+
+template <class Comparator, typename Key>
+const bool HasKeyPrefix<Comparator, Key>::value;
+
+// 预取节点到缓存, 只读且时间局部性高
+inline void PrefetchNode(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+    if(addr != nullptr) __builtin_prefetch(addr, 0, 3);
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * @brief 节点内联的键前缀, 比较器没有 KeyPrefix 时为空基类, 不占空间
+ */
+template <bool kEnabled>
+struct SkipListNodePrefix {
+    void SetPrefix(uint64_t) {}
+};
+
+template <>
+struct SkipListNodePrefix<true> {
+    void SetPrefix(uint64_t p) { prefix = p; }
+    uint64_t prefix;
+};
+
+template <typename Key, class Comparator, class Allocator = Arena>
 class SkipList {
 private:
     struct Node;
+    enum { kMaxHeight = 12 }; // 跳表的最大高度
 public:
-    explicit SkipList(Comparator cmp, Arena* arena);
+    explicit SkipList(Comparator cmp, Allocator* arena);
 
     SkipList(const SkipList&) = delete; // 禁止拷贝构造
     SkipList& operator=(const SkipList&) = delete; // 禁止拷贝赋值
@@ -36,6 +88,31 @@ public:
      */
     void Insert(const Key& key);
 
+    /**
+     * @brief 并发插入, 允许多个写线程同时调用, 读线程不受影响
+     *  每一层用 CAS 从底向上拼接, max_height_ 也用 CAS 抬升
+     *  不能与 Insert() 同时调用, 并且同一个 key 不能被重复插入
+     * @param key
+     */
+    void InsertConcurrently(const Key& key);
+
+    /**
+     * @brief 批量插入一段严格升序的键
+     *  上一个键的各层前驱(prev[])作为指针继续使用, 每次只在局部向前查找, 不必从 head_ 重新开始
+     *  与 Insert 一样需要外部保证单写者, 批内的键不能与表中已有的键重复
+     * @param keys 升序键数组
+     * @param n 个数
+     */
+    void InsertBatch(const Key* keys, size_t n);
+
+    /**
+     * @brief 从一段严格升序的键直接构造跳表, 只用于空表, 总代价 O(n)
+     *  每层维护一个尾指针, 新节点直接挂在各层末尾, 不做任何查找, 用于日志回放和批量导入
+     * @param keys 升序键数组
+     * @param n 个数
+     */
+    void BuildFromSorted(const Key* keys, size_t n);
+
     /**
      * @brief 查看
      * 
@@ -45,45 +122,94 @@ public:
      */
     bool Contains(const Key& key) const;
 
+    /**
+     * @brief 迭代器, 记录当前节点在每一层的前驱(finger)
+     *  Prev() 利用前驱指针局部回退, 期望 O(1); 向后的相邻 Seek() 从 finger 出发, 期望 O(log d)
+     *  d 为与当前位置的距离; 向前(更小的键)Seek 退回从 head_ 开始的完整查找
+     */
     class Iterator {
+    public:
         explicit Iterator(const SkipList* list);
         bool Valid() const;
         const Key& key() const;
         void Next();
         void Prev();
         void Seek(const Key& target);
-        void SeedToFirst();
+        void SeekToFirst();
         void SeekToLast();
 
         private:
+            // 各层前驱全部指向 head_
+            void ResetFinger();
+
             const SkipList* list_;
             Node* node_;
+            // prev_[i] 是第 i 层上键小于 node_ 的某个节点, 通常就是最后一个
+            // 并发插入可能使它不再是最后一个, 但始终小于 node_, 所以总能作为查找起点
+            Node* prev_[kMaxHeight];
     };
 
     private:
-        enum { kMaxHeight = 12 }; // 跳表的最大高度
         // inline int GetMaxHeight() const { return kMaxHeight; }
         // 区别时后一种是动态的原子变量 可以在运行时进行调整
         inline int GetMaxHeight() const {return max_height_.load(std::memory_order_relaxed);}
 
         Node* NewNode(const Key& key, int height);
         int RandomHeight();
+        // 并发插入使用的线程局部随机数, 避免多个写者争用 rnd_
+        int RandomHeightConcurrently();
+        Node* NewNodeConcurrently(const Key& key, int height);
+        // 按分配器类型选择: Arena 需要加锁, ConcurrentArena 直接无锁分配
+        char* AllocateConcurrently(Arena* arena, size_t bytes);
+        char* AllocateConcurrently(ConcurrentArena* arena, size_t bytes);
         bool Equal(const Key& a, const Key& b) const { return (compare_(a, b) == 0); }
 
+        typedef std::integral_constant<bool, HasKeyPrefix<Comparator, Key>::value> UsePrefix;
+
+        // 查找键的前缀, 每次查找只算一次
+        uint64_t KeyPrefix(const Key& key) const { return KeyPrefix(key, UsePrefix()); }
+        uint64_t KeyPrefix(const Key& key, std::true_type) const { return compare_.KeyPrefix(key); }
+        uint64_t KeyPrefix(const Key&, std::false_type) const { return 0; }
+
+        // 节点 n 的键与 key 比较, 前缀能区分时不访问节点外的键
+        int CompareNodeToKey(Node* n, const Key& key, uint64_t key_prefix) const {
+            return CompareNodeToKey(n, key, key_prefix, UsePrefix());
+        }
+        int CompareNodeToKey(Node* n, const Key& key, uint64_t key_prefix, std::true_type) const {
+            if(n->prefix < key_prefix) return -1;
+            if(n->prefix > key_prefix) return +1;
+            return compare_(n->key, key);
+        }
+        int CompareNodeToKey(Node* n, const Key& key, uint64_t, std::false_type) const {
+            return compare_(n->key, key);
+        }
+
+        // key 是否大于节点 n 的键(n 为空视为无穷大)
+        bool KeyIsAfterNode(const Key& key, uint64_t key_prefix, Node* n) const;
+
         Node* FindGreaterOrEqual(const Key& key, Node** prev) const;
+        // finger[i] 都小于 key 时, 从 finger 出发局部查找并把 finger 更新为 key 的各层前驱
+        Node* FindGreaterOrEqualFromFinger(const Key& key, Node** finger) const;
         Node* FindLessThan(const Key& key) const;
         Node* FindLast() const;
+        // 从 before 出发在 level 层找到 key 的前驱和后继
+        void FindSpliceForLevel(const Key& key, uint64_t key_prefix, Node* before, int level,
+                                Node** out_prev, Node** out_next) const;
 
         Comparator compare_;
-        Arena* arena_;
+        Allocator* arena_;
         Node* head_; // 跳表的头节点
 
         std::atomic<int> max_height_;
         Random rnd_; // 随机数生成器
+        std::mutex arena_mu_; // Arena 本身不是线程安全的, 并发插入时保护节点分配
 };  // class SkipList
 
-template <typename Key, class Comparator>
-struct SkipList<Key, Comparator>::Node {
+// 节点布局: [prefix] | key | next_[0] | next_[1] ..., 前缀是基类成员, 排在 key 之前
+// 绝大多数节点高度为 1~2, 前缀、key 和低层指针落在同一个缓存行内
+template <typename Key, class Comparator, class Allocator>
+struct SkipList<Key, Comparator, Allocator>::Node
+    : public SkipListNodePrefix<HasKeyPrefix<Comparator, Key>::value> {
     explicit Node(const Key& k) : key(k) {}
 
     Key const key;
@@ -106,65 +232,110 @@ struct SkipList<Key, Comparator>::Node {
         assert(n >= 0);
         next_[n].store(x, std::memory_order_relaxed);
     }
+
+    // 仅当第 n 层后继仍为 expected 时才替换为 x
+    bool CASNext(int n, Node* expected, Node* x){
+        assert(n >= 0);
+        return next_[n].compare_exchange_strong(expected, x, std::memory_order_release,
+                                                std::memory_order_relaxed);
+    }
 private:
     std::atomic<Node*> next_[1]; // Flexible array member
 };
 
-template <typename Key, class Comparator>
-typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::NewNode(const Key& key, int height) {
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::NewNode(const Key& key, int height) {
     char* const node_mem = arena_->AllocateAligned(
         sizeof(Node) + sizeof(std::atomic<Node*>) * (height - 1));
     return new (node_mem) Node(key);
 }
 
-template <typename Key, class Comparator>
-inline SkipList<Key, Comparator>::Iterator::Iterator(const SkipList* list) {
+template <typename Key, class Comparator, class Allocator>
+inline SkipList<Key, Comparator, Allocator>::Iterator::Iterator(const SkipList* list) {
     list_ = list;
     node_ = nullptr;
+    ResetFinger();
 }
 
-template <typename Key, class Comparator>
-inline bool SkipList<Key, Comparator>::Iterator::Valid() const {
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::ResetFinger() {
+    for(int i = 0; i < kMaxHeight; i++) prev_[i] = list_->head_;
+}
+
+template <typename Key, class Comparator, class Allocator>
+inline bool SkipList<Key, Comparator, Allocator>::Iterator::Valid() const {
     return node_ != nullptr;
 }
 
-template <typename Key, class Comparator>
-inline const Key& SkipList<Key, Comparator>::Iterator::key() const {
+template <typename Key, class Comparator, class Allocator>
+inline const Key& SkipList<Key, Comparator, Allocator>::Iterator::key() const {
     assert(Valid());
     return node_->key;
 }
 
-template <typename Key, class Comparator>
-inline void SkipList<Key, Comparator>::Iterator::Next() {
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::Next() {
     assert(Valid());
-    node_ = node_->Next(0);
+    Node* old = node_;
+    node_ = old->Next(0);
+    // old 所在的层(从 0 层开始连续)上, old 就是新节点的前驱
+    // 节点不记录高度, 用 "前驱的后继就是 old" 来判断 old 是否在该层
+    for(int i = 0; i < kMaxHeight && prev_[i]->Next(i) == old; i++) prev_[i] = old;
 }
 
-template <typename Key, class Comparator>
-inline void SkipList<Key, Comparator>::Iterator::Prev() {
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::Prev() {
     assert(Valid());
-    node_ = list_->FindLessThan(node_->key);
-    if(node_ == list_->head_) node_ = nullptr;
+    Node* target = node_;
+    // 0 层前驱可能因为并发插入不再紧挨着 target, 先向前追上; 不需要任何键比较
+    while(prev_[0]->Next(0) != target) prev_[0] = prev_[0]->Next(0);
+    Node* n = prev_[0];
+    if(n == list_->head_) {
+        node_ = nullptr;
+        return;
+    }
+    // 新位置 n 的各层前驱: prev_[i] == n 说明 n 在第 i 层, 需要从上一层的前驱出发走到 n 之前
+    // 其余层的 prev_[i] 本来就小于 n, 保持不变
+    for(int i = kMaxHeight - 1; i >= 0; i--) {
+        if(prev_[i] != n) continue;
+        Node* x = (i + 1 < kMaxHeight) ? prev_[i + 1] : list_->head_;
+        while(x->Next(i) != n) x = x->Next(i);
+        prev_[i] = x;
+    }
+    node_ = n;
 }
 
-template <typename Key, class Comparator>
-inline void SkipList<Key, Comparator>::Iterator::Seek(const Key& target) {
-    node_ = list_->FindGreaterOrEqual(target, nullptr);
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::Seek(const Key& target) {
+    if(Valid() && list_->compare_(node_->key, target) <= 0) {
+        // 向后查找, 当前的 finger 都小于 target
+        node_ = list_->FindGreaterOrEqualFromFinger(target, prev_);
+    } else {
+        ResetFinger();
+        node_ = list_->FindGreaterOrEqual(target, prev_);
+    }
 }
 
-template <typename Key, class Comparator>
-inline void SkipList<Key, Comparator>::Iterator::SeekToFirst() {
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::SeekToFirst() {
+    ResetFinger();
     node_ = list_->head_->Next(0);
 }
 
-template <typename Key, class Comparator>
-inline void SkipList<Key, Comparator>::Iterator::SeekToLast() {
-    node_ = list_->FindLast();
-    if(node_ == list_->head_) node_ = nullptr;
+template <typename Key, class Comparator, class Allocator>
+inline void SkipList<Key, Comparator, Allocator>::Iterator::SeekToLast() {
+    Node* last = list_->FindLast();
+    ResetFinger();
+    if(last == list_->head_) {
+        node_ = nullptr;
+        return;
+    }
+    // 重新查找一次以得到最后一个节点的各层前驱, 反向遍历只在开始时付出这一次代价
+    node_ = list_->FindGreaterOrEqual(last->key, prev_);
 }
 
-template <typename Key, class Comparator>
-int SkipList<Key, Comparator>::RandomHeight() {
+template <typename Key, class Comparator, class Allocator>
+int SkipList<Key, Comparator, Allocator>::RandomHeight() {
     static const unsigned int kBranching = 4;
     int height = 1;
     while(height < kMaxHeight && rnd_.OneIn(kBranching)) height++;
@@ -174,19 +345,54 @@ int SkipList<Key, Comparator>::RandomHeight() {
     return height;
 }
 
-template <typename Key, class Comparator>
-bool SkipList<Key, Comparator>::KeyIsAfterNode(const Key& key, Node* n) const {
-    return (n != nullptr) && (compare_(n->key, key) < 0);
+template <typename Key, class Comparator, class Allocator>
+int SkipList<Key, Comparator, Allocator>::RandomHeightConcurrently() {
+    static const unsigned int kBranching = 4;
+    // 每个线程独立的种子, 防止各线程生成完全相同的高度序列
+    static thread_local Random rnd(
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    int height = 1;
+    while(height < kMaxHeight && rnd.OneIn(kBranching)) height++;
+
+    assert(height > 0);
+    assert(height <= kMaxHeight);
+    return height;
+}
+
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::NewNodeConcurrently(const Key& key, int height) {
+    char* const node_mem = AllocateConcurrently(
+        arena_, sizeof(Node) + sizeof(std::atomic<Node*>) * (height - 1));
+    return new (node_mem) Node(key);
+}
+
+template <typename Key, class Comparator, class Allocator>
+char* SkipList<Key, Comparator, Allocator>::AllocateConcurrently(Arena* arena, size_t bytes) {
+    std::lock_guard<std::mutex> l(arena_mu_);
+    return arena->AllocateAligned(bytes);
 }
 
-template <typename Key, class Comparator>
-typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::FindGreaterOrEqual(const Key& key, Node** prev)
+template <typename Key, class Comparator, class Allocator>
+char* SkipList<Key, Comparator, Allocator>::AllocateConcurrently(ConcurrentArena* arena, size_t bytes) {
+    return arena->AllocateAligned(bytes);
+}
+
+template <typename Key, class Comparator, class Allocator>
+bool SkipList<Key, Comparator, Allocator>::KeyIsAfterNode(const Key& key, uint64_t key_prefix, Node* n) const {
+    return (n != nullptr) && (CompareNodeToKey(n, key, key_prefix) < 0);
+}
+
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::FindGreaterOrEqual(const Key& key, Node** prev)
     const {
     Node* x = head_;
     int level = GetMaxHeight() - 1;
+    const uint64_t key_prefix = KeyPrefix(key);
     while(true){
         Node* next = x->Next(level);
-        if(KeyIsAfterNode(key, next)) x = next;
+        // 比较 next 的同时预取它在本层的后继, 如果继续前进, 下一次比较就不会缓存未命中
+        if(next != nullptr) PrefetchNode(next->NoBarrier_Next(level));
+        if(KeyIsAfterNode(key, key_prefix, next)) x = next;
         else{
             if(prev != nullptr) prev[level] = x;
             if(level == 0) return next;
@@ -195,22 +401,62 @@ typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::FindGreater
     }
 }
 
-template <typename Key, class Comparator>
-typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::FindLessThan(const Key& key) const {
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::FindGreaterOrEqualFromFinger(
+    const Key& key, Node** finger) const {
+    const uint64_t key_prefix = KeyPrefix(key);
+    // 从第 0 层向上找到最高的"过期"层: 该层 finger 的后继已经小于 key
+    // 某层没过期时更高的层一般也没过期, 因为高层的后继不会比低层的更靠前
+    const int max_height = GetMaxHeight();
+    int level = 0;
+    while(level + 1 < max_height &&
+          KeyIsAfterNode(key, key_prefix, finger[level + 1]->Next(level + 1))) {
+        level++;
+    }
+    // 从该层开始向下局部查找, 更高的层 finger 保持不变(仍然小于 key)
+    Node* before = finger[level];
+    Node* next = nullptr;
+    for(int i = level; i >= 0; --i){
+        FindSpliceForLevel(key, key_prefix, before, i, &finger[i], &next);
+        before = finger[i];
+    }
+    return next;
+}
+
+template <typename Key, class Comparator, class Allocator>
+void SkipList<Key, Comparator, Allocator>::FindSpliceForLevel(const Key& key, uint64_t key_prefix,
+                                                              Node* before, int level,
+                                                              Node** out_prev, Node** out_next) const {
+    while(true){
+        Node* next = before->Next(level);
+        if(next != nullptr) PrefetchNode(next->NoBarrier_Next(level));
+        if(KeyIsAfterNode(key, key_prefix, next)) before = next;
+        else{
+            *out_prev = before;
+            *out_next = next;
+            return;
+        }
+    }
+}
+
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::FindLessThan(const Key& key) const {
     Node* x = head_;
     int level = GetMaxHeight() - 1;
+    const uint64_t key_prefix = KeyPrefix(key);
     while(true){
         assert(x == head_ || compare_(x->key, key) < 0);
         Node* next = x->Next(level);
-        if(next ==nullptr || compare_(next->key, key) >= 0){
+        if(next != nullptr) PrefetchNode(next->NoBarrier_Next(level));
+        if(next ==nullptr || CompareNodeToKey(next, key, key_prefix) >= 0){
             if(level == 0) return x;
             else level--;
         }else x = next;
     }
 }
 
-template <typename Key, class Comparator>
-typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::FindLast() const {
+template <typename Key, class Comparator, class Allocator>
+typename SkipList<Key, Comparator, Allocator>::Node* SkipList<Key, Comparator, Allocator>::FindLast() const {
     Node* x = head_;
     int level = GetMaxHeight() - 1;
     while(true){
@@ -222,8 +468,8 @@ typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::FindLast()
     }
 }
 
-template <typename Key, class Comparator>
-SkipList<Key, Comparator>::SkipList(Comparator cmp, Arena* arena) :
+template <typename Key, class Comparator, class Allocator>
+SkipList<Key, Comparator, Allocator>::SkipList(Comparator cmp, Allocator* arena) :
         compare_(cmp),
         arena_(arena),
         head_(NewNode(0, kMaxHeight)),
@@ -232,8 +478,8 @@ SkipList<Key, Comparator>::SkipList(Comparator cmp, Arena* arena) :
             for (int i = 0; i < kMaxHeight; i++) head_->SetNext(i, nullptr);
 }
 
-template <typename Key, class Comparator>
-void SkipList<Key, Comparator>::Insert(const Key& key) {
+template <typename Key, class Comparator, class Allocator>
+void SkipList<Key, Comparator, Allocator>::Insert(const Key& key) {
     Node* prev[kMaxHeight];
     Node* x = FindGreaterOrEqual(key, prev);
 
@@ -245,14 +491,106 @@ void SkipList<Key, Comparator>::Insert(const Key& key) {
         max_height_.store(height, std::memory_order_relaxed);
     }
     x = NewNode(key, height);
+    x->SetPrefix(KeyPrefix(key));
     for(int i=0; i < height; ++i){
         x->NoBarrier_SetNext(i, prev[i]->NoBarrier_Next(i));
         prev[i]->SetNext(i, x);
     }
 }
 
-template <typename Key, class Comparator>
-bool SkipList<Key, Comparator>::Contains(const Key& key) const {
+template <typename Key, class Comparator, class Allocator>
+void SkipList<Key, Comparator, Allocator>::InsertConcurrently(const Key& key) {
+    int height = RandomHeightConcurrently();
+
+    // CAS 抬升 max_height_, 失败时 max_height 会被更新为当前值
+    int max_height = max_height_.load(std::memory_order_relaxed);
+    while(height > max_height){
+        if(max_height_.compare_exchange_weak(max_height, height)){
+            max_height = height;
+            break;
+        }
+    }
+
+    // 从最高层向下计算每层的拼接位置
+    Node* prev[kMaxHeight];
+    Node* next[kMaxHeight];
+    Node* before = head_;
+    const uint64_t key_prefix = KeyPrefix(key);
+    for(int i = max_height - 1; i >= 0; --i){
+        FindSpliceForLevel(key, key_prefix, before, i, &prev[i], &next[i]);
+        before = prev[i];
+    }
+    assert(next[0] == nullptr || !Equal(key, next[0]->key));
+
+    Node* x = NewNodeConcurrently(key, height);
+    x->SetPrefix(key_prefix);
+    // 自底向上拼接: 读者在高层看到 x 时, 它的低层一定已经可达
+    for(int i = 0; i < height; ++i){
+        while(true){
+            x->NoBarrier_SetNext(i, next[i]);
+            if(prev[i]->CASNext(i, next[i], x)) break;
+            // 有其他写者抢先修改了 prev[i], 从 prev[i] 出发重新定位本层
+            FindSpliceForLevel(key, key_prefix, prev[i], i, &prev[i], &next[i]);
+        }
+    }
+}
+
+template <typename Key, class Comparator, class Allocator>
+void SkipList<Key, Comparator, Allocator>::InsertBatch(const Key* keys, size_t n) {
+    if(n == 0) return;
+    Node* prev[kMaxHeight];
+    // 第一个键正常查找, 当前最大高度以上的层前驱都是 head_
+    Node* x = FindGreaterOrEqual(keys[0], prev);
+    for(int i = GetMaxHeight(); i < kMaxHeight; ++i) prev[i] = head_;
+
+    for(size_t k = 0; k < n; ++k){
+        const Key& key = keys[k];
+        const uint64_t key_prefix = KeyPrefix(key);
+        if(k > 0){
+            assert(compare_(keys[k - 1], key) < 0);
+            x = FindGreaterOrEqualFromFinger(key, prev);
+        }
+        assert(x == nullptr || !Equal(key, x->key));
+
+        int height = RandomHeight();
+        if(height > GetMaxHeight()){
+            max_height_.store(height, std::memory_order_relaxed);
+        }
+        x = NewNode(key, height);
+        x->SetPrefix(key_prefix);
+        for(int i = 0; i < height; ++i){
+            x->NoBarrier_SetNext(i, prev[i]->NoBarrier_Next(i));
+            prev[i]->SetNext(i, x);
+            // 新节点就是下一个(更大的)键在这些层的前驱
+            prev[i] = x;
+        }
+    }
+}
+
+template <typename Key, class Comparator, class Allocator>
+void SkipList<Key, Comparator, Allocator>::BuildFromSorted(const Key* keys, size_t n) {
+    assert(head_->Next(0) == nullptr);
+    Node* tail[kMaxHeight];
+    for(int i = 0; i < kMaxHeight; ++i) tail[i] = head_;
+
+    for(size_t k = 0; k < n; ++k){
+        assert(k == 0 || compare_(keys[k - 1], keys[k]) < 0);
+        int height = RandomHeight();
+        if(height > GetMaxHeight()){
+            max_height_.store(height, std::memory_order_relaxed);
+        }
+        Node* x = NewNode(keys[k], height);
+        x->SetPrefix(KeyPrefix(keys[k]));
+        for(int i = 0; i < height; ++i){
+            x->NoBarrier_SetNext(i, nullptr);
+            tail[i]->SetNext(i, x);
+            tail[i] = x;
+        }
+    }
+}
+
+template <typename Key, class Comparator, class Allocator>
+bool SkipList<Key, Comparator, Allocator>::Contains(const Key& key) const {
     Node* x = FindGreaterOrEqual(key, nullptr);
     if(x != nullptr && Equal(key, x->key)) return true;
     else return false;
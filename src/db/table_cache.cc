@@ -0,0 +1,104 @@
+/**
+ * @file table_cache.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "table_cache.h"
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/table.h"
+#include "filename.h"
+
+namespace leveldb {
+
+// 缓存中的值: 表和它的文件, 一起打开一起删除
+struct TableAndFile {
+    RandomAccessFile* file;
+    Table* table;
+};
+
+static void DeleteEntry(const Slice& key, void* value) {
+    TableAndFile* tf = reinterpret_cast<TableAndFile*>(value);
+    delete tf->table;
+    delete tf->file;
+    delete tf;
+}
+
+static void UnrefEntry(void* arg1, void* arg2) {
+    Cache* cache = reinterpret_cast<Cache*>(arg1);
+    Cache::Handle* h = reinterpret_cast<Cache::Handle*>(arg2);
+    cache->Release(h);
+}
+
+TableCache::TableCache(const std::string& dbname, const Options& options, int entries)
+    : env_(options.env), dbname_(dbname), options_(options), cache_(NewLRUCache(entries)) {}
+
+TableCache::~TableCache() { delete cache_; }
+
+Status TableCache::FindTable(uint64_t file_number, uint64_t file_size, Cache::Handle** handle) {
+    char buf[sizeof(file_number)];
+    EncodeFixed64(buf, file_number);
+    Slice key(buf, sizeof(buf));
+    *handle = cache_->Lookup(key);
+    if(*handle != nullptr) return Status::OK();
+
+    const std::string fname = TableFileName(dbname_, file_number);
+    RandomAccessFile* file = nullptr;
+    Table* table = nullptr;
+    Status s = env_->NewRandomAccessFile(fname, &file);
+    if(s.ok()) s = Table::Open(options_, file, file_size, &table);
+
+    if(!s.ok()) {
+        // 不缓存失败的结果: 错误可能是暂时的, 或者有人修复了文件, 下次再试
+        assert(table == nullptr);
+        delete file;
+        return s;
+    }
+    TableAndFile* tf = new TableAndFile;
+    tf->file = file;
+    tf->table = table;
+    *handle = cache_->Insert(key, tf, 1, &DeleteEntry);
+    return s;
+}
+
+Iterator* TableCache::NewIterator(const ReadOptions& options, uint64_t file_number, uint64_t file_size,
+                                  Table** tableptr) {
+    if(tableptr != nullptr) *tableptr = nullptr;
+
+    Cache::Handle* handle = nullptr;
+    Status s = FindTable(file_number, file_size, &handle);
+    if(!s.ok()) return NewErrorIterator(s);
+
+    Table* table = reinterpret_cast<TableAndFile*>(cache_->Value(handle))->table;
+    Iterator* result = table->NewIterator(options);
+    result->RegisterCleanup(&UnrefEntry, cache_, handle);
+    if(tableptr != nullptr) *tableptr = table;
+    return result;
+}
+
+Status TableCache::Get(const ReadOptions& options, uint64_t file_number, uint64_t file_size, const Slice& k,
+                       void* arg, void (*handle_result)(void*, const Slice&, const Slice&)) {
+    Cache::Handle* handle = nullptr;
+    Status s = FindTable(file_number, file_size, &handle);
+    if(s.ok()) {
+        Table* t = reinterpret_cast<TableAndFile*>(cache_->Value(handle))->table;
+        s = t->InternalGet(options, k, arg, handle_result);
+        cache_->Release(handle);
+    }
+    return s;
+}
+
+void TableCache::Evict(uint64_t file_number) {
+    char buf[sizeof(file_number)];
+    EncodeFixed64(buf, file_number);
+    cache_->Erase(Slice(buf, sizeof(buf)));
+}
+
+}   // namespace leveldb
@@ -0,0 +1,63 @@
+/**
+ * @file table_cache.h
+ * @author alongnice
+ * @brief 表缓存: 按文件编号缓存打开的表文件和解析好的索引
+ *  每次读取都重新打开文件并解析索引块代价太大, 这里用一个 LRU 缓存控制同时打开的文件数
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "cache.h"
+#include "dbformat.h"
+#include "iterator.h"
+#include "options.h"
+
+namespace leveldb {
+
+class Env;
+class Table;
+
+class TableCache {
+public:
+    /**
+     * @param options 打开表时使用的选项, comparator 和 filter_policy 必须是作用于内部键的版本
+     * @param entries 最多同时打开的表文件数
+     */
+    TableCache(const std::string& dbname, const Options& options, int entries);
+
+    TableCache(const TableCache&) = delete;
+    TableCache& operator=(const TableCache&) = delete;
+
+    ~TableCache();
+
+    /**
+     * @brief 遍历编号为 file_number 的表, 迭代器存活期间表一直留在缓存中
+     * @param tableptr 非空时指向底层的表, 与迭代器的生命周期相同
+     */
+    Iterator* NewIterator(const ReadOptions& options, uint64_t file_number, uint64_t file_size,
+                          Table** tableptr = nullptr);
+
+    // 在表中查找第一个 >= k 的记录, 找到时调用 handle_result
+    Status Get(const ReadOptions& options, uint64_t file_number, uint64_t file_size, const Slice& k,
+               void* arg, void (*handle_result)(void*, const Slice&, const Slice&));
+
+    // 文件被删除之前把它从缓存中移除
+    void Evict(uint64_t file_number);
+
+private:
+    Status FindTable(uint64_t file_number, uint64_t file_size, Cache::Handle** handle);
+
+    Env* const env_;
+    const std::string dbname_;
+    const Options& options_;
+    Cache* cache_;
+};
+
+}   // namespace leveldb
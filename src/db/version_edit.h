@@ -0,0 +1,118 @@
+/**
+ * @file version_edit.h
+ * @author alongnice
+ * @brief 版本变更: 两个相邻版本之间增删了哪些文件, 以及日志编号、序列号等元数据
+ *  每次变更编码成一条记录追加到描述文件(MANIFEST), 打开时依次应用所有记录得到当前版本
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dbformat.h"
+#include "status.h"
+
+namespace leveldb {
+
+class VersionSet;
+
+// 一个表文件的元数据
+struct FileMetaData {
+    FileMetaData() : refs(0), allowed_seeks(1 << 30), number(0), file_size(0) {}
+
+    int refs;
+    int allowed_seeks;  // 剩余的无效查找次数, 用完之后触发对这个文件的压缩
+    uint64_t number;
+    uint64_t file_size;
+    InternalKey smallest;  // 表中最小的内部键
+    InternalKey largest;   // 表中最大的内部键
+};
+
+class VersionEdit {
+public:
+    VersionEdit() { Clear(); }
+    ~VersionEdit() = default;
+
+    void Clear();
+
+    void SetComparatorName(const Slice& name) {
+        has_comparator_ = true;
+        comparator_ = name.ToString();
+    }
+    void SetLogNumber(uint64_t num) {
+        has_log_number_ = true;
+        log_number_ = num;
+    }
+    void SetNextFile(uint64_t num) {
+        has_next_file_number_ = true;
+        next_file_number_ = num;
+    }
+    void SetLastSequence(SequenceNumber seq) {
+        has_last_sequence_ = true;
+        last_sequence_ = seq;
+    }
+    // level 层下一次压缩从 key 之后开始
+    void SetCompactPointer(int level, const InternalKey& key) {
+        compact_pointers_.push_back(std::make_pair(level, key));
+    }
+
+    /**
+     * @brief 在 level 层加入一个文件
+     *  要求: 变更还没有保存到描述文件; smallest 和 largest 是文件中最小和最大的键
+     */
+    void AddFile(int level, uint64_t file, uint64_t file_size, const InternalKey& smallest,
+                 const InternalKey& largest) {
+        FileMetaData f;
+        f.number = file;
+        f.file_size = file_size;
+        f.smallest = smallest;
+        f.largest = largest;
+        new_files_.push_back(std::make_pair(level, f));
+    }
+
+    // 从 level 层删除编号为 file 的文件
+    void RemoveFile(int level, uint64_t file) { deleted_files_.insert(std::make_pair(level, file)); }
+
+    void EncodeTo(std::string* dst) const;
+    Status DecodeFrom(const Slice& src);
+
+private:
+    friend class VersionSet;
+
+    typedef std::set<std::pair<int, uint64_t>> DeletedFileSet;
+
+    std::string comparator_;
+    uint64_t log_number_;
+    uint64_t next_file_number_;
+    SequenceNumber last_sequence_;
+    bool has_comparator_;
+    bool has_log_number_;
+    bool has_next_file_number_;
+    bool has_last_sequence_;
+
+    std::vector<std::pair<int, InternalKey>> compact_pointers_;
+    DeletedFileSet deleted_files_;
+    std::vector<std::pair<int, FileMetaData>> new_files_;
+};
+
+}   // namespace leveldb
+
+/**
+ * 编码格式: 一串 (tag, 字段) 对, tag 为 varint32, 只写出设置过的字段
+ *  kComparator     : 长度前缀的比较器名
+ *  kLogNumber      : varint64, 编号更小的日志中的数据都已经落到表文件
+ *  kNextFileNumber : varint64
+ *  kLastSequence   : varint64
+ *  kCompactPointer : varint32 层号 + 长度前缀的内部键
+ *  kDeletedFile    : varint32 层号 + varint64 文件编号
+ *  kNewFile        : varint32 层号 + varint64 编号 + varint64 大小 + 最小键 + 最大键
+ * tag 的取值写入了磁盘, 不能修改; 新字段只能使用新的 tag
+ */
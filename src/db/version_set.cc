@@ -0,0 +1,991 @@
+/**
+ * @file version_set.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "version_set.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/options.h"
+#include "filename.h"
+#include "log_reader.h"
+#include "log_writer.h"
+#include "merger.h"
+#include "table_cache.h"
+#include "two_level_iterator.h"
+
+namespace leveldb {
+
+static size_t TargetFileSize(const Options* options) { return options->max_file_size; }
+
+// 输出文件与 level+2 层的重叠超过这个字节数时切换到新的输出文件
+static int64_t MaxGrandParentOverlapBytes(const Options* options) { return 10 * TargetFileSize(options); }
+
+// 扩大 level 层输入时, 整个压缩的输入总量不超过这个字节数
+static int64_t ExpandedCompactionByteSizeLimit(const Options* options) { return 25 * TargetFileSize(options); }
+
+// L1 为 10MB, 之后每层是上一层的 10 倍; L0 按文件数计分, 不使用这个值
+static double MaxBytesForLevel(int level) {
+    double result = 10. * 1048576.0;
+    while(level > 1) {
+        result *= 10;
+        level--;
+    }
+    return result;
+}
+
+static int64_t TotalFileSize(const std::vector<FileMetaData*>& files) {
+    int64_t sum = 0;
+    for(size_t i = 0; i < files.size(); i++) sum += files[i]->file_size;
+    return sum;
+}
+
+Version::~Version() {
+    assert(refs_ == 0);
+
+    // 从链表中摘除
+    prev_->next_ = next_;
+    next_->prev_ = prev_;
+
+    for(int level = 0; level < config::kNumLevels; level++) {
+        for(size_t i = 0; i < files_[level].size(); i++) {
+            FileMetaData* f = files_[level][i];
+            assert(f->refs > 0);
+            f->refs--;
+            if(f->refs <= 0) delete f;
+        }
+    }
+}
+
+int FindFile(const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files, const Slice& key) {
+    uint32_t left = 0;
+    uint32_t right = files.size();
+    while(left < right) {
+        uint32_t mid = (left + right) / 2;
+        const FileMetaData* f = files[mid];
+        if(icmp.Compare(f->largest.Encode(), key) < 0) {
+            // mid 及之前的文件都在 key 之前
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return right;
+}
+
+static bool AfterFile(const Comparator* ucmp, const Slice* user_key, const FileMetaData* f) {
+    // user_key 为空表示在所有键之前
+    return (user_key != nullptr && ucmp->Compare(*user_key, f->largest.user_key()) > 0);
+}
+
+static bool BeforeFile(const Comparator* ucmp, const Slice* user_key, const FileMetaData* f) {
+    // user_key 为空表示在所有键之后
+    return (user_key != nullptr && ucmp->Compare(*user_key, f->smallest.user_key()) < 0);
+}
+
+bool SomeFileOverlapsRange(const InternalKeyComparator& icmp, bool disjoint_sorted_files,
+                           const std::vector<FileMetaData*>& files, const Slice* smallest_user_key,
+                           const Slice* largest_user_key) {
+    const Comparator* ucmp = icmp.user_comparator();
+    if(!disjoint_sorted_files) {
+        // 逐个检查
+        for(size_t i = 0; i < files.size(); i++) {
+            const FileMetaData* f = files[i];
+            if(AfterFile(ucmp, smallest_user_key, f) || BeforeFile(ucmp, largest_user_key, f)) {
+                // 不重叠
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 二分查找
+    uint32_t index = 0;
+    if(smallest_user_key != nullptr) {
+        // smallest_user_key 配上最大的 tag, 排在这个用户键的所有版本之前
+        InternalKey small_key(*smallest_user_key, kMaxSequenceNumber, kValueTypeForSeek);
+        index = FindFile(icmp, files, small_key.Encode());
+    }
+
+    // 范围的起点在所有文件之后
+    if(index >= files.size()) return false;
+
+    return !BeforeFile(ucmp, largest_user_key, files[index]);
+}
+
+/**
+ * @brief 遍历一层中的文件, key() 为文件的最大键, value() 为 16 字节的编号和大小
+ *  作为两层迭代器的外层, 内层是对应文件的表迭代器
+ */
+class Version::LevelFileNumIterator : public Iterator {
+public:
+    LevelFileNumIterator(const InternalKeyComparator& icmp, const std::vector<FileMetaData*>* flist)
+        : icmp_(icmp), flist_(flist), index_(flist->size()) {}  // 初始无效
+
+    bool Valid() const override { return index_ < flist_->size(); }
+    void Seek(const Slice& target) override { index_ = FindFile(icmp_, *flist_, target); }
+    void SeekToFirst() override { index_ = 0; }
+    void SeekToLast() override { index_ = flist_->empty() ? 0 : flist_->size() - 1; }
+    void Next() override {
+        assert(Valid());
+        index_++;
+    }
+    void Prev() override {
+        assert(Valid());
+        if(index_ == 0) {
+            index_ = flist_->size();  // 变为无效
+        } else {
+            index_--;
+        }
+    }
+    Slice key() const override {
+        assert(Valid());
+        return (*flist_)[index_]->largest.Encode();
+    }
+    Slice value() const override {
+        assert(Valid());
+        EncodeFixed64(value_buf_, (*flist_)[index_]->number);
+        EncodeFixed64(value_buf_ + 8, (*flist_)[index_]->file_size);
+        return Slice(value_buf_, sizeof(value_buf_));
+    }
+    Status status() const override { return Status::OK(); }
+
+private:
+    const InternalKeyComparator icmp_;
+    const std::vector<FileMetaData*>* const flist_;
+    uint32_t index_;
+
+    // value() 的返回值指向这里
+    mutable char value_buf_[16];
+};
+
+static Iterator* GetFileIterator(void* arg, const ReadOptions& options, const Slice& file_value) {
+    TableCache* cache = reinterpret_cast<TableCache*>(arg);
+    if(file_value.size() != 16) return NewErrorIterator(Status::Corruption("FileReader invoked with unexpected value"));
+    return cache->NewIterator(options, DecodeFixed64(file_value.data()), DecodeFixed64(file_value.data() + 8));
+}
+
+Iterator* Version::NewConcatenatingIterator(const ReadOptions& options, int level) const {
+    return NewTwoLevelIterator(new LevelFileNumIterator(vset_->icmp_, &files_[level]), &GetFileIterator,
+                               vset_->table_cache_, options);
+}
+
+void Version::AddIterators(const ReadOptions& options, std::vector<Iterator*>* iters) {
+    // L0 的文件可能互相重叠, 每个文件单独一个迭代器
+    for(size_t i = 0; i < files_[0].size(); i++) {
+        iters->push_back(vset_->table_cache_->NewIterator(options, files_[0][i]->number, files_[0][i]->file_size));
+    }
+
+    // 其他层每层一个拼接迭代器, 用到某个文件时才打开它
+    for(int level = 1; level < config::kNumLevels; level++) {
+        if(!files_[level].empty()) iters->push_back(NewConcatenatingIterator(options, level));
+    }
+}
+
+namespace {
+enum SaverState {
+    kNotFound,
+    kFound,
+    kDeleted,
+    kCorrupt,
+};
+
+struct Saver {
+    SaverState state;
+    const Comparator* ucmp;
+    Slice user_key;
+    std::string* value;
+};
+}   // namespace
+
+// Table::InternalGet 的回调: ikey 是第一个 >= 查找键的记录, 用户键相同才算命中
+static void SaveValue(void* arg, const Slice& ikey, const Slice& v) {
+    Saver* s = reinterpret_cast<Saver*>(arg);
+    ParsedInternalKey parsed_key;
+    if(!ParseInternalKey(ikey, &parsed_key)) {
+        s->state = kCorrupt;
+    } else if(s->ucmp->Compare(parsed_key.user_key, s->user_key) == 0) {
+        s->state = (parsed_key.type == kTypeValue) ? kFound : kDeleted;
+        if(s->state == kFound) s->value->assign(v.data(), v.size());
+    }
+}
+
+static bool NewestFirst(FileMetaData* a, FileMetaData* b) { return a->number > b->number; }
+
+Status Version::Get(const ReadOptions& options, const LookupKey& k, std::string* value, GetStats* stats) {
+    stats->seek_file = nullptr;
+    stats->seek_file_level = -1;
+
+    const Slice ikey = k.internal_key();
+    const Slice user_key = k.user_key();
+    const Comparator* ucmp = vset_->icmp_.user_comparator();
+
+    FileMetaData* last_file_read = nullptr;
+    int last_file_read_level = -1;
+    std::vector<FileMetaData*> candidates;
+    for(int level = 0; level < config::kNumLevels; level++) {
+        const std::vector<FileMetaData*>& files = files_[level];
+        if(files.empty()) continue;
+
+        candidates.clear();
+        if(level == 0) {
+            // L0 的文件可能重叠, 找出所有包含 user_key 的文件, 从新到旧检查
+            for(size_t i = 0; i < files.size(); i++) {
+                FileMetaData* f = files[i];
+                if(ucmp->Compare(user_key, f->smallest.user_key()) >= 0 &&
+                   ucmp->Compare(user_key, f->largest.user_key()) <= 0) {
+                    candidates.push_back(f);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), NewestFirst);
+        } else {
+            // 其他层最多一个文件可能包含 user_key
+            const uint32_t index = FindFile(vset_->icmp_, files, ikey);
+            if(index < files.size() && ucmp->Compare(user_key, files[index]->smallest.user_key()) >= 0) {
+                candidates.push_back(files[index]);
+            }
+        }
+
+        for(size_t i = 0; i < candidates.size(); i++) {
+            FileMetaData* f = candidates[i];
+            if(last_file_read != nullptr && stats->seek_file == nullptr) {
+                // 读了不止一个文件, 第一个文件白读了一次
+                stats->seek_file = last_file_read;
+                stats->seek_file_level = last_file_read_level;
+            }
+            last_file_read = f;
+            last_file_read_level = level;
+
+            Saver saver;
+            saver.state = kNotFound;
+            saver.ucmp = ucmp;
+            saver.user_key = user_key;
+            saver.value = value;
+            Status s = vset_->table_cache_->Get(options, f->number, f->file_size, ikey, &saver, &SaveValue);
+            if(!s.ok()) return s;
+            switch(saver.state) {
+                case kNotFound:
+                    break;  // 继续找更旧的文件
+                case kFound:
+                    return s;
+                case kDeleted:
+                    return Status::NotFound(Slice());
+                case kCorrupt:
+                    return Status::Corruption("corrupted key for ", user_key);
+            }
+        }
+    }
+    return Status::NotFound(Slice());
+}
+
+bool Version::UpdateStats(const GetStats& stats) {
+    FileMetaData* f = stats.seek_file;
+    if(f != nullptr) {
+        f->allowed_seeks--;
+        if(f->allowed_seeks <= 0 && file_to_compact_ == nullptr) {
+            file_to_compact_ = f;
+            file_to_compact_level_ = stats.seek_file_level;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Version::Ref() { ++refs_; }
+
+void Version::Unref() {
+    assert(this != &vset_->dummy_versions_);
+    assert(refs_ >= 1);
+    --refs_;
+    if(refs_ == 0) delete this;
+}
+
+bool Version::OverlapInLevel(int level, const Slice* smallest_user_key, const Slice* largest_user_key) {
+    return SomeFileOverlapsRange(vset_->icmp_, (level > 0), files_[level], smallest_user_key, largest_user_key);
+}
+
+int Version::PickLevelForMemTableOutput(const Slice& smallest_user_key, const Slice& largest_user_key) {
+    int level = 0;
+    if(!OverlapInLevel(0, &smallest_user_key, &largest_user_key)) {
+        // 与下一层不重叠, 且与再下一层重叠的字节数不多时, 继续往下放
+        InternalKey start(smallest_user_key, kMaxSequenceNumber, kValueTypeForSeek);
+        InternalKey limit(largest_user_key, 0, static_cast<ValueType>(0));
+        std::vector<FileMetaData*> overlaps;
+        while(level < config::kMaxMemCompactLevel) {
+            if(OverlapInLevel(level + 1, &smallest_user_key, &largest_user_key)) break;
+            if(level + 2 < config::kNumLevels) {
+                GetOverlappingInputs(level + 2, &start, &limit, &overlaps);
+                if(TotalFileSize(overlaps) > MaxGrandParentOverlapBytes(vset_->options_)) break;
+            }
+            level++;
+        }
+    }
+    return level;
+}
+
+void Version::GetOverlappingInputs(int level, const InternalKey* begin, const InternalKey* end,
+                                   std::vector<FileMetaData*>* inputs) {
+    assert(level >= 0);
+    assert(level < config::kNumLevels);
+    inputs->clear();
+    Slice user_begin, user_end;
+    if(begin != nullptr) user_begin = begin->user_key();
+    if(end != nullptr) user_end = end->user_key();
+    const Comparator* user_cmp = vset_->icmp_.user_comparator();
+    for(size_t i = 0; i < files_[level].size();) {
+        FileMetaData* f = files_[level][i++];
+        const Slice file_start = f->smallest.user_key();
+        const Slice file_limit = f->largest.user_key();
+        if(begin != nullptr && user_cmp->Compare(file_limit, user_begin) < 0) {
+            // 整个文件在范围之前
+        } else if(end != nullptr && user_cmp->Compare(file_start, user_end) > 0) {
+            // 整个文件在范围之后
+        } else {
+            inputs->push_back(f);
+            if(level == 0) {
+                // L0 的文件可能互相重叠, 新加入的文件扩大了范围时重新开始, 把与新范围重叠的文件都收进来
+                if(begin != nullptr && user_cmp->Compare(file_start, user_begin) < 0) {
+                    user_begin = file_start;
+                    inputs->clear();
+                    i = 0;
+                } else if(end != nullptr && user_cmp->Compare(file_limit, user_end) > 0) {
+                    user_end = file_limit;
+                    inputs->clear();
+                    i = 0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 把一串 VersionEdit 高效地应用到一个版本上, 中间不产生完整的版本拷贝
+ */
+class VersionSet::Builder {
+public:
+    Builder(VersionSet* vset, Version* base) : vset_(vset), base_(base) {
+        base_->Ref();
+        BySmallestKey cmp;
+        cmp.internal_comparator = &vset_->icmp_;
+        for(int level = 0; level < config::kNumLevels; level++) levels_[level].added_files = new FileSet(cmp);
+    }
+
+    ~Builder() {
+        for(int level = 0; level < config::kNumLevels; level++) {
+            const FileSet* added = levels_[level].added_files;
+            std::vector<FileMetaData*> to_unref;
+            to_unref.reserve(added->size());
+            for(FileSet::const_iterator it = added->begin(); it != added->end(); ++it) to_unref.push_back(*it);
+            delete added;
+            for(size_t i = 0; i < to_unref.size(); i++) {
+                FileMetaData* f = to_unref[i];
+                f->refs--;
+                if(f->refs <= 0) delete f;
+            }
+        }
+        base_->Unref();
+    }
+
+    void Apply(const VersionEdit* edit) {
+        for(size_t i = 0; i < edit->compact_pointers_.size(); i++) {
+            const int level = edit->compact_pointers_[i].first;
+            vset_->compact_pointer_[level] = edit->compact_pointers_[i].second.Encode().ToString();
+        }
+
+        for(VersionEdit::DeletedFileSet::const_iterator it = edit->deleted_files_.begin();
+            it != edit->deleted_files_.end(); ++it) {
+            levels_[it->first].deleted_files.insert(it->second);
+        }
+
+        for(size_t i = 0; i < edit->new_files_.size(); i++) {
+            const int level = edit->new_files_[i].first;
+            FileMetaData* f = new FileMetaData(edit->new_files_[i].second);
+            f->refs = 1;
+
+            // 无效查找的额度: 一次查找的代价约等于压缩 16KB 数据, 即
+            //   一次查找 10ms, 读写 1MB 数据 10ms(100MB/s), 压缩 1MB 要读写约 25MB(本层 1MB + 下一层 10~12MB)
+            // 所以 25 次查找的代价与压缩 1MB 相当, 这里保守地取每 16KB 一次查找
+            f->allowed_seeks = static_cast<int>(f->file_size / 16384U);
+            if(f->allowed_seeks < 100) f->allowed_seeks = 100;
+
+            levels_[level].deleted_files.erase(f->number);
+            levels_[level].added_files->insert(f);
+        }
+    }
+
+    void SaveTo(Version* v) {
+        BySmallestKey cmp;
+        cmp.internal_comparator = &vset_->icmp_;
+        for(int level = 0; level < config::kNumLevels; level++) {
+            // 把新增的文件按顺序合并进原有的文件中, 同时去掉删除的文件
+            const std::vector<FileMetaData*>& base_files = base_->files_[level];
+            std::vector<FileMetaData*>::const_iterator base_iter = base_files.begin();
+            std::vector<FileMetaData*>::const_iterator base_end = base_files.end();
+            const FileSet* added_files = levels_[level].added_files;
+            v->files_[level].reserve(base_files.size() + added_files->size());
+            for(FileSet::const_iterator added_it = added_files->begin(); added_it != added_files->end(); ++added_it) {
+                // 先加入原有文件中排在 added_it 之前的
+                for(std::vector<FileMetaData*>::const_iterator bpos =
+                        std::upper_bound(base_iter, base_end, *added_it, cmp);
+                    base_iter != bpos; ++base_iter) {
+                    MaybeAddFile(v, level, *base_iter);
+                }
+                MaybeAddFile(v, level, *added_it);
+            }
+            for(; base_iter != base_end; ++base_iter) MaybeAddFile(v, level, *base_iter);
+
+#ifndef NDEBUG
+            // L0 之外的层不能有重叠的文件
+            if(level > 0) {
+                for(uint32_t i = 1; i < v->files_[level].size(); i++) {
+                    const InternalKey& prev_end = v->files_[level][i - 1]->largest;
+                    const InternalKey& this_begin = v->files_[level][i]->smallest;
+                    if(vset_->icmp_.Compare(prev_end, this_begin) >= 0) {
+                        std::fprintf(stderr, "overlapping ranges in same level\n");
+                        std::abort();
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+private:
+    // 按最小键排序, 最小键相同时按文件编号
+    struct BySmallestKey {
+        const InternalKeyComparator* internal_comparator;
+
+        bool operator()(FileMetaData* f1, FileMetaData* f2) const {
+            int r = internal_comparator->Compare(f1->smallest, f2->smallest);
+            if(r != 0) return (r < 0);
+            return (f1->number < f2->number);
+        }
+    };
+
+    typedef std::set<FileMetaData*, BySmallestKey> FileSet;
+
+    struct LevelState {
+        std::set<uint64_t> deleted_files;
+        FileSet* added_files;
+    };
+
+    void MaybeAddFile(Version* v, int level, FileMetaData* f) {
+        if(levels_[level].deleted_files.count(f->number) > 0) return;  // 文件已删除
+        std::vector<FileMetaData*>* files = &v->files_[level];
+        if(level > 0 && !files->empty()) {
+            // 不能与已加入的文件重叠
+            assert(vset_->icmp_.Compare((*files)[files->size() - 1]->largest, f->smallest) < 0);
+        }
+        f->refs++;
+        files->push_back(f);
+    }
+
+    VersionSet* vset_;
+    Version* base_;
+    LevelState levels_[config::kNumLevels];
+};
+
+VersionSet::VersionSet(const std::string& dbname, const Options* options, TableCache* table_cache,
+                       const InternalKeyComparator* cmp)
+    : env_(options->env), dbname_(dbname), options_(options), table_cache_(table_cache), icmp_(*cmp),
+      next_file_number_(2), manifest_file_number_(0), last_sequence_(0), log_number_(0),
+      descriptor_file_(nullptr), descriptor_log_(nullptr), dummy_versions_(this), current_(nullptr) {
+    AppendVersion(new Version(this));
+}
+
+VersionSet::~VersionSet() {
+    current_->Unref();
+    assert(dummy_versions_.next_ == &dummy_versions_);  // 所有版本都已释放
+    delete descriptor_log_;
+    delete descriptor_file_;
+}
+
+void VersionSet::AppendVersion(Version* v) {
+    assert(v->refs_ == 0);
+    assert(v != current_);
+    if(current_ != nullptr) current_->Unref();
+    current_ = v;
+    v->Ref();
+
+    // 加到链表尾部
+    v->prev_ = dummy_versions_.prev_;
+    v->next_ = &dummy_versions_;
+    v->prev_->next_ = v;
+    v->next_->prev_ = v;
+}
+
+Status VersionSet::LogAndApply(VersionEdit* edit, std::mutex* mu) {
+    if(edit->has_log_number_) {
+        assert(edit->log_number_ >= log_number_);
+        assert(edit->log_number_ < next_file_number_);
+    } else {
+        edit->SetLogNumber(log_number_);
+    }
+    edit->SetNextFile(next_file_number_);
+    edit->SetLastSequence(last_sequence_);
+
+    Version* v = new Version(this);
+    {
+        Builder builder(this, current_);
+        builder.Apply(edit);
+        builder.SaveTo(v);
+    }
+    Finalize(v);
+
+    // 第一次调用时创建新的描述文件, 先写入当前版本的完整快照
+    std::string new_manifest_file;
+    Status s;
+    if(descriptor_log_ == nullptr) {
+        assert(descriptor_file_ == nullptr);
+        new_manifest_file = DescriptorFileName(dbname_, manifest_file_number_);
+        s = env_->NewWritableFile(new_manifest_file, &descriptor_file_);
+        if(s.ok()) {
+            descriptor_log_ = new log::Writer(descriptor_file_);
+            s = WriteSnapshot(descriptor_log_);
+        }
+    }
+
+    // 写描述文件期间放开锁, 调用方保证同一时间只有一个 LogAndApply
+    {
+        mu->unlock();
+        if(s.ok()) {
+            std::string record;
+            edit->EncodeTo(&record);
+            s = descriptor_log_->AddRecord(record);
+            if(s.ok()) s = descriptor_file_->Sync();
+        }
+        // 新的描述文件写好之后才让 CURRENT 指向它
+        if(s.ok() && !new_manifest_file.empty()) s = SetCurrentFile(env_, dbname_, manifest_file_number_);
+        mu->lock();
+    }
+
+    if(s.ok()) {
+        AppendVersion(v);
+        log_number_ = edit->log_number_;
+    } else {
+        delete v;
+        if(!new_manifest_file.empty()) {
+            delete descriptor_log_;
+            delete descriptor_file_;
+            descriptor_log_ = nullptr;
+            descriptor_file_ = nullptr;
+            env_->RemoveFile(new_manifest_file);
+        }
+    }
+    return s;
+}
+
+namespace {
+struct LogReporter : public log::Reader::Reporter {
+    Status* status;
+    void Corruption(size_t bytes, const Status& s) override {
+        if(this->status->ok()) *this->status = s;
+    }
+};
+}   // namespace
+
+Status VersionSet::Recover() {
+    // CURRENT 的内容是当前描述文件的文件名加换行
+    std::string current;
+    Status s = ReadFileToString(env_, CurrentFileName(dbname_), &current);
+    if(!s.ok()) return s;
+    if(current.empty() || current[current.size() - 1] != '\n') {
+        return Status::Corruption("CURRENT file does not end with newline");
+    }
+    current.resize(current.size() - 1);
+
+    const std::string dscname = dbname_ + "/" + current;
+    SequentialFile* file;
+    s = env_->NewSequentialFile(dscname, &file);
+    if(!s.ok()) return s;
+
+    bool have_log_number = false;
+    bool have_next_file = false;
+    bool have_last_sequence = false;
+    uint64_t next_file = 0;
+    uint64_t last_sequence = 0;
+    uint64_t log_number = 0;
+    Builder builder(this, current_);
+
+    {
+        LogReporter reporter;
+        reporter.status = &s;
+        log::Reader reader(file, &reporter, true, 0);
+        Slice record;
+        std::string scratch;
+        while(reader.ReadRecord(&record, &scratch) && s.ok()) {
+            VersionEdit edit;
+            s = edit.DecodeFrom(record);
+            if(s.ok() && edit.has_comparator_ && edit.comparator_ != icmp_.user_comparator()->Name()) {
+                s = Status::InvalidArgument(edit.comparator_ + " does not match existing comparator ",
+                                            icmp_.user_comparator()->Name());
+            }
+            if(s.ok()) builder.Apply(&edit);
+
+            if(edit.has_log_number_) {
+                log_number = edit.log_number_;
+                have_log_number = true;
+            }
+            if(edit.has_next_file_number_) {
+                next_file = edit.next_file_number_;
+                have_next_file = true;
+            }
+            if(edit.has_last_sequence_) {
+                last_sequence = edit.last_sequence_;
+                have_last_sequence = true;
+            }
+        }
+    }
+    delete file;
+
+    if(s.ok()) {
+        if(!have_next_file) {
+            s = Status::Corruption("no meta-nextfile entry in descriptor");
+        } else if(!have_log_number) {
+            s = Status::Corruption("no meta-lognumber entry in descriptor");
+        } else if(!have_last_sequence) {
+            s = Status::Corruption("no last-sequence-number entry in descriptor");
+        }
+    }
+
+    if(s.ok()) {
+        Version* v = new Version(this);
+        builder.SaveTo(v);
+        Finalize(v);
+        AppendVersion(v);
+        // 旧的描述文件不再追加, 下一次 LogAndApply 写一个新的
+        manifest_file_number_ = next_file;
+        next_file_number_ = next_file + 1;
+        last_sequence_ = last_sequence;
+        log_number_ = log_number;
+        MarkFileNumberUsed(log_number);
+    }
+    return s;
+}
+
+void VersionSet::Finalize(Version* v) {
+    int best_level = -1;
+    double best_score = -1;
+
+    for(int level = 0; level < config::kNumLevels - 1; level++) {
+        double score;
+        if(level == 0) {
+            // L0 按文件数计分: 写缓冲较大时 L0 的压缩量大, 按字节计会太频繁;
+            // 而且每次读都要合并 L0 的所有文件, 文件数本身就是代价
+            score = v->files_[level].size() / static_cast<double>(config::kL0_CompactionTrigger);
+        } else {
+            score = static_cast<double>(TotalFileSize(v->files_[level])) / MaxBytesForLevel(level);
+        }
+        if(score > best_score) {
+            best_level = level;
+            best_score = score;
+        }
+    }
+
+    v->compaction_level_ = best_level;
+    v->compaction_score_ = best_score;
+}
+
+Status VersionSet::WriteSnapshot(log::Writer* log) {
+    VersionEdit edit;
+    edit.SetComparatorName(icmp_.user_comparator()->Name());
+
+    for(int level = 0; level < config::kNumLevels; level++) {
+        if(!compact_pointer_[level].empty()) {
+            InternalKey key;
+            key.DecodeFrom(compact_pointer_[level]);
+            edit.SetCompactPointer(level, key);
+        }
+    }
+
+    for(int level = 0; level < config::kNumLevels; level++) {
+        const std::vector<FileMetaData*>& files = current_->files_[level];
+        for(size_t i = 0; i < files.size(); i++) {
+            const FileMetaData* f = files[i];
+            edit.AddFile(level, f->number, f->file_size, f->smallest, f->largest);
+        }
+    }
+
+    std::string record;
+    edit.EncodeTo(&record);
+    return log->AddRecord(record);
+}
+
+int VersionSet::NumLevelFiles(int level) const {
+    assert(level >= 0);
+    assert(level < config::kNumLevels);
+    return current_->files_[level].size();
+}
+
+int64_t VersionSet::NumLevelBytes(int level) const {
+    assert(level >= 0);
+    assert(level < config::kNumLevels);
+    return TotalFileSize(current_->files_[level]);
+}
+
+const char* VersionSet::LevelSummary(LevelSummaryStorage* scratch) const {
+    static_assert(config::kNumLevels == 7, "");
+    std::snprintf(scratch->buffer, sizeof(scratch->buffer), "files[ %d %d %d %d %d %d %d ]",
+                  int(current_->files_[0].size()), int(current_->files_[1].size()),
+                  int(current_->files_[2].size()), int(current_->files_[3].size()),
+                  int(current_->files_[4].size()), int(current_->files_[5].size()),
+                  int(current_->files_[6].size()));
+    return scratch->buffer;
+}
+
+void VersionSet::AddLiveFiles(std::set<uint64_t>* live) {
+    for(Version* v = dummy_versions_.next_; v != &dummy_versions_; v = v->next_) {
+        for(int level = 0; level < config::kNumLevels; level++) {
+            const std::vector<FileMetaData*>& files = v->files_[level];
+            for(size_t i = 0; i < files.size(); i++) live->insert(files[i]->number);
+        }
+    }
+}
+
+void VersionSet::GetRange(const std::vector<FileMetaData*>& inputs, InternalKey* smallest,
+                          InternalKey* largest) {
+    assert(!inputs.empty());
+    smallest->Clear();
+    largest->Clear();
+    for(size_t i = 0; i < inputs.size(); i++) {
+        FileMetaData* f = inputs[i];
+        if(i == 0) {
+            *smallest = f->smallest;
+            *largest = f->largest;
+        } else {
+            if(icmp_.Compare(f->smallest, *smallest) < 0) *smallest = f->smallest;
+            if(icmp_.Compare(f->largest, *largest) > 0) *largest = f->largest;
+        }
+    }
+}
+
+void VersionSet::GetRange2(const std::vector<FileMetaData*>& inputs1, const std::vector<FileMetaData*>& inputs2,
+                           InternalKey* smallest, InternalKey* largest) {
+    std::vector<FileMetaData*> all = inputs1;
+    all.insert(all.end(), inputs2.begin(), inputs2.end());
+    GetRange(all, smallest, largest);
+}
+
+Iterator* VersionSet::MakeInputIterator(Compaction* c) {
+    ReadOptions options;
+    options.verify_checksums = options_->paranoid_checks;
+    options.fill_cache = false;  // 输入只读一遍, 不要把热点块挤出缓存
+
+    // L0 的每个文件一个迭代器, 其他层每层一个拼接迭代器
+    const int space = (c->level() == 0 ? c->inputs_[0].size() + 1 : 2);
+    Iterator** list = new Iterator*[space];
+    int num = 0;
+    for(int which = 0; which < 2; which++) {
+        if(!c->inputs_[which].empty()) {
+            if(c->level() + which == 0) {
+                const std::vector<FileMetaData*>& files = c->inputs_[which];
+                for(size_t i = 0; i < files.size(); i++) {
+                    list[num++] = table_cache_->NewIterator(options, files[i]->number, files[i]->file_size);
+                }
+            } else {
+                list[num++] = NewTwoLevelIterator(new Version::LevelFileNumIterator(icmp_, &c->inputs_[which]),
+                                                  &GetFileIterator, table_cache_, options);
+            }
+        }
+    }
+    assert(num <= space);
+    Iterator* result = NewMergingIterator(&icmp_, list, num);
+    delete[] list;
+    return result;
+}
+
+Compaction* VersionSet::PickCompaction() {
+    Compaction* c;
+    int level;
+
+    // 大小超标优先于无效查找
+    const bool size_compaction = (current_->compaction_score_ >= 1);
+    const bool seek_compaction = (current_->file_to_compact_ != nullptr);
+    if(size_compaction) {
+        level = current_->compaction_level_;
+        assert(level >= 0);
+        assert(level + 1 < config::kNumLevels);
+        c = new Compaction(options_, level);
+
+        // 选出 compact_pointer_[level] 之后的第一个文件
+        for(size_t i = 0; i < current_->files_[level].size(); i++) {
+            FileMetaData* f = current_->files_[level][i];
+            if(compact_pointer_[level].empty() || icmp_.Compare(f->largest.Encode(), compact_pointer_[level]) > 0) {
+                c->inputs_[0].push_back(f);
+                break;
+            }
+        }
+        if(c->inputs_[0].empty()) {
+            // 到了这一层的末尾, 从头开始
+            c->inputs_[0].push_back(current_->files_[level][0]);
+        }
+    } else if(seek_compaction) {
+        level = current_->file_to_compact_level_;
+        c = new Compaction(options_, level);
+        c->inputs_[0].push_back(current_->file_to_compact_);
+    } else {
+        return nullptr;
+    }
+
+    c->input_version_ = current_;
+    c->input_version_->Ref();
+
+    // L0 的文件可能互相重叠, 把与选中文件重叠的都加进来
+    if(level == 0) {
+        InternalKey smallest, largest;
+        GetRange(c->inputs_[0], &smallest, &largest);
+        current_->GetOverlappingInputs(0, &smallest, &largest, &c->inputs_[0]);
+        assert(!c->inputs_[0].empty());
+    }
+
+    SetupOtherInputs(c);
+    return c;
+}
+
+void VersionSet::SetupOtherInputs(Compaction* c) {
+    const int level = c->level();
+    InternalKey smallest, largest;
+
+    GetRange(c->inputs_[0], &smallest, &largest);
+    current_->GetOverlappingInputs(level + 1, &smallest, &largest, &c->inputs_[1]);
+
+    // 整个压缩的范围
+    InternalKey all_start, all_limit;
+    GetRange2(c->inputs_[0], c->inputs_[1], &all_start, &all_limit);
+
+    // 在不增加 level+1 层输入文件的前提下, 看能不能多带上一些 level 层的文件
+    if(!c->inputs_[1].empty()) {
+        std::vector<FileMetaData*> expanded0;
+        current_->GetOverlappingInputs(level, &all_start, &all_limit, &expanded0);
+        const int64_t inputs1_size = TotalFileSize(c->inputs_[1]);
+        const int64_t expanded0_size = TotalFileSize(expanded0);
+        if(expanded0.size() > c->inputs_[0].size() &&
+           inputs1_size + expanded0_size < ExpandedCompactionByteSizeLimit(options_)) {
+            InternalKey new_start, new_limit;
+            GetRange(expanded0, &new_start, &new_limit);
+            std::vector<FileMetaData*> expanded1;
+            current_->GetOverlappingInputs(level + 1, &new_start, &new_limit, &expanded1);
+            if(expanded1.size() == c->inputs_[1].size()) {
+                smallest = new_start;
+                largest = new_limit;
+                c->inputs_[0] = expanded0;
+                c->inputs_[1] = expanded1;
+                GetRange2(c->inputs_[0], c->inputs_[1], &all_start, &all_limit);
+            }
+        }
+    }
+
+    // 与 level+2 层重叠的文件
+    if(level + 2 < config::kNumLevels) {
+        current_->GetOverlappingInputs(level + 2, &all_start, &all_limit, &c->grandparents_);
+    }
+
+    // 下一次这一层的压缩从本次范围之后开始; 立即更新而不是等 LogAndApply,
+    // 这样压缩失败时下一次会换一个范围尝试
+    compact_pointer_[level] = largest.Encode().ToString();
+    c->edit_.SetCompactPointer(level, largest);
+}
+
+Compaction* VersionSet::CompactRange(int level, const InternalKey* begin, const InternalKey* end) {
+    std::vector<FileMetaData*> inputs;
+    current_->GetOverlappingInputs(level, begin, end, &inputs);
+    if(inputs.empty()) return nullptr;
+
+    // 范围很大时一次只压缩一部分; L0 的文件可能重叠, 不能只选其中一部分
+    if(level > 0) {
+        const uint64_t limit = TargetFileSize(options_);
+        uint64_t total = 0;
+        for(size_t i = 0; i < inputs.size(); i++) {
+            total += inputs[i]->file_size;
+            if(total >= limit) {
+                inputs.resize(i + 1);
+                break;
+            }
+        }
+    }
+
+    Compaction* c = new Compaction(options_, level);
+    c->input_version_ = current_;
+    c->input_version_->Ref();
+    c->inputs_[0] = inputs;
+    SetupOtherInputs(c);
+    return c;
+}
+
+Compaction::Compaction(const Options* options, int level)
+    : level_(level), max_output_file_size_(TargetFileSize(options)), input_version_(nullptr),
+      grandparent_index_(0), seen_key_(false), overlapped_bytes_(0) {
+    for(int i = 0; i < config::kNumLevels; i++) level_ptrs_[i] = 0;
+}
+
+Compaction::~Compaction() {
+    if(input_version_ != nullptr) input_version_->Unref();
+}
+
+bool Compaction::IsTrivialMove() const {
+    const VersionSet* vset = input_version_->vset_;
+    // 与 level+2 层重叠太多时不直接移动, 否则之后把它压缩到 level+2 层的代价太大
+    return (num_input_files(0) == 1 && num_input_files(1) == 0 &&
+            TotalFileSize(grandparents_) <= MaxGrandParentOverlapBytes(vset->options_));
+}
+
+void Compaction::AddInputDeletions(VersionEdit* edit) {
+    for(int which = 0; which < 2; which++) {
+        for(size_t i = 0; i < inputs_[which].size(); i++) edit->RemoveFile(level_ + which, inputs_[which][i]->number);
+    }
+}
+
+bool Compaction::IsBaseLevelForKey(const Slice& user_key) {
+    const Comparator* user_cmp = input_version_->vset_->icmp_.user_comparator();
+    for(int lvl = level_ + 2; lvl < config::kNumLevels; lvl++) {
+        const std::vector<FileMetaData*>& files = input_version_->files_[lvl];
+        while(level_ptrs_[lvl] < files.size()) {
+            FileMetaData* f = files[level_ptrs_[lvl]];
+            if(user_cmp->Compare(user_key, f->largest.user_key()) <= 0) {
+                // user_key 不会落在这一层更后面的文件里
+                if(user_cmp->Compare(user_key, f->smallest.user_key()) >= 0) return false;
+                break;
+            }
+            level_ptrs_[lvl]++;
+        }
+    }
+    return true;
+}
+
+bool Compaction::ShouldStopBefore(const Slice& internal_key) {
+    const VersionSet* vset = input_version_->vset_;
+    const InternalKeyComparator* icmp = &vset->icmp_;
+    // 跳过最大键在 internal_key 之前的 grandparents_
+    while(grandparent_index_ < grandparents_.size() &&
+          icmp->Compare(internal_key, grandparents_[grandparent_index_]->largest.Encode()) > 0) {
+        if(seen_key_) overlapped_bytes_ += grandparents_[grandparent_index_]->file_size;
+        grandparent_index_++;
+    }
+    seen_key_ = true;
+
+    if(overlapped_bytes_ > MaxGrandParentOverlapBytes(vset->options_)) {
+        overlapped_bytes_ = 0;
+        return true;
+    }
+    return false;
+}
+
+void Compaction::ReleaseInputs() {
+    if(input_version_ != nullptr) {
+        input_version_->Unref();
+        input_version_ = nullptr;
+    }
+}
+
+}   // namespace leveldb
@@ -0,0 +1,314 @@
+/**
+ * @file version_set.h
+ * @author alongnice
+ * @brief 版本管理: 每个版本是某一时刻各层(L0~L6)表文件的快照
+ *  版本不可变, 读者持有引用期间文件不会被删除; 压缩和 memtable 落盘通过 VersionEdit 生成新版本
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dbformat.h"
+#include "version_edit.h"
+
+namespace leveldb {
+
+namespace log {
+class Writer;
+}
+
+class Compaction;
+class Env;
+class Iterator;
+class MemTable;
+class TableCache;
+class Version;
+class VersionSet;
+class WritableFile;
+struct Options;
+struct ReadOptions;
+
+/**
+ * @brief 返回 files 中第一个 largest >= key 的文件下标, 没有时返回 files.size()
+ *  要求: files 按键有序且互不重叠
+ */
+int FindFile(const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files, const Slice& key);
+
+/**
+ * @brief files 中是否有文件与用户键范围 [*smallest_user_key, *largest_user_key] 重叠
+ *  smallest_user_key 为空表示比所有键都小, largest_user_key 为空表示比所有键都大
+ * @param disjoint_sorted_files 为 true 时 files 互不重叠且有序, 可以二分查找
+ */
+bool SomeFileOverlapsRange(const InternalKeyComparator& icmp, bool disjoint_sorted_files,
+                           const std::vector<FileMetaData*>& files, const Slice* smallest_user_key,
+                           const Slice* largest_user_key);
+
+class Version {
+public:
+    // 一次点查的统计: 查找读了不止一个文件时, 记下第一个读过却没有找到的文件
+    struct GetStats {
+        FileMetaData* seek_file;
+        int seek_file_level;
+    };
+
+    // 把遍历这个版本所有文件的迭代器追加到 iters, L0 每个文件一个, 其他层每层一个
+    void AddIterators(const ReadOptions& options, std::vector<Iterator*>* iters);
+
+    /**
+     * @brief 在各层文件中查找, 找到值时写入 val
+     * @return Status 找不到或最新的版本是删除时返回 NotFound
+     */
+    Status Get(const ReadOptions& options, const LookupKey& key, std::string* val, GetStats* stats);
+
+    /**
+     * @brief 把 Get 的统计计入文件的无效查找次数
+     * @return true 有文件的次数用完, 需要调度压缩
+     */
+    bool UpdateStats(const GetStats& stats);
+
+    // 引用计数由 DBImpl 的锁保护
+    void Ref();
+    void Unref();
+
+    // 返回 level 层中与内部键范围 [begin, end] 重叠的文件, begin/end 为空表示不设限
+    void GetOverlappingInputs(int level, const InternalKey* begin, const InternalKey* end,
+                              std::vector<FileMetaData*>* inputs);
+
+    // level 层是否有文件与用户键范围重叠, 参数含义同 SomeFileOverlapsRange
+    bool OverlapInLevel(int level, const Slice* smallest_user_key, const Slice* largest_user_key);
+
+    // memtable 落盘生成的覆盖 [smallest_user_key, largest_user_key] 的文件应该放到哪一层
+    int PickLevelForMemTableOutput(const Slice& smallest_user_key, const Slice& largest_user_key);
+
+    int NumFiles(int level) const { return files_[level].size(); }
+
+private:
+    friend class Compaction;
+    friend class VersionSet;
+
+    class LevelFileNumIterator;
+
+    explicit Version(VersionSet* vset)
+        : vset_(vset), next_(this), prev_(this), refs_(0), file_to_compact_(nullptr),
+          file_to_compact_level_(-1), compaction_score_(-1), compaction_level_(-1) {}
+
+    Version(const Version&) = delete;
+    Version& operator=(const Version&) = delete;
+
+    ~Version();
+
+    // 依次遍历 level 层(>0)各个文件的迭代器, 只在用到某个文件时才打开它
+    Iterator* NewConcatenatingIterator(const ReadOptions& options, int level) const;
+
+    VersionSet* vset_;
+    Version* next_;  // 版本链表
+    Version* prev_;
+    int refs_;
+
+    // 每层的文件, L0 之外各层的文件按键有序且互不重叠
+    std::vector<FileMetaData*> files_[config::kNumLevels];
+
+    // 无效查找次数用完的文件, 下一次压缩的候选
+    FileMetaData* file_to_compact_;
+    int file_to_compact_level_;
+
+    // 最需要压缩的层和它的分数, 分数 >= 1 时需要压缩; 由 VersionSet::Finalize 计算
+    double compaction_score_;
+    int compaction_level_;
+};
+
+class VersionSet {
+public:
+    VersionSet(const std::string& dbname, const Options* options, TableCache* table_cache,
+               const InternalKeyComparator* cmp);
+
+    VersionSet(const VersionSet&) = delete;
+    VersionSet& operator=(const VersionSet&) = delete;
+
+    ~VersionSet();
+
+    /**
+     * @brief 把 edit 应用到当前版本得到新版本, 写入描述文件后设为当前版本
+     *  要求: 调用时持有 *mu, 写描述文件期间会暂时放开; 同一时间只能有一个调用者
+     */
+    Status LogAndApply(VersionEdit* edit, std::mutex* mu);
+
+    // 从 CURRENT 指向的描述文件恢复最后保存的状态
+    Status Recover();
+
+    Version* current() const { return current_; }
+
+    uint64_t ManifestFileNumber() const { return manifest_file_number_; }
+
+    // 分配一个新的文件编号
+    uint64_t NewFileNumber() { return next_file_number_++; }
+
+    // 刚分配的编号没有用上时归还
+    void ReuseFileNumber(uint64_t file_number) {
+        if(next_file_number_ == file_number + 1) next_file_number_ = file_number;
+    }
+
+    int NumLevelFiles(int level) const;
+    int64_t NumLevelBytes(int level) const;
+
+    SequenceNumber LastSequence() const { return last_sequence_; }
+    void SetLastSequence(SequenceNumber s) {
+        assert(s >= last_sequence_);
+        last_sequence_ = s;
+    }
+
+    // 确保以后不会再分配到 number
+    void MarkFileNumberUsed(uint64_t number) {
+        if(next_file_number_ <= number) next_file_number_ = number + 1;
+    }
+
+    // 编号小于它的日志都已经不再需要
+    uint64_t LogNumber() const { return log_number_; }
+
+    /**
+     * @brief 选出下一次压缩, 不需要压缩时返回 nullptr
+     *  大小超标优先于无效查找触发的压缩
+     */
+    Compaction* PickCompaction();
+
+    // 压缩 level 层中与 [begin, end] 重叠的文件, 没有重叠的文件时返回 nullptr
+    Compaction* CompactRange(int level, const InternalKey* begin, const InternalKey* end);
+
+    // 归并压缩的所有输入文件, 调用方负责删除
+    Iterator* MakeInputIterator(Compaction* c);
+
+    bool NeedsCompaction() const {
+        Version* v = current_;
+        return (v->compaction_score_ >= 1) || (v->file_to_compact_ != nullptr);
+    }
+
+    // 把所有存活版本引用的文件编号加入 live
+    void AddLiveFiles(std::set<uint64_t>* live);
+
+    // 每层文件数的可读摘要, 形如 "files[ 0 1 2 0 0 0 0 ]"
+    struct LevelSummaryStorage {
+        char buffer[100];
+    };
+    const char* LevelSummary(LevelSummaryStorage* scratch) const;
+
+private:
+    class Builder;
+
+    friend class Compaction;
+    friend class Version;
+
+    // 计算 v 中最需要压缩的层
+    void Finalize(Version* v);
+
+    void GetRange(const std::vector<FileMetaData*>& inputs, InternalKey* smallest, InternalKey* largest);
+    void GetRange2(const std::vector<FileMetaData*>& inputs1, const std::vector<FileMetaData*>& inputs2,
+                   InternalKey* smallest, InternalKey* largest);
+
+    // 选好 level 层的输入之后, 补上 level+1 层的输入, 在不增加 level+1 层输入的前提下尽量扩大 level 层输入
+    void SetupOtherInputs(Compaction* c);
+
+    // 把当前版本完整地写入新的描述文件
+    Status WriteSnapshot(log::Writer* log);
+
+    void AppendVersion(Version* v);
+
+    Env* const env_;
+    const std::string dbname_;
+    const Options* const options_;
+    TableCache* const table_cache_;
+    const InternalKeyComparator icmp_;
+    uint64_t next_file_number_;
+    uint64_t manifest_file_number_;
+    SequenceNumber last_sequence_;
+    uint64_t log_number_;
+
+    // 懒打开, 第一次 LogAndApply 时创建新的描述文件
+    WritableFile* descriptor_file_;
+    log::Writer* descriptor_log_;
+    Version dummy_versions_;  // 双向循环链表的头
+    Version* current_;        // == dummy_versions_.prev_
+
+    // 每层下一次压缩从这个键之后开始, 为空表示从头开始
+    std::string compact_pointer_[config::kNumLevels];
+};
+
+// 一次压缩的信息
+class Compaction {
+public:
+    ~Compaction();
+
+    // 输入来自 level 和 level+1 层, 输出到 level+1 层
+    int level() const { return level_; }
+
+    // 压缩完成后要应用的变更
+    VersionEdit* edit() { return &edit_; }
+
+    // which 为 0 或 1, 分别对应 level 和 level+1 层
+    int num_input_files(int which) const { return inputs_[which].size(); }
+    FileMetaData* input(int which, int i) const { return inputs_[which][i]; }
+
+    uint64_t MaxOutputFileSize() const { return max_output_file_size_; }
+
+    // 只需要把一个文件移到下一层, 不需要归并
+    bool IsTrivialMove() const;
+
+    // 把所有输入文件作为删除加入 edit
+    void AddInputDeletions(VersionEdit* edit);
+
+    // user_key 在 level+1 之下的各层都不存在时返回 true, 此时它的删除标记可以丢弃
+    bool IsBaseLevelForKey(const Slice& user_key);
+
+    // 输出 internal_key 之前是否应该结束当前输出文件, 避免单个输出文件与 level+2 层重叠太多
+    bool ShouldStopBefore(const Slice& internal_key);
+
+    // 压缩完成后释放对输入版本的引用
+    void ReleaseInputs();
+
+private:
+    friend class Version;
+    friend class VersionSet;
+
+    Compaction(const Options* options, int level);
+
+    int level_;
+    uint64_t max_output_file_size_;
+    Version* input_version_;
+    VersionEdit edit_;
+
+    std::vector<FileMetaData*> inputs_[2];
+
+    // 与压缩范围重叠的 level+2 层文件, 用于 ShouldStopBefore
+    std::vector<FileMetaData*> grandparents_;
+    size_t grandparent_index_;  // ShouldStopBefore 扫描到的位置
+    bool seen_key_;             // 是否已经输出过键
+    int64_t overlapped_bytes_;  // 当前输出文件与 grandparents_ 重叠的字节数
+
+    // IsBaseLevelForKey 在每层扫描到的位置; 输入的键是递增的, 只需要向前移动
+    size_t level_ptrs_[config::kNumLevels];
+};
+
+}   // namespace leveldb
+
+/**
+ * 分层结构
+ *  L0: memtable 直接落盘的文件, 文件之间可以重叠, 查找时按新到旧逐个检查
+ *  L1~L6: 每层的文件互不重叠, 查找时每层最多读一个文件; 每层的容量是上一层的 10 倍(L1 为 10MB)
+ *
+ * 压缩的选择
+ *  1. 大小: L0 按文件数 / kL0_CompactionTrigger 计分, 其他层按总字节数 / 该层容量计分
+ *     分数最高且 >= 1 的层参与压缩, 从上次压缩结束的键(compact_pointer_)之后选一个文件, 各层轮流推进
+ *  2. 查找: 一次点查读了多个文件才找到时, 第一个文件算一次无效查找
+ *     文件的无效查找额度与大小成正比(每 16KB 一次, 至少 100 次), 用完之后压缩这个文件
+ *     压缩一个文件的 I/O 与若干次查找相当, 额度用完说明压缩比继续承受多余的查找更划算
+ *
+ * 压缩的输入是 level 层选中的文件加上 level+1 层与之重叠的文件, 归并后写成 level+1 层的新文件
+ * 输出文件按大小(max_file_size)和与 level+2 层的重叠量切分, 同一个用户键的所有版本不会被切到两个文件中
+ */
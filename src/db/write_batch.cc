@@ -0,0 +1,153 @@
+/**
+ * @file write_batch.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/write_batch.h"
+
+#include "memtable.h"
+#include "write_batch_internal.h"
+
+namespace leveldb {
+
+static const size_t kHeader = WriteBatchInternal::kHeaderSize;
+
+const size_t WriteBatchInternal::kHeaderSize;
+
+WriteBatch::Handler::~Handler() = default;
+
+WriteBatch::WriteBatch() { Clear(); }
+
+WriteBatch::~WriteBatch() = default;
+
+void WriteBatch::Clear() {
+    rep_.clear();
+    rep_.resize(kHeader);
+}
+
+size_t WriteBatch::ApproximateSize() const { return rep_.size(); }
+
+void WriteBatch::Put(const Slice& key, const Slice& value) {
+    WriteBatchInternal::SetCount(this, WriteBatchInternal::Count(this) + 1);
+    rep_.push_back(static_cast<char>(kTypeValue));
+    PutLengthPrefixedSlice(&rep_, key);
+    PutLengthPrefixedSlice(&rep_, value);
+}
+
+void WriteBatch::Delete(const Slice& key) {
+    WriteBatchInternal::SetCount(this, WriteBatchInternal::Count(this) + 1);
+    rep_.push_back(static_cast<char>(kTypeDeletion));
+    PutLengthPrefixedSlice(&rep_, key);
+}
+
+int WriteBatchInternal::Count(const WriteBatch* b) { return DecodeFixed32(b->rep_.data() + 8); }
+
+void WriteBatchInternal::SetCount(WriteBatch* b, int n) { EncodeFixed32(&b->rep_[8], n); }
+
+SequenceNumber WriteBatchInternal::Sequence(const WriteBatch* b) {
+    return SequenceNumber(DecodeFixed64(b->rep_.data()));
+}
+
+void WriteBatchInternal::SetSequence(WriteBatch* b, SequenceNumber seq) {
+    EncodeFixed64(&b->rep_[0], seq);
+}
+
+void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
+    assert(contents.size() >= kHeader);
+    b->rep_.assign(contents.data(), contents.size());
+}
+
+namespace {
+/**
+ * @brief 把批次中的更新插入 memtable, 序列号从批次头部的值开始逐条递增
+ */
+class MemTableInserter : public WriteBatch::Handler {
+public:
+    MemTableInserter(SequenceNumber seq, MemTable* mem, bool concurrently)
+        : sequence_(seq), mem_(mem), concurrently_(concurrently) {}
+
+    void Put(const Slice& key, const Slice& value) override {
+        Add(kTypeValue, key, value);
+    }
+    void Delete(const Slice& key) override { Add(kTypeDeletion, key, Slice()); }
+
+private:
+    void Add(ValueType type, const Slice& key, const Slice& value) {
+        if(concurrently_) {
+            mem_->AddConcurrently(sequence_, type, key, value);
+        } else {
+            mem_->Add(sequence_, type, key, value);
+        }
+        sequence_++;
+    }
+
+    SequenceNumber sequence_;
+    MemTable* const mem_;
+    const bool concurrently_;
+};
+}   // namespace
+
+Status WriteBatch::Iterate(Handler* handler) const {
+    Slice input(rep_);
+    if(input.size() < kHeader) return Status::Corruption("malformed WriteBatch (too small)");
+
+    input.remove_prefix(kHeader);
+    Slice key, value;
+    int found = 0;
+    while(!input.empty()) {
+        found++;
+        char tag = input[0];
+        input.remove_prefix(1);
+        switch(tag) {
+            case kTypeValue:
+                if(GetLengthPrefixedSlice(&input, &key) && GetLengthPrefixedSlice(&input, &value)) {
+                    handler->Put(key, value);
+                } else {
+                    return Status::Corruption("bad WriteBatch Put");
+                }
+                break;
+            case kTypeDeletion:
+                if(GetLengthPrefixedSlice(&input, &key)) {
+                    handler->Delete(key);
+                } else {
+                    return Status::Corruption("bad WriteBatch Delete");
+                }
+                break;
+            default:
+                return Status::Corruption("unknown WriteBatch tag");
+        }
+    }
+    if(found != WriteBatchInternal::Count(this)) {
+        return Status::Corruption("WriteBatch has wrong count");
+    }
+    return Status::OK();
+}
+
+void WriteBatch::Append(const WriteBatch& source) {
+    WriteBatchInternal::SetCount(this, WriteBatchInternal::Count(this) +
+                                       WriteBatchInternal::Count(&source));
+    assert(source.rep_.size() >= kHeader);
+    rep_.append(source.rep_.data() + kHeader, source.rep_.size() - kHeader);
+}
+
+Slice WriteBatchInternal::Records(const WriteBatch* b) {
+    return Slice(b->rep_.data() + kHeader, b->rep_.size() - kHeader);
+}
+
+void WriteBatchInternal::EncodeHeader(char* dst, SequenceNumber seq, int count) {
+    EncodeFixed64(dst, seq);
+    EncodeFixed32(dst + 8, count);
+}
+
+Status WriteBatchInternal::InsertInto(const WriteBatch* b, MemTable* memtable, bool concurrently) {
+    MemTableInserter inserter(Sequence(b), memtable, concurrently);
+    return b->Iterate(&inserter);
+}
+
+}   // namespace leveldb
@@ -0,0 +1,56 @@
+/**
+ * @file write_batch_internal.h
+ * @author alongnice
+ * @brief WriteBatch 的内部接口, 不希望出现在公开的 WriteBatch 中
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "dbformat.h"
+#include "write_batch.h"
+
+namespace leveldb {
+
+class MemTable;
+
+class WriteBatchInternal {
+public:
+    // 批次中的更新条数
+    static int Count(const WriteBatch* batch);
+    static void SetCount(WriteBatch* batch, int n);
+
+    // 批次第一条更新的序列号
+    static SequenceNumber Sequence(const WriteBatch* batch);
+    static void SetSequence(WriteBatch* batch, SequenceNumber seq);
+
+    // 编码后的内容, 直接作为一条日志记录
+    static Slice Contents(const WriteBatch* batch) { return Slice(batch->rep_); }
+    static size_t ByteSize(const WriteBatch* batch) { return batch->rep_.size(); }
+
+    // 头部之后的记录部分; 多个批次的记录部分拼在一个新头部之后, 就是它们合并后的内容
+    static Slice Records(const WriteBatch* batch);
+
+    // 头部长度: 8 字节序列号 + 4 字节条数
+    static const size_t kHeaderSize = 12;
+
+    // 在 dst 中写入头部
+    static void EncodeHeader(char* dst, SequenceNumber seq, int count);
+
+    // 用日志中读出的内容替换批次
+    static void SetContents(WriteBatch* batch, const Slice& contents);
+
+    /**
+     * @brief 把批次中的更新按各自的序列号插入 memtable
+     * @param concurrently 为 true 时使用 MemTable::AddConcurrently, 允许多个批次同时插入
+     */
+    static Status InsertInto(const WriteBatch* batch, MemTable* memtable, bool concurrently);
+
+    // 把 src 中的更新追加到 dst 后面
+    static void Append(WriteBatch* dst, const WriteBatch* src) { dst->Append(*src); }
+};
+
+}   // namespace leveldb
@@ -0,0 +1,258 @@
+/**
+ * @file block.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "block.h"
+
+#include <cassert>
+#include <string>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/comparator.h"
+#include "format.h"
+
+namespace leveldb {
+
+inline uint32_t Block::NumRestarts() const {
+    assert(size_ >= sizeof(uint32_t));
+    return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+}
+
+Block::Block(const BlockContents& contents)
+    : data_(contents.data.data()), size_(contents.data.size()),
+      owned_(contents.heap_allocated) {
+    if(size_ < sizeof(uint32_t)) {
+        size_ = 0;  // 格式错误
+    } else {
+        size_t max_restarts_allowed = (size_ - sizeof(uint32_t)) / sizeof(uint32_t);
+        if(NumRestarts() > max_restarts_allowed) {
+            // 块太小, 放不下这么多重启点
+            size_ = 0;
+        } else {
+            restart_offset_ = size_ - (1 + NumRestarts()) * sizeof(uint32_t);
+        }
+    }
+}
+
+Block::~Block() {
+    if(owned_) delete[] data_;
+}
+
+/**
+ * @brief 解析从 p 开始的一条记录的三个长度, 不能越过 limit
+ *  三个长度都小于 128 时各占一个字节, 这是最常见的情况, 单独走快速路径
+ * @return 键的差异部分的起始位置, 数据非法时返回 nullptr
+ */
+static inline const char* DecodeEntry(const char* p, const char* limit, uint32_t* shared,
+                                      uint32_t* non_shared, uint32_t* value_length) {
+    if(limit - p < 3) return nullptr;
+    *shared = reinterpret_cast<const uint8_t*>(p)[0];
+    *non_shared = reinterpret_cast<const uint8_t*>(p)[1];
+    *value_length = reinterpret_cast<const uint8_t*>(p)[2];
+    if((*shared | *non_shared | *value_length) < 128) {
+        p += 3;
+    } else {
+        uint32_t lengths[3];
+        p = GetVarint32Batch(p, limit, lengths, 3);
+        if(p == nullptr) return nullptr;
+        *shared = lengths[0];
+        *non_shared = lengths[1];
+        *value_length = lengths[2];
+    }
+
+    if(static_cast<uint32_t>(limit - p) < (*non_shared + *value_length)) return nullptr;
+    return p;
+}
+
+class Block::Iter : public Iterator {
+public:
+    Iter(const Comparator* comparator, const char* data, uint32_t restarts, uint32_t num_restarts)
+        : comparator_(comparator), data_(data), restarts_(restarts), num_restarts_(num_restarts),
+          current_(restarts_), restart_index_(num_restarts_) {
+        assert(num_restarts_ > 0);
+    }
+
+    bool Valid() const override { return current_ < restarts_; }
+    Status status() const override { return status_; }
+    Slice key() const override {
+        assert(Valid());
+        return key_;
+    }
+    Slice value() const override {
+        assert(Valid());
+        return value_;
+    }
+
+    void Next() override {
+        assert(Valid());
+        ParseNextKey();
+    }
+
+    void Prev() override {
+        assert(Valid());
+
+        // 退回到 current_ 之前的那个重启点
+        const uint32_t original = current_;
+        while(GetRestartPoint(restart_index_) >= original) {
+            if(restart_index_ == 0) {
+                // 没有更前面的记录了
+                current_ = restarts_;
+                restart_index_ = num_restarts_;
+                return;
+            }
+            restart_index_--;
+        }
+
+        SeekToRestartPoint(restart_index_);
+        do {
+            // 一直扫描到 original 之前的那条记录
+        } while(ParseNextKey() && NextEntryOffset() < original);
+    }
+
+    void Seek(const Slice& target) override {
+        // 在重启点上二分, 找到最后一个键 < target 的重启点
+        uint32_t left = 0;
+        uint32_t right = num_restarts_ - 1;
+        int current_key_compare = 0;
+
+        if(Valid()) {
+            // 迭代器已经有位置时, 用当前键缩小二分的范围; 顺序的 Seek 经常落在同一个区间里
+            current_key_compare = Compare(key_, target);
+            if(current_key_compare < 0) {
+                // key_ 小于 target, 从当前位置往后找
+                left = restart_index_;
+            } else if(current_key_compare > 0) {
+                right = restart_index_;
+            } else {
+                // 恰好就是 target
+                return;
+            }
+        }
+
+        while(left < right) {
+            uint32_t mid = (left + right + 1) / 2;
+            uint32_t region_offset = GetRestartPoint(mid);
+            uint32_t shared, non_shared, value_length;
+            const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
+                                              &non_shared, &value_length);
+            if(key_ptr == nullptr || (shared != 0)) {
+                CorruptionError();
+                return;
+            }
+            Slice mid_key(key_ptr, non_shared);
+            if(Compare(mid_key, target) < 0) {
+                // mid 处的键 < target, mid 之前的重启点都不用看了
+                left = mid;
+            } else {
+                // mid 处的键 >= target, mid 及之后的重启点都不用看了
+                right = mid - 1;
+            }
+        }
+
+        // 二分结果仍是当前所在的区间且当前键 < target 时, 从当前位置继续扫描, 不用回到重启点
+        assert(current_key_compare == 0 || Valid());
+        bool skip_seek = left == restart_index_ && current_key_compare < 0;
+        if(!skip_seek) SeekToRestartPoint(left);
+        // 线性扫描到第一个 >= target 的键
+        while(true) {
+            if(!ParseNextKey()) return;
+            if(Compare(key_, target) >= 0) return;
+        }
+    }
+
+    void SeekToFirst() override {
+        SeekToRestartPoint(0);
+        ParseNextKey();
+    }
+
+    void SeekToLast() override {
+        SeekToRestartPoint(num_restarts_ - 1);
+        while(ParseNextKey() && NextEntryOffset() < restarts_) {
+            // 扫到最后一条记录
+        }
+    }
+
+private:
+    inline int Compare(const Slice& a, const Slice& b) const { return comparator_->Compare(a, b); }
+
+    // 当前记录之后的位置
+    inline uint32_t NextEntryOffset() const {
+        return static_cast<uint32_t>((value_.data() + value_.size()) - data_);
+    }
+
+    uint32_t GetRestartPoint(uint32_t index) {
+        assert(index < num_restarts_);
+        return DecodeFixed32(data_ + restarts_ + index * sizeof(uint32_t));
+    }
+
+    void SeekToRestartPoint(uint32_t index) {
+        key_.clear();
+        restart_index_ = index;
+        // current_ 由 ParseNextKey() 设置; ParseNextKey() 从 value_ 的末尾开始解析, 这里预先设置好
+        uint32_t offset = GetRestartPoint(index);
+        value_ = Slice(data_ + offset, 0);
+    }
+
+    void CorruptionError() {
+        current_ = restarts_;
+        restart_index_ = num_restarts_;
+        status_ = Status::Corruption("bad entry in block");
+        key_.clear();
+        value_.clear();
+    }
+
+    bool ParseNextKey() {
+        current_ = NextEntryOffset();
+        const char* p = data_ + current_;
+        const char* limit = data_ + restarts_;  // 记录部分到重启点数组为止
+        if(p >= limit) {
+            // 没有记录了, 标记为无效
+            current_ = restarts_;
+            restart_index_ = num_restarts_;
+            return false;
+        }
+
+        // 解析下一条记录
+        uint32_t shared, non_shared, value_length;
+        p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
+        if(p == nullptr || key_.size() < shared) {
+            CorruptionError();
+            return false;
+        }
+        key_.resize(shared);
+        key_.append(p, non_shared);
+        value_ = Slice(p + non_shared, value_length);
+        while(restart_index_ + 1 < num_restarts_ && GetRestartPoint(restart_index_ + 1) < current_) {
+            ++restart_index_;
+        }
+        return true;
+    }
+
+    const Comparator* const comparator_;
+    const char* const data_;       // 块内容
+    uint32_t const restarts_;      // 重启点数组的偏移(fixed32 数组)
+    uint32_t const num_restarts_;  // 重启点个数
+
+    // current_ 是当前记录在 data_ 中的偏移, >= restarts_ 表示无效
+    uint32_t current_;
+    uint32_t restart_index_;  // current_ 所在区间的重启点下标
+    std::string key_;
+    Slice value_;
+    Status status_;
+};
+
+Iterator* Block::NewIterator(const Comparator* comparator) {
+    if(size_ < sizeof(uint32_t)) return NewErrorIterator(Status::Corruption("bad block contents"));
+    const uint32_t num_restarts = NumRestarts();
+    if(num_restarts == 0) return NewEmptyIterator();
+    return new Iter(comparator, data_, restart_offset_, num_restarts);
+}
+
+}   // namespace leveldb
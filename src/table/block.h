@@ -0,0 +1,49 @@
+/**
+ * @file block.h
+ * @author alongnice
+ * @brief 只读的数据块, 格式见 block_builder.h
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "iterator.h"
+
+namespace leveldb {
+
+struct BlockContents;
+class Comparator;
+
+class Block {
+public:
+    // 用 contents 初始化, 块内容格式非法时 size() 为 0, 迭代器返回 Corruption
+    explicit Block(const BlockContents& contents);
+
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+
+    ~Block();
+
+    size_t size() const { return size_; }
+
+    // 返回的迭代器按 comparator 的顺序遍历块中的键值对
+    Iterator* NewIterator(const Comparator* comparator);
+
+private:
+    class Iter;
+
+    uint32_t NumRestarts() const;
+
+    const char* data_;
+    size_t size_;
+    uint32_t restart_offset_;  // 重启点数组在 data_ 中的偏移
+    bool owned_;               // Block 负责 delete[] data_
+};
+
+}   // namespace leveldb
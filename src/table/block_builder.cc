@@ -0,0 +1,82 @@
+/**
+ * @file block_builder.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "block_builder.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/comparator.h"
+#include "../../include/leveldb/options.h"
+
+namespace leveldb {
+
+BlockBuilder::BlockBuilder(const Options* options)
+    : options_(options), restarts_(), counter_(0), finished_(false) {
+    assert(options->block_restart_interval >= 1);
+    restarts_.push_back(0);  // 第一个重启点在偏移 0 处
+}
+
+void BlockBuilder::Reset() {
+    buffer_.clear();
+    restarts_.clear();
+    restarts_.push_back(0);
+    counter_ = 0;
+    finished_ = false;
+    last_key_.clear();
+}
+
+size_t BlockBuilder::CurrentSizeEstimate() const {
+    return (buffer_.size() +                        // 原始数据
+            restarts_.size() * sizeof(uint32_t) +   // 重启点数组
+            sizeof(uint32_t));                      // 重启点个数
+}
+
+Slice BlockBuilder::Finish() {
+    for(size_t i = 0; i < restarts_.size(); i++) PutFixed32(&buffer_, restarts_[i]);
+    PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+    finished_ = true;
+    return Slice(buffer_);
+}
+
+void BlockBuilder::Add(const Slice& key, const Slice& value) {
+    Slice last_key_piece(last_key_);
+    assert(!finished_);
+    assert(counter_ <= options_->block_restart_interval);
+    assert(buffer_.empty() || options_->comparator->Compare(key, last_key_piece) > 0);
+    size_t shared = 0;
+    if(counter_ < options_->block_restart_interval) {
+        // 与前一个键的公共前缀
+        shared = SharedPrefixLength(last_key_piece, key);
+    } else {
+        // 开始新的重启点, 键完整存储
+        restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
+        counter_ = 0;
+    }
+    const size_t non_shared = key.size() - shared;
+
+    // 三个长度
+    PutVarint32(&buffer_, static_cast<uint32_t>(shared));
+    PutVarint32(&buffer_, static_cast<uint32_t>(non_shared));
+    PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+
+    // 键的差异部分和值
+    buffer_.append(key.data() + shared, non_shared);
+    buffer_.append(value.data(), value.size());
+
+    last_key_.resize(shared);
+    last_key_.append(key.data() + shared, non_shared);
+    assert(Slice(last_key_) == key);
+    counter_++;
+}
+
+}   // namespace leveldb
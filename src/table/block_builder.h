@@ -0,0 +1,69 @@
+/**
+ * @file block_builder.h
+ * @author alongnice
+ * @brief 构造数据块: 键按顺序加入, 与前一个键共享的前缀只记长度, 每隔若干个键设置一个完整存储的重启点
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "slice.h"
+
+namespace leveldb {
+
+struct Options;
+
+class BlockBuilder {
+public:
+    explicit BlockBuilder(const Options* options);
+
+    BlockBuilder(const BlockBuilder&) = delete;
+    BlockBuilder& operator=(const BlockBuilder&) = delete;
+
+    // 清空内容, 就像刚构造出来一样
+    void Reset();
+
+    // 要求: 上一次 Reset 之后没有调用过 Finish, 且 key 大于之前加入的所有键
+    void Add(const Slice& key, const Slice& value);
+
+    // 写入重启点数组, 返回整个块的内容; 在 Reset 之前一直有效
+    Slice Finish();
+
+    // 当前块大小的估计值(未压缩)
+    size_t CurrentSizeEstimate() const;
+
+    bool empty() const { return buffer_.empty(); }
+
+private:
+    const Options* options_;
+    std::string buffer_;               // 目标缓冲
+    std::vector<uint32_t> restarts_;   // 重启点在块中的偏移
+    int counter_;                      // 上一个重启点之后加入的键数
+    bool finished_;                    // 是否已经调用过 Finish
+    std::string last_key_;
+};
+
+}   // namespace leveldb
+
+/**
+ * 块的格式:
+ *  entry[0..n-1]
+ *  restarts : fixed32[num_restarts]  // 每个重启点的偏移
+ *  num_restarts : fixed32
+ *
+ * entry :=
+ *  shared_bytes   : varint32  // 与前一个键共享的前缀长度, 重启点处为 0
+ *  unshared_bytes : varint32
+ *  value_length   : varint32
+ *  key_delta      : char[unshared_bytes]
+ *  value          : char[value_length]
+ *
+ * 查找时先在重启点上二分(重启点的键完整存储, 可以直接比较), 再从重启点开始线性扫描
+ */
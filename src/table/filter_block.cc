@@ -0,0 +1,103 @@
+/**
+ * @file filter_block.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "filter_block.h"
+
+#include <cassert>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/filter_policy.h"
+
+namespace leveldb {
+
+// 每 2KB 的数据块偏移生成一个过滤器
+static const size_t kFilterBaseLg = 11;
+static const size_t kFilterBase = 1 << kFilterBaseLg;
+
+FilterBlockBuilder::FilterBlockBuilder(const FilterPolicy* policy) : policy_(policy) {}
+
+void FilterBlockBuilder::StartBlock(uint64_t block_offset) {
+    uint64_t filter_index = (block_offset / kFilterBase);
+    assert(filter_index >= filter_offsets_.size());
+    while(filter_index > filter_offsets_.size()) GenerateFilter();
+}
+
+void FilterBlockBuilder::AddKey(const Slice& key) {
+    start_.push_back(keys_.size());
+    keys_.append(key.data(), key.size());
+}
+
+Slice FilterBlockBuilder::Finish() {
+    if(!start_.empty()) GenerateFilter();
+
+    // 追加偏移数组
+    const uint32_t array_offset = result_.size();
+    for(size_t i = 0; i < filter_offsets_.size(); i++) PutFixed32(&result_, filter_offsets_[i]);
+
+    PutFixed32(&result_, array_offset);
+    result_.push_back(kFilterBaseLg);
+    return Slice(result_);
+}
+
+void FilterBlockBuilder::GenerateFilter() {
+    const size_t num_keys = start_.size();
+    if(num_keys == 0) {
+        // 没有键, 直接记一个空过滤器
+        filter_offsets_.push_back(result_.size());
+        return;
+    }
+
+    // 由拼接的键还原出键列表
+    start_.push_back(keys_.size());  // 哨兵, 简化长度计算
+    tmp_keys_.resize(num_keys);
+    for(size_t i = 0; i < num_keys; i++) {
+        const char* base = keys_.data() + start_[i];
+        size_t length = start_[i + 1] - start_[i];
+        tmp_keys_[i] = Slice(base, length);
+    }
+
+    filter_offsets_.push_back(result_.size());
+    policy_->CreateFilter(&tmp_keys_[0], static_cast<int>(num_keys), &result_);
+
+    tmp_keys_.clear();
+    keys_.clear();
+    start_.clear();
+}
+
+FilterBlockReader::FilterBlockReader(const FilterPolicy* policy, const Slice& contents)
+    : policy_(policy), data_(nullptr), offset_(nullptr), num_(0), base_lg_(0) {
+    size_t n = contents.size();
+    if(n < 5) return;  // 至少要有 offset_array_start 和 base_lg
+    base_lg_ = contents[n - 1];
+    uint32_t last_word = DecodeFixed32(contents.data() + n - 5);
+    if(last_word > n - 5) return;
+    data_ = contents.data();
+    offset_ = data_ + last_word;
+    num_ = (n - 5 - last_word) / 4;
+}
+
+bool FilterBlockReader::KeyMayMatch(uint64_t block_offset, const Slice& key) const {
+    uint64_t index = block_offset >> base_lg_;
+    if(index < num_) {
+        uint32_t start = DecodeFixed32(offset_ + index * 4);
+        uint32_t limit = DecodeFixed32(offset_ + index * 4 + 4);
+        if(start <= limit && limit <= static_cast<size_t>(offset_ - data_)) {
+            Slice filter = Slice(data_ + start, limit - start);
+            return policy_->KeyMayMatch(key, filter);
+        } else if(start == limit) {
+            // 空过滤器不匹配任何键
+            return false;
+        }
+    }
+    return true;  // 出错时当作可能匹配
+}
+
+}   // namespace leveldb
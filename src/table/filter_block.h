@@ -0,0 +1,80 @@
+/**
+ * @file filter_block.h
+ * @author alongnice
+ * @brief 过滤块: 表文件中保存所有过滤器的元数据块, 按数据块在文件中的偏移每 2KB 生成一个过滤器
+ *  点查时根据数据块的偏移找到对应的过滤器, 键一定不存在时就不必读这个数据块
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "slice.h"
+
+namespace leveldb {
+
+class FilterPolicy;
+
+/**
+ * @brief 生成一个表的所有过滤器, 调用顺序必须符合 (StartBlock AddKey*)* Finish
+ */
+class FilterBlockBuilder {
+public:
+    explicit FilterBlockBuilder(const FilterPolicy* policy);
+
+    FilterBlockBuilder(const FilterBlockBuilder&) = delete;
+    FilterBlockBuilder& operator=(const FilterBlockBuilder&) = delete;
+
+    // 之后加入的键属于从 block_offset 开始的数据块
+    void StartBlock(uint64_t block_offset);
+    void AddKey(const Slice& key);
+    // 返回整个过滤块的内容, 在本对象析构之前一直有效
+    Slice Finish();
+
+private:
+    void GenerateFilter();
+
+    const FilterPolicy* policy_;
+    std::string keys_;             // 拼接在一起的键
+    std::vector<size_t> start_;    // 每个键在 keys_ 中的起始位置
+    std::string result_;           // 已经生成的过滤器
+    std::vector<Slice> tmp_keys_;  // 生成过滤器时传给 policy_ 的参数
+    std::vector<uint32_t> filter_offsets_;
+};
+
+class FilterBlockReader {
+public:
+    // 要求: contents 和 policy 在本对象存活期间一直有效
+    FilterBlockReader(const FilterPolicy* policy, const Slice& contents);
+
+    // 从 block_offset 开始的数据块中可能含有 key 时返回 true; 过滤块损坏时也返回 true
+    bool KeyMayMatch(uint64_t block_offset, const Slice& key) const;
+
+private:
+    const FilterPolicy* policy_;
+    const char* data_;    // 过滤块的起始位置
+    const char* offset_;  // 偏移数组的起始位置
+    size_t num_;          // 偏移数组的项数
+    size_t base_lg_;      // 每个过滤器覆盖 2^base_lg_ 字节的数据块偏移
+};
+
+}   // namespace leveldb
+
+/**
+ * 过滤块的格式:
+ *  filter[0..n-1]        // 第 i 个过滤器覆盖偏移在 [i * 2KB, (i + 1) * 2KB) 中开始的数据块
+ *  offset[0..n-1]        // fixed32, 每个过滤器在块中的起始位置
+ *  offset_array_start    // fixed32, 偏移数组的起始位置
+ *  base_lg               // 1 字节, 当前为 11 (2KB)
+ *
+ * 过滤器按数据块的偏移而不是按数据块划分, 读取时不需要额外的映射就能直接定位
+ * 一个数据块跨越多个 2KB 区间时, 后面的区间得到空过滤器, 空过滤器总是不匹配
+ * 元数据索引块中的键为 "filter." + 策略名称, 值为过滤块的 BlockHandle
+ */
@@ -0,0 +1,115 @@
+/**
+ * @file format.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "format.h"
+
+#include <cassert>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/crc32c.h"
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/options.h"
+
+namespace leveldb {
+
+void BlockHandle::EncodeTo(std::string* dst) const {
+    // 两个字段都必须已经设置过
+    assert(offset_ != ~static_cast<uint64_t>(0));
+    assert(size_ != ~static_cast<uint64_t>(0));
+    PutVarint64(dst, offset_);
+    PutVarint64(dst, size_);
+}
+
+Status BlockHandle::DecodeFrom(Slice* input) {
+    if(GetVarint64(input, &offset_) && GetVarint64(input, &size_)) return Status::OK();
+    return Status::Corruption("bad block handle");
+}
+
+void Footer::EncodeTo(std::string* dst) const {
+    const size_t original_size = dst->size();
+    metaindex_handle_.EncodeTo(dst);
+    index_handle_.EncodeTo(dst);
+    dst->resize(original_size + 2 * BlockHandle::kMaxEncodedLength);  // 补齐
+    PutFixed32(dst, static_cast<uint32_t>(kTableMagicNumber & 0xffffffffu));
+    PutFixed32(dst, static_cast<uint32_t>(kTableMagicNumber >> 32));
+    assert(dst->size() == original_size + kEncodedLength);
+}
+
+Status Footer::DecodeFrom(Slice* input) {
+    if(input->size() < kEncodedLength) return Status::Corruption("footer too short");
+    const char* magic_ptr = input->data() + kEncodedLength - 8;
+    const uint32_t magic_lo = DecodeFixed32(magic_ptr);
+    const uint32_t magic_hi = DecodeFixed32(magic_ptr + 4);
+    const uint64_t magic = (static_cast<uint64_t>(magic_hi) << 32) | magic_lo;
+    if(magic != kTableMagicNumber) return Status::Corruption("not an sstable (bad magic number)");
+
+    Status result = metaindex_handle_.DecodeFrom(input);
+    if(result.ok()) result = index_handle_.DecodeFrom(input);
+    if(result.ok()) {
+        // 跳过补齐和魔数
+        const char* end = magic_ptr + 8;
+        *input = Slice(end, input->data() + input->size() - end);
+    }
+    return result;
+}
+
+Status ReadBlock(RandomAccessFile* file, const ReadOptions& options, const BlockHandle& handle,
+                 BlockContents* result) {
+    result->data = Slice();
+    result->cachable = false;
+    result->heap_allocated = false;
+
+    // 连同尾部一次读出
+    size_t n = static_cast<size_t>(handle.size());
+    char* buf = new char[n + kBlockTrailerSize];
+    Slice contents;
+    Status s = file->Read(handle.offset(), n + kBlockTrailerSize, &contents, buf);
+    if(!s.ok()) {
+        delete[] buf;
+        return s;
+    }
+    if(contents.size() != n + kBlockTrailerSize) {
+        delete[] buf;
+        return Status::Corruption("truncated block read");
+    }
+
+    const char* data = contents.data();  // 文件实现可能返回自己的内存而不是 buf
+    if(options.verify_checksums) {
+        const uint32_t crc = crc32c::Unmask(DecodeFixed32(data + n + 1));
+        const uint32_t actual = crc32c::Value(data, n + 1);
+        if(actual != crc) {
+            delete[] buf;
+            return Status::Corruption("block checksum mismatch");
+        }
+    }
+
+    switch(data[n]) {
+        case kNoCompression:
+            if(data != buf) {
+                // 文件返回的是它自己持有的内存(如 mmap), 可以直接引用, 不需要缓存副本
+                delete[] buf;
+                result->data = Slice(data, n);
+                result->heap_allocated = false;
+                result->cachable = false;
+            } else {
+                result->data = Slice(buf, n);
+                result->heap_allocated = true;
+                result->cachable = true;
+            }
+            break;
+        default:
+            delete[] buf;
+            return Status::Corruption("bad block type");
+    }
+    return Status::OK();
+}
+
+}   // namespace leveldb
@@ -0,0 +1,118 @@
+/**
+ * @file format.h
+ * @author alongnice
+ * @brief 表文件的磁盘格式
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "slice.h"
+#include "status.h"
+
+namespace leveldb {
+
+class RandomAccessFile;
+struct ReadOptions;
+
+// 块的压缩类型, 记录在每个块的尾部; 目前只支持不压缩
+enum CompressionType {
+    kNoCompression = 0x0,
+};
+
+/**
+ * @brief 指向文件中一个块的位置和大小(不含尾部)
+ */
+class BlockHandle {
+public:
+    // 两个 varint64 的最大长度
+    enum { kMaxEncodedLength = 10 + 10 };
+
+    BlockHandle();
+
+    uint64_t offset() const { return offset_; }
+    void set_offset(uint64_t offset) { offset_ = offset; }
+
+    uint64_t size() const { return size_; }
+    void set_size(uint64_t size) { size_ = size; }
+
+    void EncodeTo(std::string* dst) const;
+    Status DecodeFrom(Slice* input);
+
+private:
+    uint64_t offset_;
+    uint64_t size_;
+};
+
+/**
+ * @brief 固定长度的文件尾, 位于每个表文件的末尾
+ */
+class Footer {
+public:
+    // 两个补齐到最大长度的句柄 + 8 字节魔数
+    enum { kEncodedLength = 2 * BlockHandle::kMaxEncodedLength + 8 };
+
+    Footer() = default;
+
+    const BlockHandle& metaindex_handle() const { return metaindex_handle_; }
+    void set_metaindex_handle(const BlockHandle& h) { metaindex_handle_ = h; }
+
+    const BlockHandle& index_handle() const { return index_handle_; }
+    void set_index_handle(const BlockHandle& h) { index_handle_ = h; }
+
+    void EncodeTo(std::string* dst) const;
+    Status DecodeFrom(Slice* input);
+
+private:
+    BlockHandle metaindex_handle_;
+    BlockHandle index_handle_;
+};
+
+// 文件尾的魔数
+static const uint64_t kTableMagicNumber = 0xdb4775248b80fb57ull;
+
+// 每个块后面跟 1 字节类型 + 4 字节 crc
+static const size_t kBlockTrailerSize = 5;
+
+/**
+ * @brief 读出的块内容及其内存归属
+ */
+struct BlockContents {
+    Slice data;           // 块的实际内容
+    bool cachable;        // 是否可以放进块缓存
+    bool heap_allocated;  // 为 true 时 data 由 new[] 分配, 使用者负责 delete[]
+};
+
+/**
+ * @brief 读取 handle 指向的块, 按 options 决定是否校验 crc
+ *  成功时 result 的数据归属见 BlockContents
+ */
+Status ReadBlock(RandomAccessFile* file, const ReadOptions& options, const BlockHandle& handle,
+                 BlockContents* result);
+
+inline BlockHandle::BlockHandle()
+    : offset_(~static_cast<uint64_t>(0)), size_(~static_cast<uint64_t>(0)) {}
+
+}   // namespace leveldb
+
+/**
+ * 表文件的格式:
+ *  [data block 1]
+ *  ...
+ *  [data block N]
+ *  [meta block 1]        // 目前只有过滤块, 见 filter_block.h
+ *  ...
+ *  [metaindex block]     // 元数据块名 -> BlockHandle
+ *  [index block]         // 分隔键 -> 数据块的 BlockHandle
+ *  [footer]              // 固定 48 字节
+ *
+ * 每个块后面都有 5 字节的尾部: type(1 字节压缩类型) + crc(4 字节, 覆盖块内容和 type, 经过 Mask)
+ * footer 中两个句柄按 varint 编码后补齐到 40 字节, 最后 8 字节是小端的魔数
+ * 读表时先读 footer, 再读 index block 常驻内存, 数据块按需读取, 设置了块缓存时解析好的数据块放进缓存
+ */
@@ -0,0 +1,89 @@
+/**
+ * @file iterator_wrapper.h
+ * @author alongnice
+ * @brief 迭代器的包装, 缓存 Valid() 和 key() 的结果
+ *  组合迭代器在内层迭代器上反复判断有效性和取键, 缓存之后省掉这些虚函数调用, 也更利于缓存局部性
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cassert>
+
+#include "iterator.h"
+
+namespace leveldb {
+
+class IteratorWrapper {
+public:
+    IteratorWrapper() : iter_(nullptr), valid_(false) {}
+    explicit IteratorWrapper(Iterator* iter) : iter_(nullptr) { Set(iter); }
+    ~IteratorWrapper() { delete iter_; }
+
+    Iterator* iter() const { return iter_; }
+
+    // 接管 iter, 之前持有的迭代器被删除
+    void Set(Iterator* iter) {
+        delete iter_;
+        iter_ = iter;
+        if(iter_ == nullptr) {
+            valid_ = false;
+        } else {
+            Update();
+        }
+    }
+
+    bool Valid() const { return valid_; }
+    Slice key() const {
+        assert(Valid());
+        return key_;
+    }
+    Slice value() const {
+        assert(Valid());
+        return iter_->value();
+    }
+    Status status() const {
+        assert(iter_);
+        return iter_->status();
+    }
+    void Next() {
+        assert(iter_);
+        iter_->Next();
+        Update();
+    }
+    void Prev() {
+        assert(iter_);
+        iter_->Prev();
+        Update();
+    }
+    void Seek(const Slice& k) {
+        assert(iter_);
+        iter_->Seek(k);
+        Update();
+    }
+    void SeekToFirst() {
+        assert(iter_);
+        iter_->SeekToFirst();
+        Update();
+    }
+    void SeekToLast() {
+        assert(iter_);
+        iter_->SeekToLast();
+        Update();
+    }
+
+private:
+    void Update() {
+        valid_ = iter_->Valid();
+        if(valid_) key_ = iter_->key();
+    }
+
+    Iterator* iter_;
+    bool valid_;
+    Slice key_;
+};
+
+}   // namespace leveldb
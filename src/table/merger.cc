@@ -0,0 +1,160 @@
+/**
+ * @file merger.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "merger.h"
+
+#include "../../include/leveldb/comparator.h"
+#include "../../include/leveldb/iterator.h"
+#include "iterator_wrapper.h"
+
+namespace leveldb {
+
+namespace {
+
+class MergingIterator : public Iterator {
+public:
+    MergingIterator(const Comparator* comparator, Iterator** children, int n)
+        : comparator_(comparator), children_(new IteratorWrapper[n]), n_(n), current_(nullptr),
+          direction_(kForward) {
+        for(int i = 0; i < n; i++) children_[i].Set(children[i]);
+    }
+
+    ~MergingIterator() override { delete[] children_; }
+
+    bool Valid() const override { return current_ != nullptr; }
+
+    void SeekToFirst() override {
+        for(int i = 0; i < n_; i++) children_[i].SeekToFirst();
+        FindSmallest();
+        direction_ = kForward;
+    }
+
+    void SeekToLast() override {
+        for(int i = 0; i < n_; i++) children_[i].SeekToLast();
+        FindLargest();
+        direction_ = kReverse;
+    }
+
+    void Seek(const Slice& target) override {
+        for(int i = 0; i < n_; i++) children_[i].Seek(target);
+        FindSmallest();
+        direction_ = kForward;
+    }
+
+    void Next() override {
+        assert(Valid());
+
+        // 反向切换到正向: 其他子迭代器都要定位到 key() 之后
+        // 当前子迭代器已经在 key() 上, 不用动
+        if(direction_ != kForward) {
+            for(int i = 0; i < n_; i++) {
+                IteratorWrapper* child = &children_[i];
+                if(child != current_) {
+                    child->Seek(key());
+                    if(child->Valid() && comparator_->Compare(key(), child->key()) == 0) child->Next();
+                }
+            }
+            direction_ = kForward;
+        }
+
+        current_->Next();
+        FindSmallest();
+    }
+
+    void Prev() override {
+        assert(Valid());
+
+        // 正向切换到反向: 其他子迭代器都要定位到 key() 之前
+        if(direction_ != kReverse) {
+            for(int i = 0; i < n_; i++) {
+                IteratorWrapper* child = &children_[i];
+                if(child != current_) {
+                    child->Seek(key());
+                    if(child->Valid()) {
+                        // 停在第一个 >= key() 的位置, 退一步
+                        child->Prev();
+                    } else {
+                        // 所有键都 < key()
+                        child->SeekToLast();
+                    }
+                }
+            }
+            direction_ = kReverse;
+        }
+
+        current_->Prev();
+        FindLargest();
+    }
+
+    Slice key() const override {
+        assert(Valid());
+        return current_->key();
+    }
+
+    Slice value() const override {
+        assert(Valid());
+        return current_->value();
+    }
+
+    Status status() const override {
+        for(int i = 0; i < n_; i++) {
+            Status s = children_[i].status();
+            if(!s.ok()) return s;
+        }
+        return Status::OK();
+    }
+
+private:
+    enum Direction { kForward, kReverse };
+
+    // 子迭代器个数很少(通常不超过十几个), 线性扫描比维护堆更快
+    void FindSmallest();
+    void FindLargest();
+
+    const Comparator* comparator_;
+    IteratorWrapper* children_;
+    int n_;
+    IteratorWrapper* current_;
+    Direction direction_;
+};
+
+void MergingIterator::FindSmallest() {
+    IteratorWrapper* smallest = nullptr;
+    for(int i = 0; i < n_; i++) {
+        IteratorWrapper* child = &children_[i];
+        if(child->Valid()) {
+            if(smallest == nullptr || comparator_->Compare(child->key(), smallest->key()) < 0) smallest = child;
+        }
+    }
+    current_ = smallest;
+}
+
+void MergingIterator::FindLargest() {
+    IteratorWrapper* largest = nullptr;
+    for(int i = n_ - 1; i >= 0; i--) {
+        IteratorWrapper* child = &children_[i];
+        if(child->Valid()) {
+            if(largest == nullptr || comparator_->Compare(child->key(), largest->key()) > 0) largest = child;
+        }
+    }
+    current_ = largest;
+}
+
+}   // namespace
+
+Iterator* NewMergingIterator(const Comparator* comparator, Iterator** children, int n) {
+    assert(n >= 0);
+    if(n == 0) return NewEmptyIterator();
+    if(n == 1) return children[0];
+    return new MergingIterator(comparator, children, n);
+}
+
+}   // namespace leveldb
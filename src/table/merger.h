@@ -0,0 +1,26 @@
+/**
+ * @file merger.h
+ * @author alongnice
+ * @brief 归并迭代器: 把多个有序的迭代器合成一个有序的迭代器
+ *  压缩时用它合并参与的各个表, 读 memtable 和各层文件的组合视图也用它
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+namespace leveldb {
+
+class Comparator;
+class Iterator;
+
+/**
+ * @brief 返回 children[0, n) 的归并结果, 接管所有子迭代器
+ *  不去重: 同一个键在多个子迭代器中出现时都会输出
+ */
+Iterator* NewMergingIterator(const Comparator* comparator, Iterator** children, int n);
+
+}   // namespace leveldb
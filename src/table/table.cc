@@ -0,0 +1,250 @@
+/**
+ * @file table.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/table.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "../../include/leveldb/cache.h"
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/comparator.h"
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/filter_policy.h"
+#include "block.h"
+#include "filter_block.h"
+#include "format.h"
+#include "two_level_iterator.h"
+
+namespace leveldb {
+
+// 过滤块在内存中的对齐, 与缓存行大小相同
+static const size_t kFilterAlignment = 64;
+
+struct Table::Rep {
+    ~Rep() {
+        delete filter;
+        delete[] filter_data;
+        delete index_block;
+    }
+
+    Options options;
+    Status status;
+    RandomAccessFile* file;
+    uint64_t cache_id;             // 块缓存中本表的键前缀
+    FilterBlockReader* filter;     // 没有过滤策略或文件中没有对应的过滤块时为空
+    const char* filter_data;       // 过滤块的内存由这里持有时非空
+
+    BlockHandle metaindex_handle;  // 元数据索引块的位置
+    Block* index_block;            // 打开时读入, 常驻内存
+};
+
+Status Table::Open(const Options& options, RandomAccessFile* file, uint64_t size, Table** table) {
+    *table = nullptr;
+    if(size < Footer::kEncodedLength) return Status::Corruption("file is too short to be an sstable");
+
+    char footer_space[Footer::kEncodedLength];
+    Slice footer_input;
+    Status s = file->Read(size - Footer::kEncodedLength, Footer::kEncodedLength, &footer_input,
+                          footer_space);
+    if(!s.ok()) return s;
+    if(footer_input.size() != Footer::kEncodedLength) return Status::Corruption("truncated footer read");
+
+    Footer footer;
+    s = footer.DecodeFrom(&footer_input);
+    if(!s.ok()) return s;
+
+    // 读入索引块
+    BlockContents index_block_contents;
+    ReadOptions opt;
+    if(options.paranoid_checks) opt.verify_checksums = true;
+    s = ReadBlock(file, opt, footer.index_handle(), &index_block_contents);
+    if(!s.ok()) return s;
+
+    Rep* rep = new Table::Rep;
+    rep->options = options;
+    rep->file = file;
+    rep->metaindex_handle = footer.metaindex_handle();
+    rep->index_block = new Block(index_block_contents);
+    rep->cache_id = (options.block_cache ? options.block_cache->NewId() : 0);
+    rep->filter = nullptr;
+    rep->filter_data = nullptr;
+    *table = new Table(rep);
+    (*table)->ReadMeta(footer);
+    return Status::OK();
+}
+
+void Table::ReadMeta(const Footer& footer) {
+    if(rep_->options.filter_policy == nullptr) return;  // 不需要任何元数据
+
+    // 元数据只用于加速, 读取出错不影响打开, 除非要求严格检查
+    ReadOptions opt;
+    if(rep_->options.paranoid_checks) opt.verify_checksums = true;
+    BlockContents contents;
+    if(!ReadBlock(rep_->file, opt, footer.metaindex_handle(), &contents).ok()) return;
+    Block* meta = new Block(contents);
+
+    // 元数据索引块的键是固定的字符串, 总是按字典序排列
+    Iterator* iter = meta->NewIterator(BytewiseComparator());
+    std::string key = "filter.";
+    key.append(rep_->options.filter_policy->Name());
+    iter->Seek(key);
+    if(iter->Valid() && iter->key() == Slice(key)) ReadFilter(iter->value());
+    delete iter;
+    delete meta;
+}
+
+void Table::ReadFilter(const Slice& filter_handle_value) {
+    Slice v = filter_handle_value;
+    BlockHandle filter_handle;
+    if(!filter_handle.DecodeFrom(&v).ok()) return;
+
+    ReadOptions opt;
+    if(rep_->options.paranoid_checks) opt.verify_checksums = true;
+    BlockContents block;
+    if(!ReadBlock(rep_->file, opt, filter_handle, &block).ok()) return;
+    Slice data = block.data;
+    if(reinterpret_cast<uintptr_t>(data.data()) % kFilterAlignment != 0) {
+        // 分块格式的过滤器按过滤块内 64 字节对齐, 过滤块本身也要对齐, 每次探测才只碰一个缓存行
+        char* buf = new char[data.size() + kFilterAlignment - 1];
+        char* aligned = buf + (kFilterAlignment - reinterpret_cast<uintptr_t>(buf) % kFilterAlignment) %
+                                  kFilterAlignment;
+        std::memcpy(aligned, data.data(), data.size());
+        if(block.heap_allocated) delete[] block.data.data();
+        rep_->filter_data = buf;  // 析构时释放
+        data = Slice(aligned, data.size());
+    } else if(block.heap_allocated) {
+        rep_->filter_data = block.data.data();  // 析构时释放
+    }
+    rep_->filter = new FilterBlockReader(rep_->options.filter_policy, data);
+}
+
+Table::~Table() { delete rep_; }
+
+static void DeleteBlock(void* arg, void* ignored) { delete reinterpret_cast<Block*>(arg); }
+
+static void DeleteCachedBlock(const Slice& key, void* value) {
+    Block* block = reinterpret_cast<Block*>(value);
+    delete block;
+}
+
+static void ReleaseBlock(void* arg, void* h) {
+    Cache* cache = reinterpret_cast<Cache*>(arg);
+    Cache::Handle* handle = reinterpret_cast<Cache::Handle*>(h);
+    cache->Release(handle);
+}
+
+// 把编码后的句柄转换成对应数据块的迭代器
+Iterator* Table::BlockReader(void* arg, const ReadOptions& options, const Slice& index_value) {
+    Table* table = reinterpret_cast<Table*>(arg);
+    Cache* block_cache = table->rep_->options.block_cache;
+    Block* block = nullptr;
+    Cache::Handle* cache_handle = nullptr;
+
+    BlockHandle handle;
+    Slice input = index_value;
+    Status s = handle.DecodeFrom(&input);
+    // 这里故意忽略 input 中剩余的内容, 以后可以在句柄后面追加信息
+    if(s.ok()) {
+        BlockContents contents;
+        if(block_cache != nullptr) {
+            // 缓存键: 表的 id + 块在文件中的偏移, 各 8 字节
+            char cache_key_buffer[16];
+            EncodeFixed64(cache_key_buffer, table->rep_->cache_id);
+            EncodeFixed64(cache_key_buffer + 8, handle.offset());
+            Slice key(cache_key_buffer, sizeof(cache_key_buffer));
+            cache_handle = block_cache->Lookup(key);
+            if(cache_handle != nullptr) {
+                block = reinterpret_cast<Block*>(block_cache->Value(cache_handle));
+            } else {
+                s = ReadBlock(table->rep_->file, options, handle, &contents);
+                if(s.ok()) {
+                    block = new Block(contents);
+                    if(contents.cachable && options.fill_cache) {
+                        cache_handle = block_cache->Insert(key, block, block->size(), &DeleteCachedBlock);
+                    }
+                }
+            }
+        } else {
+            s = ReadBlock(table->rep_->file, options, handle, &contents);
+            if(s.ok()) block = new Block(contents);
+        }
+    }
+
+    Iterator* iter;
+    if(block != nullptr) {
+        iter = block->NewIterator(table->rep_->options.comparator);
+        if(cache_handle == nullptr) {
+            iter->RegisterCleanup(&DeleteBlock, block, nullptr);
+        } else {
+            // 迭代器存活期间持有缓存句柄, 块不会被淘汰释放
+            iter->RegisterCleanup(&ReleaseBlock, block_cache, cache_handle);
+        }
+    } else {
+        iter = NewErrorIterator(s);
+    }
+    return iter;
+}
+
+Iterator* Table::NewIterator(const ReadOptions& options) const {
+    return NewTwoLevelIterator(rep_->index_block->NewIterator(rep_->options.comparator),
+                               &Table::BlockReader, const_cast<Table*>(this), options);
+}
+
+Status Table::InternalGet(const ReadOptions& options, const Slice& k, void* arg,
+                          void (*handle_result)(void*, const Slice&, const Slice&)) {
+    Status s;
+    Iterator* iiter = rep_->index_block->NewIterator(rep_->options.comparator);
+    iiter->Seek(k);
+    if(iiter->Valid()) {
+        // 索引键 >= 块内所有键, 第一个 >= k 的索引项就是唯一可能包含 k 的块
+        Slice handle_value = iiter->value();
+        FilterBlockReader* filter = rep_->filter;
+        BlockHandle handle;
+        if(filter != nullptr && handle.DecodeFrom(&handle_value).ok() &&
+           !filter->KeyMayMatch(handle.offset(), k)) {
+            // 过滤器确定键不在这个块中, 不必读取数据块
+        } else {
+            Iterator* block_iter = BlockReader(this, options, iiter->value());
+            block_iter->Seek(k);
+            if(block_iter->Valid()) (*handle_result)(arg, block_iter->key(), block_iter->value());
+            s = block_iter->status();
+            delete block_iter;
+        }
+    }
+    if(s.ok()) s = iiter->status();
+    delete iiter;
+    return s;
+}
+
+uint64_t Table::ApproximateOffsetOf(const Slice& key) const {
+    Iterator* index_iter = rep_->index_block->NewIterator(rep_->options.comparator);
+    index_iter->Seek(key);
+    uint64_t result;
+    if(index_iter->Valid()) {
+        BlockHandle handle;
+        Slice input = index_iter->value();
+        Status s = handle.DecodeFrom(&input);
+        if(s.ok()) {
+            result = handle.offset();
+        } else {
+            // 句柄损坏, 退回到元数据索引块的位置, 它接近文件末尾
+            result = rep_->metaindex_handle.offset();
+        }
+    } else {
+        // key 比表中所有键都大, 返回元数据索引块的位置, 它接近文件末尾
+        result = rep_->metaindex_handle.offset();
+    }
+    delete index_iter;
+    return result;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,201 @@
+/**
+ * @file table_builder.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/table_builder.h"
+
+#include <cassert>
+#include <string>
+
+#include "../../include/leveldb/coding.h"
+#include "../../include/leveldb/comparator.h"
+#include "../../include/leveldb/crc32c.h"
+#include "../../include/leveldb/env.h"
+#include "../../include/leveldb/filter_policy.h"
+#include "block_builder.h"
+#include "filter_block.h"
+#include "format.h"
+
+namespace leveldb {
+
+struct TableBuilder::Rep {
+    Rep(const Options& opt, WritableFile* f)
+        : options(opt), index_block_options(opt), file(f), offset(0), data_block(&options),
+          index_block(&index_block_options), num_entries(0), closed(false),
+          filter_block(opt.filter_policy == nullptr ? nullptr
+                                                    : new FilterBlockBuilder(opt.filter_policy)),
+          pending_index_entry(false) {
+        // 索引块很小且只做二分, 每个键都作为重启点, 省掉块内的线性扫描
+        index_block_options.block_restart_interval = 1;
+    }
+
+    Options options;
+    Options index_block_options;
+    WritableFile* file;
+    uint64_t offset;
+    Status status;
+    BlockBuilder data_block;
+    BlockBuilder index_block;
+    std::string last_key;
+    int64_t num_entries;
+    bool closed;  // 已调用 Finish 或 Abandon
+    FilterBlockBuilder* filter_block;  // 没有过滤策略时为空
+
+    // 数据块写出后并不马上加索引项, 而是等下一个块的第一个键到来
+    // 这样索引键可以取上一块最后一个键和下一块第一个键之间最短的分隔键
+    // 例如 "the quick brown fox" 和 "the who" 之间可以用 "the r"
+    // 不变量: 只有 data_block 为空时 pending_index_entry 才为 true
+    bool pending_index_entry;
+    BlockHandle pending_handle;  // 待加入索引的数据块句柄
+};
+
+TableBuilder::TableBuilder(const Options& options, WritableFile* file)
+    : rep_(new Rep(options, file)) {
+    if(rep_->filter_block != nullptr) rep_->filter_block->StartBlock(0);
+}
+
+TableBuilder::~TableBuilder() {
+    assert(rep_->closed);  // 忘了调用 Finish?
+    delete rep_->filter_block;
+    delete rep_;
+}
+
+void TableBuilder::Add(const Slice& key, const Slice& value) {
+    Rep* r = rep_;
+    assert(!r->closed);
+    if(!ok()) return;
+    if(r->num_entries > 0) assert(r->options.comparator->Compare(key, Slice(r->last_key)) > 0);
+
+    if(r->pending_index_entry) {
+        assert(r->data_block.empty());
+        r->options.comparator->FindShortestSeparator(&r->last_key, key);
+        std::string handle_encoding;
+        r->pending_handle.EncodeTo(&handle_encoding);
+        r->index_block.Add(r->last_key, Slice(handle_encoding));
+        r->pending_index_entry = false;
+    }
+
+    if(r->filter_block != nullptr) r->filter_block->AddKey(key);
+
+    r->last_key.assign(key.data(), key.size());
+    r->num_entries++;
+    r->data_block.Add(key, value);
+
+    const size_t estimated_block_size = r->data_block.CurrentSizeEstimate();
+    if(estimated_block_size >= r->options.block_size) Flush();
+}
+
+void TableBuilder::Flush() {
+    Rep* r = rep_;
+    assert(!r->closed);
+    if(!ok()) return;
+    if(r->data_block.empty()) return;
+    assert(!r->pending_index_entry);
+    WriteBlock(&r->data_block, &r->pending_handle);
+    if(ok()) {
+        r->pending_index_entry = true;
+        r->status = r->file->Flush();
+    }
+    if(r->filter_block != nullptr) r->filter_block->StartBlock(r->offset);
+}
+
+void TableBuilder::WriteBlock(BlockBuilder* block, BlockHandle* handle) {
+    // 文件中的格式:
+    //    block_data: uint8[n]
+    //    type: uint8
+    //    crc: uint32
+    assert(ok());
+    Slice raw = block->Finish();
+    WriteRawBlock(raw, kNoCompression, handle);
+    block->Reset();
+}
+
+void TableBuilder::WriteRawBlock(const Slice& block_contents, int type, BlockHandle* handle) {
+    Rep* r = rep_;
+    handle->set_offset(r->offset);
+    handle->set_size(block_contents.size());
+    r->status = r->file->Append(block_contents);
+    if(r->status.ok()) {
+        char trailer[kBlockTrailerSize];
+        trailer[0] = static_cast<char>(type);
+        uint32_t crc = crc32c::Value(block_contents.data(), block_contents.size());
+        crc = crc32c::Extend(crc, trailer, 1);  // crc 同时覆盖块类型
+        EncodeFixed32(trailer + 1, crc32c::Mask(crc));
+        r->status = r->file->Append(Slice(trailer, kBlockTrailerSize));
+        if(r->status.ok()) r->offset += block_contents.size() + kBlockTrailerSize;
+    }
+}
+
+Status TableBuilder::status() const { return rep_->status; }
+
+Status TableBuilder::Finish() {
+    Rep* r = rep_;
+    Flush();
+    assert(!r->closed);
+    r->closed = true;
+
+    BlockHandle filter_block_handle, metaindex_block_handle, index_block_handle;
+
+    // 过滤块, 过滤器本身已经很紧凑, 不需要块内的前缀压缩和重启点
+    if(ok() && r->filter_block != nullptr) {
+        WriteRawBlock(r->filter_block->Finish(), kNoCompression, &filter_block_handle);
+    }
+
+    // 元数据索引块
+    if(ok()) {
+        BlockBuilder meta_index_block(&r->options);
+        if(r->filter_block != nullptr) {
+            // "filter.<策略名>" -> 过滤块的位置
+            std::string key = "filter.";
+            key.append(r->options.filter_policy->Name());
+            std::string handle_encoding;
+            filter_block_handle.EncodeTo(&handle_encoding);
+            meta_index_block.Add(key, handle_encoding);
+        }
+        WriteBlock(&meta_index_block, &metaindex_block_handle);
+    }
+
+    // 索引块
+    if(ok()) {
+        if(r->pending_index_entry) {
+            // 最后一个块后面没有键了, 取最后一个键的短后继作为索引键
+            r->options.comparator->FindShortSuccessor(&r->last_key);
+            std::string handle_encoding;
+            r->pending_handle.EncodeTo(&handle_encoding);
+            r->index_block.Add(r->last_key, Slice(handle_encoding));
+            r->pending_index_entry = false;
+        }
+        WriteBlock(&r->index_block, &index_block_handle);
+    }
+
+    // 文件尾
+    if(ok()) {
+        Footer footer;
+        footer.set_metaindex_handle(metaindex_block_handle);
+        footer.set_index_handle(index_block_handle);
+        std::string footer_encoding;
+        footer.EncodeTo(&footer_encoding);
+        r->status = r->file->Append(footer_encoding);
+        if(r->status.ok()) r->offset += footer_encoding.size();
+    }
+    return r->status;
+}
+
+void TableBuilder::Abandon() {
+    Rep* r = rep_;
+    assert(!r->closed);
+    r->closed = true;
+}
+
+uint64_t TableBuilder::NumEntries() const { return rep_->num_entries; }
+
+uint64_t TableBuilder::FileSize() const { return rep_->offset; }
+
+}   // namespace leveldb
@@ -0,0 +1,149 @@
+/**
+ * @file two_level_iterator.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "two_level_iterator.h"
+
+#include <string>
+
+#include "../../include/leveldb/options.h"
+#include "iterator_wrapper.h"
+
+namespace leveldb {
+
+namespace {
+
+class TwoLevelIterator : public Iterator {
+public:
+    TwoLevelIterator(Iterator* index_iter, BlockFunction block_function, void* arg,
+                     const ReadOptions& options)
+        : block_function_(block_function), arg_(arg), options_(options), index_iter_(index_iter),
+          data_iter_(nullptr) {}
+
+    ~TwoLevelIterator() override = default;
+
+    void Seek(const Slice& target) override {
+        index_iter_.Seek(target);
+        InitDataBlock();
+        if(data_iter_.iter() != nullptr) data_iter_.Seek(target);
+        SkipEmptyDataBlocksForward();
+    }
+
+    void SeekToFirst() override {
+        index_iter_.SeekToFirst();
+        InitDataBlock();
+        if(data_iter_.iter() != nullptr) data_iter_.SeekToFirst();
+        SkipEmptyDataBlocksForward();
+    }
+
+    void SeekToLast() override {
+        index_iter_.SeekToLast();
+        InitDataBlock();
+        if(data_iter_.iter() != nullptr) data_iter_.SeekToLast();
+        SkipEmptyDataBlocksBackward();
+    }
+
+    void Next() override {
+        assert(Valid());
+        data_iter_.Next();
+        SkipEmptyDataBlocksForward();
+    }
+
+    void Prev() override {
+        assert(Valid());
+        data_iter_.Prev();
+        SkipEmptyDataBlocksBackward();
+    }
+
+    bool Valid() const override { return data_iter_.Valid(); }
+    Slice key() const override {
+        assert(Valid());
+        return data_iter_.key();
+    }
+    Slice value() const override {
+        assert(Valid());
+        return data_iter_.value();
+    }
+
+    Status status() const override {
+        // 先报索引的错误, 再报当前数据块的错误, 最后报之前丢弃的数据块留下的错误
+        if(!index_iter_.status().ok()) return index_iter_.status();
+        if(data_iter_.iter() != nullptr && !data_iter_.status().ok()) return data_iter_.status();
+        return status_;
+    }
+
+private:
+    void SaveError(const Status& s) {
+        if(status_.ok() && !s.ok()) status_ = s;
+    }
+
+    void SkipEmptyDataBlocksForward() {
+        while(data_iter_.iter() == nullptr || !data_iter_.Valid()) {
+            // 移到下一个数据块
+            if(!index_iter_.Valid()) {
+                SetDataIterator(nullptr);
+                return;
+            }
+            index_iter_.Next();
+            InitDataBlock();
+            if(data_iter_.iter() != nullptr) data_iter_.SeekToFirst();
+        }
+    }
+
+    void SkipEmptyDataBlocksBackward() {
+        while(data_iter_.iter() == nullptr || !data_iter_.Valid()) {
+            if(!index_iter_.Valid()) {
+                SetDataIterator(nullptr);
+                return;
+            }
+            index_iter_.Prev();
+            InitDataBlock();
+            if(data_iter_.iter() != nullptr) data_iter_.SeekToLast();
+        }
+    }
+
+    void SetDataIterator(Iterator* data_iter) {
+        if(data_iter_.iter() != nullptr) SaveError(data_iter_.status());
+        data_iter_.Set(data_iter);
+    }
+
+    void InitDataBlock() {
+        if(!index_iter_.Valid()) {
+            SetDataIterator(nullptr);
+            return;
+        }
+        Slice handle = index_iter_.value();
+        if(data_iter_.iter() != nullptr && handle.compare(data_block_handle_) == 0) {
+            // 仍是同一个数据块, 不需要重新打开
+            return;
+        }
+        Iterator* iter = (*block_function_)(arg_, options_, handle);
+        data_block_handle_.assign(handle.data(), handle.size());
+        SetDataIterator(iter);
+    }
+
+    BlockFunction block_function_;
+    void* arg_;
+    const ReadOptions options_;
+    Status status_;
+    IteratorWrapper index_iter_;
+    IteratorWrapper data_iter_;  // 可能为空
+    // data_iter_ 非空时, 保存打开它的索引值
+    std::string data_block_handle_;
+};
+
+}   // namespace
+
+Iterator* NewTwoLevelIterator(Iterator* index_iter, BlockFunction block_function, void* arg,
+                              const ReadOptions& options) {
+    return new TwoLevelIterator(index_iter, block_function, arg, options);
+}
+
+}   // namespace leveldb
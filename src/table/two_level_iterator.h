@@ -0,0 +1,29 @@
+/**
+ * @file two_level_iterator.h
+ * @author alongnice
+ * @brief 两层迭代器: 外层遍历索引, 每个索引值通过 block_function 打开一个内层迭代器
+ *  表的全量遍历就是索引块迭代器 + 数据块迭代器的组合
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "iterator.h"
+
+namespace leveldb {
+
+struct ReadOptions;
+
+// 把索引值(编码后的句柄)转换成内层迭代器
+typedef Iterator* (*BlockFunction)(void* arg, const ReadOptions& options, const Slice& index_value);
+
+/**
+ * @brief 返回的迭代器接管 index_iter, 依次遍历每个索引项对应的内层迭代器中的键值对
+ */
+Iterator* NewTwoLevelIterator(Iterator* index_iter, BlockFunction block_function, void* arg,
+                              const ReadOptions& options);
+
+}   // namespace leveldb
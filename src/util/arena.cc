@@ -11,29 +11,162 @@
 
 #include "../../include/leveldb/arena.h"
 
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace leveldb {
 
-static const int kBlockSize = 4096; // 每个内存块的大小
+const size_t Arena::kDefaultBlockSize;
+const size_t Arena::kMinBlockSize;
+const size_t Arena::kMaxBlockSize;
+const size_t Arena::kDefaultHugePageSize;
+const size_t Arena::kDefaultMaxRetainedBytes;
+const size_t BlockRecycler::kDefaultCapacity;
+
+namespace {
+/**
+ * @brief 按申请方式释放内存块
+ */
+void FreeBlock(const ArenaBlock& block) {
+#if defined(__linux__)
+    if(block.mmapped) {
+        munmap(block.data, block.size);
+        return;
+    }
+#endif
+    delete[] block.data;
+}
+
+/**
+ * @brief 修正块大小: 限制在合理范围内, 按 8 字节对齐, 大页模式下取整到大页的整数倍
+ */
+size_t OptimizeBlockSize(size_t block_size, size_t huge_page_size) {
+    block_size = std::max(Arena::kMinBlockSize, block_size);
+    block_size = std::min(Arena::kMaxBlockSize, block_size);
+    if(block_size % 8 != 0) block_size = (1 + block_size / 8) * 8;
+    if(huge_page_size > 0 && block_size % huge_page_size != 0) {
+        block_size = (1 + block_size / huge_page_size) * huge_page_size;
+    }
+    return block_size;
+}
+}   // namespace
+
+BlockRecycler::BlockRecycler(size_t capacity) : capacity_(capacity), retained_bytes_(0) {}
+
+BlockRecycler::~BlockRecycler() {
+    for(size_t it = 0; it < blocks_.size(); ++it) FreeBlock(blocks_[it]);
+}
+
+bool BlockRecycler::Take(size_t size, bool mmapped, ArenaBlock* block) {
+    std::lock_guard<std::mutex> l(mu_);
+    // 从尾部找, 最近归还的块更可能还在缓存中
+    for(size_t it = blocks_.size(); it > 0; --it) {
+        const ArenaBlock& b = blocks_[it - 1];
+        if(b.size == size && b.mmapped == mmapped) {
+            *block = b;
+            blocks_[it - 1] = blocks_.back();
+            blocks_.pop_back();
+            retained_bytes_ -= size;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BlockRecycler::Give(const ArenaBlock& block) {
+    std::lock_guard<std::mutex> l(mu_);
+    if(retained_bytes_ + block.size > capacity_) return false;
+    blocks_.push_back(block);
+    retained_bytes_ += block.size;
+    return true;
+}
+
+size_t BlockRecycler::RetainedBytes() const {
+    std::lock_guard<std::mutex> l(mu_);
+    return retained_bytes_;
+}
 
-Arena::Arena() 
-    : alloc_ptr_(nullptr), alloc_bytes_remaining_(0), memory_usage_(0) {}
+BlockRecycler* BlockRecycler::Default() {
+    static BlockRecycler instance(kDefaultCapacity);
+    return &instance;
+}
+
+Arena::Arena(size_t block_size, size_t huge_page_size, BlockRecycler* recycler)
+    : block_size_(OptimizeBlockSize(block_size, huge_page_size)),
+      huge_page_size_(huge_page_size), recycler_(recycler),
+      alloc_ptr_(nullptr), alloc_bytes_remaining_(0), memory_usage_(0) {}
     // 初始化内存池
 
 Arena::~Arena(){
     // 释放所有分配的内存块
+    for(size_t it = 0; it < blocks_.size(); ++it) ReleaseBlock(blocks_[it]);
+    for(size_t it = 0; it < free_blocks_.size(); ++it) ReleaseBlock(free_blocks_[it]);
+}
+
+void Arena::Reset(size_t max_retained_bytes) {
+    // 上一轮保留但没有用完的块也受本次上限约束
+    while(!free_blocks_.empty() && RetainedBytes() > max_retained_bytes) {
+        ReleaseBlock(free_blocks_.back());
+        free_blocks_.pop_back();
+    }
+    size_t retained = RetainedBytes();
     for(size_t it = 0; it < blocks_.size(); ++it) {
-        delete[] blocks_[it];
+        const ArenaBlock& b = blocks_[it];
+        if(b.size == block_size_ && retained + b.size <= max_retained_bytes) {
+            free_blocks_.push_back(b);
+            retained += b.size;
+        } else {
+            ReleaseBlock(b);
+        }
     }
+    blocks_.clear();
+    alloc_ptr_ = nullptr;
+    alloc_bytes_remaining_ = 0;
+    memory_usage_.store(0, std::memory_order_relaxed);
+}
+
+size_t Arena::MmapBlockCount() const {
+    size_t count = 0;
+    for(size_t it = 0; it < blocks_.size(); ++it) {
+        if(blocks_[it].mmapped) count++;
+    }
+    return count;
+}
+
+void Arena::ReleaseBlock(const ArenaBlock& block) {
+    // 只有普通块才值得回收, 大块大小不固定很难被再次使用
+    if(recycler_ != nullptr && block.size == block_size_ && recycler_->Give(block)) return;
+    FreeBlock(block);
+}
+
+char* Arena::AllocateRegularBlock() {
+    ArenaBlock b;
+    if(!free_blocks_.empty()) {
+        b = free_blocks_.back();
+        free_blocks_.pop_back();
+    } else if(recycler_ == nullptr || !recycler_->Take(block_size_, huge_page_size_ > 0, &b)) {
+        // 普通块优先尝试大页, 失败再走 new char[]
+        char* result = nullptr;
+        if(huge_page_size_ > 0) result = AllocateMmapBlock(block_size_);
+        if(result == nullptr) result = AllocateNewBlock(block_size_);
+        return result;
+    }
+    blocks_.push_back(b);
+    memory_usage_.fetch_add(b.size + sizeof(char*), std::memory_order_relaxed);
+    return b.data;
 }
 
 char* Arena::AllocateFallback(size_t bytes) {
-    if (bytes>kBlockSize/4){
+    if (bytes>block_size_/4){
         char* result = AllocateNewBlock(bytes);
         return result;
     }
 
-    alloc_ptr_ = AllocateNewBlock(kBlockSize);
-    alloc_bytes_remaining_ = kBlockSize;
+    alloc_ptr_ = AllocateRegularBlock();
+    alloc_bytes_remaining_ = block_size_;
 
     char* result = alloc_ptr_;
     alloc_ptr_ += bytes;
@@ -93,9 +226,39 @@ char* Arena::AllocateAligned(size_t bytes) {
 
 char* Arena::AllocateNewBlock(size_t block_bytes) {
     char* result = new char[block_bytes];
-    blocks_.push_back(result);
+    blocks_.push_back(ArenaBlock{result, block_bytes, false});
+    memory_usage_.fetch_add(block_bytes + sizeof(char*), std::memory_order_relaxed);
+    return result;
+}
+
+char* Arena::AllocateMmapBlock(size_t block_bytes) {
+#if defined(__linux__)
+    assert(huge_page_size_ > 0 && block_bytes % huge_page_size_ == 0);
+    // 透明大页要求地址按大页对齐: 多申请一个大页, 再把首尾未对齐的部分还回去
+    const size_t reserve = block_bytes + huge_page_size_;
+    void* addr = mmap(nullptr, reserve, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(addr == MAP_FAILED) return nullptr;
+
+    char* raw = static_cast<char*>(addr);
+    const uintptr_t mod = reinterpret_cast<uintptr_t>(raw) % huge_page_size_;
+    const size_t head = (mod == 0) ? 0 : huge_page_size_ - mod;
+    char* result = raw + head;
+    if(head > 0) munmap(raw, head);
+    const size_t tail = reserve - head - block_bytes;
+    if(tail > 0) munmap(result + block_bytes, tail);
+
+#if defined(MADV_HUGEPAGE)
+    // 内核未开启透明大页时这里会失败, 内存依然可用, 只是退化为普通页
+    madvise(result, block_bytes, MADV_HUGEPAGE);
+#endif
+    blocks_.push_back(ArenaBlock{result, block_bytes, true});
     memory_usage_.fetch_add(block_bytes + sizeof(char*), std::memory_order_relaxed);
     return result;
+#else
+    (void)block_bytes;
+    return nullptr;
+#endif
 }
 
 }   // namespace leveldb
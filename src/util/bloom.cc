@@ -0,0 +1,195 @@
+/**
+ * @file bloom.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/filter_policy.h"
+
+#include <cstring>
+
+#include "../../include/leveldb/hash.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace leveldb {
+
+FilterPolicy::~FilterPolicy() = default;
+
+namespace {
+
+static uint32_t BloomHash(const Slice& key) { return Hash(key.data(), key.size(), 0xbc9f1d34); }
+
+// 分块格式的过滤器以这个字节结尾; 经典格式的最后一个字节是探测次数, 不会超过 30
+static const char kBlockedBloomMarker = static_cast<char>(0xff);
+// 分块格式的尾部: 对齐填充的字节数(1) + 探测次数(1) + 标记(1)
+static const size_t kBlockedBloomTrailer = 3;
+static const size_t kCacheLineSize = 64;
+
+/**
+ * @brief 分块格式中 key 的 k 个探测位, 全部落在同一个 512 位的缓存行内, 按字节写入 mask
+ *  行号取哈希值的高位(乘法映射), 行内位置取 h * 黄金比例常数逐次相乘后的高 9 位, 两者互不干扰
+ */
+static inline void BlockedProbeMask(uint32_t h, size_t k, char mask[kCacheLineSize]) {
+    std::memset(mask, 0, kCacheLineSize);
+    uint32_t h2 = h * 0x9e3779b9u;
+    for(size_t j = 0; j < k; j++) {
+        const uint32_t bitpos = h2 >> 23;  // 0..511
+        mask[bitpos >> 3] |= static_cast<char>(1 << (bitpos & 7));
+        h2 *= 0x9e3779b9u;
+    }
+}
+
+static inline size_t BlockedLine(uint32_t h, size_t num_lines) {
+    // 把 [0, 2^32) 均匀映射到 [0, num_lines), 用乘法代替取模
+    return static_cast<size_t>((static_cast<uint64_t>(h) * num_lines) >> 32);
+}
+
+/**
+ * @brief line 中包含 mask 的所有位时返回 true
+ *  SSE2 下 4 次 128 位的与/比较一次检查全部探测位, 没有随探测次数增长的分支
+ */
+static inline bool BlockedLineContains(const char* line, const char* mask) {
+#if defined(__SSE2__)
+    __m128i ok = _mm_set1_epi32(-1);
+    for(size_t i = 0; i < kCacheLineSize; i += 16) {
+        const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + i));
+        const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        ok = _mm_and_si128(ok, _mm_cmpeq_epi32(_mm_and_si128(bits, m), m));
+    }
+    return _mm_movemask_epi8(ok) == 0xffff;
+#else
+    uint64_t missing = 0;
+    for(size_t i = 0; i < kCacheLineSize; i += 8) {
+        uint64_t bits, m;
+        std::memcpy(&bits, line + i, 8);
+        std::memcpy(&m, mask + i, 8);
+        missing |= m & ~bits;
+    }
+    return missing == 0;
+#endif
+}
+
+class BloomFilterPolicy : public FilterPolicy {
+public:
+    BloomFilterPolicy(int bits_per_key, BloomFilterFormat format)
+        : bits_per_key_(bits_per_key), format_(format) {
+        // 探测次数取 bits_per_key * ln(2) 时误判率最低, 向下取整以减少探测开销
+        k_ = static_cast<size_t>(bits_per_key * 0.69);  // 0.69 =~ ln(2)
+        if(k_ < 1) k_ = 1;
+        if(k_ > 30) k_ = 30;
+    }
+
+    // 两种格式共用一个名称: 过滤器自身记录了格式, 读取时按格式分派, 切换格式不影响已有的表
+    const char* Name() const override { return "leveldb.BuiltinBloomFilter2"; }
+
+    void CreateFilter(const Slice* keys, int n, std::string* dst) const override {
+        if(format_ == kBlockedBloomFormat) {
+            CreateBlockedFilter(keys, n, dst);
+            return;
+        }
+
+        // 位数组大小, 键很少时误判率会很高, 至少给 64 位
+        size_t bits = n * bits_per_key_;
+        if(bits < 64) bits = 64;
+        size_t bytes = (bits + 7) / 8;
+        bits = bytes * 8;
+
+        const size_t init_size = dst->size();
+        dst->resize(init_size + bytes, 0);
+        dst->push_back(static_cast<char>(k_));  // 记下探测次数, 读取时不依赖当前参数
+        char* array = &(*dst)[init_size];
+        for(int i = 0; i < n; i++) {
+            // 双重哈希: 用一个哈希值和它的循环移位生成 k 个探测位置 h + i * delta
+            uint32_t h = BloomHash(keys[i]);
+            const uint32_t delta = (h >> 17) | (h << 15);  // 右循环移位 17 位
+            for(size_t j = 0; j < k_; j++) {
+                const uint32_t bitpos = h % bits;
+                array[bitpos / 8] |= (1 << (bitpos % 8));
+                h += delta;
+            }
+        }
+    }
+
+    bool KeyMayMatch(const Slice& key, const Slice& bloom_filter) const override {
+        const size_t len = bloom_filter.size();
+        if(len < 2) return false;
+
+        const char* array = bloom_filter.data();
+        if(array[len - 1] == kBlockedBloomMarker) return BlockedKeyMayMatch(key, bloom_filter);
+
+        const size_t bits = (len - 1) * 8;
+
+        // 使用生成时的探测次数, 不同参数生成的过滤器也能正确读取
+        const size_t k = array[len - 1];
+        if(k > 30) {
+            // 保留给以后的新编码方式, 一律视为匹配
+            return true;
+        }
+
+        uint32_t h = BloomHash(key);
+        const uint32_t delta = (h >> 17) | (h << 15);
+        for(size_t j = 0; j < k; j++) {
+            const uint32_t bitpos = h % bits;
+            if((array[bitpos / 8] & (1 << (bitpos % 8))) == 0) return false;
+            h += delta;
+        }
+        return true;
+    }
+
+private:
+    void CreateBlockedFilter(const Slice* keys, int n, std::string* dst) const {
+        size_t bytes = (static_cast<size_t>(n) * bits_per_key_ + 7) / 8;
+        const size_t num_lines = bytes < kCacheLineSize ? 1 : (bytes + kCacheLineSize - 1) / kCacheLineSize;
+
+        // 填充到 dst 中 64 字节对齐的位置, 过滤块本身对齐时每一行正好占一个缓存行
+        const size_t pad = (kCacheLineSize - dst->size() % kCacheLineSize) % kCacheLineSize;
+        const size_t init_size = dst->size();
+        dst->resize(init_size + pad + num_lines * kCacheLineSize, 0);
+        dst->push_back(static_cast<char>(pad));
+        dst->push_back(static_cast<char>(k_));
+        dst->push_back(kBlockedBloomMarker);
+
+        char* array = &(*dst)[init_size + pad];
+        char mask[kCacheLineSize];
+        for(int i = 0; i < n; i++) {
+            const uint32_t h = BloomHash(keys[i]);
+            char* line = array + BlockedLine(h, num_lines) * kCacheLineSize;
+            BlockedProbeMask(h, k_, mask);
+            for(size_t j = 0; j < kCacheLineSize; j++) line[j] |= mask[j];
+        }
+    }
+
+    static bool BlockedKeyMayMatch(const Slice& key, const Slice& filter) {
+        const size_t len = filter.size();
+        if(len < kBlockedBloomTrailer) return true;  // 格式错误, 视为匹配
+        const size_t pad = static_cast<uint8_t>(filter[len - 3]);
+        const size_t k = static_cast<uint8_t>(filter[len - 2]);
+        if(len < kBlockedBloomTrailer + pad + kCacheLineSize || k > 30) return true;
+        const size_t num_lines = (len - kBlockedBloomTrailer - pad) / kCacheLineSize;
+
+        const uint32_t h = BloomHash(key);
+        alignas(16) char mask[kCacheLineSize];
+        BlockedProbeMask(h, k, mask);
+        return BlockedLineContains(filter.data() + pad + BlockedLine(h, num_lines) * kCacheLineSize, mask);
+    }
+
+    size_t bits_per_key_;
+    size_t k_;
+    BloomFilterFormat format_;
+};
+
+}   // namespace
+
+const FilterPolicy* NewBloomFilterPolicy(int bits_per_key, BloomFilterFormat format) {
+    return new BloomFilterPolicy(bits_per_key, format);
+}
+
+}   // namespace leveldb
@@ -0,0 +1,788 @@
+/**
+ * @file cache.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/cache.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "../../include/leveldb/hash.h"
+
+namespace leveldb {
+
+Cache::~Cache() = default;
+
+namespace {
+
+/**
+ * @brief 缓存条目, 分配在堆上, 键紧跟在结构体后面
+ *  条目同时挂在哈希表和两条链表之一上:
+ *   in_use_ : 被外部句柄引用的条目, 顺序无意义
+ *   lru_    : 只被缓存自身引用的条目, 按最近使用排序, 淘汰从这里开始
+ *  条目被外部 Lookup 时从 lru_ 移到 in_use_, 最后一个句柄释放后移回 lru_
+ */
+struct LRUHandle {
+    void* value;
+    void (*deleter)(const Slice&, void* value);
+    LRUHandle* next_hash;
+    LRUHandle* next;
+    LRUHandle* prev;
+    size_t charge;
+    size_t key_length;
+    bool in_cache;     // 是否仍在缓存中(未被淘汰或删除)
+    uint32_t refs;     // 引用数, 在缓存中时包含缓存自身的一个引用
+    uint32_t hash;     // key 的哈希, 用于分片和快速比较
+    char key_data[1];  // 键的起始位置
+
+    Slice key() const {
+        // 只有链表头的 next 等于自身, 链表头没有有意义的键
+        assert(next != this);
+        return Slice(key_data, key_length);
+    }
+};
+
+/**
+ * @brief 简单的开链哈希表, 比标准库的实现快一些
+ *  桶数始终不少于条目数, 平均每个桶不超过一个条目
+ *  Handle 需要提供 key()、hash 和 next_hash
+ */
+template <typename Handle>
+class HandleTable {
+public:
+    HandleTable() : length_(0), elems_(0), list_(nullptr) { Resize(); }
+    ~HandleTable() { delete[] list_; }
+
+    Handle* Lookup(const Slice& key, uint32_t hash) { return *FindPointer(key, hash); }
+
+    // 插入 h, 返回被替换掉的同键旧条目, 没有时返回 nullptr
+    Handle* Insert(Handle* h) {
+        Handle** ptr = FindPointer(h->key(), h->hash);
+        Handle* old = *ptr;
+        h->next_hash = (old == nullptr ? nullptr : old->next_hash);
+        *ptr = h;
+        if(old == nullptr) {
+            ++elems_;
+            if(elems_ > length_) Resize();
+        }
+        return old;
+    }
+
+    Handle* Remove(const Slice& key, uint32_t hash) {
+        Handle** ptr = FindPointer(key, hash);
+        Handle* result = *ptr;
+        if(result != nullptr) {
+            *ptr = result->next_hash;
+            --elems_;
+        }
+        return result;
+    }
+
+private:
+    // 返回指向匹配条目的指针槽; 没有匹配时返回桶链表末尾的槽
+    Handle** FindPointer(const Slice& key, uint32_t hash) {
+        Handle** ptr = &list_[hash & (length_ - 1)];
+        while(*ptr != nullptr && ((*ptr)->hash != hash || key != (*ptr)->key())) {
+            ptr = &(*ptr)->next_hash;
+        }
+        return ptr;
+    }
+
+    void Resize() {
+        uint32_t new_length = 4;
+        while(new_length < elems_) new_length *= 2;
+        Handle** new_list = new Handle*[new_length];
+        std::memset(new_list, 0, sizeof(new_list[0]) * new_length);
+        uint32_t count = 0;
+        for(uint32_t i = 0; i < length_; i++) {
+            Handle* h = list_[i];
+            while(h != nullptr) {
+                Handle* next = h->next_hash;
+                Handle** ptr = &new_list[h->hash & (new_length - 1)];
+                h->next_hash = *ptr;
+                *ptr = h;
+                h = next;
+                count++;
+            }
+        }
+        assert(elems_ == count);
+        delete[] list_;
+        list_ = new_list;
+        length_ = new_length;
+    }
+
+    uint32_t length_;  // 桶数, 总是 2 的幂
+    uint32_t elems_;
+    Handle** list_;
+};
+
+/**
+ * @brief 分片缓存中的一个分片
+ */
+class LRUCache {
+public:
+    LRUCache();
+    ~LRUCache();
+
+    // 与构造分开, 便于分片数组直接默认构造
+    void SetCapacity(size_t capacity) { capacity_ = capacity; }
+
+    static uint32_t HandleHash(Cache::Handle* h) { return reinterpret_cast<LRUHandle*>(h)->hash; }
+    static void* HandleValue(Cache::Handle* h) { return reinterpret_cast<LRUHandle*>(h)->value; }
+
+    // 与 Cache 中的同名方法相同, 多了调用方算好的哈希值
+    Cache::Handle* Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                          void (*deleter)(const Slice& key, void* value));
+    Cache::Handle* Lookup(const Slice& key, uint32_t hash);
+    void Release(Cache::Handle* handle);
+    void Erase(const Slice& key, uint32_t hash);
+    void Prune();
+    size_t TotalCharge() const {
+        std::lock_guard<std::mutex> l(mutex_);
+        return usage_;
+    }
+    // 把本分片的统计累加到 stats
+    void AddStats(Cache::Stats* stats) const {
+        std::lock_guard<std::mutex> l(mutex_);
+        stats->hits += stats_.hits;
+        stats->misses += stats_.misses;
+        stats->inserts += stats_.inserts;
+        stats->evictions += stats_.evictions;
+    }
+
+private:
+    void LRU_Remove(LRUHandle* e);
+    void LRU_Append(LRUHandle* list, LRUHandle* e);
+    void Ref(LRUHandle* e);
+    void Unref(LRUHandle* e);
+    bool FinishErase(LRUHandle* e);
+
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    size_t usage_;  // 以下成员都由 mutex_ 保护
+
+    // lru_.prev 是最新的条目, lru_.next 是最旧的条目
+    // 这条链表上的条目 refs == 1 且 in_cache == true
+    LRUHandle lru_;
+
+    // 被外部引用的条目, refs >= 2 且 in_cache == true
+    LRUHandle in_use_;
+
+    HandleTable<LRUHandle> table_;
+    Cache::Stats stats_;
+};
+
+LRUCache::LRUCache() : capacity_(0), usage_(0) {
+    // 空的循环链表
+    lru_.next = &lru_;
+    lru_.prev = &lru_;
+    in_use_.next = &in_use_;
+    in_use_.prev = &in_use_;
+}
+
+LRUCache::~LRUCache() {
+    assert(in_use_.next == &in_use_);  // 调用方还持有未释放的句柄
+    for(LRUHandle* e = lru_.next; e != &lru_;) {
+        LRUHandle* next = e->next;
+        assert(e->in_cache);
+        e->in_cache = false;
+        assert(e->refs == 1);  // lru_ 上的条目不变量
+        Unref(e);
+        e = next;
+    }
+}
+
+void LRUCache::Ref(LRUHandle* e) {
+    if(e->refs == 1 && e->in_cache) {
+        // 在 lru_ 上, 被外部引用后移到 in_use_
+        LRU_Remove(e);
+        LRU_Append(&in_use_, e);
+    }
+    e->refs++;
+}
+
+void LRUCache::Unref(LRUHandle* e) {
+    assert(e->refs > 0);
+    e->refs--;
+    if(e->refs == 0) {
+        // 已经不在缓存中, 释放
+        assert(!e->in_cache);
+        (*e->deleter)(e->key(), e->value);
+        std::free(e);
+    } else if(e->in_cache && e->refs == 1) {
+        // 外部不再引用, 移回 lru_
+        LRU_Remove(e);
+        LRU_Append(&lru_, e);
+    }
+}
+
+void LRUCache::LRU_Remove(LRUHandle* e) {
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+}
+
+void LRUCache::LRU_Append(LRUHandle* list, LRUHandle* e) {
+    // 放在 list 之前, 成为最新的条目
+    e->next = list;
+    e->prev = list->prev;
+    e->prev->next = e;
+    e->next->prev = e;
+}
+
+Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash) {
+    std::lock_guard<std::mutex> l(mutex_);
+    LRUHandle* e = table_.Lookup(key, hash);
+    if(e != nullptr) {
+        stats_.hits++;
+        Ref(e);
+    } else {
+        stats_.misses++;
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void LRUCache::Release(Cache::Handle* handle) {
+    std::lock_guard<std::mutex> l(mutex_);
+    Unref(reinterpret_cast<LRUHandle*>(handle));
+}
+
+Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                                void (*deleter)(const Slice& key, void* value)) {
+    std::lock_guard<std::mutex> l(mutex_);
+
+    // 键紧跟在结构体之后, 一次分配
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(std::malloc(sizeof(LRUHandle) - 1 + key.size()));
+    e->value = value;
+    e->deleter = deleter;
+    e->charge = charge;
+    e->key_length = key.size();
+    e->hash = hash;
+    e->in_cache = false;
+    e->refs = 1;  // 返回给调用方的句柄
+    std::memcpy(e->key_data, key.data(), key.size());
+    stats_.inserts++;
+
+    if(capacity_ > 0) {
+        e->refs++;  // 缓存自身的引用
+        e->in_cache = true;
+        LRU_Append(&in_use_, e);
+        usage_ += charge;
+        FinishErase(table_.Insert(e));
+    } else {
+        // 容量为 0 表示关闭缓存, 条目不进缓存, 句柄释放时直接删除
+        e->next = nullptr;
+    }
+    while(usage_ > capacity_ && lru_.next != &lru_) {
+        // 从最旧的条目开始淘汰, 被外部引用的条目不淘汰, 所以实际占用可能暂时超过容量
+        LRUHandle* old = lru_.next;
+        assert(old->refs == 1);
+        FinishErase(table_.Remove(old->key(), old->hash));
+        stats_.evictions++;
+    }
+
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+// e 已经从哈希表中移除时, 把它移出缓存并去掉缓存自身的引用; e 为空时返回 false
+bool LRUCache::FinishErase(LRUHandle* e) {
+    if(e != nullptr) {
+        assert(e->in_cache);
+        LRU_Remove(e);
+        e->in_cache = false;
+        usage_ -= e->charge;
+        Unref(e);
+    }
+    return e != nullptr;
+}
+
+void LRUCache::Erase(const Slice& key, uint32_t hash) {
+    std::lock_guard<std::mutex> l(mutex_);
+    FinishErase(table_.Remove(key, hash));
+}
+
+void LRUCache::Prune() {
+    std::lock_guard<std::mutex> l(mutex_);
+    while(lru_.next != &lru_) {
+        LRUHandle* e = lru_.next;
+        assert(e->refs == 1);
+        FinishErase(table_.Remove(e->key(), e->hash));
+    }
+}
+
+/**
+ * @brief W-TinyLFU 缓存的条目, 布局与 LRUHandle 相同, 引用计数和访问位改成原子变量
+ *  命中路径只持有读锁, 增加引用和设置访问位都不修改链表
+ *  所在的队列(窗口或主区)、链表指针和 in_cache 只在写锁下修改
+ */
+struct TinyLFUHandle {
+    void* value;
+    void (*deleter)(const Slice&, void* value);
+    TinyLFUHandle* next_hash;
+    TinyLFUHandle* next;
+    TinyLFUHandle* prev;
+    size_t charge;
+    size_t key_length;
+    std::atomic<uint32_t> refs;     // 引用数, 在缓存中时包含缓存自身的一个引用
+    std::atomic<bool> referenced;   // CLOCK 的访问位, 命中时置位, 指针扫过时清零
+    bool in_cache;                  // 是否仍在缓存中(未被淘汰或删除)
+    bool in_window;                 // 在窗口队列还是主队列
+    uint32_t hash;
+    char key_data[1];
+
+    Slice key() const {
+        assert(next != this);
+        return Slice(key_data, key_length);
+    }
+};
+
+// 读写锁; 工程用 C++11, 没有 std::shared_mutex, 直接封装 pthread_rwlock
+class RWMutex {
+public:
+    RWMutex() { pthread_rwlock_init(&mu_, nullptr); }
+    ~RWMutex() { pthread_rwlock_destroy(&mu_); }
+
+    RWMutex(const RWMutex&) = delete;
+    RWMutex& operator=(const RWMutex&) = delete;
+
+    void ReadLock() { pthread_rwlock_rdlock(&mu_); }
+    void WriteLock() { pthread_rwlock_wrlock(&mu_); }
+    void Unlock() { pthread_rwlock_unlock(&mu_); }
+
+private:
+    pthread_rwlock_t mu_;
+};
+
+class ReadLockGuard {
+public:
+    explicit ReadLockGuard(RWMutex* mu) : mu_(mu) { mu_->ReadLock(); }
+    ~ReadLockGuard() { mu_->Unlock(); }
+
+private:
+    RWMutex* const mu_;
+};
+
+class WriteLockGuard {
+public:
+    explicit WriteLockGuard(RWMutex* mu) : mu_(mu) { mu_->WriteLock(); }
+    ~WriteLockGuard() { mu_->Unlock(); }
+
+private:
+    RWMutex* const mu_;
+};
+
+/**
+ * @brief 估计键最近访问频率的 count-min sketch, 4 行计数器, 每个计数器最大 15
+ *  计数器按 64 字节分块, 每块 4 行各 16 个, 宽度指每行的计数器总数
+ *  计数用不加锁的 load/store, 并发时丢失少量更新无妨, 结果本来就是估计值
+ *  累计增加 10 * 宽度 次后所有计数减半, 过去的热点逐渐让位给新的热点
+ *  调整大小和减半需要独占, 其余操作在读锁下即可
+ */
+class FrequencySketch {
+public:
+    FrequencySketch() : width_(0), additions_(0), storage_(nullptr), counters_(nullptr) {}
+    ~FrequencySketch() { delete[] storage_; }
+
+    // 宽度至少为 n, 扩大时清空已有计数
+    void EnsureCapacity(size_t n) {
+        if(n <= width_) return;
+        size_t width = 64;
+        while(width < n) width *= 2;
+        delete[] storage_;
+        // 多分配 63 个, 让块的起点和缓存行对齐
+        storage_ = new std::atomic<uint8_t>[kDepth * width + 63];
+        counters_ = storage_ + (64 - reinterpret_cast<uintptr_t>(storage_) % 64) % 64;
+        for(size_t i = 0; i < kDepth * width; i++) counters_[i].store(0, std::memory_order_relaxed);
+        width_ = width;
+        additions_.store(0, std::memory_order_relaxed);
+    }
+
+    void Increment(uint32_t hash) {
+        if(width_ == 0) return;
+        std::atomic<uint8_t>* block = Block(hash);
+        const uint32_t h = Mix(hash);
+        for(size_t i = 0; i < kDepth; i++) {
+            std::atomic<uint8_t>& c = block[i * 16 + ((h >> (4 * i)) & 15)];
+            const uint8_t v = c.load(std::memory_order_relaxed);
+            if(v < kMaxCount) c.store(v + 1, std::memory_order_relaxed);
+        }
+        additions_.store(additions_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    uint32_t Estimate(uint32_t hash) const {
+        if(width_ == 0) return 0;
+        const std::atomic<uint8_t>* block = Block(hash);
+        const uint32_t h = Mix(hash);
+        uint32_t result = kMaxCount;
+        for(size_t i = 0; i < kDepth; i++) {
+            const uint32_t v = block[i * 16 + ((h >> (4 * i)) & 15)].load(std::memory_order_relaxed);
+            if(v < result) result = v;
+        }
+        return result;
+    }
+
+    bool NeedsAging() const { return additions_.load(std::memory_order_relaxed) >= kSampleFactor * width_; }
+
+    void Age() {
+        for(size_t i = 0; i < kDepth * width_; i++) {
+            counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1, std::memory_order_relaxed);
+        }
+        additions_.store(additions_.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+    }
+
+private:
+    static const size_t kDepth = 4;
+    static const uint8_t kMaxCount = 15;
+    static const size_t kSampleFactor = 10;
+
+    // 一个键的 4 个计数器在同一个 64 字节块中, 每行占 16 个, 一次更新只碰一个缓存行
+    std::atomic<uint8_t>* Block(uint32_t hash) const { return counters_ + (hash & (width_ / 16 - 1)) * 64; }
+
+    // 低位已经用来选块, 打散之后用高位选块内的计数器
+    static uint32_t Mix(uint32_t hash) { return (hash * 0x9e3779b9u) >> 16; }
+
+    size_t width_;  // 每行的计数器数, 总是 2 的幂
+    std::atomic<size_t> additions_;
+    std::atomic<uint8_t>* storage_;
+    std::atomic<uint8_t>* counters_;  // storage_ 中 64 字节对齐的起点
+};
+
+/**
+ * @brief 按 W-TinyLFU 淘汰的分片: 新条目先进容量 1% 的窗口, 被挤出窗口时
+ *  和主区的淘汰对象比较访问频率, 频率更高才进入主区, 否则直接淘汰
+ *  一次性扫描的键频率很低, 进不了主区, 不会冲掉热点
+ *  窗口先进先出, 主区按 CLOCK 淘汰, 命中只设置访问位, 所以 Lookup 只需要读锁
+ *  Release 只原子地减少引用计数, 不加锁
+ */
+class TinyLFUCache {
+public:
+    TinyLFUCache();
+    ~TinyLFUCache();
+
+    void SetCapacity(size_t capacity);
+
+    static uint32_t HandleHash(Cache::Handle* h) { return reinterpret_cast<TinyLFUHandle*>(h)->hash; }
+    static void* HandleValue(Cache::Handle* h) { return reinterpret_cast<TinyLFUHandle*>(h)->value; }
+
+    Cache::Handle* Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                          void (*deleter)(const Slice& key, void* value));
+    Cache::Handle* Lookup(const Slice& key, uint32_t hash);
+    void Release(Cache::Handle* handle) { Unref(reinterpret_cast<TinyLFUHandle*>(handle)); }
+    void Erase(const Slice& key, uint32_t hash);
+    void Prune();
+    size_t TotalCharge() const {
+        ReadLockGuard l(&mutex_);
+        return window_.usage + main_.usage;
+    }
+    void AddStats(Cache::Stats* stats) const {
+        stats->hits += hits_.load(std::memory_order_relaxed);
+        stats->misses += misses_.load(std::memory_order_relaxed);
+        stats->inserts += inserts_.load(std::memory_order_relaxed);
+        stats->evictions += evictions_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // 循环链表, head.next 是时钟指针指向的条目, 新条目放在 head 之前
+    struct Queue {
+        TinyLFUHandle head;
+        size_t usage;
+        size_t length;
+    };
+
+    static void Unref(TinyLFUHandle* e);
+    void Link(Queue* q, TinyLFUHandle* e);
+    void Unlink(TinyLFUHandle* e);
+    TinyLFUHandle* ClockVictim(Queue* q);
+    bool FinishErase(TinyLFUHandle* e);
+    void Evict(TinyLFUHandle* e);
+    void EvictFromWindow();
+
+    size_t capacity_;
+    size_t window_capacity_;
+
+    mutable RWMutex mutex_;
+    // 以下成员在写锁下修改; 命中路径只在读锁下查哈希表和增加频率
+    Queue window_;
+    Queue main_;
+    HandleTable<TinyLFUHandle> table_;
+    FrequencySketch sketch_;
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> inserts_;
+    std::atomic<uint64_t> evictions_;
+};
+
+TinyLFUCache::TinyLFUCache()
+    : capacity_(0), window_capacity_(0), hits_(0), misses_(0), inserts_(0), evictions_(0) {
+    Queue* queues[] = {&window_, &main_};
+    for(Queue* q : queues) {
+        q->head.next = &q->head;
+        q->head.prev = &q->head;
+        q->usage = 0;
+        q->length = 0;
+    }
+}
+
+TinyLFUCache::~TinyLFUCache() {
+    Queue* queues[] = {&window_, &main_};
+    for(Queue* q : queues) {
+        while(q->head.next != &q->head) {
+            TinyLFUHandle* e = q->head.next;
+            assert(e->refs.load() == 1);  // 调用方还持有未释放的句柄
+            table_.Remove(e->key(), e->hash);
+            FinishErase(e);
+        }
+    }
+}
+
+void TinyLFUCache::SetCapacity(size_t capacity) {
+    capacity_ = capacity;
+    window_capacity_ = capacity / 100;
+    if(capacity_ > 0) sketch_.EnsureCapacity(1);
+}
+
+void TinyLFUCache::Unref(TinyLFUHandle* e) {
+    if(e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        assert(!e->in_cache);
+        (*e->deleter)(e->key(), e->value);
+        e->~TinyLFUHandle();
+        std::free(e);
+    }
+}
+
+void TinyLFUCache::Link(Queue* q, TinyLFUHandle* e) {
+    e->in_window = (q == &window_);
+    e->next = &q->head;
+    e->prev = q->head.prev;
+    e->prev->next = e;
+    e->next->prev = e;
+    q->usage += e->charge;
+    q->length++;
+}
+
+void TinyLFUCache::Unlink(TinyLFUHandle* e) {
+    Queue* q = e->in_window ? &window_ : &main_;
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    q->usage -= e->charge;
+    q->length--;
+}
+
+// 时钟指针扫过的条目: 访问位置位的清零后放到队尾, 再给一次机会
+// 被外部引用的条目不淘汰, 也放到队尾; 扫两圈都找不到时返回 nullptr
+TinyLFUHandle* TinyLFUCache::ClockVictim(Queue* q) {
+    for(size_t n = 2 * q->length; n > 0; n--) {
+        TinyLFUHandle* e = q->head.next;
+        if(e->referenced.load(std::memory_order_relaxed)) {
+            e->referenced.store(false, std::memory_order_relaxed);
+        } else if(e->refs.load(std::memory_order_relaxed) == 1) {
+            return e;
+        }
+        Unlink(e);
+        Link(q, e);
+    }
+    return nullptr;
+}
+
+Cache::Handle* TinyLFUCache::Lookup(const Slice& key, uint32_t hash) {
+    ReadLockGuard l(&mutex_);
+    // 未命中也计数, 随后插入的条目凭这次访问和主区比较频率
+    sketch_.Increment(hash);
+    TinyLFUHandle* e = table_.Lookup(key, hash);
+    if(e != nullptr) {
+        e->refs.fetch_add(1, std::memory_order_relaxed);
+        // 访问位已经置位时不再写, 热点条目所在的缓存行不会在各核之间来回传递
+        if(!e->referenced.load(std::memory_order_relaxed)) e->referenced.store(true, std::memory_order_relaxed);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+Cache::Handle* TinyLFUCache::Insert(const Slice& key, uint32_t hash, void* value, size_t charge,
+                                    void (*deleter)(const Slice& key, void* value)) {
+    // 分配和拷贝键不需要持锁
+    void* mem = std::malloc(sizeof(TinyLFUHandle) - 1 + key.size());
+    TinyLFUHandle* e = new(mem) TinyLFUHandle;
+    e->value = value;
+    e->deleter = deleter;
+    e->next = nullptr;
+    e->charge = charge;
+    e->key_length = key.size();
+    e->refs.store(1, std::memory_order_relaxed);  // 返回给调用方的句柄
+    e->referenced.store(false, std::memory_order_relaxed);
+    e->in_cache = false;
+    e->in_window = true;
+    e->hash = hash;
+    std::memcpy(e->key_data, key.data(), key.size());
+    inserts_.fetch_add(1, std::memory_order_relaxed);
+    // 容量为 0 表示关闭缓存, 条目不进缓存, 句柄释放时直接删除
+    if(capacity_ == 0) return reinterpret_cast<Cache::Handle*>(e);
+
+    WriteLockGuard l(&mutex_);
+    e->refs.fetch_add(1, std::memory_order_relaxed);  // 缓存自身的引用
+    e->in_cache = true;
+    Link(&window_, e);
+    FinishErase(table_.Insert(e));
+
+    // 宽度跟着条目数增长, 保证 sketch 能区分缓存中的各个键
+    sketch_.EnsureCapacity(window_.length + main_.length);
+    if(sketch_.NeedsAging()) sketch_.Age();
+    EvictFromWindow();
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+// 窗口超出容量时把最旧的条目作为候选, 主区有空间就直接进入,
+// 否则和主区的淘汰对象比较频率, 输的一方被淘汰
+void TinyLFUCache::EvictFromWindow() {
+    // 窗口至少保留最新插入的条目, 否则容量很小时新条目一进来就要和主区比较
+    while(window_.usage > window_capacity_ && window_.length > 1) {
+        // 窗口按先进先出, 最旧的条目作为候选; 它的访问位保留到主区
+        TinyLFUHandle* candidate = window_.head.next;
+        const uint32_t freq = sketch_.Estimate(candidate->hash);
+        bool admit = true;
+        while(window_.usage + main_.usage > capacity_) {
+            TinyLFUHandle* victim = ClockVictim(&main_);
+            if(victim == nullptr) break;  // 主区全部被引用, 占用暂时超过容量
+            if(freq > sketch_.Estimate(victim->hash)) {
+                Evict(victim);
+            } else {
+                admit = false;
+                break;
+            }
+        }
+        if(admit) {
+            Unlink(candidate);
+            Link(&main_, candidate);
+        } else {
+            Evict(candidate);
+        }
+    }
+    // 窗口只剩一个大条目时也可能超出总容量, 从主区腾出空间
+    while(window_.usage + main_.usage > capacity_) {
+        TinyLFUHandle* victim = ClockVictim(&main_);
+        if(victim == nullptr) break;
+        Evict(victim);
+    }
+}
+
+// e 已经从哈希表中移除时, 把它移出队列并去掉缓存自身的引用; e 为空时返回 false
+bool TinyLFUCache::FinishErase(TinyLFUHandle* e) {
+    if(e != nullptr) {
+        assert(e->in_cache);
+        Unlink(e);
+        e->in_cache = false;
+        Unref(e);
+    }
+    return e != nullptr;
+}
+
+void TinyLFUCache::Evict(TinyLFUHandle* e) {
+    TinyLFUHandle* removed = table_.Remove(e->key(), e->hash);
+    assert(removed == e);
+    FinishErase(removed);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TinyLFUCache::Erase(const Slice& key, uint32_t hash) {
+    WriteLockGuard l(&mutex_);
+    FinishErase(table_.Remove(key, hash));
+}
+
+void TinyLFUCache::Prune() {
+    WriteLockGuard l(&mutex_);
+    Queue* queues[] = {&window_, &main_};
+    for(Queue* q : queues) {
+        for(TinyLFUHandle* e = q->head.next; e != &q->head;) {
+            TinyLFUHandle* next = e->next;
+            if(e->refs.load(std::memory_order_relaxed) == 1) {
+                table_.Remove(e->key(), e->hash);
+                FinishErase(e);
+            }
+            e = next;
+        }
+    }
+}
+
+static const int kNumShardBits = 4;
+static const int kNumShards = 1 << kNumShardBits;
+
+/**
+ * @brief 按键的哈希高位分成 16 个分片, 并发访问不同分片时不争用同一把锁
+ *  Shard 是单个分片的实现, 不同的淘汰策略共用这层分片逻辑
+ */
+template <typename Shard>
+class ShardedCache : public Cache {
+public:
+    explicit ShardedCache(size_t capacity) : last_id_(0) {
+        const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
+        for(int s = 0; s < kNumShards; s++) shard_[s].SetCapacity(per_shard);
+    }
+    ~ShardedCache() override = default;
+
+    Handle* Insert(const Slice& key, void* value, size_t charge,
+                   void (*deleter)(const Slice& key, void* value)) override {
+        const uint32_t hash = HashSlice(key);
+        return shard_[ShardOf(hash)].Insert(key, hash, value, charge, deleter);
+    }
+    Handle* Lookup(const Slice& key) override {
+        const uint32_t hash = HashSlice(key);
+        return shard_[ShardOf(hash)].Lookup(key, hash);
+    }
+    void Release(Handle* handle) override { shard_[ShardOf(Shard::HandleHash(handle))].Release(handle); }
+    void Erase(const Slice& key) override {
+        const uint32_t hash = HashSlice(key);
+        shard_[ShardOf(hash)].Erase(key, hash);
+    }
+    void* Value(Handle* handle) override { return Shard::HandleValue(handle); }
+    uint64_t NewId() override {
+        std::lock_guard<std::mutex> l(id_mutex_);
+        return ++(last_id_);
+    }
+    void Prune() override {
+        for(int s = 0; s < kNumShards; s++) shard_[s].Prune();
+    }
+    size_t TotalCharge() const override {
+        size_t total = 0;
+        for(int s = 0; s < kNumShards; s++) total += shard_[s].TotalCharge();
+        return total;
+    }
+    Stats GetStats() const override {
+        Stats stats;
+        for(int s = 0; s < kNumShards; s++) shard_[s].AddStats(&stats);
+        return stats;
+    }
+
+private:
+    static inline uint32_t HashSlice(const Slice& s) { return Hash(s.data(), s.size(), 0); }
+
+    // 用高位选分片, 低位留给分片内的哈希表选桶
+    static uint32_t ShardOf(uint32_t hash) { return hash >> (32 - kNumShardBits); }
+
+    Shard shard_[kNumShards];
+    std::mutex id_mutex_;
+    uint64_t last_id_;
+};
+
+}   // namespace
+
+Cache* NewLRUCache(size_t capacity) { return new ShardedCache<LRUCache>(capacity); }
+
+Cache* NewTinyLFUCache(size_t capacity) { return new ShardedCache<TinyLFUCache>(capacity); }
+
+}   // namespace leveldb
@@ -0,0 +1,228 @@
+/**
+ * @file coding.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/coding.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace leveldb {
+
+void PutFixed32(std::string* dst, uint32_t value) {
+    char buf[sizeof(value)];
+    EncodeFixed32(buf, value);
+    dst->append(buf, sizeof(buf));
+}
+
+void PutFixed64(std::string* dst, uint64_t value) {
+    char buf[sizeof(value)];
+    EncodeFixed64(buf, value);
+    dst->append(buf, sizeof(buf));
+}
+
+void PutVarint32(std::string* dst, uint32_t v) {
+    char buf[5];
+    char* ptr = EncodeVarint32(buf, v);
+    dst->append(buf, ptr - buf);
+}
+
+void PutVarint64(std::string* dst, uint64_t v) {
+    char buf[10];
+    char* ptr = EncodeVarint64(buf, v);
+    dst->append(buf, ptr - buf);
+}
+
+void PutLengthPrefixedSlice(std::string* dst, const Slice& value) {
+    PutVarint32(dst, static_cast<uint32_t>(value.size()));
+    dst->append(value.data(), value.size());
+}
+
+int VarintLength(uint64_t v) {
+    int len = 1;
+    while(v >= 128) {
+        v >>= 7;
+        len++;
+    }
+    return len;
+}
+
+char* EncodeVarint32(char* dst, uint32_t v) {
+    uint8_t* ptr = reinterpret_cast<uint8_t*>(dst);
+    static const int B = 128;
+    if(v < (1 << 7)) {
+        *(ptr++) = v;
+    } else if(v < (1 << 14)) {
+        *(ptr++) = v | B;
+        *(ptr++) = v >> 7;
+    } else if(v < (1 << 21)) {
+        *(ptr++) = v | B;
+        *(ptr++) = (v >> 7) | B;
+        *(ptr++) = v >> 14;
+    } else if(v < (1 << 28)) {
+        *(ptr++) = v | B;
+        *(ptr++) = (v >> 7) | B;
+        *(ptr++) = (v >> 14) | B;
+        *(ptr++) = v >> 21;
+    } else {
+        *(ptr++) = v | B;
+        *(ptr++) = (v >> 7) | B;
+        *(ptr++) = (v >> 14) | B;
+        *(ptr++) = (v >> 21) | B;
+        *(ptr++) = v >> 28;
+    }
+    return reinterpret_cast<char*>(ptr);
+}
+
+char* EncodeVarint64(char* dst, uint64_t v) {
+    static const int B = 128;
+    uint8_t* ptr = reinterpret_cast<uint8_t*>(dst);
+    while(v >= B) {
+        *(ptr++) = v | B;
+        v >>= 7;
+    }
+    *(ptr++) = static_cast<uint8_t>(v);
+    return reinterpret_cast<char*>(ptr);
+}
+
+const char* GetVarint32PtrFallback(const char* p, const char* limit, uint32_t* value) {
+    uint32_t result = 0;
+    for(uint32_t shift = 0; shift <= 28 && p < limit; shift += 7) {
+        uint32_t byte = *(reinterpret_cast<const uint8_t*>(p));
+        p++;
+        if(byte & 128) {
+            // 还有后续字节
+            result |= ((byte & 127) << shift);
+        } else {
+            result |= (byte << shift);
+            *value = result;
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+const char* GetVarint64Ptr(const char* p, const char* limit, uint64_t* value) {
+    uint64_t result = 0;
+    for(uint32_t shift = 0; shift <= 63 && p < limit; shift += 7) {
+        uint64_t byte = *(reinterpret_cast<const uint8_t*>(p));
+        p++;
+        if(byte & 128) {
+            result |= ((byte & 127) << shift);
+        } else {
+            result |= (byte << shift);
+            *value = result;
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+bool GetVarint32(Slice* input, uint32_t* value) {
+    const char* p = input->data();
+    const char* limit = p + input->size();
+    const char* q = GetVarint32Ptr(p, limit, value);
+    if(q == nullptr) return false;
+    *input = Slice(q, limit - q);
+    return true;
+}
+
+bool GetVarint64(Slice* input, uint64_t* value) {
+    const char* p = input->data();
+    const char* limit = p + input->size();
+    const char* q = GetVarint64Ptr(p, limit, value);
+    if(q == nullptr) return false;
+    *input = Slice(q, limit - q);
+    return true;
+}
+
+bool GetLengthPrefixedSlice(Slice* input, Slice* result) {
+    uint32_t len;
+    if(GetVarint32(input, &len) && input->size() >= len) {
+        *result = Slice(input->data(), len);
+        input->remove_prefix(len);
+        return true;
+    }
+    return false;
+}
+
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+namespace {
+/**
+ * @brief 把 len(1~5) 个字节的 varint 拼成整数: 先截掉多余的字节, 再把每字节的 7 位数据挤到一起
+ *  w 为小端读出的 8 字节, 与逐字节解析一样, 第 5 字节超出 32 位的部分被丢弃
+ */
+inline uint32_t AssembleVarint32(uint64_t w, int len) {
+    w &= (~static_cast<uint64_t>(0)) >> (64 - 8 * len);
+    return static_cast<uint32_t>((w & 0x7f) | ((w >> 1) & 0x3f80) | ((w >> 2) & 0x1fc000) |
+                                 ((w >> 3) & 0xfe00000) | ((w >> 4) & 0xf0000000));
+}
+}   // namespace
+
+const char* GetVarint32Batch(const char* p, const char* limit, uint32_t* values, size_t n) {
+    while(n > 0 && limit - p >= 16) {
+        // 窗口多留 8 字节 0, 窗口末尾的值也可以直接按 8 字节读出
+        uint8_t window[24] = {0};
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(window), chunk);
+        // 第 i 位为 1 表示第 i 字节不是某个 varint 的最后一个字节
+        const uint32_t more = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+
+        if(more == 0 && n >= 16) {
+            // 16 个单字节的值, 零扩展成 32 位后整批写出
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i lo = _mm_unpacklo_epi8(chunk, zero);
+            const __m128i hi = _mm_unpackhi_epi8(chunk, zero);
+            __m128i* out = reinterpret_cast<__m128i*>(values);
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+            values += 16;
+            n -= 16;
+            p += 16;
+            continue;
+        }
+
+        // 逐个解出完整落在窗口内的值, 每个值的长度由下一个结束字节的位置直接给出
+        const uint32_t ends = ~more;
+        int pos = 0;
+        while(n > 0) {
+            const int len = __builtin_ctz(ends >> pos) + 1;
+            if(pos + len > 16) break;
+            if(len > 5) return nullptr;
+            uint64_t w;
+            std::memcpy(&w, window + pos, sizeof(w));
+            *(values++) = AssembleVarint32(w, len);
+            n--;
+            pos += len;
+            if(pos == 16) break;
+        }
+        if(pos == 0) return nullptr;  // 16 个字节都带续位, 不可能是合法的 varint32
+        p += pos;
+    }
+    for(; n > 0; n--) {
+        p = GetVarint32Ptr(p, limit, values++);
+        if(p == nullptr) return nullptr;
+    }
+    return p;
+}
+#else
+const char* GetVarint32Batch(const char* p, const char* limit, uint32_t* values, size_t n) {
+    for(; n > 0; n--) {
+        p = GetVarint32Ptr(p, limit, values++);
+        if(p == nullptr) return nullptr;
+    }
+    return p;
+}
+#endif
+
+}   // namespace leveldb
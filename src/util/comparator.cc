@@ -1,6 +1,8 @@
 #include "../../include/leveldb/comparator.h"
 #include "../../include/leveldb/slice.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 
 namespace leveldb {
@@ -23,8 +25,9 @@ public:
             diff_index++;
         if (diff_index < min_length) {
             uint8_t diff_byte = static_cast<uint8_t>((*start)[diff_index]);
-            if (diff_byte < static_cast<uint8_t>(limit[diff_index]) 
-                && diff_index + 1 < static_cast<uint8_t>(limit[diff_index])) {
+            // 差异字节加一之后仍然小于 limit 的对应字节才能截断, 否则截出来的键会 >= limit
+            if (diff_byte < static_cast<uint8_t>(0xff) &&
+                diff_byte + 1 < static_cast<uint8_t>(limit[diff_index])) {
                     (*start)[diff_index]++;
                     start->resize(diff_index + 1);
                     assert(Compare(*start, limit)<0);
@@ -0,0 +1,110 @@
+/**
+ * @file concurrent_arena.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/concurrent_arena.h"
+
+#include <new>
+#include <thread>
+
+namespace leveldb {
+
+const size_t ConcurrentArena::kDefaultShardBlockSize;
+
+namespace {
+// 分片数取不小于 cpu 核数的 2 的幂, 上限 64
+size_t ShardCount() {
+    size_t cpus = std::thread::hardware_concurrency();
+    if(cpus == 0) cpus = 1;
+    size_t n = 1;
+    while(n < cpus && n < 64) n <<= 1;
+    return n;
+}
+
+std::atomic<uint32_t> next_thread_id(0);
+}   // namespace
+
+ConcurrentArena::ConcurrentArena(size_t shard_block_size, size_t arena_block_size,
+                                 size_t huge_page_size, BlockRecycler* recycler)
+    : shard_block_size_(shard_block_size),
+      arena_(BackingBlockSize(shard_block_size, arena_block_size), huge_page_size, recycler) {
+    assert(shard_block_size_ >= 2 * kAlign);
+    size_t n = ShardCount();
+    shard_mask_ = n - 1;
+    shards_.reset(new Shard[n]);
+}
+
+ConcurrentArena::~ConcurrentArena() = default;
+
+size_t ConcurrentArena::BackingBlockSize(size_t shard_block_size, size_t arena_block_size) {
+    const size_t region_bytes = sizeof(Region) + shard_block_size;
+    return arena_block_size < region_bytes ? region_bytes : arena_block_size;
+}
+
+ConcurrentArena::Shard* ConcurrentArena::CurrentShard() {
+    static thread_local uint32_t thread_id =
+        next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    return &shards_[thread_id & shard_mask_];
+}
+
+size_t ConcurrentArena::AllocatedAndUnused() const {
+    size_t unused = 0;
+    for(size_t i = 0; i <= shard_mask_; i++) {
+        Region* r = shards_[i].current.load(std::memory_order_acquire);
+        if(r != nullptr) {
+            size_t used = r->used.load(std::memory_order_relaxed);
+            unused += r->size - used;
+        }
+    }
+    return unused;
+}
+
+char* ConcurrentArena::AllocateSlow(Shard* s, Region* seen, size_t bytes, size_t align) {
+    if(bytes + align > shard_block_size_ / 4) {
+        // 大块直接从后备 arena 分配, 后备 arena 的对齐分配满足 kAlign
+        std::lock_guard<std::mutex> l(arena_mu_);
+        return align > 1 ? arena_.AllocateAligned(bytes) : arena_.Allocate(bytes);
+    }
+
+    std::lock_guard<std::mutex> refill(s->refill_mu);
+    Region* r = s->current.load(std::memory_order_acquire);
+    if(r != seen && r != nullptr) {
+        // 其他线程已经换过区域了, 先在新区域上重试
+        char* result = TryAllocate(r, bytes, align);
+        if(result != nullptr) return result;
+    }
+
+    char* mem;
+    size_t size;
+    {
+        std::lock_guard<std::mutex> l(arena_mu_);
+        const size_t region_bytes = sizeof(Region) + shard_block_size_;
+        if(region_bytes + kAlign <= arena_.BlockSize() / 4) {
+            mem = arena_.AllocateAligned(region_bytes);
+            size = shard_block_size_;
+        } else {
+            // 区域放不进普通块的 1/4 时占用整个普通块, 否则会被分配成不能回收的大块
+            mem = arena_.AllocateBlock();
+            size = arena_.BlockSize() - sizeof(Region);
+        }
+    }
+    Region* fresh = new (mem) Region;
+    fresh->base = mem + sizeof(Region);
+    fresh->size = size;
+    fresh->used.store(0, std::memory_order_relaxed);
+
+    // 在发布之前先分配好本次请求, 新区域一定放得下
+    char* result = TryAllocate(fresh, bytes, align);
+    assert(result != nullptr);
+    s->current.store(fresh, std::memory_order_release);
+    return result;
+}
+
+}   // namespace leveldb
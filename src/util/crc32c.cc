@@ -0,0 +1,225 @@
+/**
+ * @file crc32c.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LEVELDB_CRC32C_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+namespace leveldb {
+namespace crc32c {
+
+namespace {
+// Castagnoli 多项式的反射表示
+const uint32_t kPoly = 0x82f63b78u;
+
+// 三路交错时每一路的长度: 长数据按 kLongBlock, 剩余部分按 kShortBlock
+const size_t kLongBlock = 8192;
+const size_t kShortBlock = 256;
+
+/**
+ * @brief 查表实现用的 slicing-by-4 表, table[0] 即标准的单字节表
+ */
+struct PortableTables {
+    uint32_t table[4][256];
+
+    PortableTables() {
+        for(uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for(int k = 0; k < 8; k++) crc = (crc >> 1) ^ ((crc & 1) ? kPoly : 0);
+            table[0][i] = crc;
+        }
+        for(uint32_t i = 0; i < 256; i++) {
+            for(int t = 1; t < 4; t++) {
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+            }
+        }
+    }
+};
+
+const PortableTables& Tables() {
+    static const PortableTables tables;
+    return tables;
+}
+
+inline uint32_t LoadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+}   // namespace
+
+uint32_t ExtendPortable(uint32_t init_crc, const char* data, size_t n) {
+    const PortableTables& t = Tables();
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* e = p + n;
+    uint32_t l = init_crc ^ 0xffffffffu;
+
+    while(e - p >= 4) {
+        l ^= LoadLE32(p);
+        l = t.table[3][l & 0xff] ^ t.table[2][(l >> 8) & 0xff] ^
+            t.table[1][(l >> 16) & 0xff] ^ t.table[0][l >> 24];
+        p += 4;
+    }
+    while(p < e) {
+        l = t.table[0][(l ^ *p) & 0xff] ^ (l >> 8);
+        p++;
+    }
+    return l ^ 0xffffffffu;
+}
+
+#if defined(LEVELDB_CRC32C_SSE42)
+namespace {
+/**
+ * @brief "在 crc 寄存器后追加 len 个 0 字节"这一线性变换, 按输入的 4 个字节拆成 4 张表
+ *  三路交错计算时, 前一段的 crc 经过该变换后与后一段(从 0 开始计算)的 crc 异或即为合并结果
+ */
+struct ShiftTable {
+    uint32_t table[4][256];
+
+    explicit ShiftTable(size_t len) {
+        // op 是 32x32 的 GF(2) 矩阵, op[i] 为第 i 位输入对应的输出; 先构造追加 1 个 0 位的变换
+        uint32_t op[32];
+        op[0] = kPoly;
+        for(int i = 1; i < 32; i++) op[i] = 1u << (i - 1);
+        // 平方 3 次得到追加 1 个 0 字节, 再按 len 的二进制位累乘
+        for(int i = 0; i < 3; i++) Square(op);
+        uint32_t result[32];
+        for(int i = 0; i < 32; i++) result[i] = 1u << i;
+        while(len > 0) {
+            if(len & 1) Multiply(op, result);
+            Square(op);
+            len >>= 1;
+        }
+        for(int k = 0; k < 4; k++) {
+            for(uint32_t b = 0; b < 256; b++) table[k][b] = Apply(result, b << (8 * k));
+        }
+    }
+
+    uint32_t Shift(uint32_t crc) const {
+        return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+               table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+    }
+
+private:
+    static uint32_t Apply(const uint32_t* mat, uint32_t vec) {
+        uint32_t sum = 0;
+        for(int i = 0; vec != 0; i++, vec >>= 1) {
+            if(vec & 1) sum ^= mat[i];
+        }
+        return sum;
+    }
+    // mat = mat * mat
+    static void Square(uint32_t* mat) {
+        uint32_t sq[32];
+        for(int i = 0; i < 32; i++) sq[i] = Apply(mat, mat[i]);
+        std::memcpy(mat, sq, sizeof(sq));
+    }
+    // dst = a * dst, 两个变换可交换(都是同一个变换的幂)
+    static void Multiply(const uint32_t* a, uint32_t* dst) {
+        uint32_t prod[32];
+        for(int i = 0; i < 32; i++) prod[i] = Apply(a, dst[i]);
+        std::memcpy(dst, prod, sizeof(prod));
+    }
+};
+
+const ShiftTable& LongShift() {
+    static const ShiftTable table(kLongBlock);
+    return table;
+}
+
+const ShiftTable& ShortShift() {
+    static const ShiftTable table(kShortBlock);
+    return table;
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief 三段各 block 字节交错计算, 返回合并之后的 crc 寄存器
+ */
+__attribute__((target("sse4.2")))
+inline uint64_t Extend3Way(uint64_t l, const uint8_t* p, size_t block, const ShiftTable& shift) {
+    uint64_t l1 = 0, l2 = 0;
+    for(size_t i = 0; i < block; i += 8) {
+        l = _mm_crc32_u64(l, Load64(p + i));
+        l1 = _mm_crc32_u64(l1, Load64(p + block + i));
+        l2 = _mm_crc32_u64(l2, Load64(p + 2 * block + i));
+    }
+    l = shift.Shift(static_cast<uint32_t>(l)) ^ l1;
+    return shift.Shift(static_cast<uint32_t>(l)) ^ l2;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t ExtendSse42(uint32_t init_crc, const char* data, size_t n) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* e = p + n;
+    uint64_t l = init_crc ^ 0xffffffffu;
+
+    // 先对齐到 8 字节
+    while(p < e && (reinterpret_cast<uintptr_t>(p) & 7) != 0) l = _mm_crc32_u8(l, *p++);
+    if(static_cast<size_t>(e - p) >= 3 * kLongBlock) {
+        const ShiftTable& shift = LongShift();
+        while(static_cast<size_t>(e - p) >= 3 * kLongBlock) {
+            l = Extend3Way(l, p, kLongBlock, shift);
+            p += 3 * kLongBlock;
+        }
+    }
+    if(static_cast<size_t>(e - p) >= 3 * kShortBlock) {
+        const ShiftTable& shift = ShortShift();
+        while(static_cast<size_t>(e - p) >= 3 * kShortBlock) {
+            l = Extend3Way(l, p, kShortBlock, shift);
+            p += 3 * kShortBlock;
+        }
+    }
+    while(e - p >= 8) {
+        l = _mm_crc32_u64(l, Load64(p));
+        p += 8;
+    }
+    while(p < e) l = _mm_crc32_u8(l, *p++);
+    return static_cast<uint32_t>(l) ^ 0xffffffffu;
+}
+}   // namespace
+#endif  // LEVELDB_CRC32C_SSE42
+
+namespace {
+typedef uint32_t (*ExtendFunction)(uint32_t, const char*, size_t);
+
+ExtendFunction ChooseExtend() {
+#if defined(LEVELDB_CRC32C_SSE42)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.2")) return ExtendSse42;
+#endif
+    return ExtendPortable;
+}
+
+// 第一次调用时选定实现, 之后每次调用只是一次间接跳转; 局部静态变量避免静态初始化顺序问题
+ExtendFunction Selected() {
+    static const ExtendFunction extend = ChooseExtend();
+    return extend;
+}
+}   // namespace
+
+uint32_t Extend(uint32_t init_crc, const char* data, size_t n) {
+    return Selected()(init_crc, data, n);
+}
+
+bool IsHardwareAccelerated() { return Selected() != ExtendPortable; }
+
+}   // namespace crc32c
+}   // namespace leveldb
@@ -0,0 +1,74 @@
+/**
+ * @file env.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/env.h"
+
+#include <cassert>
+#include <deque>
+
+namespace leveldb {
+
+namespace {
+
+// 没有异步 I/O 时的队列: 加入时就同步执行, 完成顺序与加入顺序相同
+// 写请求在加入时确定位置, 与之后直接调用 Append 的顺序和异步实现一致
+class SyncIOQueue final : public IOQueue {
+public:
+    SyncIOQueue() = default;
+    ~SyncIOQueue() override { assert(done_.empty()); }
+
+    void AddRead(const RandomAccessFile* file, uint64_t offset, size_t n, char* scratch,
+                 IORequest* req) override {
+        req->status = file->Read(offset, n, &req->result, scratch);
+        done_.push_back(req);
+    }
+
+    void AddWrite(WritableFile* file, const Slice& data, IORequest* req) override {
+        req->status = file->Append(data);
+        done_.push_back(req);
+    }
+
+    void AddSync(WritableFile* file, IORequest* req) override {
+        req->status = file->Sync();
+        done_.push_back(req);
+    }
+
+    void Submit() override {}
+
+    IORequest* Wait() override {
+        if(done_.empty()) return nullptr;
+        IORequest* req = done_.front();
+        done_.pop_front();
+        return req;
+    }
+
+private:
+    std::deque<IORequest*> done_;
+};
+
+}   // namespace
+
+Env::~Env() = default;
+
+Status Env::NewIOQueue(int depth, IOQueue** result) {
+    *result = new SyncIOQueue;
+    return Status::OK();
+}
+
+IOQueue::~IOQueue() = default;
+
+SequentialFile::~SequentialFile() = default;
+
+RandomAccessFile::~RandomAccessFile() = default;
+
+WritableFile::~WritableFile() = default;
+
+}   // namespace leveldb
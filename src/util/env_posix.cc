@@ -0,0 +1,769 @@
+/**
+ * @file env_posix.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define LEVELDB_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#include <deque>
+#include <vector>
+
+#include "../../include/leveldb/env.h"
+
+namespace leveldb {
+
+namespace {
+// 写缓冲大小, 小段追加先攒在缓冲区里再一次 write
+const size_t kWritableFileBufferSize = 65536;
+
+// 默认最多同时映射的只读文件数; 32 位系统的地址空间容不下很多映射, 不使用 mmap
+const int kDefaultMmapLimit = (sizeof(void*) >= 8) ? 1000 : 0;
+
+/**
+ * @brief 限制某种资源的同时占用数, 申请不到时调用方改用不占用这种资源的做法
+ *  上限可以随时调整, 已经占用的不受影响
+ */
+class Limiter {
+public:
+    explicit Limiter(int max_acquires) : max_acquires_(max_acquires), acquires_(0) {}
+
+    Limiter(const Limiter&) = delete;
+    Limiter& operator=(const Limiter&) = delete;
+
+    bool Acquire() {
+        const int old = acquires_.fetch_add(1, std::memory_order_relaxed);
+        if(old < max_acquires_.load(std::memory_order_relaxed)) return true;
+        acquires_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 归还 Acquire 成功时占用的一份
+    void Release() { acquires_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void SetMax(int max_acquires) { max_acquires_.store(max_acquires, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> max_acquires_;
+    std::atomic<int> acquires_;
+};
+
+Limiter* MmapLimiter() {
+    static Limiter limiter(kDefaultMmapLimit);
+    return &limiter;
+}
+
+std::atomic<bool> use_io_uring(true);
+
+Status PosixError(const std::string& context, int error_number) {
+    if(error_number == ENOENT) return Status::NotFound(context, std::strerror(error_number));
+    return Status::IOError(context, std::strerror(error_number));
+}
+
+class PosixSequentialFile final : public SequentialFile {
+public:
+    PosixSequentialFile(std::string filename, int fd) : fd_(fd), filename_(std::move(filename)) {}
+    ~PosixSequentialFile() override { close(fd_); }
+
+    Status Read(size_t n, Slice* result, char* scratch) override {
+        Status status;
+        while(true) {
+            ::ssize_t read_size = ::read(fd_, scratch, n);
+            if(read_size < 0) {
+                if(errno == EINTR) continue;  // 被信号打断, 重试
+                status = PosixError(filename_, errno);
+                break;
+            }
+            *result = Slice(scratch, read_size);
+            break;
+        }
+        return status;
+    }
+
+    Status Skip(uint64_t n) override {
+        if(::lseek(fd_, n, SEEK_CUR) == static_cast<off_t>(-1)) return PosixError(filename_, errno);
+        return Status::OK();
+    }
+
+private:
+    const int fd_;
+    const std::string filename_;
+};
+
+// 每次读都用 pread, 不移动文件偏移, 多线程共享同一个 fd 也是安全的
+class PosixRandomAccessFile final : public RandomAccessFile {
+public:
+    PosixRandomAccessFile(std::string filename, int fd) : fd_(fd), filename_(std::move(filename)) {}
+    ~PosixRandomAccessFile() override { close(fd_); }
+
+    Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const override {
+        size_t done = 0;
+        while(done < n) {
+            ::ssize_t read_size = ::pread(fd_, scratch + done, n - done, static_cast<off_t>(offset + done));
+            if(read_size < 0) {
+                if(errno == EINTR) continue;
+                *result = Slice(scratch, 0);
+                return PosixError(filename_, errno);
+            }
+            if(read_size == 0) break;  // 文件末尾
+            done += read_size;
+        }
+        *result = Slice(scratch, done);
+        return Status::OK();
+    }
+
+    // 供异步队列直接向内核提交读请求
+    int fd() const { return fd_; }
+    const std::string& filename() const { return filename_; }
+
+private:
+    const int fd_;
+    const std::string filename_;
+};
+
+// 整个文件映射到内存, 读取直接返回指向映射的 Slice, 不拷贝也不进内核
+// 映射的长度在打开时确定, 只适合打开后不再修改的文件(如表文件)
+class PosixMmapReadableFile final : public RandomAccessFile {
+public:
+    // mmap_base 是 mmap 返回的起点, 析构时解除映射并归还 limiter 的一份
+    PosixMmapReadableFile(std::string filename, char* mmap_base, size_t length, Limiter* limiter)
+        : mmap_base_(mmap_base), length_(length), limiter_(limiter), filename_(std::move(filename)) {}
+
+    ~PosixMmapReadableFile() override {
+        ::munmap(static_cast<void*>(mmap_base_), length_);
+        limiter_->Release();
+    }
+
+    Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const override {
+        // 与 pread 的实现一致: 读到文件末尾时返回较短的结果
+        if(offset >= length_) {
+            *result = Slice(mmap_base_ + length_, 0);
+            return Status::OK();
+        }
+        *result = Slice(mmap_base_ + offset, std::min<uint64_t>(n, length_ - offset));
+        return Status::OK();
+    }
+
+private:
+    char* const mmap_base_;
+    const size_t length_;
+    Limiter* const limiter_;
+    const std::string filename_;
+};
+
+// 追加模式的文件由内核决定写入位置; 其余文件自己记录写到哪里, 用 pwrite 按偏移写,
+// 这样异步队列可以为还没完成的写请求预留位置, 之后的 Append 接在预留的位置后面
+class PosixWritableFile final : public WritableFile {
+public:
+    PosixWritableFile(std::string filename, int fd, bool append)
+        : pos_(0), fd_(fd), append_(append), file_offset_(0), filename_(std::move(filename)) {}
+
+    ~PosixWritableFile() override {
+        if(fd_ >= 0) Close();
+    }
+
+    Status Append(const Slice& data) override {
+        size_t write_size = data.size();
+        const char* write_data = data.data();
+
+        // 尽量放进缓冲区
+        size_t copy_size = std::min(write_size, kWritableFileBufferSize - pos_);
+        std::memcpy(buf_ + pos_, write_data, copy_size);
+        write_data += copy_size;
+        write_size -= copy_size;
+        pos_ += copy_size;
+        if(write_size == 0) return Status::OK();
+
+        // 放不下: 先把缓冲区写出去, 小的剩余部分进缓冲区, 大的直接写
+        Status status = FlushBuffer();
+        if(!status.ok()) return status;
+        if(write_size < kWritableFileBufferSize) {
+            std::memcpy(buf_, write_data, write_size);
+            pos_ = write_size;
+            return Status::OK();
+        }
+        return WriteUnbuffered(write_data, write_size);
+    }
+
+    Status Close() override {
+        Status status = FlushBuffer();
+        const int close_result = ::close(fd_);
+        if(close_result < 0 && status.ok()) status = PosixError(filename_, errno);
+        fd_ = -1;
+        return status;
+    }
+
+    Status Flush() override { return FlushBuffer(); }
+
+    /**
+     * @brief 供异步队列使用: 先写出缓冲区, 再为长度 n 的追加预留位置, 通过 *offset 返回
+     *  追加模式的文件不能预留位置, 返回 false, 调用方改用同步的 Append
+     */
+    bool ReserveAppend(size_t n, uint64_t* offset, Status* status) {
+        if(append_) return false;
+        *status = FlushBuffer();
+        *offset = file_offset_;
+        if(status->ok()) file_offset_ += n;
+        return true;
+    }
+
+    // 在 offset 处写入 data, 用于补完异步写入时没写完的部分
+    Status WriteAt(const char* data, size_t size, uint64_t offset) {
+        while(size > 0) {
+            ::ssize_t write_result = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+            if(write_result < 0) {
+                if(errno == EINTR) continue;
+                return PosixError(filename_, errno);
+            }
+            data += write_result;
+            size -= write_result;
+            offset += write_result;
+        }
+        return Status::OK();
+    }
+
+    int fd() const { return fd_; }
+    const std::string& filename() const { return filename_; }
+
+    Status Sync() override {
+        Status status = FlushBuffer();
+        if(!status.ok()) return status;
+        // 只需要数据落盘, fdatasync 省掉不必要的元数据(如修改时间)写入
+#if defined(__linux__)
+        if(::fdatasync(fd_) != 0) return PosixError(filename_, errno);
+#else
+        if(::fsync(fd_) != 0) return PosixError(filename_, errno);
+#endif
+        return Status::OK();
+    }
+
+private:
+    Status FlushBuffer() {
+        Status status = WriteUnbuffered(buf_, pos_);
+        pos_ = 0;
+        return status;
+    }
+
+    Status WriteUnbuffered(const char* data, size_t size) {
+        if(!append_) {
+            Status status = WriteAt(data, size, file_offset_);
+            if(status.ok()) file_offset_ += size;
+            return status;
+        }
+        while(size > 0) {
+            ssize_t write_result = ::write(fd_, data, size);
+            if(write_result < 0) {
+                if(errno == EINTR) continue;
+                return PosixError(filename_, errno);
+            }
+            data += write_result;
+            size -= write_result;
+        }
+        return Status::OK();
+    }
+
+    char buf_[kWritableFileBufferSize];
+    size_t pos_;
+    int fd_;
+    const bool append_;
+    uint64_t file_offset_;  // 非追加模式下下一次写入的位置, 包括已预留给异步写入的部分
+    const std::string filename_;
+};
+
+#if defined(LEVELDB_HAVE_IO_URING)
+/**
+ * @brief 基于 io_uring 的异步队列, 直接用系统调用, 不依赖 liburing
+ *  pread 实现的读文件和非追加模式的写文件提交给内核, 一次 io_uring_enter 提交整批请求
+ *  其他文件(mmap 映射的、追加模式的、非 posix 实现的)在加入时同步执行
+ */
+class PosixUringIOQueue final : public IOQueue {
+public:
+    // 内核不支持或不允许使用 io_uring 时返回 nullptr
+    static PosixUringIOQueue* Open(int depth);
+
+    ~PosixUringIOQueue() override;
+
+    void AddRead(const RandomAccessFile* file, uint64_t offset, size_t n, char* scratch,
+                 IORequest* req) override;
+    void AddWrite(WritableFile* file, const Slice& data, IORequest* req) override;
+    void AddSync(WritableFile* file, IORequest* req) override;
+    void Submit() override;
+    IORequest* Wait() override;
+
+private:
+    enum OpType { kRead, kWrite, kSync };
+
+    // 一个交给内核的请求, 地址作为 user_data 随完成事件带回
+    struct Op {
+        OpType type;
+        const PosixRandomAccessFile* read_file;
+        PosixWritableFile* write_file;
+        uint64_t offset;
+        struct ::iovec iov;
+        IORequest* req;
+    };
+
+    PosixUringIOQueue(int ring_fd, const struct ::io_uring_params& params, int depth);
+
+    // 取一个空闲的 Op, 全部在用时先提交并等待一个请求完成
+    Op* NewOp(IORequest* req);
+    void PrepareSqe(Op* op, struct ::io_uring_sqe* sqe);
+    // 收取完成事件, wait 为 true 时至少等到一个
+    void Reap(bool wait);
+    void Complete(Op* op, int res);
+    void ExecuteSync(Op* op);
+
+    int ring_fd_;
+    bool ok_;  // 三块映射都成功
+
+    void* sq_ring_;
+    size_t sq_ring_size_;
+    void* cq_ring_;
+    size_t cq_ring_size_;
+    struct ::io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    struct ::io_uring_cqe* cqes_;
+
+    std::vector<Op> ops_;
+    std::vector<Op*> free_ops_;
+    std::vector<Op*> pending_;  // 已加入还没提交
+    size_t in_flight_;          // 已提交还没完成
+    std::deque<IORequest*> done_;
+};
+
+PosixUringIOQueue* PosixUringIOQueue::Open(int depth) {
+    if(depth <= 0) return nullptr;
+    struct ::io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+    if(ring_fd < 0) return nullptr;  // ENOSYS: 内核太旧; EPERM: 被 seccomp 等禁止
+    PosixUringIOQueue* queue = new PosixUringIOQueue(ring_fd, params, depth);
+    if(!queue->ok_) {
+        delete queue;
+        return nullptr;
+    }
+    return queue;
+}
+
+PosixUringIOQueue::PosixUringIOQueue(int ring_fd, const struct ::io_uring_params& params, int depth)
+    : ring_fd_(ring_fd), ok_(false), sq_ring_(MAP_FAILED), cq_ring_(MAP_FAILED),
+      sqes_(static_cast<struct ::io_uring_sqe*>(MAP_FAILED)), ops_(depth), in_flight_(0) {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct ::io_uring_cqe);
+    sqes_size_ = params.sq_entries * sizeof(struct ::io_uring_sqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if(single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQ_RING);
+    if(sq_ring_ == MAP_FAILED) return;
+    if(single_mmap) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_CQ_RING);
+        if(cq_ring_ == MAP_FAILED) return;
+    }
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                        IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) return;
+    sqes_ = static_cast<struct ::io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct ::io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    for(size_t i = 0; i < ops_.size(); i++) free_ops_.push_back(&ops_[i]);
+    ok_ = true;
+}
+
+PosixUringIOQueue::~PosixUringIOQueue() {
+    assert(pending_.empty() && in_flight_ == 0 && done_.empty());
+    if(sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+    if(cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+    if(sq_ring_ != MAP_FAILED) ::munmap(sq_ring_, sq_ring_size_);
+    ::close(ring_fd_);
+}
+
+PosixUringIOQueue::Op* PosixUringIOQueue::NewOp(IORequest* req) {
+    while(free_ops_.empty()) {
+        Submit();
+        Reap(true);
+    }
+    Op* op = free_ops_.back();
+    free_ops_.pop_back();
+    op->read_file = nullptr;
+    op->write_file = nullptr;
+    op->offset = 0;
+    op->iov.iov_base = nullptr;
+    op->iov.iov_len = 0;
+    op->req = req;
+    return op;
+}
+
+void PosixUringIOQueue::AddRead(const RandomAccessFile* file, uint64_t offset, size_t n, char* scratch,
+                                IORequest* req) {
+    const PosixRandomAccessFile* posix_file = dynamic_cast<const PosixRandomAccessFile*>(file);
+    if(posix_file == nullptr) {
+        // mmap 映射的文件读取不进内核, 异步没有意义
+        req->status = file->Read(offset, n, &req->result, scratch);
+        done_.push_back(req);
+        return;
+    }
+    Op* op = NewOp(req);
+    op->type = kRead;
+    op->read_file = posix_file;
+    op->offset = offset;
+    op->iov.iov_base = scratch;
+    op->iov.iov_len = n;
+    pending_.push_back(op);
+}
+
+void PosixUringIOQueue::AddWrite(WritableFile* file, const Slice& data, IORequest* req) {
+    PosixWritableFile* posix_file = dynamic_cast<PosixWritableFile*>(file);
+    uint64_t offset;
+    Status status;
+    if(posix_file == nullptr || !posix_file->ReserveAppend(data.size(), &offset, &status)) {
+        req->status = file->Append(data);
+        done_.push_back(req);
+        return;
+    }
+    if(!status.ok()) {
+        req->status = status;
+        done_.push_back(req);
+        return;
+    }
+    Op* op = NewOp(req);
+    op->type = kWrite;
+    op->write_file = posix_file;
+    op->offset = offset;
+    op->iov.iov_base = const_cast<char*>(data.data());
+    op->iov.iov_len = data.size();
+    pending_.push_back(op);
+}
+
+void PosixUringIOQueue::AddSync(WritableFile* file, IORequest* req) {
+    PosixWritableFile* posix_file = dynamic_cast<PosixWritableFile*>(file);
+    Status status;
+    if(posix_file != nullptr) status = posix_file->Flush();
+    if(posix_file == nullptr || !status.ok()) {
+        req->status = (posix_file == nullptr ? file->Sync() : status);
+        done_.push_back(req);
+        return;
+    }
+    Op* op = NewOp(req);
+    op->type = kSync;
+    op->write_file = posix_file;
+    pending_.push_back(op);
+}
+
+void PosixUringIOQueue::PrepareSqe(Op* op, struct ::io_uring_sqe* sqe) {
+    std::memset(sqe, 0, sizeof(*sqe));
+    switch(op->type) {
+        case kRead:
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = op->read_file->fd();
+            break;
+        case kWrite:
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->fd = op->write_file->fd();
+            break;
+        case kSync:
+            // 等之前提交的请求(包括这个文件的写入)全部完成之后才开始
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fd = op->write_file->fd();
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            sqe->flags = IOSQE_IO_DRAIN;
+            break;
+    }
+    if(op->type != kSync) {
+        sqe->addr = reinterpret_cast<uintptr_t>(&op->iov);
+        sqe->len = 1;
+        sqe->off = op->offset;
+    }
+    sqe->user_data = reinterpret_cast<uintptr_t>(op);
+}
+
+void PosixUringIOQueue::Submit() {
+    if(pending_.empty()) return;
+    // 只有本线程写 sq 尾指针, 内核读取之前用 release 保证请求内容可见
+    unsigned tail = *sq_tail_;
+    for(size_t i = 0; i < pending_.size(); i++) {
+        const unsigned index = tail & sq_mask_;
+        PrepareSqe(pending_[i], &sqes_[index]);
+        sq_array_[index] = index;
+        tail++;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    size_t to_submit = pending_.size();
+    while(to_submit > 0) {
+        const int ret = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, to_submit, 0, 0, nullptr, 0));
+        if(ret > 0) {
+            to_submit -= ret;
+            in_flight_ += ret;
+            continue;
+        }
+        if(ret < 0 && errno == EINTR) continue;
+        if(ret < 0 && (errno == EAGAIN || errno == EBUSY) && in_flight_ > 0) {
+            Reap(true);  // 内核暂时没有资源, 先收掉一些完成事件
+            continue;
+        }
+        // 无法提交: 把内核还没取走的请求撤回, 改用同步读写
+        const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+        for(size_t i = pending_.size() - (tail - head); i < pending_.size(); i++) ExecuteSync(pending_[i]);
+        break;
+    }
+    pending_.clear();
+}
+
+void PosixUringIOQueue::Reap(bool wait) {
+    unsigned head = *cq_head_;
+    while(true) {
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if(head != tail) break;
+        if(!wait || in_flight_ == 0) return;
+        const int ret = static_cast<int>(
+            ::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if(ret < 0 && errno != EINTR) return;
+    }
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for(; head != tail; head++) {
+        const struct ::io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        Op* op = reinterpret_cast<Op*>(static_cast<uintptr_t>(cqe.user_data));
+        const int res = cqe.res;
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        in_flight_--;
+        Complete(op, res);
+    }
+}
+
+void PosixUringIOQueue::Complete(Op* op, int res) {
+    IORequest* req = op->req;
+    char* buf = static_cast<char*>(op->iov.iov_base);
+    const size_t n = op->iov.iov_len;
+    switch(op->type) {
+        case kRead:
+            if(res < 0) {
+                req->status = PosixError(op->read_file->filename(), -res);
+                req->result = Slice(buf, 0);
+            } else if(res > 0 && static_cast<size_t>(res) < n) {
+                // 没到文件末尾的短读, 剩下的部分同步读完
+                Slice rest;
+                req->status = op->read_file->Read(op->offset + res, n - res, &rest, buf + res);
+                req->result = Slice(buf, res + rest.size());
+            } else {
+                req->status = Status::OK();
+                req->result = Slice(buf, res);
+            }
+            break;
+        case kWrite:
+            if(res < 0) {
+                req->status = PosixError(op->write_file->filename(), -res);
+            } else {
+                req->status = op->write_file->WriteAt(buf + res, n - res, op->offset + res);
+            }
+            break;
+        case kSync:
+            req->status = (res < 0 ? PosixError(op->write_file->filename(), -res) : Status::OK());
+            break;
+    }
+    done_.push_back(req);
+    free_ops_.push_back(op);
+}
+
+void PosixUringIOQueue::ExecuteSync(Op* op) {
+    IORequest* req = op->req;
+    char* buf = static_cast<char*>(op->iov.iov_base);
+    switch(op->type) {
+        case kRead:
+            req->status = op->read_file->Read(op->offset, op->iov.iov_len, &req->result, buf);
+            break;
+        case kWrite:
+            req->status = op->write_file->WriteAt(buf, op->iov.iov_len, op->offset);
+            break;
+        case kSync:
+            req->status = op->write_file->Sync();
+            break;
+    }
+    done_.push_back(req);
+    free_ops_.push_back(op);
+}
+
+IORequest* PosixUringIOQueue::Wait() {
+    Submit();
+    if(done_.empty()) Reap(true);
+    if(done_.empty()) return nullptr;
+    IORequest* req = done_.front();
+    done_.pop_front();
+    return req;
+}
+#endif  // LEVELDB_HAVE_IO_URING
+
+class PosixEnv : public Env {
+public:
+    Status NewSequentialFile(const std::string& filename, SequentialFile** result) override {
+        int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) {
+            *result = nullptr;
+            return PosixError(filename, errno);
+        }
+        *result = new PosixSequentialFile(filename, fd);
+        return Status::OK();
+    }
+
+    Status NewRandomAccessFile(const std::string& filename, RandomAccessFile** result) override {
+        int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) {
+            *result = nullptr;
+            return PosixError(filename, errno);
+        }
+        Limiter* limiter = MmapLimiter();
+        if(limiter->Acquire()) {
+            struct ::stat file_stat;
+            if(::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+                void* base = ::mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if(base != MAP_FAILED) {
+                    ::close(fd);  // 映射建立后不依赖 fd
+                    *result = new PosixMmapReadableFile(filename, reinterpret_cast<char*>(base),
+                                                        file_stat.st_size, limiter);
+                    return Status::OK();
+                }
+            }
+            // 空文件不能映射, 映射失败时也退回 pread
+            limiter->Release();
+        }
+        *result = new PosixRandomAccessFile(filename, fd);
+        return Status::OK();
+    }
+
+    Status NewWritableFile(const std::string& filename, WritableFile** result) override {
+        return OpenWritable(filename, O_TRUNC | O_WRONLY | O_CREAT | O_CLOEXEC, result);
+    }
+
+    Status NewAppendableFile(const std::string& filename, WritableFile** result) override {
+        return OpenWritable(filename, O_APPEND | O_WRONLY | O_CREAT | O_CLOEXEC, result);
+    }
+
+    bool FileExists(const std::string& filename) override {
+        return ::access(filename.c_str(), F_OK) == 0;
+    }
+
+    Status GetChildren(const std::string& directory_path, std::vector<std::string>* result) override {
+        result->clear();
+        ::DIR* dir = ::opendir(directory_path.c_str());
+        if(dir == nullptr) return PosixError(directory_path, errno);
+        struct ::dirent* entry;
+        while((entry = ::readdir(dir)) != nullptr) {
+            result->emplace_back(entry->d_name);
+        }
+        ::closedir(dir);
+        return Status::OK();
+    }
+
+    Status CreateDir(const std::string& dirname) override {
+        if(::mkdir(dirname.c_str(), 0755) != 0 && errno != EEXIST) return PosixError(dirname, errno);
+        return Status::OK();
+    }
+
+    Status RemoveFile(const std::string& filename) override {
+        if(::unlink(filename.c_str()) != 0) return PosixError(filename, errno);
+        return Status::OK();
+    }
+
+    Status NewIOQueue(int depth, IOQueue** result) override {
+#if defined(LEVELDB_HAVE_IO_URING)
+        if(use_io_uring.load(std::memory_order_relaxed)) {
+            IOQueue* queue = PosixUringIOQueue::Open(depth);
+            if(queue != nullptr) {
+                *result = queue;
+                return Status::OK();
+            }
+        }
+#endif
+        return Env::NewIOQueue(depth, result);  // 同步的 pread/pwrite
+    }
+
+    Status RenameFile(const std::string& from, const std::string& to) override {
+        if(::rename(from.c_str(), to.c_str()) != 0) return PosixError(from, errno);
+        return Status::OK();
+    }
+
+    Status GetFileSize(const std::string& filename, uint64_t* size) override {
+        struct ::stat file_stat;
+        if(::stat(filename.c_str(), &file_stat) != 0) {
+            *size = 0;
+            return PosixError(filename, errno);
+        }
+        *size = file_stat.st_size;
+        return Status::OK();
+    }
+
+private:
+    static Status OpenWritable(const std::string& filename, int flags, WritableFile** result) {
+        int fd = ::open(filename.c_str(), flags, 0644);
+        if(fd < 0) {
+            *result = nullptr;
+            return PosixError(filename, errno);
+        }
+        *result = new PosixWritableFile(filename, fd, (flags & O_APPEND) != 0);
+        return Status::OK();
+    }
+};
+}   // namespace
+
+void SetReadOnlyMmapLimit(int limit) { MmapLimiter()->SetMax(limit); }
+
+void SetUseIOUring(bool use) { use_io_uring.store(use, std::memory_order_relaxed); }
+
+Env* Env::Default() {
+    // 故意不析构: 进程退出时可能仍有后台线程在使用
+    static PosixEnv* env = new PosixEnv;
+    return env;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,48 @@
+/**
+ * @file hash.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/hash.h"
+
+#include "../../include/leveldb/coding.h"
+
+namespace leveldb {
+
+uint32_t Hash(const char* data, size_t n, uint32_t seed) {
+    const uint32_t m = 0xc6a4a793;
+    const uint32_t r = 24;
+    const char* limit = data + n;
+    uint32_t h = seed ^ (n * m);
+
+    // 每次处理 4 字节
+    while(data + 4 <= limit) {
+        uint32_t w = DecodeFixed32(data);
+        data += 4;
+        h += w;
+        h *= m;
+        h ^= (h >> 16);
+    }
+
+    // 剩余的 0~3 字节, 故意贯穿
+    switch(limit - data) {
+        case 3:
+            h += static_cast<uint8_t>(data[2]) << 16;
+        case 2:
+            h += static_cast<uint8_t>(data[1]) << 8;
+        case 1:
+            h += static_cast<uint8_t>(data[0]);
+            h *= m;
+            h ^= (h >> r);
+            break;
+    }
+    return h;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,24 @@
+/**
+ * @file options.cc
+ * @author alongnice
+ * @brief
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "../../include/leveldb/options.h"
+
+#include "../../include/leveldb/comparator.h"
+#include "../../include/leveldb/env.h"
+
+namespace leveldb {
+
+Options::Options()
+    : comparator(BytewiseComparator()), env(Env::Default()), paranoid_checks(false),
+      write_buffer_size(4 << 20), max_open_files(1000), block_cache(nullptr), block_size(4096),
+      block_restart_interval(16), filter_policy(nullptr), max_file_size(2 << 20) {}
+
+}   // namespace leveldb
@@ -3,6 +3,8 @@
 #include "arena.h"
 #include "random.h"
 
+#include <cstring>
+
 namespace leveldb {
 TEST(ArenaTest, Empty) { Arena arena;}
 
@@ -44,4 +46,88 @@ TEST(ArentTest, Simple){
     }
 }
 
+TEST(ArenaTest, BlockSizeOption) {
+    // 过小的块大小会被修正到下限, 非 8 字节对齐的会被向上取整
+    ASSERT_EQ(Arena(1).BlockSize(), Arena::kMinBlockSize);
+    ASSERT_EQ(Arena(Arena::kMinBlockSize + 1).BlockSize() % 8, 0u);
+    ASSERT_EQ(Arena(1 << 20).BlockSize(), 1u << 20);
+
+    Arena arena(1 << 20);
+    for(int i = 0; i < 1000; i++) arena.Allocate(100);
+    // 10 万字节都在第一个 1MB 块中
+    ASSERT_LE(arena.MemoryUsage(), (1u << 20) + sizeof(char*));
+}
+
+TEST(ArenaTest, HugePage) {
+    Arena arena(Arena::kDefaultBlockSize, Arena::kDefaultHugePageSize);
+    ASSERT_EQ(arena.BlockSize() % Arena::kDefaultHugePageSize, 0u);
+
+    std::vector<std::pair<size_t, char*>> allocated;
+    Random rnd(301);
+    for(int i = 0; i < 50000; i++) {
+        size_t s = rnd.Uniform(200) + 1;
+        char* r = rnd.OneIn(2) ? arena.AllocateAligned(s) : arena.Allocate(s);
+        memset(r, i % 256, s);
+        allocated.emplace_back(s, r);
+    }
+    for(size_t i = 0; i < allocated.size(); i++) {
+        for(size_t b = 0; b < allocated[i].first; b++) {
+            ASSERT_EQ(int(allocated[i].second[b]) & 0xff, i % 256);
+        }
+    }
+#if defined(__linux__)
+    // mmap 成功时块地址按大页对齐
+    ASSERT_GT(arena.MmapBlockCount(), 0u);
+#endif
+}
+
+TEST(ArenaTest, Reset) {
+    Arena arena;
+    for(int i = 0; i < 100; i++) arena.Allocate(1000);
+    const size_t used = arena.MemoryUsage();
+    ASSERT_GT(used, 0u);
+
+    arena.Reset();
+    ASSERT_EQ(arena.MemoryUsage(), 0u);
+    ASSERT_GT(arena.RetainedBytes(), 0u);
+
+    // 第二轮复用保留的块, 本地空闲块被消耗
+    const size_t retained = arena.RetainedBytes();
+    for(int i = 0; i < 10; i++) {
+        char* p = arena.Allocate(1000);
+        memset(p, i, 1000);
+    }
+    ASSERT_LT(arena.RetainedBytes(), retained);
+
+    // 保留上限为 0 时全部释放
+    arena.Reset(0);
+    ASSERT_EQ(arena.RetainedBytes(), 0u);
+}
+
+TEST(ArenaTest, Recycler) {
+    BlockRecycler recycler(16 * Arena::kDefaultBlockSize);
+    {
+        Arena arena(Arena::kDefaultBlockSize, 0, &recycler);
+        for(int i = 0; i < 100; i++) arena.Allocate(1000);
+    }
+    // 析构时普通块还给回收站, 但不超过容量
+    ASSERT_EQ(recycler.RetainedBytes(), 16 * Arena::kDefaultBlockSize);
+
+    {
+        Arena arena(Arena::kDefaultBlockSize, 0, &recycler);
+        char* p = arena.Allocate(100);
+        memset(p, 1, 100);
+        ASSERT_EQ(recycler.RetainedBytes(), 15 * Arena::kDefaultBlockSize);
+        // 大块不参与回收
+        arena.Allocate(Arena::kDefaultBlockSize);
+    }
+    ASSERT_EQ(recycler.RetainedBytes(), 16 * Arena::kDefaultBlockSize);
+
+    // 块大小不同的 arena 取不到这些块
+    ArenaBlock b;
+    ASSERT_FALSE(recycler.Take(2 * Arena::kDefaultBlockSize, false, &b));
+    ASSERT_TRUE(recycler.Take(Arena::kDefaultBlockSize, false, &b));
+    delete[] b.data;
+}
+
 }
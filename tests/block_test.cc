@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "block.h"
+#include "block_builder.h"
+#include "comparator.h"
+#include "format.h"
+#include "options.h"
+#include "random.h"
+
+namespace leveldb {
+
+// 用 model 中的键值构造一个块, 返回的块引用 storage 中的数据
+static Block* BuildBlock(const std::map<std::string, std::string>& model, int restart_interval,
+                         std::string* storage) {
+    Options options;
+    options.block_restart_interval = restart_interval;
+    BlockBuilder builder(&options);
+    for(std::map<std::string, std::string>::const_iterator it = model.begin(); it != model.end(); ++it) {
+        builder.Add(it->first, it->second);
+    }
+    *storage = builder.Finish().ToString();
+    BlockContents contents;
+    contents.data = Slice(*storage);
+    contents.cachable = false;
+    contents.heap_allocated = false;
+    return new Block(contents);
+}
+
+TEST(BlockTest, Empty) {
+    std::map<std::string, std::string> model;
+    std::string storage;
+    Block* block = BuildBlock(model, 16, &storage);
+    Iterator* iter = block->NewIterator(BytewiseComparator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(!iter->Valid());
+    iter->Seek("foo");
+    ASSERT_TRUE(!iter->Valid());
+    ASSERT_TRUE(iter->status().ok());
+    delete iter;
+    delete block;
+}
+
+// 各种重启间隔下, 正向/反向遍历和随机 Seek 都与 std::map 一致
+TEST(BlockTest, MatchesModel) {
+    Random rnd(301);
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 500; i++) {
+        // 键共享较长的前缀, 长度有长有短, 覆盖多字节 varint 的长度
+        std::string key = "user:" + std::to_string(rnd.Uniform(100000));
+        if(rnd.OneIn(10)) key.append(200, 'k');
+        model[key] = std::string(rnd.Uniform(300), static_cast<char>('a' + i % 26));
+    }
+
+    const int intervals[] = {1, 2, 16, 1000};
+    for(size_t n = 0; n < sizeof(intervals) / sizeof(intervals[0]); n++) {
+        std::string storage;
+        Block* block = BuildBlock(model, intervals[n], &storage);
+        Iterator* iter = block->NewIterator(BytewiseComparator());
+
+        std::map<std::string, std::string>::iterator it = model.begin();
+        for(iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+            ASSERT_EQ(it->first, iter->key().ToString());
+            ASSERT_EQ(it->second, iter->value().ToString());
+        }
+        ASSERT_TRUE(it == model.end());
+
+        std::map<std::string, std::string>::reverse_iterator rit = model.rbegin();
+        for(iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+            ASSERT_EQ(rit->first, iter->key().ToString());
+        }
+        ASSERT_TRUE(rit == model.rend());
+
+        for(int i = 0; i < 1000; i++) {
+            std::string target = "user:" + std::to_string(rnd.Uniform(100000));
+            iter->Seek(target);
+            it = model.lower_bound(target);
+            if(it == model.end()) {
+                ASSERT_TRUE(!iter->Valid());
+            } else {
+                ASSERT_TRUE(iter->Valid());
+                ASSERT_EQ(it->first, iter->key().ToString());
+                ASSERT_EQ(it->second, iter->value().ToString());
+            }
+        }
+        ASSERT_TRUE(iter->status().ok());
+        delete iter;
+        delete block;
+    }
+}
+
+TEST(BlockTest, PrefixCompression) {
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 100; i++) model[std::string(50, 'p') + std::to_string(1000 + i)] = "v";
+    std::string full, compressed;
+    delete BuildBlock(model, 1, &full);
+    delete BuildBlock(model, 16, &compressed);
+    ASSERT_LT(compressed.size() * 2, full.size());
+}
+
+TEST(BlockTest, Corruption) {
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 100; i++) model["key" + std::to_string(1000 + i)] = "value";
+    std::string storage;
+    delete BuildBlock(model, 16, &storage);
+
+    // 重启点个数超出块大小
+    std::string bad = storage;
+    bad[bad.size() - 1] = '\x7f';
+    BlockContents contents;
+    contents.data = Slice(bad);
+    contents.cachable = false;
+    contents.heap_allocated = false;
+    Block block(contents);
+    ASSERT_EQ(0u, block.size());
+    Iterator* iter = block.NewIterator(BytewiseComparator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(!iter->Valid());
+    ASSERT_TRUE(iter->status().IsCorruption());
+    delete iter;
+
+    // 第一条记录声称与前一个键共享前缀
+    bad = storage;
+    bad[0] = '\x05';
+    contents.data = Slice(bad);
+    Block block2(contents);
+    iter = block2.NewIterator(BytewiseComparator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(!iter->Valid());
+    ASSERT_TRUE(iter->status().IsCorruption());
+    delete iter;
+}
+
+}   // namespace leveldb
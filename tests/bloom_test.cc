@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "coding.h"
+#include "filter_policy.h"
+
+namespace leveldb {
+
+static const int kVerbose = 1;
+
+static Slice Key(int i, char* buffer) {
+    EncodeFixed32(buffer, i);
+    return Slice(buffer, sizeof(uint32_t));
+}
+
+// 参数为新生成的过滤器的格式
+class BloomTest : public testing::TestWithParam<BloomFilterFormat> {
+protected:
+    BloomTest() : policy_(NewBloomFilterPolicy(10, GetParam())) {}
+    ~BloomTest() override { delete policy_; }
+
+    void Reset() {
+        keys_.clear();
+        filter_.clear();
+    }
+
+    void Add(const Slice& s) { keys_.push_back(s.ToString()); }
+
+    void Build() {
+        std::vector<Slice> key_slices;
+        for(size_t i = 0; i < keys_.size(); i++) key_slices.push_back(Slice(keys_[i]));
+        filter_.clear();
+        policy_->CreateFilter(key_slices.data(), static_cast<int>(key_slices.size()), &filter_);
+        keys_.clear();
+    }
+
+    size_t FilterSize() const { return filter_.size(); }
+
+    bool Matches(const Slice& s) {
+        if(!keys_.empty()) Build();
+        return policy_->KeyMayMatch(s, filter_);
+    }
+
+    double FalsePositiveRate() {
+        char buffer[sizeof(int)];
+        int result = 0;
+        for(int i = 0; i < 10000; i++) {
+            if(Matches(Key(i + 1000000000, buffer))) result++;
+        }
+        return result / 10000.0;
+    }
+
+private:
+    const FilterPolicy* policy_;
+    std::string filter_;
+    std::vector<std::string> keys_;
+};
+
+TEST_P(BloomTest, EmptyFilter) {
+    ASSERT_TRUE(!Matches("hello"));
+    ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_P(BloomTest, Small) {
+    Add("hello");
+    Add("world");
+    ASSERT_TRUE(Matches("hello"));
+    ASSERT_TRUE(Matches("world"));
+    ASSERT_TRUE(!Matches("x"));
+    ASSERT_TRUE(!Matches("foo"));
+}
+
+static int NextLength(int length) {
+    if(length < 10) {
+        length += 1;
+    } else if(length < 100) {
+        length += 10;
+    } else if(length < 1000) {
+        length += 100;
+    } else {
+        length += 1000;
+    }
+    return length;
+}
+
+// 各种键数下都没有漏判, 误判率接近 bits_per_key = 10 时的理论值 1%
+TEST_P(BloomTest, VaryingLengths) {
+    char buffer[sizeof(int)];
+
+    int mediocre_filters = 0;
+    int good_filters = 0;
+
+    for(int length = 1; length <= 10000; length = NextLength(length)) {
+        Reset();
+        for(int i = 0; i < length; i++) Add(Key(i, buffer));
+        Build();
+
+        // 分块格式按 64 字节的整行分配
+        ASSERT_LE(FilterSize(), static_cast<size_t>((length * 10 / 8) + 64 + 40)) << length;
+
+        for(int i = 0; i < length; i++) {
+            ASSERT_TRUE(Matches(Key(i, buffer))) << "Length " << length << "; key " << i;
+        }
+
+        double rate = FalsePositiveRate();
+        if(kVerbose >= 2) {
+            std::fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+                         rate * 100.0, length, static_cast<int>(FilterSize()));
+        }
+        // 分块格式每行内的键数有波动, 误判率略高
+        const bool blocked = GetParam() == kBlockedBloomFormat;
+        ASSERT_LE(rate, blocked ? 0.03 : 0.02);
+        if(rate > (blocked ? 0.02 : 0.0125)) {
+            mediocre_filters++;  // 允许少数偏高
+        } else {
+            good_filters++;
+        }
+    }
+    ASSERT_LE(mediocre_filters, good_filters / 5);
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, BloomTest,
+                         testing::Values(kLegacyBloomFormat, kBlockedBloomFormat));
+
+// 过滤器记录了自己的格式, 任意格式设置的策略都能读取两种格式的过滤器
+TEST(BloomFormatTest, ReadsEitherFormat) {
+    const FilterPolicy* legacy = NewBloomFilterPolicy(10, kLegacyBloomFormat);
+    const FilterPolicy* blocked = NewBloomFilterPolicy(10, kBlockedBloomFormat);
+    ASSERT_STREQ(legacy->Name(), blocked->Name());
+
+    char buffer[sizeof(int)];
+    std::vector<std::string> storage;
+    for(int i = 0; i < 1000; i++) storage.push_back(Key(i, buffer).ToString());
+    std::vector<Slice> keys(storage.begin(), storage.end());
+
+    const FilterPolicy* policies[] = {legacy, blocked};
+    for(int w = 0; w < 2; w++) {
+        std::string filter;
+        policies[w]->CreateFilter(keys.data(), static_cast<int>(keys.size()), &filter);
+        for(int r = 0; r < 2; r++) {
+            int false_positives = 0;
+            for(int i = 0; i < 1000; i++) {
+                ASSERT_TRUE(policies[r]->KeyMayMatch(keys[i], filter));
+                if(policies[r]->KeyMayMatch(Key(i + 1000000, buffer), filter)) false_positives++;
+            }
+            ASSERT_LE(false_positives, 30);
+        }
+    }
+    delete legacy;
+    delete blocked;
+}
+
+// 分块格式的位数组从 dst 中 64 字节对齐的位置开始, 前面已有的内容保持不变
+TEST(BloomFormatTest, BlockedFilterIsLineAligned) {
+    const FilterPolicy* blocked = NewBloomFilterPolicy(10, kBlockedBloomFormat);
+    std::string dst = "abc";
+    Slice key("hello");
+    blocked->CreateFilter(&key, 1, &dst);
+    ASSERT_EQ("abc", dst.substr(0, 3));
+    // 3 字节已有内容 + 61 字节填充 + 一行 + 3 字节尾部
+    ASSERT_EQ(3u + 61 + 64 + 3, dst.size());
+    Slice filter(dst.data() + 3, dst.size() - 3);
+    ASSERT_TRUE(blocked->KeyMayMatch(key, filter));
+    ASSERT_TRUE(!blocked->KeyMayMatch("world", filter));
+    delete blocked;
+}
+
+}   // namespace leveldb
@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "cache.h"
+#include "coding.h"
+
+namespace leveldb {
+
+// 键和值都用整数, 便于检查
+static std::string EncodeKey(int k) {
+    std::string result;
+    PutFixed32(&result, k);
+    return result;
+}
+static int DecodeKey(const Slice& k) {
+    assert(k.size() == 4);
+    return DecodeFixed32(k.data());
+}
+static void* EncodeValue(uintptr_t v) { return reinterpret_cast<void*>(v); }
+static int DecodeValue(void* v) { return reinterpret_cast<uintptr_t>(v); }
+
+// 各种淘汰策略的缓存共用同一组测试
+typedef Cache* (*CacheFactory)(size_t capacity);
+
+class CacheTest : public testing::TestWithParam<CacheFactory> {
+protected:
+    static void Deleter(const Slice& key, void* v) {
+        current_->deleted_keys_.push_back(DecodeKey(key));
+        current_->deleted_values_.push_back(DecodeValue(v));
+    }
+
+    static const int kCacheSize = 1000;
+
+    CacheTest() : cache_(GetParam()(kCacheSize)) { current_ = this; }
+    ~CacheTest() override { delete cache_; }
+
+    int Lookup(int key) {
+        Cache::Handle* handle = cache_->Lookup(EncodeKey(key));
+        const int r = (handle == nullptr) ? -1 : DecodeValue(cache_->Value(handle));
+        if(handle != nullptr) cache_->Release(handle);
+        return r;
+    }
+
+    void Insert(int key, int value, int charge = 1) {
+        cache_->Release(cache_->Insert(EncodeKey(key), EncodeValue(value), charge, &CacheTest::Deleter));
+    }
+
+    Cache::Handle* InsertAndReturnHandle(int key, int value, int charge = 1) {
+        return cache_->Insert(EncodeKey(key), EncodeValue(value), charge, &CacheTest::Deleter);
+    }
+
+    void Erase(int key) { cache_->Erase(EncodeKey(key)); }
+
+    static CacheTest* current_;
+    std::vector<int> deleted_keys_;
+    std::vector<int> deleted_values_;
+    Cache* cache_;
+};
+CacheTest* CacheTest::current_;
+
+TEST_P(CacheTest, HitAndMiss) {
+    ASSERT_EQ(-1, Lookup(100));
+
+    Insert(100, 101);
+    ASSERT_EQ(101, Lookup(100));
+    ASSERT_EQ(-1, Lookup(200));
+    ASSERT_EQ(-1, Lookup(300));
+
+    Insert(200, 201);
+    ASSERT_EQ(101, Lookup(100));
+    ASSERT_EQ(201, Lookup(200));
+    ASSERT_EQ(-1, Lookup(300));
+
+    Insert(100, 102);
+    ASSERT_EQ(102, Lookup(100));
+    ASSERT_EQ(201, Lookup(200));
+    ASSERT_EQ(-1, Lookup(300));
+
+    ASSERT_EQ(1, deleted_keys_.size());
+    ASSERT_EQ(100, deleted_keys_[0]);
+    ASSERT_EQ(101, deleted_values_[0]);
+}
+
+TEST_P(CacheTest, Erase) {
+    Erase(200);
+    ASSERT_EQ(0, deleted_keys_.size());
+
+    Insert(100, 101);
+    Insert(200, 201);
+    Erase(100);
+    ASSERT_EQ(-1, Lookup(100));
+    ASSERT_EQ(201, Lookup(200));
+    ASSERT_EQ(1, deleted_keys_.size());
+    ASSERT_EQ(100, deleted_keys_[0]);
+    ASSERT_EQ(101, deleted_values_[0]);
+
+    Erase(100);
+    ASSERT_EQ(-1, Lookup(100));
+    ASSERT_EQ(201, Lookup(200));
+    ASSERT_EQ(1, deleted_keys_.size());
+}
+
+// 被句柄引用的条目在删除或覆盖之后仍然有效, 最后一个句柄释放时才调用 deleter
+TEST_P(CacheTest, EntriesArePinned) {
+    Insert(100, 101);
+    Cache::Handle* h1 = cache_->Lookup(EncodeKey(100));
+    ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+
+    Insert(100, 102);
+    Cache::Handle* h2 = cache_->Lookup(EncodeKey(100));
+    ASSERT_EQ(102, DecodeValue(cache_->Value(h2)));
+    ASSERT_EQ(0, deleted_keys_.size());
+
+    cache_->Release(h1);
+    ASSERT_EQ(1, deleted_keys_.size());
+    ASSERT_EQ(100, deleted_keys_[0]);
+    ASSERT_EQ(101, deleted_values_[0]);
+
+    Erase(100);
+    ASSERT_EQ(-1, Lookup(100));
+    ASSERT_EQ(1, deleted_keys_.size());
+
+    cache_->Release(h2);
+    ASSERT_EQ(2, deleted_keys_.size());
+    ASSERT_EQ(100, deleted_keys_[1]);
+    ASSERT_EQ(102, deleted_values_[1]);
+}
+
+// 经常访问的条目不会被淘汰
+TEST_P(CacheTest, EvictionPolicy) {
+    Insert(100, 101);
+    Insert(200, 201);
+    Insert(300, 301);
+    Cache::Handle* h = cache_->Lookup(EncodeKey(300));
+
+    for(int i = 0; i < kCacheSize + 100; i++) {
+        Insert(1000 + i, 2000 + i);
+        ASSERT_EQ(2000 + i, Lookup(1000 + i));
+        ASSERT_EQ(101, Lookup(100));
+    }
+    ASSERT_EQ(101, Lookup(100));
+    ASSERT_EQ(-1, Lookup(200));
+    ASSERT_EQ(301, Lookup(300));
+    cache_->Release(h);
+}
+
+// 被引用的条目不计入可淘汰的部分, 占用可以暂时超过容量
+TEST_P(CacheTest, UseExceedsCacheSize) {
+    std::vector<Cache::Handle*> h;
+    for(int i = 0; i < kCacheSize + 100; i++) h.push_back(InsertAndReturnHandle(1000 + i, 2000 + i));
+
+    for(size_t i = 0; i < h.size(); i++) ASSERT_EQ(2000 + static_cast<int>(i), Lookup(1000 + i));
+
+    for(size_t i = 0; i < h.size(); i++) cache_->Release(h[i]);
+}
+
+// 按 charge 计算容量: 大条目挤出的条目更多
+TEST_P(CacheTest, HeavyEntries) {
+    const int kLight = 1;
+    const int kHeavy = 10;
+    int added = 0;
+    int index = 0;
+    while(added < 2 * kCacheSize) {
+        const int weight = (index & 1) ? kLight : kHeavy;
+        Insert(index, 1000 + index, weight);
+        added += weight;
+        index++;
+    }
+
+    int cached_weight = 0;
+    for(int i = 0; i < index; i++) {
+        const int weight = (i & 1 ? kLight : kHeavy);
+        int r = Lookup(i);
+        if(r >= 0) {
+            cached_weight += weight;
+            ASSERT_EQ(1000 + i, r);
+        }
+    }
+    ASSERT_LE(cached_weight, kCacheSize + kCacheSize / 10);
+    ASSERT_LE(cache_->TotalCharge(), static_cast<size_t>(kCacheSize + kCacheSize / 10));
+}
+
+TEST_P(CacheTest, NewId) {
+    uint64_t a = cache_->NewId();
+    uint64_t b = cache_->NewId();
+    ASSERT_NE(a, b);
+}
+
+TEST_P(CacheTest, Prune) {
+    Insert(1, 100);
+    Insert(2, 200);
+
+    Cache::Handle* handle = cache_->Lookup(EncodeKey(1));
+    ASSERT_TRUE(handle);
+    cache_->Prune();
+    cache_->Release(handle);
+
+    ASSERT_EQ(100, Lookup(1));
+    ASSERT_EQ(-1, Lookup(2));
+}
+
+TEST_P(CacheTest, ZeroSizeCache) {
+    delete cache_;
+    cache_ = GetParam()(0);
+
+    Insert(1, 100);
+    ASSERT_EQ(-1, Lookup(1));
+}
+
+TEST_P(CacheTest, Stats) {
+    Insert(1, 100);
+    Insert(2, 200);
+    ASSERT_EQ(100, Lookup(1));
+    ASSERT_EQ(100, Lookup(1));
+    ASSERT_EQ(-1, Lookup(3));
+
+    Cache::Stats stats = cache_->GetStats();
+    ASSERT_EQ(2u, stats.hits);
+    ASSERT_EQ(1u, stats.misses);
+    ASSERT_EQ(2u, stats.inserts);
+    ASSERT_EQ(0u, stats.evictions);
+
+    for(int i = 0; i < kCacheSize * 2; i++) Insert(1000 + i, i);
+    stats = cache_->GetStats();
+    // 容量按分片向上取整, 实际可容纳的条目略多于 kCacheSize
+    ASSERT_GE(stats.evictions, static_cast<uint64_t>(kCacheSize * 9 / 10));
+    ASSERT_EQ(stats.inserts - stats.evictions, static_cast<uint64_t>(cache_->TotalCharge()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, CacheTest, testing::Values(&NewLRUCache, &NewTinyLFUCache));
+
+// 先查, 未命中再插入, 和表读取使用块缓存的方式相同
+static void Access(Cache* cache, int key) {
+    Cache::Handle* h = cache->Lookup(EncodeKey(key));
+    if(h == nullptr) h = cache->Insert(EncodeKey(key), EncodeValue(key), 1, [](const Slice&, void*) {});
+    cache->Release(h);
+}
+
+// 返回一次大范围扫描之后还留在缓存中的热点键个数
+static int HotKeysAfterScan(Cache* cache, int hot_keys, int scan_keys) {
+    for(int round = 0; round < 10; round++) {
+        for(int k = 0; k < hot_keys; k++) Access(cache, k);
+    }
+    for(int k = 0; k < scan_keys; k++) Access(cache, 100000 + k);
+    int cached = 0;
+    for(int k = 0; k < hot_keys; k++) {
+        Cache::Handle* h = cache->Lookup(EncodeKey(k));
+        if(h != nullptr) {
+            cached++;
+            cache->Release(h);
+        }
+    }
+    return cached;
+}
+
+// 扫描的键只访问一次, 频率比不过热点, 进不了主区; LRU 会被扫描整个冲掉
+TEST(TinyLFUCacheTest, ScanResistance) {
+    const int kCapacity = 1600;
+    const int kHot = 200;
+    const int kScan = 4 * kCapacity;
+
+    Cache* lru = NewLRUCache(kCapacity);
+    ASSERT_LT(HotKeysAfterScan(lru, kHot, kScan), kHot / 10);
+    delete lru;
+
+    Cache* tinylfu = NewTinyLFUCache(kCapacity);
+    ASSERT_GE(HotKeysAfterScan(tinylfu, kHot, kScan), kHot * 9 / 10);
+    ASSERT_LE(tinylfu->TotalCharge(), static_cast<size_t>(kCapacity));
+    delete tinylfu;
+}
+
+class CacheConcurrencyTest : public testing::TestWithParam<CacheFactory> {};
+
+// 多线程同时读写不同分片和同一分片, 所有句柄都正确释放
+TEST_P(CacheConcurrencyTest, ParallelLookupInsert) {
+    Cache* cache = GetParam()(1000);
+    std::atomic<int> deleted(0);
+    static std::atomic<int>* deleted_ptr;
+    deleted_ptr = &deleted;
+    struct Del {
+        static void Fn(const Slice&, void*) { deleted_ptr->fetch_add(1); }
+    };
+
+    const int kThreads = 4;
+    const int kOps = 20000;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; t++) {
+        threads.emplace_back([cache, t]() {
+            for(int i = 0; i < kOps; i++) {
+                const std::string key = EncodeKey((i * 7 + t) % 3000);
+                Cache::Handle* h = cache->Lookup(key);
+                if(h == nullptr) {
+                    h = cache->Insert(key, EncodeValue(DecodeKey(key)), 1, &Del::Fn);
+                }
+                EXPECT_EQ(DecodeKey(key), DecodeValue(cache->Value(h)));
+                cache->Release(h);
+            }
+        });
+    }
+    for(size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    Cache::Stats stats = cache->GetStats();
+    ASSERT_EQ(static_cast<uint64_t>(kThreads * kOps), stats.hits + stats.misses);
+    ASSERT_LE(cache->TotalCharge(), 1000u + 16);
+    const uint64_t inserts = stats.inserts;
+    delete cache;
+    ASSERT_EQ(inserts, static_cast<uint64_t>(deleted.load()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, CacheConcurrencyTest, testing::Values(&NewLRUCache, &NewTinyLFUCache));
+
+}   // namespace leveldb
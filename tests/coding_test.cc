@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "coding.h"
+#include "random.h"
+
+namespace leveldb {
+
+TEST(CodingTest, Fixed32) {
+    std::string s;
+    for(uint32_t v = 0; v < 100000; v++) PutFixed32(&s, v);
+    const char* p = s.data();
+    for(uint32_t v = 0; v < 100000; v++) {
+        ASSERT_EQ(v, DecodeFixed32(p));
+        p += sizeof(uint32_t);
+    }
+}
+
+TEST(CodingTest, Fixed64) {
+    std::string s;
+    for(int power = 0; power <= 63; power++) {
+        uint64_t v = static_cast<uint64_t>(1) << power;
+        PutFixed64(&s, v - 1);
+        PutFixed64(&s, v + 0);
+        PutFixed64(&s, v + 1);
+    }
+    const char* p = s.data();
+    for(int power = 0; power <= 63; power++) {
+        uint64_t v = static_cast<uint64_t>(1) << power;
+        ASSERT_EQ(v - 1, DecodeFixed64(p));
+        ASSERT_EQ(v + 0, DecodeFixed64(p + 8));
+        ASSERT_EQ(v + 1, DecodeFixed64(p + 16));
+        p += 24;
+    }
+}
+
+// 定长编码必须是小端序, 与主机字节序无关
+TEST(CodingTest, EncodingOutput) {
+    std::string dst;
+    PutFixed32(&dst, 0x04030201);
+    ASSERT_EQ(4u, dst.size());
+    ASSERT_EQ(0x01, static_cast<int>(dst[0]));
+    ASSERT_EQ(0x04, static_cast<int>(dst[3]));
+}
+
+TEST(CodingTest, Varint32) {
+    std::string s;
+    for(uint32_t i = 0; i < (32 * 32); i++) {
+        uint32_t v = (i / 32) << (i % 32);
+        PutVarint32(&s, v);
+    }
+    const char* p = s.data();
+    const char* limit = p + s.size();
+    for(uint32_t i = 0; i < (32 * 32); i++) {
+        uint32_t expected = (i / 32) << (i % 32);
+        uint32_t actual;
+        const char* start = p;
+        p = GetVarint32Ptr(p, limit, &actual);
+        ASSERT_TRUE(p != nullptr);
+        ASSERT_EQ(expected, actual);
+        ASSERT_EQ(VarintLength(actual), p - start);
+    }
+    ASSERT_EQ(p, limit);
+}
+
+TEST(CodingTest, Varint64) {
+    std::vector<uint64_t> values;
+    values.push_back(0);
+    values.push_back(100);
+    values.push_back(~static_cast<uint64_t>(0));
+    values.push_back(~static_cast<uint64_t>(0) - 1);
+    for(uint32_t k = 0; k < 64; k++) {
+        const uint64_t power = 1ull << k;
+        values.push_back(power);
+        values.push_back(power - 1);
+        values.push_back(power + 1);
+    }
+    std::string s;
+    for(size_t i = 0; i < values.size(); i++) PutVarint64(&s, values[i]);
+
+    Slice input(s);
+    for(size_t i = 0; i < values.size(); i++) {
+        uint64_t actual;
+        ASSERT_TRUE(GetVarint64(&input, &actual));
+        ASSERT_EQ(values[i], actual);
+    }
+    ASSERT_TRUE(input.empty());
+}
+
+TEST(CodingTest, Varint32Overflow) {
+    uint32_t result;
+    std::string input("\x81\x82\x83\x84\x85\x11");
+    ASSERT_TRUE(GetVarint32Ptr(input.data(), input.data() + input.size(), &result) == nullptr);
+}
+
+TEST(CodingTest, Varint32Truncation) {
+    uint32_t large_value = (1u << 31) + 100;
+    std::string s;
+    PutVarint32(&s, large_value);
+    uint32_t result;
+    for(size_t len = 0; len < s.size() - 1; len++) {
+        ASSERT_TRUE(GetVarint32Ptr(s.data(), s.data() + len, &result) == nullptr);
+    }
+    ASSERT_TRUE(GetVarint32Ptr(s.data(), s.data() + s.size(), &result) != nullptr);
+    ASSERT_EQ(large_value, result);
+}
+
+TEST(CodingTest, Varint64Truncation) {
+    uint64_t large_value = (1ull << 63) + 100ull;
+    std::string s;
+    PutVarint64(&s, large_value);
+    uint64_t result;
+    for(size_t len = 0; len < s.size() - 1; len++) {
+        ASSERT_TRUE(GetVarint64Ptr(s.data(), s.data() + len, &result) == nullptr);
+    }
+    ASSERT_TRUE(GetVarint64Ptr(s.data(), s.data() + s.size(), &result) != nullptr);
+    ASSERT_EQ(large_value, result);
+}
+
+TEST(CodingTest, Strings) {
+    std::string s;
+    PutLengthPrefixedSlice(&s, Slice(""));
+    PutLengthPrefixedSlice(&s, Slice("foo"));
+    PutLengthPrefixedSlice(&s, Slice("bar"));
+    PutLengthPrefixedSlice(&s, Slice(std::string(200, 'x')));
+
+    Slice input(s);
+    Slice v;
+    ASSERT_TRUE(GetLengthPrefixedSlice(&input, &v));
+    ASSERT_EQ("", v.ToString());
+    ASSERT_TRUE(GetLengthPrefixedSlice(&input, &v));
+    ASSERT_EQ("foo", v.ToString());
+    ASSERT_TRUE(GetLengthPrefixedSlice(&input, &v));
+    ASSERT_EQ("bar", v.ToString());
+    ASSERT_TRUE(GetLengthPrefixedSlice(&input, &v));
+    ASSERT_EQ(std::string(200, 'x'), v.ToString());
+    ASSERT_EQ("", input.ToString());
+    // 长度前缀超出剩余数据
+    std::string bad;
+    PutVarint32(&bad, 10);
+    bad.append("abc");
+    input = Slice(bad);
+    ASSERT_TRUE(!GetLengthPrefixedSlice(&input, &v));
+}
+
+// 批量解析与逐个解析的结果和结束位置必须完全一致, 覆盖单字节整批、跨窗口和尾部路径
+TEST(CodingTest, Varint32Batch) {
+    Random rnd(301);
+    for(int round = 0; round < 200; round++) {
+        const size_t n = rnd.Uniform(100);
+        std::vector<uint32_t> expected;
+        std::string s;
+        for(size_t i = 0; i < n; i++) {
+            uint32_t v;
+            switch(round % 4) {
+                case 0: v = rnd.Uniform(128); break;                         // 全部单字节
+                case 1: v = rnd.Uniform(1 << 14); break;                     // 1~2 字节
+                case 2: v = rnd.Next() >> rnd.Uniform(32); break;            // 各种长度混合
+                default: v = rnd.OneIn(8) ? 0xffffffffu : rnd.Uniform(64); break;
+            }
+            expected.push_back(v);
+            PutVarint32(&s, v);
+        }
+        s.append(rnd.Uniform(20), '\x7f');  // 尾部多余数据不影响结果
+
+        std::vector<uint32_t> actual(n + 1, 12345);
+        const char* end = GetVarint32Batch(s.data(), s.data() + s.size(), actual.data(), n);
+        ASSERT_TRUE(end != nullptr);
+        for(size_t i = 0; i < n; i++) ASSERT_EQ(expected[i], actual[i]) << round << " " << i;
+        ASSERT_EQ(12345u, actual[n]);  // 不会多写
+
+        const char* p = s.data();
+        uint32_t v;
+        for(size_t i = 0; i < n; i++) p = GetVarint32Ptr(p, s.data() + s.size(), &v);
+        ASSERT_EQ(p, end);
+    }
+}
+
+TEST(CodingTest, Varint32BatchCorruption) {
+    uint32_t values[4];
+    // 数据不足
+    std::string s;
+    PutVarint32(&s, 1);
+    PutVarint32(&s, 300);
+    ASSERT_TRUE(GetVarint32Batch(s.data(), s.data() + s.size(), values, 3) == nullptr);
+    // 一长串续位: 超过 5 字节的 varint32 非法
+    std::string bad(32, '\x80');
+    ASSERT_TRUE(GetVarint32Batch(bad.data(), bad.data() + bad.size(), values, 1) == nullptr);
+    bad = std::string(4, '\x01') + std::string(6, '\x81') + std::string(16, '\x01');
+    ASSERT_TRUE(GetVarint32Batch(bad.data(), bad.data() + bad.size(), values, 4) != nullptr);
+    ASSERT_TRUE(GetVarint32Batch(bad.data(), bad.data() + bad.size(), values, 5) == nullptr);
+}
+
+}   // namespace leveldb
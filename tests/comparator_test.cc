@@ -27,6 +27,24 @@ TEST(ComparatorTest, FindShortestSeparator) {
     EXPECT_GE(cmp->Compare(Slice(start), Slice("apple")), 0);
 }
 
+// 差异字节加一后等于 limit 的字节时不能截断, 否则分隔键等于 limit
+TEST(ComparatorTest, FindShortestSeparatorAdjacentBytes) {
+    const Comparator* cmp = BytewiseComparator();
+    std::string start = "abc1";
+    cmp->FindShortestSeparator(&start, Slice("abd"));
+    EXPECT_EQ("abc1", start);
+
+    // 差异位置较深时, 只要 limit 的字节足够大就能截断
+    start = std::string("aaaaaaa\x01zzz");
+    cmp->FindShortestSeparator(&start, Slice("aaaaaaa\x05"));
+    EXPECT_EQ(std::string("aaaaaaa\x02"), start);
+
+    // start 是 limit 的前缀时保持不变
+    start = "abc";
+    cmp->FindShortestSeparator(&start, Slice("abcdef"));
+    EXPECT_EQ("abc", start);
+}
+
 TEST(ComparatorTest, FindShortSuccessor) {
     const Comparator* cmp = BytewiseComparator();
     std::string key = "abc";
@@ -34,4 +52,20 @@ TEST(ComparatorTest, FindShortSuccessor) {
     EXPECT_GE(cmp->Compare(Slice(key), Slice("abc")), 0);
 }
 
+TEST(ComparatorTest, BytewiseCompareMatchesVirtual) {
+    const Comparator* cmp = BytewiseComparator();
+    BytewiseCompare inlined;
+    VirtualCompare wrapped(cmp);
+    const char* keys[] = {"", "a", "ab", "abc", "abd", "b", "\xff", "\x80" "a"};
+    const size_t n = sizeof(keys) / sizeof(keys[0]);
+    for(size_t i = 0; i < n; i++) {
+        for(size_t j = 0; j < n; j++) {
+            const int expected = cmp->Compare(keys[i], keys[j]);
+            EXPECT_EQ(expected < 0, inlined(keys[i], keys[j]) < 0);
+            EXPECT_EQ(expected == 0, inlined(keys[i], keys[j]) == 0);
+            EXPECT_EQ(expected, wrapped(keys[i], keys[j]));
+        }
+    }
+}
+
 } // namespace leveldb
\ No newline at end of file
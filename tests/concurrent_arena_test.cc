@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "concurrent_arena.h"
+#include "random.h"
+#include "skiplist.h"
+
+namespace leveldb {
+
+TEST(ConcurrentArenaTest, Empty) { ConcurrentArena arena; }
+
+TEST(ConcurrentArenaTest, SingleThread) {
+    ConcurrentArena arena;
+    std::vector<std::pair<size_t, char*>> allocated;
+    Random rnd(301);
+    size_t bytes = 0;
+    for(int i = 0; i < 20000; i++) {
+        size_t s = rnd.OneIn(1000) ? rnd.Uniform(6000) : rnd.Uniform(100);
+        if(s == 0) s = 1;
+        char* r = rnd.OneIn(4) ? arena.AllocateAligned(s) : arena.Allocate(s);
+        for(size_t b = 0; b < s; b++) r[b] = i % 256;
+        bytes += s;
+        allocated.emplace_back(s, r);
+        ASSERT_GE(arena.MemoryUsage(), bytes);
+    }
+    for(size_t i = 0; i < allocated.size(); i++) {
+        for(size_t b = 0; b < allocated[i].first; b++) {
+            ASSERT_EQ(int(allocated[i].second[b]) & 0xff, i % 256);
+        }
+    }
+    ASSERT_LE(arena.AllocatedAndUnused(), arena.MemoryUsage());
+}
+
+// 多线程同时分配并写满各自的内存, 结束后检查没有任何两次分配发生重叠
+TEST(ConcurrentArenaTest, MultiThread) {
+    const int kThreads = 4;
+    const int kPerThread = 20000;
+    ConcurrentArena arena(4096);
+    std::vector<std::vector<std::pair<size_t, char*>>> allocated(kThreads);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&arena, &allocated, t]() {
+            Random rnd(1000 + t);
+            for(int i = 0; i < kPerThread; i++) {
+                size_t s = rnd.OneIn(500) ? rnd.Uniform(3000) + 1 : rnd.Uniform(64) + 1;
+                char* r = rnd.OneIn(2) ? arena.AllocateAligned(s) : arena.Allocate(s);
+                std::memset(r, t + 1, s);
+                allocated[t].emplace_back(s, r);
+            }
+        });
+    }
+    for(size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    size_t bytes = 0;
+    for(int t = 0; t < kThreads; t++) {
+        for(size_t i = 0; i < allocated[t].size(); i++) {
+            const size_t s = allocated[t][i].first;
+            const char* p = allocated[t][i].second;
+            bytes += s;
+            for(size_t b = 0; b < s; b++) ASSERT_EQ(p[b], t + 1);
+        }
+    }
+    ASSERT_GE(arena.MemoryUsage(), bytes);
+}
+
+TEST(ConcurrentArenaTest, AlignedAllocation) {
+    ConcurrentArena arena;
+    const size_t align = (sizeof(void*) > 8) ? sizeof(void*) : 8;
+    for(int i = 1; i < 1000; i++) {
+        arena.Allocate(i % 7 + 1);  // 打乱当前区域的对齐
+        char* p = arena.AllocateAligned(i);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) & (align - 1), 0u);
+    }
+}
+
+// 分片区域从后备 Arena 的普通块中切出, 析构后块进入回收站, 下一个 arena 从回收站取块
+TEST(ConcurrentArenaTest, RecyclesBlocks) {
+    BlockRecycler recycler(BlockRecycler::kDefaultCapacity);
+    {
+        ConcurrentArena arena(ConcurrentArena::kDefaultShardBlockSize, Arena::kDefaultBlockSize, 0,
+                              &recycler);
+        for(int i = 0; i < 100000; i++) arena.Allocate(40);
+        ASSERT_GE(arena.MemoryUsage(), 4000000u);
+    }
+    const size_t retained = recycler.RetainedBytes();
+    ASSERT_GE(retained, 4000000u);
+
+    {
+        ConcurrentArena arena(ConcurrentArena::kDefaultShardBlockSize, Arena::kDefaultBlockSize, 0,
+                              &recycler);
+        arena.Allocate(40);
+        ASSERT_LT(recycler.RetainedBytes(), retained);
+    }
+    ASSERT_EQ(recycler.RetainedBytes(), retained);
+}
+
+struct U64Comparator {
+    int operator()(const uint64_t& a, const uint64_t& b) const {
+        if(a < b) return -1;
+        else if(a > b) return +1;
+        else return 0;
+    }
+};
+
+TEST(ConcurrentArenaTest, BacksConcurrentSkipList) {
+    const int kThreads = 4;
+    const int kPerThread = 10000;
+    ConcurrentArena arena;
+    SkipList<uint64_t, U64Comparator, ConcurrentArena> list(U64Comparator(), &arena);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&list, t]() {
+            for(int i = 0; i < kPerThread; i++) {
+                list.InsertConcurrently(static_cast<uint64_t>(i) * kThreads + t);
+            }
+        });
+    }
+    for(size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    SkipList<uint64_t, U64Comparator, ConcurrentArena>::Iterator iter(&list);
+    iter.SeekToFirst();
+    for(uint64_t expected = 0; expected < kThreads * kPerThread; expected++) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(expected, iter.key());
+        iter.Next();
+    }
+    ASSERT_TRUE(!iter.Valid());
+}
+
+}   // namespace leveldb
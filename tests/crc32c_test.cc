@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "crc32c.h"
+#include "random.h"
+
+namespace leveldb {
+namespace crc32c {
+
+// iSCSI 标准(RFC 3720 B.4)中的测试向量
+TEST(CRC, StandardResults) {
+    char buf[32];
+
+    std::memset(buf, 0, sizeof(buf));
+    ASSERT_EQ(0x8a9136aau, Value(buf, sizeof(buf)));
+
+    std::memset(buf, 0xff, sizeof(buf));
+    ASSERT_EQ(0x62a8ab43u, Value(buf, sizeof(buf)));
+
+    for(int i = 0; i < 32; i++) buf[i] = static_cast<char>(i);
+    ASSERT_EQ(0x46dd794eu, Value(buf, sizeof(buf)));
+
+    for(int i = 0; i < 32; i++) buf[i] = static_cast<char>(31 - i);
+    ASSERT_EQ(0x113fdb5cu, Value(buf, sizeof(buf)));
+
+    uint8_t data[48] = {
+        0x01, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00,
+        0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x18, 0x28, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    ASSERT_EQ(0xd9963a56u, Value(reinterpret_cast<char*>(data), sizeof(data)));
+}
+
+TEST(CRC, Values) { ASSERT_NE(Value("a", 1), Value("foo", 3)); }
+
+TEST(CRC, Extend) {
+    ASSERT_EQ(Value("hello world", 11), Extend(Value("hello ", 6), "world", 5));
+}
+
+TEST(CRC, Mask) {
+    uint32_t crc = Value("foo", 3);
+    ASSERT_NE(crc, Mask(crc));
+    ASSERT_NE(crc, Mask(Mask(crc)));
+    ASSERT_EQ(crc, Unmask(Mask(crc)));
+    ASSERT_EQ(crc, Unmask(Unmask(Mask(Mask(crc)))));
+}
+
+// 加速路径与查表路径逐一对比: 覆盖未对齐的起点, 以及短/长两种三路交错和剩余尾部
+TEST(CRC, MatchesPortable) {
+    Random rnd(301);
+    std::string data(3 * 8192 * 2 + 3 * 256 * 3 + 64, '\0');
+    for(size_t i = 0; i < data.size(); i++) data[i] = static_cast<char>(rnd.Uniform(256));
+
+    const size_t lengths[] = {0, 1, 7, 8, 9, 63, 767, 768, 769, 1000, 3 * 8192 - 1,
+                              3 * 8192, 3 * 8192 + 3 * 256 + 5, data.size() - 8};
+    for(size_t offset = 0; offset < 8; offset++) {
+        for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            const char* p = data.data() + offset;
+            ASSERT_EQ(ExtendPortable(0, p, lengths[i]), Value(p, lengths[i]))
+                << offset << " " << lengths[i];
+            ASSERT_EQ(ExtendPortable(0x12345678, p, lengths[i]), Extend(0x12345678, p, lengths[i]));
+        }
+    }
+}
+
+// 分段计算与整段计算结果相同
+TEST(CRC, ExtendInPieces) {
+    Random rnd(301);
+    std::string data(100000, '\0');
+    for(size_t i = 0; i < data.size(); i++) data[i] = static_cast<char>(rnd.Uniform(256));
+    const uint32_t expected = Value(data.data(), data.size());
+    uint32_t crc = 0;
+    size_t pos = 0;
+    while(pos < data.size()) {
+        size_t n = std::min(data.size() - pos, static_cast<size_t>(rnd.Uniform(30000)));
+        crc = Extend(crc, data.data() + pos, n);
+        pos += n;
+    }
+    ASSERT_EQ(expected, crc);
+}
+
+}   // namespace crc32c
+}   // namespace leveldb
@@ -0,0 +1,366 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "db_impl.h"
+#include "env.h"
+#include "filename.h"
+
+namespace leveldb {
+
+// 删除数据库目录及其中的所有文件
+static void DestroyDir(const std::string& dbname) {
+    Env* env = Env::Default();
+    std::vector<std::string> children;
+    if(!env->GetChildren(dbname, &children).ok()) return;
+    for(size_t i = 0; i < children.size(); i++) {
+        if(children[i] != "." && children[i] != "..") env->RemoveFile(dbname + "/" + children[i]);
+    }
+    ::rmdir(dbname.c_str());
+}
+
+class DBTest : public testing::Test {
+public:
+    DBTest() : dbname_("/tmp/leveldb_db_test_" + std::to_string(getpid())), db_(nullptr) {
+        DestroyDir(dbname_);
+        Reopen();
+    }
+
+    ~DBTest() override {
+        delete db_;
+        DestroyDir(dbname_);
+    }
+
+    void Reopen(const Options& options = Options()) {
+        ASSERT_TRUE(TryReopen(options).ok());
+    }
+
+    Status TryReopen(const Options& options) {
+        delete db_;
+        db_ = new DBImpl(options, dbname_);
+        return db_->Open();
+    }
+
+    // 当前唯一的日志文件; 描述文件和表文件共用编号, 日志的编号不固定
+    std::string LogFile() {
+        std::vector<std::string> children;
+        EXPECT_TRUE(Env::Default()->GetChildren(dbname_, &children).ok());
+        std::string result;
+        uint64_t number;
+        FileType type;
+        for(size_t i = 0; i < children.size(); i++) {
+            if(ParseFileName(children[i], &number, &type) && type == kLogFile) {
+                EXPECT_TRUE(result.empty());
+                result = dbname_ + "/" + children[i];
+            }
+        }
+        return result;
+    }
+
+    int CountFiles(FileType want) {
+        std::vector<std::string> children;
+        Env::Default()->GetChildren(dbname_, &children);
+        int count = 0;
+        uint64_t number;
+        FileType type;
+        for(size_t i = 0; i < children.size(); i++) {
+            if(ParseFileName(children[i], &number, &type) && type == want) count++;
+        }
+        return count;
+    }
+
+    int TotalTableFiles() {
+        int result = 0;
+        for(int level = 0; level < config::kNumLevels; level++) result += db_->NumLevelFiles(level);
+        return result;
+    }
+
+    std::string Get(const std::string& key) {
+        std::string value;
+        Status s = db_->Get(key, &value);
+        if(s.IsNotFound()) return "NOT_FOUND";
+        if(!s.ok()) return s.ToString();
+        return value;
+    }
+
+protected:
+    const std::string dbname_;
+    DBImpl* db_;
+};
+
+TEST_F(DBTest, Empty) { ASSERT_EQ("NOT_FOUND", Get("foo")); }
+
+TEST_F(DBTest, PutDeleteGet) {
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v1").ok());
+    ASSERT_EQ("v1", Get("foo"));
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v2").ok());
+    ASSERT_EQ("v2", Get("foo"));
+    ASSERT_TRUE(db_->Delete(WriteOptions(), "foo").ok());
+    ASSERT_EQ("NOT_FOUND", Get("foo"));
+}
+
+TEST_F(DBTest, WriteBatchIsAtomic) {
+    WriteBatch batch;
+    batch.Put("a", "1");
+    batch.Put("b", "2");
+    batch.Delete("a");
+    batch.Put("c", "3");
+    ASSERT_TRUE(db_->Write(WriteOptions(), &batch).ok());
+    ASSERT_EQ("NOT_FOUND", Get("a"));
+    ASSERT_EQ("2", Get("b"));
+    ASSERT_EQ("3", Get("c"));
+}
+
+// 多个线程同时同步写入, 写入经过组提交后全部可见
+TEST_F(DBTest, ConcurrentSyncWrites) {
+    const int kThreads = 8;
+    const int kPerThread = 300;
+    WriteOptions sync;
+    sync.sync = true;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; t++) {
+        threads.emplace_back([this, t, &sync]() {
+            for(int i = 0; i < kPerThread; i++) {
+                std::string key = std::to_string(t) + "." + std::to_string(i);
+                // 同步写和普通写交替, 覆盖组长不合并同步写者的分支
+                ASSERT_TRUE(db_->Put(i % 2 == 0 ? sync : WriteOptions(), key, key + "v").ok());
+            }
+        });
+    }
+    for(size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    for(int t = 0; t < kThreads; t++) {
+        for(int i = 0; i < kPerThread; i++) {
+            std::string key = std::to_string(t) + "." + std::to_string(i);
+            ASSERT_EQ(key + "v", Get(key));
+        }
+    }
+    uint64_t size;
+    ASSERT_TRUE(Env::Default()->GetFileSize(LogFile(), &size).ok());
+    ASSERT_GT(size, 0u);
+}
+
+// 写入过程中并发读取, 读者只会看到某个写入之后的完整状态
+TEST_F(DBTest, ReadsDuringWrites) {
+    std::atomic<bool> stop(false);
+    std::thread writer([this, &stop]() {
+        for(int i = 0; i < 2000; i++) {
+            WriteBatch batch;
+            batch.Put("x", std::to_string(i));
+            batch.Put("y", std::to_string(i));
+            ASSERT_TRUE(db_->Write(WriteOptions(), &batch).ok());
+        }
+        stop.store(true);
+    });
+    while(!stop.load()) {
+        std::string y = Get("y");
+        std::string x = Get("x");
+        // 先读 y 再读 x, x 只会更新
+        if(y != "NOT_FOUND") ASSERT_LE(std::stoi(y), std::stoi(x));
+    }
+    writer.join();
+    ASSERT_EQ("1999", Get("x"));
+}
+
+TEST_F(DBTest, Recover) {
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v1").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "baz", "v5").ok());
+    Reopen();
+    ASSERT_EQ("v1", Get("foo"));
+    ASSERT_EQ("v5", Get("baz"));
+    ASSERT_EQ(2u, db_->recovery_stats().updates);
+
+    // 恢复后的序列号接着旧日志继续, 新写入覆盖旧值
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v2").ok());
+    ASSERT_TRUE(db_->Delete(WriteOptions(), "baz").ok());
+    ASSERT_EQ("v2", Get("foo"));
+    Reopen();
+    ASSERT_EQ("v2", Get("foo"));
+    ASSERT_EQ("NOT_FOUND", Get("baz"));
+    ASSERT_EQ(2u, db_->recovery_stats().files);
+    ASSERT_EQ(4u, db_->recovery_stats().max_sequence);
+}
+
+// 记录跨越多个包和多个日志块的恢复
+TEST_F(DBTest, RecoverManyRecords) {
+    const std::string big(100000, 'x');
+    for(int i = 0; i < 3000; i++) {
+        const std::string key = "k" + std::to_string(i);
+        ASSERT_TRUE(db_->Put(WriteOptions(), key, i % 100 == 0 ? big : key).ok());
+    }
+    Reopen();
+    for(int i = 0; i < 3000; i++) {
+        const std::string key = "k" + std::to_string(i);
+        ASSERT_EQ(i % 100 == 0 ? big : key, Get(key));
+    }
+    ASSERT_EQ(3000u, db_->recovery_stats().records);
+    ASSERT_EQ(0u, db_->recovery_stats().dropped_bytes);
+}
+
+// 日志尾部损坏: 默认跳过损坏的数据, paranoid 模式下打开失败
+TEST_F(DBTest, RecoverWithCorruptLog) {
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v1").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "bar", "v2").ok());
+    delete db_;
+    db_ = nullptr;
+
+    // 翻转第二条记录中的一个字节
+    const std::string fname = LogFile();
+    FILE* f = std::fopen(fname.c_str(), "r+b");
+    ASSERT_TRUE(f != nullptr);
+    std::fseek(f, -2, SEEK_END);
+    int c = std::fgetc(f);
+    std::fseek(f, -2, SEEK_END);
+    std::fputc(c ^ 0x55, f);
+    std::fclose(f);
+
+    Options paranoid;
+    paranoid.paranoid_checks = true;
+    ASSERT_TRUE(TryReopen(paranoid).IsCorruption());
+
+    Reopen();
+    ASSERT_EQ("v1", Get("foo"));
+    ASSERT_EQ("NOT_FOUND", Get("bar"));
+    ASSERT_GT(db_->recovery_stats().dropped_bytes, 0u);
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v3").ok());
+    ASSERT_EQ("v3", Get("foo"));
+}
+
+// memtable 落盘之后从表文件读取, 旧日志被删除
+TEST_F(DBTest, FlushToTable) {
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v1").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "bar", "v2").ok());
+    ASSERT_TRUE(db_->Delete(WriteOptions(), "bar").ok());
+    ASSERT_TRUE(db_->FlushMemTable().ok());
+    ASSERT_EQ(1, TotalTableFiles());
+    ASSERT_EQ(1, CountFiles(kLogFile));
+    ASSERT_EQ("v1", Get("foo"));
+    ASSERT_EQ("NOT_FOUND", Get("bar"));
+
+    // 表文件中的版本被 memtable 中更新的版本覆盖
+    ASSERT_TRUE(db_->Put(WriteOptions(), "foo", "v3").ok());
+    ASSERT_EQ("v3", Get("foo"));
+
+    // 重新打开时从描述文件恢复表文件, 只重放没有落盘的日志
+    Reopen();
+    ASSERT_EQ("v3", Get("foo"));
+    ASSERT_EQ("NOT_FOUND", Get("bar"));
+    ASSERT_EQ(1, TotalTableFiles());
+    ASSERT_EQ(1u, db_->recovery_stats().updates);
+}
+
+// 写入超过 write_buffer_size 时自动切换 memtable 并在后台落盘, L0 文件多了之后自动压缩
+TEST_F(DBTest, AutomaticCompaction) {
+    Options options;
+    options.write_buffer_size = 64 << 10;
+    Reopen(options);
+
+    const std::string value(1000, 'v');
+    for(int i = 0; i < 2000; i++) {
+        ASSERT_TRUE(db_->Put(WriteOptions(), "key" + std::to_string(i % 500), value + std::to_string(i)).ok());
+    }
+    ASSERT_TRUE(db_->FlushMemTable().ok());
+    // 后台压缩完成后 L0 的文件数降到触发值以下, 被压缩掉的文件从目录中删除
+    for(int i = 0; i < 1000; i++) {
+        if(db_->NumLevelFiles(0) < config::kL0_CompactionTrigger && TotalTableFiles() == CountFiles(kTableFile)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_LT(db_->NumLevelFiles(0), config::kL0_CompactionTrigger);
+    ASSERT_GT(TotalTableFiles(), 0);
+    ASSERT_EQ(TotalTableFiles(), CountFiles(kTableFile));
+
+    for(int i = 1500; i < 2000; i++) ASSERT_EQ(value + std::to_string(i), Get("key" + std::to_string(i % 500)));
+
+    Reopen(options);
+    for(int i = 1500; i < 2000; i++) ASSERT_EQ(value + std::to_string(i), Get("key" + std::to_string(i % 500)));
+}
+
+// 压缩丢弃被覆盖的版本和已经没有意义的删除标记
+TEST_F(DBTest, CompactionDropsShadowedAndDeletedEntries) {
+    const std::string value(1000, 'x');
+    for(int round = 0; round < 5; round++) {
+        for(int i = 0; i < 100; i++) ASSERT_TRUE(db_->Put(WriteOptions(), "k" + std::to_string(i), value).ok());
+        ASSERT_TRUE(db_->FlushMemTable().ok());
+    }
+    for(int i = 0; i < 100; i += 2) ASSERT_TRUE(db_->Delete(WriteOptions(), "k" + std::to_string(i)).ok());
+
+    db_->CompactRange(nullptr, nullptr);
+    ASSERT_EQ(0, db_->NumLevelFiles(0));
+
+    // 剩下的数据只有 50 个键各一个版本
+    uint64_t total = 0;
+    std::vector<std::string> children;
+    Env::Default()->GetChildren(dbname_, &children);
+    uint64_t number;
+    FileType type;
+    for(size_t i = 0; i < children.size(); i++) {
+        uint64_t size;
+        if(ParseFileName(children[i], &number, &type) && type == kTableFile &&
+           Env::Default()->GetFileSize(dbname_ + "/" + children[i], &size).ok()) {
+            total += size;
+        }
+    }
+    ASSERT_LT(total, 60u * 1100);
+    ASSERT_GT(total, 50u * 1000);
+
+    for(int i = 0; i < 100; i++) ASSERT_EQ(i % 2 == 0 ? "NOT_FOUND" : value, Get("k" + std::to_string(i)));
+}
+
+// 多次只读不命中第一个文件的查找会触发对它的压缩
+TEST_F(DBTest, SeekCompaction) {
+    // 两个文件范围重叠, 在不同的层; 查找 "b" 要先读上层的文件再读下层的文件
+    ASSERT_TRUE(db_->Put(WriteOptions(), "a", "va").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "b", "vb").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "c", "vc").ok());
+    ASSERT_TRUE(db_->FlushMemTable().ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "a", "va2").ok());
+    ASSERT_TRUE(db_->Put(WriteOptions(), "c", "vc2").ok());
+    ASSERT_TRUE(db_->FlushMemTable().ok());
+    ASSERT_EQ(2, TotalTableFiles());
+
+    // 每个文件至少有 100 次无效查找的额度
+    for(int i = 0; i < 1000 && TotalTableFiles() > 1; i++) {
+        ASSERT_EQ("vb", Get("b"));
+        if(i > 100) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(1, TotalTableFiles());
+    ASSERT_EQ("va2", Get("a"));
+    ASSERT_EQ("vb", Get("b"));
+    ASSERT_EQ("vc2", Get("c"));
+}
+
+// 并发写入和读取期间后台不断落盘和压缩, 读到的总是最新写入的值
+TEST_F(DBTest, ConcurrentWritesDuringCompaction) {
+    Options options;
+    options.write_buffer_size = 32 << 10;
+    Reopen(options);
+
+    const int kThreads = 4;
+    const int kPerThread = 3000;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; t++) {
+        threads.emplace_back([this, t]() {
+            for(int i = 0; i < kPerThread; i++) {
+                const std::string key = std::to_string(t) + "." + std::to_string(i % 300);
+                ASSERT_TRUE(db_->Put(WriteOptions(), key, std::to_string(i)).ok());
+                if(i % 7 == 0) ASSERT_EQ(std::to_string(i), Get(key));
+            }
+        });
+    }
+    for(size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    for(int t = 0; t < kThreads; t++) {
+        for(int i = kPerThread - 300; i < kPerThread; i++) {
+            ASSERT_EQ(std::to_string(i), Get(std::to_string(t) + "." + std::to_string(i % 300)));
+        }
+    }
+    ASSERT_GT(TotalTableFiles(), 0);
+}
+
+}   // namespace leveldb
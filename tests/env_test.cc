@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "env.h"
+
+namespace leveldb {
+
+class EnvPosixTest : public testing::Test {
+protected:
+    EnvPosixTest() : env_(Env::Default()) {}
+    ~EnvPosixTest() override {
+        SetReadOnlyMmapLimit(1000);
+        SetUseIOUring(true);
+    }
+
+    // 写一个 n 字节的文件, 第 i 个字节是 'a' + i % 26
+    std::string WriteFile(int index, size_t n) {
+        const std::string fname =
+            "/tmp/leveldb_env_test_" + std::to_string(getpid()) + "_" + std::to_string(index);
+        WritableFile* file;
+        EXPECT_TRUE(env_->NewWritableFile(fname, &file).ok());
+        std::string data;
+        for(size_t i = 0; i < n; i++) data.push_back('a' + i % 26);
+        EXPECT_TRUE(file->Append(data).ok());
+        EXPECT_TRUE(file->Close().ok());
+        delete file;
+        return fname;
+    }
+
+    Env* env_;
+};
+
+// 映射的文件直接返回映射内存, 不写 scratch; 越过末尾的读取和 pread 一样返回较短的结果
+TEST_F(EnvPosixTest, MmapReadReturnsMappedMemory) {
+    SetReadOnlyMmapLimit(1000);
+    const std::string fname = WriteFile(0, 100);
+    RandomAccessFile* file;
+    ASSERT_TRUE(env_->NewRandomAccessFile(fname, &file).ok());
+
+    char scratch[100];
+    Slice result;
+    ASSERT_TRUE(file->Read(10, 5, &result, scratch).ok());
+    ASSERT_EQ("klmno", result.ToString());
+    ASSERT_TRUE(result.data() < scratch || result.data() >= scratch + sizeof(scratch));
+
+    ASSERT_TRUE(file->Read(95, 10, &result, scratch).ok());
+    ASSERT_EQ("rstuv", result.ToString());
+    ASSERT_TRUE(file->Read(200, 10, &result, scratch).ok());
+    ASSERT_EQ(0u, result.size());
+    delete file;
+    ASSERT_TRUE(env_->RemoveFile(fname).ok());
+}
+
+// 达到映射上限后改用 pread, 关闭映射的文件后名额归还
+TEST_F(EnvPosixTest, MmapLimitFallsBackToPread) {
+    SetReadOnlyMmapLimit(1);
+    const std::string fname = WriteFile(1, 100);
+    char scratch[100];
+    Slice result;
+
+    RandomAccessFile* mapped;
+    ASSERT_TRUE(env_->NewRandomAccessFile(fname, &mapped).ok());
+    ASSERT_TRUE(mapped->Read(0, 3, &result, scratch).ok());
+    ASSERT_NE(scratch, result.data());
+
+    RandomAccessFile* plain;
+    ASSERT_TRUE(env_->NewRandomAccessFile(fname, &plain).ok());
+    ASSERT_TRUE(plain->Read(0, 3, &result, scratch).ok());
+    ASSERT_EQ(scratch, result.data());
+    ASSERT_EQ("abc", result.ToString());
+    delete plain;
+
+    delete mapped;
+    ASSERT_TRUE(env_->NewRandomAccessFile(fname, &mapped).ok());
+    ASSERT_TRUE(mapped->Read(0, 3, &result, scratch).ok());
+    ASSERT_NE(scratch, result.data());
+    delete mapped;
+
+    // 空文件不能映射, 总是用 pread
+    SetReadOnlyMmapLimit(1000);
+    const std::string empty = WriteFile(2, 0);
+    ASSERT_TRUE(env_->NewRandomAccessFile(empty, &plain).ok());
+    ASSERT_TRUE(plain->Read(0, 3, &result, scratch).ok());
+    ASSERT_EQ(0u, result.size());
+    delete plain;
+
+    ASSERT_TRUE(env_->RemoveFile(fname).ok());
+    ASSERT_TRUE(env_->RemoveFile(empty).ok());
+}
+
+// 参数为是否使用 io_uring; 不使用或内核不支持时队列同步执行, 结果应该完全相同
+class IOQueueTest : public EnvPosixTest, public testing::WithParamInterface<bool> {
+protected:
+    IOQueueTest() { SetUseIOUring(GetParam()); }
+
+    // 取回所有请求, 返回取回的个数
+    static int WaitAll(IOQueue* queue) {
+        int n = 0;
+        for(IORequest* req = queue->Wait(); req != nullptr; req = queue->Wait()) {
+            EXPECT_TRUE(req->status.ok()) << req->status.ToString();
+            n++;
+        }
+        return n;
+    }
+};
+
+// 异步写入的块按加入顺序排列, 和直接 Append 交错也不会错位; 深度小于请求数时自动提交和等待
+TEST_P(IOQueueTest, WriteThenSync) {
+    const std::string fname = "/tmp/leveldb_env_test_" + std::to_string(getpid()) + "_queue";
+    WritableFile* file;
+    ASSERT_TRUE(env_->NewWritableFile(fname, &file).ok());
+    IOQueue* queue;
+    ASSERT_TRUE(env_->NewIOQueue(4, &queue).ok());
+
+    const int kChunks = 50;
+    const size_t kChunkSize = 4096;
+    std::vector<std::string> chunks(kChunks);
+    std::vector<IORequest> reqs(kChunks + 1);
+    std::string expected;
+    for(int i = 0; i < kChunks; i++) {
+        chunks[i].assign(kChunkSize, 'a' + i % 26);
+        queue->AddWrite(file, chunks[i], &reqs[i]);
+        expected += chunks[i];
+        if(i % 10 == 9) {
+            ASSERT_TRUE(file->Append("tail").ok());
+            expected += "tail";
+        }
+    }
+    queue->AddSync(file, &reqs[kChunks]);
+    ASSERT_EQ(kChunks + 1, WaitAll(queue));
+    ASSERT_TRUE(file->Close().ok());
+    delete file;
+
+    uint64_t size;
+    ASSERT_TRUE(env_->GetFileSize(fname, &size).ok());
+    ASSERT_EQ(expected.size(), size);
+    RandomAccessFile* reader;
+    ASSERT_TRUE(env_->NewRandomAccessFile(fname, &reader).ok());
+    std::string scratch(size, '\0');
+    Slice result;
+    ASSERT_TRUE(reader->Read(0, size, &result, &scratch[0]).ok());
+    ASSERT_TRUE(result == Slice(expected));
+    delete reader;
+    delete queue;
+    ASSERT_TRUE(env_->RemoveFile(fname).ok());
+}
+
+// 一批随机读同时在途, 每个请求拿到自己的数据; 越过末尾的读取返回较短的结果
+TEST_P(IOQueueTest, BatchedReads) {
+    const std::string fname = WriteFile(3, 1 << 20);
+    IOQueue* queue;
+    ASSERT_TRUE(env_->NewIOQueue(16, &queue).ok());
+    for(int mmap_limit : {0, 1000}) {
+        SetReadOnlyMmapLimit(mmap_limit);
+        RandomAccessFile* file;
+        ASSERT_TRUE(env_->NewRandomAccessFile(fname, &file).ok());
+
+        const int kReads = 64;
+        std::vector<IORequest> reqs(kReads);
+        std::vector<std::string> scratch(kReads, std::string(512, '\0'));
+        for(int i = 0; i < kReads; i++) {
+            reqs[i].arg = reinterpret_cast<void*>(static_cast<uintptr_t>(i));
+            const uint64_t offset = (i == kReads - 1) ? (1 << 20) - 100 : (i * 7919u) % (1 << 20);
+            queue->AddRead(file, offset, 512, &scratch[i][0], &reqs[i]);
+        }
+        int completed = 0;
+        for(IORequest* req = queue->Wait(); req != nullptr; req = queue->Wait(), completed++) {
+            ASSERT_TRUE(req->status.ok());
+            const int i = static_cast<int>(reinterpret_cast<uintptr_t>(req->arg));
+            const uint64_t offset = (i == kReads - 1) ? (1 << 20) - 100 : (i * 7919u) % (1 << 20);
+            ASSERT_EQ(std::min<uint64_t>(512, (1 << 20) - offset), req->result.size());
+            for(size_t j = 0; j < req->result.size(); j++) {
+                ASSERT_EQ('a' + (offset + j) % 26, req->result[j]);
+            }
+        }
+        ASSERT_EQ(kReads, completed);
+        delete file;
+    }
+    delete queue;
+    ASSERT_TRUE(env_->RemoveFile(fname).ok());
+}
+
+INSTANTIATE_TEST_SUITE_P(IOUring, IOQueueTest, testing::Bool());
+
+}   // namespace leveldb
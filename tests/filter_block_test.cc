@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "coding.h"
+#include "filter_block.h"
+#include "filter_policy.h"
+#include "hash.h"
+
+namespace leveldb {
+
+// 每个键记一个 4 字节哈希值, 便于直接检查过滤块的编码
+class TestHashFilter : public FilterPolicy {
+public:
+    const char* Name() const override { return "TestHashFilter"; }
+
+    void CreateFilter(const Slice* keys, int n, std::string* dst) const override {
+        for(int i = 0; i < n; i++) {
+            uint32_t h = Hash(keys[i].data(), keys[i].size(), 1);
+            PutFixed32(dst, h);
+        }
+    }
+
+    bool KeyMayMatch(const Slice& key, const Slice& filter) const override {
+        uint32_t h = Hash(key.data(), key.size(), 1);
+        for(size_t i = 0; i + 4 <= filter.size(); i += 4) {
+            if(h == DecodeFixed32(filter.data() + i)) return true;
+        }
+        return false;
+    }
+};
+
+static std::string EscapeString(const Slice& s) {
+    std::string result;
+    for(size_t i = 0; i < s.size(); i++) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\x%02x", static_cast<unsigned char>(s[i]));
+        result += buf;
+    }
+    return result;
+}
+
+class FilterBlockTest : public testing::Test {
+protected:
+    TestHashFilter policy_;
+};
+
+TEST_F(FilterBlockTest, EmptyBuilder) {
+    FilterBlockBuilder builder(&policy_);
+    Slice block = builder.Finish();
+    ASSERT_EQ("\\x00\\x00\\x00\\x00\\x0b", EscapeString(block));
+    FilterBlockReader reader(&policy_, block);
+    ASSERT_TRUE(reader.KeyMayMatch(0, "foo"));
+    ASSERT_TRUE(reader.KeyMayMatch(100000, "foo"));
+}
+
+TEST_F(FilterBlockTest, SingleChunk) {
+    FilterBlockBuilder builder(&policy_);
+    builder.StartBlock(100);
+    builder.AddKey("foo");
+    builder.AddKey("bar");
+    builder.AddKey("box");
+    builder.StartBlock(200);
+    builder.AddKey("box");
+    builder.StartBlock(300);
+    builder.AddKey("hello");
+    Slice block = builder.Finish();
+    FilterBlockReader reader(&policy_, block);
+    ASSERT_TRUE(reader.KeyMayMatch(100, "foo"));
+    ASSERT_TRUE(reader.KeyMayMatch(100, "bar"));
+    ASSERT_TRUE(reader.KeyMayMatch(100, "box"));
+    ASSERT_TRUE(reader.KeyMayMatch(100, "hello"));
+    ASSERT_TRUE(reader.KeyMayMatch(100, "foo"));
+    ASSERT_TRUE(!reader.KeyMayMatch(100, "missing"));
+    ASSERT_TRUE(!reader.KeyMayMatch(100, "other"));
+}
+
+TEST_F(FilterBlockTest, MultiChunk) {
+    FilterBlockBuilder builder(&policy_);
+
+    // 第一个过滤器
+    builder.StartBlock(0);
+    builder.AddKey("foo");
+    builder.StartBlock(2000);
+    builder.AddKey("bar");
+
+    // 第二个过滤器
+    builder.StartBlock(3100);
+    builder.AddKey("box");
+
+    // 第三个过滤器为空
+
+    // 最后一个过滤器
+    builder.StartBlock(9000);
+    builder.AddKey("box");
+    builder.AddKey("hello");
+
+    Slice block = builder.Finish();
+    FilterBlockReader reader(&policy_, block);
+
+    // 检查第一个过滤器
+    ASSERT_TRUE(reader.KeyMayMatch(0, "foo"));
+    ASSERT_TRUE(reader.KeyMayMatch(2000, "bar"));
+    ASSERT_TRUE(!reader.KeyMayMatch(0, "box"));
+    ASSERT_TRUE(!reader.KeyMayMatch(0, "hello"));
+
+    // 检查第二个过滤器
+    ASSERT_TRUE(reader.KeyMayMatch(3100, "box"));
+    ASSERT_TRUE(!reader.KeyMayMatch(3100, "foo"));
+    ASSERT_TRUE(!reader.KeyMayMatch(3100, "bar"));
+    ASSERT_TRUE(!reader.KeyMayMatch(3100, "hello"));
+
+    // 检查第三个过滤器(空)
+    ASSERT_TRUE(!reader.KeyMayMatch(4100, "foo"));
+    ASSERT_TRUE(!reader.KeyMayMatch(4100, "bar"));
+    ASSERT_TRUE(!reader.KeyMayMatch(4100, "box"));
+    ASSERT_TRUE(!reader.KeyMayMatch(4100, "hello"));
+
+    // 检查最后一个过滤器
+    ASSERT_TRUE(reader.KeyMayMatch(9000, "box"));
+    ASSERT_TRUE(reader.KeyMayMatch(9000, "hello"));
+    ASSERT_TRUE(!reader.KeyMayMatch(9000, "foo"));
+    ASSERT_TRUE(!reader.KeyMayMatch(9000, "bar"));
+}
+
+}   // namespace leveldb
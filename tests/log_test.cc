@@ -0,0 +1,410 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include "coding.h"
+#include "crc32c.h"
+#include "env.h"
+#include "log_reader.h"
+#include "log_writer.h"
+#include "random.h"
+
+namespace leveldb {
+namespace log {
+
+// 构造指定长度的字符串, 由 partial_string 重复拼成
+static std::string BigString(const std::string& partial_string, size_t n) {
+    std::string result;
+    while(result.size() < n) result.append(partial_string);
+    result.resize(n);
+    return result;
+}
+
+static std::string NumberString(int n) {
+    char buf[50];
+    std::snprintf(buf, sizeof(buf), "%d.", n);
+    return std::string(buf);
+}
+
+// 随机长度的字符串, 长度偏向较小的值
+static std::string RandomSkewedString(int i, Random* rnd) {
+    return BigString(NumberString(i), rnd->Uniform(1 << rnd->Uniform(17)));
+}
+
+class LogTest : public testing::Test {
+public:
+    LogTest()
+        : reading_(false), writer_(new Writer(&dest_)),
+          reader_(new Reader(&source_, &report_, true, 0)) {}
+
+    ~LogTest() override {
+        delete writer_;
+        delete reader_;
+    }
+
+    void ReopenForAppend() {
+        delete writer_;
+        writer_ = new Writer(&dest_, dest_.contents_.size());
+    }
+
+    void Write(const std::string& msg) {
+        ASSERT_TRUE(!reading_) << "Write() after starting to read";
+        writer_->AddRecord(Slice(msg));
+    }
+
+    size_t WrittenBytes() const { return dest_.contents_.size(); }
+
+    std::string Read() {
+        if(!reading_) {
+            reading_ = true;
+            source_.contents_ = Slice(dest_.contents_);
+        }
+        std::string scratch;
+        Slice record;
+        if(reader_->ReadRecord(&record, &scratch)) return record.ToString();
+        return "EOF";
+    }
+
+    void IncrementByte(int offset, int delta) { dest_.contents_[offset] += delta; }
+
+    void SetByte(int offset, char new_byte) { dest_.contents_[offset] = new_byte; }
+
+    void ShrinkSize(int bytes) { dest_.contents_.resize(dest_.contents_.size() - bytes); }
+
+    // 修改头部后重新计算 crc, 构造 crc 正确但内容非法的片段
+    void FixChecksum(int header_offset, int len) {
+        uint32_t crc = crc32c::Value(&dest_.contents_[header_offset + 6], 1 + len);
+        crc = crc32c::Mask(crc);
+        EncodeFixed32(&dest_.contents_[header_offset], crc);
+    }
+
+    void ForceError() { source_.force_error_ = true; }
+
+    size_t DroppedBytes() const { return report_.dropped_bytes_; }
+
+    std::string ReportMessage() const { return report_.message_; }
+
+    // message 出现在报告中时返回 "OK"
+    std::string MatchError(const std::string& msg) const {
+        if(report_.message_.find(msg) == std::string::npos) return report_.message_;
+        return "OK";
+    }
+
+    void StartReadingAt(uint64_t initial_offset) {
+        delete reader_;
+        reader_ = new Reader(&source_, &report_, true, initial_offset);
+    }
+
+private:
+    class StringDest : public WritableFile {
+    public:
+        Status Close() override { return Status::OK(); }
+        Status Flush() override { return Status::OK(); }
+        Status Sync() override { return Status::OK(); }
+        Status Append(const Slice& slice) override {
+            contents_.append(slice.data(), slice.size());
+            return Status::OK();
+        }
+
+        std::string contents_;
+    };
+
+    class StringSource : public SequentialFile {
+    public:
+        StringSource() : force_error_(false), returned_partial_(false) {}
+
+        Status Read(size_t n, Slice* result, char* scratch) override {
+            EXPECT_TRUE(!returned_partial_) << "must not Read() after eof/error";
+            if(force_error_) {
+                force_error_ = false;
+                returned_partial_ = true;
+                return Status::Corruption("read error");
+            }
+            if(contents_.size() < n) {
+                n = contents_.size();
+                returned_partial_ = true;
+            }
+            *result = Slice(contents_.data(), n);
+            contents_.remove_prefix(n);
+            return Status::OK();
+        }
+
+        Status Skip(uint64_t n) override {
+            if(n > contents_.size()) {
+                contents_.clear();
+                return Status::NotFound("in-memory file skipped past end");
+            }
+            contents_.remove_prefix(n);
+            return Status::OK();
+        }
+
+        Slice contents_;
+        bool force_error_;
+        bool returned_partial_;
+    };
+
+    class ReportCollector : public Reader::Reporter {
+    public:
+        ReportCollector() : dropped_bytes_(0) {}
+        void Corruption(size_t bytes, const Status& status) override {
+            dropped_bytes_ += bytes;
+            message_.append(status.ToString());
+        }
+
+        size_t dropped_bytes_;
+        std::string message_;
+    };
+
+    StringDest dest_;
+    StringSource source_;
+    ReportCollector report_;
+    bool reading_;
+    Writer* writer_;
+    Reader* reader_;
+};
+
+TEST_F(LogTest, Empty) { ASSERT_EQ("EOF", Read()); }
+
+TEST_F(LogTest, ReadWrite) {
+    Write("foo");
+    Write("bar");
+    Write("");
+    Write("xxxx");
+    ASSERT_EQ("foo", Read());
+    ASSERT_EQ("bar", Read());
+    ASSERT_EQ("", Read());
+    ASSERT_EQ("xxxx", Read());
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ("EOF", Read());  // 到达末尾之后重复读取
+}
+
+TEST_F(LogTest, ManyBlocks) {
+    for(int i = 0; i < 100000; i++) Write(NumberString(i));
+    for(int i = 0; i < 100000; i++) ASSERT_EQ(NumberString(i), Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+TEST_F(LogTest, Fragmentation) {
+    Write("small");
+    Write(BigString("medium", 50000));
+    Write(BigString("large", 100000));
+    ASSERT_EQ("small", Read());
+    ASSERT_EQ(BigString("medium", 50000), Read());
+    ASSERT_EQ(BigString("large", 100000), Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+// 块尾恰好剩下一个头部的空间: 写出一个长度为 0 的 FIRST 片段
+TEST_F(LogTest, MarginalTrailer) {
+    const int n = kBlockSize - 2 * kHeaderSize;
+    Write(BigString("foo", n));
+    ASSERT_EQ(kBlockSize - kHeaderSize, WrittenBytes());
+    Write("");
+    Write("bar");
+    ASSERT_EQ(BigString("foo", n), Read());
+    ASSERT_EQ("", Read());
+    ASSERT_EQ("bar", Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+// 块尾剩余不足一个头部: 补 0 之后换块
+TEST_F(LogTest, ShortTrailer) {
+    const int n = kBlockSize - 2 * kHeaderSize + 4;
+    Write(BigString("foo", n));
+    ASSERT_EQ(kBlockSize - kHeaderSize + 4, WrittenBytes());
+    Write("");
+    Write("bar");
+    ASSERT_EQ(BigString("foo", n), Read());
+    ASSERT_EQ("", Read());
+    ASSERT_EQ("bar", Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+TEST_F(LogTest, RandomRead) {
+    const int N = 500;
+    Random write_rnd(301);
+    for(int i = 0; i < N; i++) Write(RandomSkewedString(i, &write_rnd));
+    Random read_rnd(301);
+    for(int i = 0; i < N; i++) ASSERT_EQ(RandomSkewedString(i, &read_rnd), Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+TEST_F(LogTest, ReadError) {
+    Write("foo");
+    ForceError();
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(static_cast<size_t>(kBlockSize), DroppedBytes());
+    ASSERT_EQ("OK", MatchError("read error"));
+}
+
+TEST_F(LogTest, BadRecordType) {
+    Write("foo");
+    // 类型改成未知值, 并修正 crc
+    IncrementByte(6, 100);
+    FixChecksum(0, 3);
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(3u, DroppedBytes());
+    ASSERT_EQ("OK", MatchError("unknown record type"));
+}
+
+// 文件末尾半条记录是写入端崩溃造成的, 不算损坏
+TEST_F(LogTest, TruncatedTrailingRecordIsIgnored) {
+    Write("foo");
+    ShrinkSize(4);
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(0u, DroppedBytes());
+    ASSERT_EQ("", ReportMessage());
+}
+
+TEST_F(LogTest, BadLength) {
+    const int kPayloadSize = kBlockSize - kHeaderSize;
+    Write(BigString("bar", kPayloadSize));
+    Write("foo");
+    // 最后一个字节改成长度字段, 使记录超出所在块
+    IncrementByte(4, 1);
+    ASSERT_EQ("foo", Read());
+    ASSERT_EQ(static_cast<size_t>(kBlockSize), DroppedBytes());
+    ASSERT_EQ("OK", MatchError("bad record length"));
+}
+
+TEST_F(LogTest, ChecksumMismatch) {
+    Write("foo");
+    IncrementByte(0, 10);
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(10u, DroppedBytes());
+    ASSERT_EQ("OK", MatchError("checksum mismatch"));
+}
+
+TEST_F(LogTest, UnexpectedMiddleType) {
+    Write("foo");
+    SetByte(6, kMiddleType);
+    FixChecksum(0, 3);
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(3u, DroppedBytes());
+    ASSERT_EQ("OK", MatchError("missing start"));
+}
+
+TEST_F(LogTest, UnexpectedFirstType) {
+    Write("foo");
+    Write(BigString("bar", 100000));
+    SetByte(6, kFirstType);
+    FixChecksum(0, 3);
+    ASSERT_EQ(BigString("bar", 100000), Read());
+    ASSERT_EQ("EOF", Read());
+    ASSERT_EQ(3u, DroppedBytes());
+    ASSERT_EQ("OK", MatchError("partial record without end"));
+}
+
+// 损坏只影响所在的块, 后面的记录仍能读出
+TEST_F(LogTest, ErrorJoinsRecords) {
+    Write(BigString("foo", kBlockSize));
+    Write(BigString("bar", kBlockSize));
+    Write("correct");
+    // 抹掉中间的块
+    for(int offset = kBlockSize; offset < 2 * kBlockSize; offset++) SetByte(offset, 'x');
+    ASSERT_EQ("correct", Read());
+    ASSERT_EQ("EOF", Read());
+    const size_t dropped = DroppedBytes();
+    ASSERT_LE(dropped, 2 * kBlockSize + 100u);
+    ASSERT_GE(dropped, 2 * static_cast<size_t>(kBlockSize));
+}
+
+TEST_F(LogTest, ReadStart) {
+    Write("foo");
+    Write(BigString("bar", kBlockSize));
+    Write("baz");
+    // 从第二条记录的起始位置开始读
+    StartReadingAt(kHeaderSize + 3);
+    ASSERT_EQ(BigString("bar", kBlockSize), Read());
+    ASSERT_EQ("baz", Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+TEST_F(LogTest, ReadPastStartOfRecord) {
+    Write("foo");
+    Write(BigString("bar", kBlockSize));
+    Write("baz");
+    // 起始位置落在第二条记录中间, 跳过它的剩余片段
+    StartReadingAt(kHeaderSize + 3 + 1);
+    ASSERT_EQ("baz", Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+// 分段写入与拼接后写入的字节完全相同, 片段边界可以落在段的中间
+TEST(LogGatherTest, MatchesContiguous) {
+    class StringFile : public WritableFile {
+    public:
+        Status Close() override { return Status::OK(); }
+        Status Flush() override { return Status::OK(); }
+        Status Sync() override { return Status::OK(); }
+        Status Append(const Slice& slice) override {
+            contents.append(slice.data(), slice.size());
+            return Status::OK();
+        }
+        std::string contents;
+    };
+
+    Random rnd(301);
+    StringFile gathered_file, contiguous_file;
+    Writer gathered(&gathered_file);
+    Writer contiguous(&contiguous_file);
+    for(int i = 0; i < 200; i++) {
+        std::string pieces[4];
+        Slice parts[4];
+        std::string whole;
+        for(int j = 0; j < 4; j++) {
+            pieces[j] = RandomSkewedString(i * 4 + j, &rnd);
+            parts[j] = Slice(pieces[j]);
+            whole += pieces[j];
+        }
+        ASSERT_TRUE(gathered.AddRecord(parts, 4).ok());
+        ASSERT_TRUE(contiguous.AddRecord(Slice(whole)).ok());
+    }
+    ASSERT_EQ(contiguous_file.contents, gathered_file.contents);
+}
+
+TEST_F(LogTest, ReopenForAppend) {
+    Write("hello");
+    ReopenForAppend();
+    Write("world");
+    ASSERT_EQ("hello", Read());
+    ASSERT_EQ("world", Read());
+    ASSERT_EQ("EOF", Read());
+}
+
+// 通过 posix 环境写入真实文件并读回
+TEST(LogFileTest, PosixRoundTrip) {
+    Env* env = Env::Default();
+    const std::string fname = "/tmp/leveldb_log_test_" + std::to_string(getpid()) + ".log";
+    WritableFile* file;
+    ASSERT_TRUE(env->NewWritableFile(fname, &file).ok());
+    {
+        Writer writer(file);
+        for(int i = 0; i < 1000; i++) ASSERT_TRUE(writer.AddRecord(BigString(NumberString(i), i * 37)).ok());
+        ASSERT_TRUE(file->Sync().ok());
+        ASSERT_TRUE(file->Close().ok());
+    }
+    delete file;
+
+    SequentialFile* source;
+    ASSERT_TRUE(env->NewSequentialFile(fname, &source).ok());
+    {
+        Reader reader(source, nullptr, true, 0);
+        std::string scratch;
+        Slice record;
+        for(int i = 0; i < 1000; i++) {
+            ASSERT_TRUE(reader.ReadRecord(&record, &scratch));
+            ASSERT_EQ(BigString(NumberString(i), i * 37), record.ToString());
+        }
+        ASSERT_TRUE(!reader.ReadRecord(&record, &scratch));
+    }
+    delete source;
+    ASSERT_TRUE(env->RemoveFile(fname).ok());
+    ASSERT_TRUE(!env->FileExists(fname));
+    ASSERT_TRUE(env->NewSequentialFile(fname, &source).IsNotFound());
+}
+
+}   // namespace log
+}   // namespace leveldb
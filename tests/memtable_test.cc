@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "comparator.h"
+#include "dbformat.h"
+#include "memtable.h"
+
+namespace leveldb {
+
+static std::string IKey(const std::string& user_key, SequenceNumber seq, ValueType vt) {
+    std::string encoded;
+    AppendInternalKey(&encoded, ParsedInternalKey(user_key, seq, vt));
+    return encoded;
+}
+
+TEST(FormatTest, InternalKeyEncodeDecode) {
+    const char* keys[] = {"", "k", "hello", "longggggggggggggggggggggg"};
+    const uint64_t seq[] = {1, 2, 3, (1ull << 8) - 1, 1ull << 8, (1ull << 32) + 1, kMaxSequenceNumber};
+    for(size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); k++) {
+        for(size_t s = 0; s < sizeof(seq) / sizeof(seq[0]); s++) {
+            std::string in = IKey(keys[k], seq[s], kTypeValue);
+            ParsedInternalKey decoded("", 0, kTypeValue);
+            ASSERT_TRUE(ParseInternalKey(in, &decoded));
+            ASSERT_EQ(keys[k], decoded.user_key.ToString());
+            ASSERT_EQ(seq[s], decoded.sequence);
+            ASSERT_EQ(kTypeValue, decoded.type);
+        }
+    }
+    ParsedInternalKey decoded;
+    ASSERT_TRUE(!ParseInternalKey(Slice("bar"), &decoded));
+}
+
+TEST(FormatTest, InternalKeyOrder) {
+    InternalKeyComparator icmp(BytewiseComparator());
+    // 用户键升序, 序列号降序
+    ASSERT_LT(icmp.Compare(IKey("a", 100, kTypeValue), IKey("b", 1, kTypeValue)), 0);
+    ASSERT_LT(icmp.Compare(IKey("a", 100, kTypeValue), IKey("a", 99, kTypeValue)), 0);
+    ASSERT_LT(icmp.Compare(IKey("a", 100, kTypeValue), IKey("a", 100, kTypeDeletion)), 0);
+    ASSERT_EQ(icmp.Compare(IKey("a", 100, kTypeValue), IKey("a", 100, kTypeValue)), 0);
+}
+
+TEST(FormatTest, LookupKey) {
+    LookupKey small("foo", 7);
+    ASSERT_EQ("foo", small.user_key().ToString());
+    ASSERT_EQ(IKey("foo", 7, kValueTypeForSeek), small.internal_key().ToString());
+
+    // 超过内嵌缓冲区的长键走堆分配
+    std::string big(1000, 'x');
+    LookupKey large(big, 9);
+    ASSERT_EQ(big, large.user_key().ToString());
+    ASSERT_EQ(IKey(big, 9, kValueTypeForSeek), large.internal_key().ToString());
+}
+
+class MemTableTest : public testing::Test {
+public:
+    MemTableTest() : icmp_(BytewiseComparator()), mem_(new MemTable(icmp_)) { mem_->Ref(); }
+    ~MemTableTest() { mem_->Unref(); }
+
+protected:
+    InternalKeyComparator icmp_;
+    MemTable* mem_;
+};
+
+TEST_F(MemTableTest, Empty) {
+    std::string value;
+    Status s;
+    ASSERT_FALSE(mem_->Get(LookupKey("foo", 100), &value, &s));
+    ASSERT_TRUE(s.ok());
+}
+
+TEST_F(MemTableTest, AddAndGet) {
+    mem_->Add(1, kTypeValue, "foo", "v1");
+    mem_->Add(2, kTypeValue, "bar", "b1");
+    mem_->Add(3, kTypeValue, "foo", "v2");
+
+    std::string value;
+    Status s;
+    ASSERT_TRUE(mem_->Get(LookupKey("foo", 100), &value, &s));
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ("v2", value);
+    ASSERT_TRUE(mem_->Get(LookupKey("bar", 100), &value, &s));
+    ASSERT_EQ("b1", value);
+    ASSERT_FALSE(mem_->Get(LookupKey("baz", 100), &value, &s));
+}
+
+TEST_F(MemTableTest, Snapshot) {
+    mem_->Add(10, kTypeValue, "foo", "v10");
+    mem_->Add(20, kTypeValue, "foo", "v20");
+
+    std::string value;
+    Status s;
+    // 旧快照看不到新版本
+    ASSERT_TRUE(mem_->Get(LookupKey("foo", 15), &value, &s));
+    ASSERT_EQ("v10", value);
+    ASSERT_TRUE(mem_->Get(LookupKey("foo", 20), &value, &s));
+    ASSERT_EQ("v20", value);
+    // 比所有版本都旧的快照
+    ASSERT_FALSE(mem_->Get(LookupKey("foo", 5), &value, &s));
+}
+
+TEST_F(MemTableTest, Deletion) {
+    mem_->Add(1, kTypeValue, "foo", "v1");
+    mem_->Add(2, kTypeDeletion, "foo", "");
+
+    std::string value;
+    Status s;
+    ASSERT_TRUE(mem_->Get(LookupKey("foo", 100), &value, &s));
+    ASSERT_TRUE(s.IsNotFound());
+
+    s = Status::OK();
+    ASSERT_TRUE(mem_->Get(LookupKey("foo", 1), &value, &s));
+    ASSERT_TRUE(s.ok());
+    ASSERT_EQ("v1", value);
+}
+
+// memtable 的块还给进程级回收站, 下一个 memtable 直接取用
+TEST(MemTableRecycleTest, BlocksReusedByNextMemTable) {
+    InternalKeyComparator icmp(BytewiseComparator());
+    BlockRecycler* recycler = BlockRecycler::Default();
+
+    MemTable* mem = new MemTable(icmp);
+    mem->Ref();
+    std::string value(100, 'v');
+    for(int i = 0; i < 10000; i++) mem->Add(i + 1, kTypeValue, "key" + std::to_string(i), value);
+    mem->Unref();
+    const size_t retained = recycler->RetainedBytes();
+    ASSERT_GT(retained, 0u);
+
+    mem = new MemTable(icmp);
+    mem->Ref();
+    mem->Add(1, kTypeValue, "key", value);
+    ASSERT_LT(recycler->RetainedBytes(), retained);
+    mem->Unref();
+}
+
+TEST_F(MemTableTest, LargeValueAndMemoryUsage) {
+    const size_t before = mem_->ApproximateMemoryUsage();
+    std::string big(100000, 'v');
+    mem_->Add(1, kTypeValue, "big", big);
+    ASSERT_GE(mem_->ApproximateMemoryUsage(), before + big.size());
+
+    std::string value;
+    Status s;
+    ASSERT_TRUE(mem_->Get(LookupKey("big", 1), &value, &s));
+    ASSERT_EQ(big, value);
+}
+
+// 迭代器按内部键顺序输出, 同一个用户键新版本在前
+TEST_F(MemTableTest, Iterator) {
+    mem_->Add(1, kTypeValue, "b", "b1");
+    mem_->Add(2, kTypeValue, "a", "a2");
+    mem_->Add(3, kTypeDeletion, "b", "");
+    mem_->Add(4, kTypeValue, "c", "c4");
+
+    Iterator* iter = mem_->NewIterator();
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(IKey("a", 2, kTypeValue), iter->key().ToString());
+    ASSERT_EQ("a2", iter->value().ToString());
+    iter->Next();
+    ASSERT_EQ(IKey("b", 3, kTypeDeletion), iter->key().ToString());
+    ASSERT_EQ("", iter->value().ToString());
+    iter->Next();
+    ASSERT_EQ(IKey("b", 1, kTypeValue), iter->key().ToString());
+    ASSERT_EQ("b1", iter->value().ToString());
+    iter->Next();
+    ASSERT_EQ("c4", iter->value().ToString());
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+
+    // Seek 的目标是内部键
+    iter->Seek(IKey("b", 2, kValueTypeForSeek));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(IKey("b", 1, kTypeValue), iter->key().ToString());
+    iter->Prev();
+    ASSERT_EQ(IKey("b", 3, kTypeDeletion), iter->key().ToString());
+    iter->SeekToLast();
+    ASSERT_EQ("c4", iter->value().ToString());
+    delete iter;
+}
+
+namespace {
+// 逆序比较器, 用于验证非字典序比较器走虚函数的路径
+class ReverseComparator : public Comparator {
+public:
+    const char* Name() const override { return "test.ReverseComparator"; }
+    int Compare(const Slice& a, const Slice& b) const override {
+        return BytewiseComparator()->Compare(b, a);
+    }
+    void FindShortestSeparator(std::string*, const Slice&) const override {}
+    void FindShortSuccessor(std::string*) const override {}
+};
+}   // namespace
+
+TEST(MemTableComparatorTest, CustomUserComparator) {
+    ReverseComparator reverse;
+    InternalKeyComparator icmp(&reverse);
+    ASSERT_FALSE(icmp.user_is_bytewise());
+    ASSERT_TRUE(InternalKeyComparator(BytewiseComparator()).user_is_bytewise());
+    ASSERT_GT(icmp.Compare(IKey("a", 1, kTypeValue), IKey("b", 1, kTypeValue)), 0);
+
+    MemTable* mem = new MemTable(icmp);
+    mem->Ref();
+    mem->Add(1, kTypeValue, "a", "va");
+    mem->Add(2, kTypeValue, "b", "vb");
+    mem->Add(3, kTypeValue, "a", "va2");
+    std::string value;
+    Status s;
+    ASSERT_TRUE(mem->Get(LookupKey("a", 100), &value, &s));
+    ASSERT_EQ("va2", value);
+    ASSERT_TRUE(mem->Get(LookupKey("a", 2), &value, &s));
+    ASSERT_EQ("va", value);
+    ASSERT_TRUE(mem->Get(LookupKey("b", 100), &value, &s));
+    ASSERT_EQ("vb", value);
+    ASSERT_FALSE(mem->Get(LookupKey("c", 100), &value, &s));
+    mem->Unref();
+}
+
+}   // namespace leveldb
@@ -0,0 +1,359 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "random.h"
+#include "skiplist.h"
+
+namespace leveldb {
+
+typedef uint64_t Key;
+
+struct Comparator {
+    int operator()(const Key& a, const Key& b) const {
+        if(a < b) return -1;
+        else if(a > b) return +1;
+        else return 0;
+    }
+};
+
+// 只提供高位作为前缀, 大量键前缀相同, 用来覆盖前缀相等时退回完整比较的路径
+struct PrefixComparator {
+    int operator()(const Key& a, const Key& b) const {
+        if(a < b) return -1;
+        else if(a > b) return +1;
+        else return 0;
+    }
+    uint64_t KeyPrefix(const Key& k) const { return k >> 8; }
+};
+
+TEST(SkipTest, Empty) {
+    Arena arena;
+    Comparator cmp;
+    SkipList<Key, Comparator> list(cmp, &arena);
+    ASSERT_TRUE(!list.Contains(10));
+
+    SkipList<Key, Comparator>::Iterator iter(&list);
+    ASSERT_TRUE(!iter.Valid());
+    iter.SeekToFirst();
+    ASSERT_TRUE(!iter.Valid());
+    iter.Seek(100);
+    ASSERT_TRUE(!iter.Valid());
+    iter.SeekToLast();
+    ASSERT_TRUE(!iter.Valid());
+}
+
+TEST(SkipTest, InsertAndLookup) {
+    const int N = 2000;
+    const int R = 5000;
+    Random rnd(1000);
+    std::set<Key> keys;
+    Arena arena;
+    Comparator cmp;
+    SkipList<Key, Comparator> list(cmp, &arena);
+    for(int i = 0; i < N; i++) {
+        Key key = rnd.Next() % R;
+        if(keys.insert(key).second) list.Insert(key);
+    }
+
+    for(int i = 0; i < R; i++) {
+        if(list.Contains(i)) ASSERT_EQ(keys.count(i), 1u);
+        else ASSERT_EQ(keys.count(i), 0u);
+    }
+
+    // 正向遍历
+    {
+        SkipList<Key, Comparator>::Iterator iter(&list);
+        iter.SeekToFirst();
+        for(std::set<Key>::iterator it = keys.begin(); it != keys.end(); ++it) {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(*it, iter.key());
+            iter.Next();
+        }
+        ASSERT_TRUE(!iter.Valid());
+    }
+
+    // Seek
+    for(int i = 0; i < R; i++) {
+        SkipList<Key, Comparator>::Iterator iter(&list);
+        iter.Seek(i);
+        std::set<Key>::iterator model = keys.lower_bound(i);
+        if(model == keys.end()) {
+            ASSERT_TRUE(!iter.Valid());
+        } else {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(*model, iter.key());
+        }
+    }
+
+    // 反向遍历
+    {
+        SkipList<Key, Comparator>::Iterator iter(&list);
+        iter.SeekToLast();
+        for(std::set<Key>::reverse_iterator it = keys.rbegin(); it != keys.rend(); ++it) {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(*it, iter.key());
+            iter.Prev();
+        }
+        ASSERT_TRUE(!iter.Valid());
+    }
+}
+
+TEST(SkipTest, KeyPrefixDetection) {
+    ASSERT_FALSE((HasKeyPrefix<Comparator, Key>::value));
+    ASSERT_TRUE((HasKeyPrefix<PrefixComparator, Key>::value));
+}
+
+TEST(SkipTest, InlinePrefix) {
+    const int N = 5000;
+    const int R = 20000;
+    Random rnd(301);
+    std::set<Key> keys;
+    Arena arena;
+    SkipList<Key, PrefixComparator> list(PrefixComparator(), &arena);
+    for(int i = 0; i < N; i++) {
+        Key key = rnd.Next() % R;
+        if(keys.insert(key).second) list.Insert(key);
+    }
+    for(int i = 0; i < R; i++) {
+        ASSERT_EQ(keys.count(i) == 1, list.Contains(i));
+        SkipList<Key, PrefixComparator>::Iterator iter(&list);
+        iter.Seek(i);
+        std::set<Key>::iterator model = keys.lower_bound(i);
+        if(model == keys.end()) {
+            ASSERT_TRUE(!iter.Valid());
+        } else {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(*model, iter.key());
+            iter.Prev();
+            if(model == keys.begin()) {
+                ASSERT_TRUE(!iter.Valid());
+            } else {
+                ASSERT_TRUE(iter.Valid());
+                ASSERT_EQ(*(--model), iter.key());
+            }
+        }
+    }
+}
+
+template <class Cmp>
+static void CheckAgainstModel(const SkipList<Key, Cmp>& list, const std::set<Key>& model) {
+    typename SkipList<Key, Cmp>::Iterator iter(&list);
+    iter.SeekToFirst();
+    for(std::set<Key>::const_iterator it = model.begin(); it != model.end(); ++it) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(*it, iter.key());
+        iter.Next();
+    }
+    ASSERT_TRUE(!iter.Valid());
+    for(std::set<Key>::const_iterator it = model.begin(); it != model.end(); ++it) {
+        ASSERT_TRUE(list.Contains(*it));
+    }
+}
+
+TEST(SkipTest, InsertBatch) {
+    Random rnd(301);
+    Arena arena;
+    SkipList<Key, PrefixComparator> list(PrefixComparator(), &arena);
+    std::set<Key> model;
+    // 先零散插入一些键, 再分多批插入与之交错的有序键
+    for(int i = 0; i < 1000; i++) {
+        Key key = (rnd.Next() % 100000) * 2;
+        if(model.insert(key).second) list.Insert(key);
+    }
+    for(int batch = 0; batch < 20; batch++) {
+        std::set<Key> fresh;
+        for(int i = 0; i < 500; i++) {
+            Key key = rnd.Next() % 200000;
+            if(model.count(key) == 0) fresh.insert(key);
+        }
+        std::vector<Key> sorted(fresh.begin(), fresh.end());
+        list.InsertBatch(sorted.data(), sorted.size());
+        model.insert(fresh.begin(), fresh.end());
+        CheckAgainstModel(list, model);
+    }
+    list.InsertBatch(nullptr, 0);
+    CheckAgainstModel(list, model);
+}
+
+TEST(SkipTest, BuildFromSorted) {
+    std::vector<Key> keys;
+    std::set<Key> model;
+    for(Key k = 0; k < 10000; k++) {
+        keys.push_back(k * 3 + 1);
+        model.insert(k * 3 + 1);
+    }
+    Arena arena;
+    Comparator cmp;
+    SkipList<Key, Comparator> list(cmp, &arena);
+    list.BuildFromSorted(keys.data(), keys.size());
+    CheckAgainstModel(list, model);
+
+    // 构造完成后仍然可以正常插入和查找
+    list.Insert(0);
+    list.Insert(5);
+    model.insert(0);
+    model.insert(5);
+    CheckAgainstModel(list, model);
+    ASSERT_FALSE(list.Contains(2));
+
+    SkipList<Key, Comparator>::Iterator iter(&list);
+    iter.SeekToLast();
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(*model.rbegin(), iter.key());
+}
+
+TEST(SkipTest, FingerIterator) {
+    Random rnd(301);
+    Arena arena;
+    SkipList<Key, PrefixComparator> list(PrefixComparator(), &arena);
+    std::set<Key> model;
+    for(int i = 0; i < 5000; i++) {
+        Key key = rnd.Next() % 50000;
+        if(model.insert(key).second) list.Insert(key);
+    }
+
+    // Next/Prev 交替, 与 std::set 的双向迭代逐步对照
+    SkipList<Key, PrefixComparator>::Iterator iter(&list);
+    iter.Seek(25000);
+    std::set<Key>::iterator it = model.lower_bound(25000);
+    for(int step = 0; step < 20000; step++) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(*it, iter.key());
+        if(rnd.OneIn(2)) {
+            if(it == model.begin()) continue;
+            --it;
+            iter.Prev();
+        } else {
+            ++it;
+            if(it == model.end()) {
+                --it;
+                continue;
+            }
+            iter.Next();
+        }
+    }
+
+    // 递增的相邻 Seek 走 finger 路径, 递减的 Seek 退回完整查找
+    Key target = 0;
+    for(int i = 0; i < 2000; i++) {
+        target = rnd.OneIn(5) ? rnd.Next() % 50000 : target + rnd.Uniform(50);
+        iter.Seek(target);
+        std::set<Key>::iterator expected = model.lower_bound(target);
+        if(expected == model.end()) {
+            ASSERT_TRUE(!iter.Valid());
+            continue;
+        }
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(*expected, iter.key());
+        iter.Prev();
+        if(expected == model.begin()) {
+            ASSERT_TRUE(!iter.Valid());
+        } else {
+            ASSERT_TRUE(iter.Valid());
+            ASSERT_EQ(*(--expected), iter.key());
+        }
+    }
+}
+
+// 迭代器定位之后插入的键, 在 Prev/Next/Seek 中都能被看到
+TEST(SkipTest, FingerSeesLaterInserts) {
+    Arena arena;
+    Comparator cmp;
+    SkipList<Key, Comparator> list(cmp, &arena);
+    for(Key k = 0; k < 1000; k += 10) list.Insert(k);
+
+    SkipList<Key, Comparator>::Iterator iter(&list);
+    iter.Seek(500);
+    ASSERT_EQ(500u, iter.key());
+    list.Insert(495);
+    list.Insert(505);
+    iter.Prev();
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(495u, iter.key());
+    iter.Prev();
+    ASSERT_EQ(490u, iter.key());
+    iter.Next();
+    iter.Next();
+    ASSERT_EQ(500u, iter.key());
+    list.Insert(503);
+    iter.Seek(501);
+    ASSERT_EQ(503u, iter.key());
+    iter.Next();
+    ASSERT_EQ(505u, iter.key());
+
+    // 反向遍历到头
+    iter.SeekToLast();
+    size_t count = 0;
+    for(; iter.Valid(); iter.Prev()) count++;
+    ASSERT_EQ(103u, count);
+}
+
+// 多个写线程并发插入互不相交的键, 同时有一个读线程持续检查有序性
+TEST(SkipTest, ConcurrentInsert) {
+    const int kThreads = 4;
+    const int kPerThread = 20000;
+    Arena arena;
+    Comparator cmp;
+    SkipList<Key, Comparator> list(cmp, &arena);
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> reader_ok(true);
+    std::thread reader([&]() {
+        while(!done.load(std::memory_order_acquire)) {
+            SkipList<Key, Comparator>::Iterator iter(&list);
+            iter.SeekToFirst();
+            Key last = 0;
+            bool first = true;
+            for(; iter.Valid(); iter.Next()) {
+                if(!first && iter.key() <= last) reader_ok.store(false);
+                last = iter.key();
+                first = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for(int t = 0; t < kThreads; t++) {
+        writers.emplace_back([&list, t]() {
+            Random rnd(1000 + t);
+            // 键空间按线程交错划分, 保证不会重复
+            for(int i = 0; i < kPerThread; i++) {
+                Key key = static_cast<Key>(rnd.Next()) * kThreads + t;
+                if(!list.Contains(key)) list.InsertConcurrently(key);
+            }
+        });
+    }
+    for(size_t t = 0; t < writers.size(); t++) writers[t].join();
+    done.store(true, std::memory_order_release);
+    reader.join();
+    ASSERT_TRUE(reader_ok.load());
+
+    // 逐个核对每个线程写入的键
+    for(int t = 0; t < kThreads; t++) {
+        Random rnd(1000 + t);
+        for(int i = 0; i < kPerThread; i++) {
+            Key key = static_cast<Key>(rnd.Next()) * kThreads + t;
+            ASSERT_TRUE(list.Contains(key));
+        }
+    }
+
+    // 所有层级都保持有序
+    SkipList<Key, Comparator>::Iterator iter(&list);
+    iter.SeekToFirst();
+    Key last = 0;
+    size_t count = 0;
+    for(; iter.Valid(); iter.Next()) {
+        if(count > 0) ASSERT_LT(last, iter.key());
+        last = iter.key();
+        count++;
+    }
+    ASSERT_GT(count, 0u);
+    ASSERT_LE(count, static_cast<size_t>(kThreads * kPerThread));
+}
+
+}   // namespace leveldb
@@ -20,3 +20,35 @@ TEST(SliceTest, StringConstruction) {
     EXPECT_EQ(s.size(), str.size());
     EXPECT_EQ(s.ToString(), str);
 }
+
+// 与 memcmp 的结果符号逐一对比, 覆盖向量/字/字节三段路径和最高位为 1 的字节
+TEST(SliceTest, CompareMatchesMemcmp) {
+    for(size_t len = 0; len <= 70; len++) {
+        std::string base(len, '\0');
+        for(size_t i = 0; i < len; i++) base[i] = static_cast<char>('a' + i % 26);
+        for(size_t pos = 0; pos < len; pos++) {
+            const char deltas[] = {1, -1, static_cast<char>(0x80)};
+            for(size_t d = 0; d < sizeof(deltas); d++) {
+                std::string other = base;
+                other[pos] = static_cast<char>(other[pos] + deltas[d]);
+                int expected = memcmp(base.data(), other.data(), len);
+                int actual = leveldb::CompareBytes(base.data(), other.data(), len);
+                ASSERT_EQ(expected < 0, actual < 0) << len << " " << pos;
+                ASSERT_EQ(expected > 0, actual > 0) << len << " " << pos;
+                ASSERT_EQ(pos, leveldb::SharedPrefixLength(base.data(), other.data(), len));
+            }
+        }
+        ASSERT_EQ(0, leveldb::CompareBytes(base.data(), base.data(), len));
+        ASSERT_EQ(len, leveldb::SharedPrefixLength(base.data(), base.data(), len));
+    }
+}
+
+TEST(SliceTest, CompareLength) {
+    leveldb::Slice a("abc");
+    leveldb::Slice b("abcd");
+    EXPECT_LT(a.compare(b), 0);
+    EXPECT_GT(b.compare(a), 0);
+    EXPECT_EQ(a.compare(a), 0);
+    EXPECT_EQ(3u, leveldb::SharedPrefixLength(a, b));
+    EXPECT_EQ(0u, leveldb::SharedPrefixLength(leveldb::Slice(), b));
+}
@@ -0,0 +1,481 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "block.h"
+#include "cache.h"
+#include "comparator.h"
+#include "dbformat.h"
+#include "env.h"
+#include "filter_policy.h"
+#include "format.h"
+#include "options.h"
+#include "random.h"
+#include "table.h"
+#include "table_builder.h"
+
+namespace leveldb {
+
+// 写入内存的文件
+class StringSink : public WritableFile {
+public:
+    const std::string& contents() const { return contents_; }
+
+    Status Append(const Slice& data) override {
+        contents_.append(data.data(), data.size());
+        return Status::OK();
+    }
+    Status Close() override { return Status::OK(); }
+    Status Flush() override { return Status::OK(); }
+    Status Sync() override { return Status::OK(); }
+
+private:
+    std::string contents_;
+};
+
+// 从内存读取的文件, 按 posix 的方式复制到 scratch
+class StringSource : public RandomAccessFile {
+public:
+    explicit StringSource(const Slice& contents)
+        : contents_(contents.data(), contents.size()), reads_(0) {}
+
+    std::string* mutable_contents() { return &contents_; }
+    int reads() const { return reads_; }
+
+    Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const override {
+        reads_++;
+        if(offset >= contents_.size()) return Status::InvalidArgument("invalid Read offset");
+        if(offset + n > contents_.size()) n = contents_.size() - offset;
+        std::memcpy(scratch, &contents_[offset], n);
+        *result = Slice(scratch, n);
+        return Status::OK();
+    }
+
+private:
+    std::string contents_;
+    mutable int reads_;
+};
+
+class TableTest : public testing::Test {
+protected:
+    TableTest() : source_(nullptr), table_(nullptr) {}
+    ~TableTest() override {
+        delete table_;
+        delete source_;
+    }
+
+    void Build(const std::map<std::string, std::string>& model) {
+        StringSink sink;
+        TableBuilder builder(options_, &sink);
+        for(std::map<std::string, std::string>::const_iterator it = model.begin(); it != model.end(); ++it) {
+            builder.Add(it->first, it->second);
+            ASSERT_TRUE(builder.status().ok());
+        }
+        ASSERT_TRUE(builder.Finish().ok());
+        ASSERT_EQ(sink.contents().size(), builder.FileSize());
+        ASSERT_EQ(model.size(), builder.NumEntries());
+        Open(sink.contents());
+    }
+
+    void Open(const std::string& contents) {
+        delete table_;
+        delete source_;
+        table_ = nullptr;
+        source_ = new StringSource(contents);
+        ASSERT_TRUE(Table::Open(options_, source_, contents.size(), &table_).ok());
+    }
+
+    // 读出文件中的索引块
+    Block* ReadIndexBlock() {
+        const std::string& contents = *source_->mutable_contents();
+        Slice input(contents.data() + contents.size() - Footer::kEncodedLength, Footer::kEncodedLength);
+        Footer footer;
+        EXPECT_TRUE(footer.DecodeFrom(&input).ok());
+        BlockContents block_contents;
+        EXPECT_TRUE(ReadBlock(source_, ReadOptions(), footer.index_handle(), &block_contents).ok());
+        return new Block(block_contents);
+    }
+
+    Options options_;
+    StringSource* source_;
+    Table* table_;
+};
+
+TEST_F(TableTest, Empty) {
+    std::map<std::string, std::string> model;
+    Build(model);
+    Iterator* iter = table_->NewIterator(ReadOptions());
+    iter->SeekToFirst();
+    ASSERT_TRUE(!iter->Valid());
+    iter->Seek("foo");
+    ASSERT_TRUE(!iter->Valid());
+    ASSERT_TRUE(iter->status().ok());
+    delete iter;
+}
+
+TEST_F(TableTest, BadFooter) {
+    Table* table;
+    StringSource tiny("short");
+    ASSERT_TRUE(Table::Open(options_, &tiny, 5, &table).IsCorruption());
+    ASSERT_TRUE(table == nullptr);
+
+    StringSource garbage(std::string(100, 'x'));
+    ASSERT_TRUE(Table::Open(options_, &garbage, 100, &table).IsCorruption());
+    ASSERT_TRUE(table == nullptr);
+}
+
+// 不同块大小下, 遍历和随机 Seek 都与 std::map 一致
+TEST_F(TableTest, MatchesModel) {
+    Random rnd(301);
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 2000; i++) {
+        std::string key = "user:" + std::to_string(rnd.Uniform(1000000));
+        if(rnd.OneIn(20)) key.append(100, 'k');
+        model[key] = std::string(rnd.Uniform(200), static_cast<char>('a' + i % 26));
+    }
+
+    const size_t block_sizes[] = {1, 256, 4096, 1 << 20};
+    for(size_t n = 0; n < sizeof(block_sizes) / sizeof(block_sizes[0]); n++) {
+        options_.block_size = block_sizes[n];
+        Build(model);
+        Iterator* iter = table_->NewIterator(ReadOptions());
+
+        std::map<std::string, std::string>::iterator it = model.begin();
+        for(iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+            ASSERT_EQ(it->first, iter->key().ToString());
+            ASSERT_EQ(it->second, iter->value().ToString());
+        }
+        ASSERT_TRUE(it == model.end());
+
+        std::map<std::string, std::string>::reverse_iterator rit = model.rbegin();
+        for(iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+            ASSERT_EQ(rit->first, iter->key().ToString());
+        }
+        ASSERT_TRUE(rit == model.rend());
+
+        for(int i = 0; i < 500; i++) {
+            std::string target = "user:" + std::to_string(rnd.Uniform(1000000));
+            iter->Seek(target);
+            it = model.lower_bound(target);
+            if(it == model.end()) {
+                ASSERT_TRUE(!iter->Valid());
+            } else {
+                ASSERT_TRUE(iter->Valid());
+                ASSERT_EQ(it->first, iter->key().ToString());
+            }
+        }
+        ASSERT_TRUE(iter->status().ok());
+        delete iter;
+    }
+}
+
+// 索引键取相邻两块之间最短的分隔键, 远短于数据中的长键
+TEST_F(TableTest, IndexKeysAreShortened) {
+    std::map<std::string, std::string> model;
+    Random rnd(301);
+    const std::string suffix(100, 'p');
+    for(int i = 0; i < 1000; i++) {
+        std::string key;
+        for(int j = 0; j < 6; j++) key.push_back(static_cast<char>('a' + rnd.Uniform(26)));
+        model[key + suffix] = std::string(100, 'v');
+    }
+    options_.block_size = 1024;
+    Build(model);
+
+    Block* index = ReadIndexBlock();
+    Iterator* iter = index->NewIterator(options_.comparator);
+    int entries = 0;
+    int shortened = 0;
+    std::string prev;
+    for(iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        const std::string key = iter->key().ToString();
+        ASSERT_LE(key.size(), 106u);
+        if(entries > 0) ASSERT_LT(prev, key);
+        prev = key;
+        if(key.size() <= 6) shortened++;
+        entries++;
+    }
+    ASSERT_GT(entries, 10);
+    // 随机前缀在 6 个字节以内就能分隔相邻的块; 差异字节相邻(如 'f' 和 'g')时无法截断, 保持原样
+    ASSERT_GT(shortened, entries / 3);
+    ASSERT_EQ(1u, prev.size());  // 最后一块取短后继
+    delete iter;
+    delete index;
+}
+
+// 按内部键排序的表上, InternalGet 定位到 >= 查找键的第一条记录
+TEST_F(TableTest, InternalGet) {
+    InternalKeyComparator icmp(BytewiseComparator());
+    options_.comparator = &icmp;
+    options_.block_size = 128;
+
+    StringSink sink;
+    TableBuilder builder(options_, &sink);
+    for(int i = 0; i < 200; i++) {
+        std::string user_key = "key" + std::to_string(1000 + i);
+        // 每个键两个版本, 新版本在前
+        for(SequenceNumber seq = 2; seq >= 1; seq--) {
+            std::string ikey;
+            AppendInternalKey(&ikey, ParsedInternalKey(user_key, i * 10 + seq, kTypeValue));
+            builder.Add(ikey, user_key + "@" + std::to_string(seq));
+        }
+    }
+    ASSERT_TRUE(builder.Finish().ok());
+    Open(sink.contents());
+
+    struct Saver {
+        bool found = false;
+        std::string user_key;
+        std::string value;
+        static void Save(void* arg, const Slice& k, const Slice& v) {
+            Saver* s = reinterpret_cast<Saver*>(arg);
+            ParsedInternalKey parsed;
+            ASSERT_TRUE(ParseInternalKey(k, &parsed));
+            s->found = true;
+            s->user_key = parsed.user_key.ToString();
+            s->value = v.ToString();
+        }
+    };
+
+    for(int i = 0; i < 200; i++) {
+        std::string user_key = "key" + std::to_string(1000 + i);
+        // 最新的快照看到第 2 版
+        Saver latest;
+        LookupKey lkey(user_key, kMaxSequenceNumber);
+        ASSERT_TRUE(table_->InternalGet(ReadOptions(), lkey.internal_key(), &latest, &Saver::Save).ok());
+        ASSERT_TRUE(latest.found);
+        ASSERT_EQ(user_key, latest.user_key);
+        ASSERT_EQ(user_key + "@2", latest.value);
+
+        // 第 2 版之前的快照只能看到第 1 版
+        Saver old;
+        LookupKey okey(user_key, i * 10 + 1);
+        ASSERT_TRUE(table_->InternalGet(ReadOptions(), okey.internal_key(), &old, &Saver::Save).ok());
+        ASSERT_EQ(user_key + "@1", old.value);
+    }
+
+    // 比所有键都大的查找键什么也找不到
+    Saver none;
+    LookupKey past("zzz", kMaxSequenceNumber);
+    ASSERT_TRUE(table_->InternalGet(ReadOptions(), past.internal_key(), &none, &Saver::Save).ok());
+    ASSERT_TRUE(!none.found);
+}
+
+// 带过滤器的表上, 查找不存在的键几乎不读数据块; 同一个用户键的任意版本都能命中过滤器
+// 两种过滤器格式的行为一致, 分块格式的过滤块在读取时会对齐到缓存行
+TEST_F(TableTest, FilterSkipsDataBlocks) {
+    struct Counter {
+        int calls = 0;
+        static void Count(void* arg, const Slice&, const Slice&) {
+            reinterpret_cast<Counter*>(arg)->calls++;
+        }
+    };
+
+    const BloomFilterFormat formats[] = {kLegacyBloomFormat, kBlockedBloomFormat};
+    for(size_t f = 0; f < 2; f++) {
+        InternalKeyComparator icmp(BytewiseComparator());
+        const FilterPolicy* bloom = NewBloomFilterPolicy(10, formats[f]);
+        InternalFilterPolicy ipolicy(bloom);
+        options_.comparator = &icmp;
+        options_.filter_policy = &ipolicy;
+
+        StringSink sink;
+        TableBuilder builder(options_, &sink);
+        for(int i = 0; i < 10000; i++) {
+            std::string ikey;
+            AppendInternalKey(&ikey, ParsedInternalKey("key" + std::to_string(100000 + i * 2), 100 + i,
+                                                       kTypeValue));
+            builder.Add(ikey, "v" + std::to_string(i));
+        }
+        ASSERT_TRUE(builder.Finish().ok());
+        Open(sink.contents());
+
+        // 存在的键: 用更大的序列号查找, 每次都读一个数据块
+        int before = source_->reads();
+        Counter hits;
+        for(int i = 0; i < 1000; i++) {
+            LookupKey lkey("key" + std::to_string(100000 + i * 2), kMaxSequenceNumber);
+            ASSERT_TRUE(table_->InternalGet(ReadOptions(), lkey.internal_key(), &hits, &Counter::Count).ok());
+        }
+        ASSERT_EQ(1000, hits.calls);
+        ASSERT_EQ(1000, source_->reads() - before);
+
+        // 不存在的键(奇数)夹在存在的键之间, 只有误判时才读数据块
+        before = source_->reads();
+        Counter misses;
+        for(int i = 0; i < 1000; i++) {
+            LookupKey lkey("key" + std::to_string(100001 + i * 2), kMaxSequenceNumber);
+            ASSERT_TRUE(table_->InternalGet(ReadOptions(), lkey.internal_key(), &misses, &Counter::Count).ok());
+        }
+        ASSERT_LE(source_->reads() - before, 40);
+        ASSERT_EQ(source_->reads() - before, misses.calls);
+
+        delete table_;
+        table_ = nullptr;
+        delete bloom;
+    }
+}
+
+// 打开时使用另一个名称的过滤策略, 找不到过滤块, 退回到直接读数据块
+TEST_F(TableTest, FilterPolicyMismatch) {
+    const FilterPolicy* bloom = NewBloomFilterPolicy(10);
+    options_.filter_policy = bloom;
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 100; i++) model["k" + std::to_string(100 + i)] = "v";
+    Build(model);
+
+    struct OtherPolicy : public FilterPolicy {
+        const char* Name() const override { return "OtherPolicy"; }
+        void CreateFilter(const Slice*, int, std::string*) const override {}
+        bool KeyMayMatch(const Slice&, const Slice&) const override { return false; }
+    } other;
+    options_.filter_policy = &other;
+    const std::string contents = *source_->mutable_contents();
+    Open(contents);
+
+    bool found = false;
+    ASSERT_TRUE(table_->InternalGet(ReadOptions(), "k150", &found,
+                                    [](void* arg, const Slice& k, const Slice&) {
+                                        *reinterpret_cast<bool*>(arg) = (k == Slice("k150"));
+                                    }).ok());
+    ASSERT_TRUE(found);
+    delete table_;
+    table_ = nullptr;
+    delete bloom;
+}
+
+// 设置了块缓存时, 重复读取同一个块只读一次文件; fill_cache 为 false 的读取不放进缓存
+TEST_F(TableTest, BlockCache) {
+    Cache* cache = NewLRUCache(1 << 20);
+    options_.block_cache = cache;
+    options_.block_size = 256;
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 1000; i++) model["k" + std::to_string(10000 + i)] = std::string(50, 'v');
+    Build(model);
+
+    // 不填充缓存的全量扫描
+    ReadOptions no_fill;
+    no_fill.fill_cache = false;
+    Iterator* iter = table_->NewIterator(no_fill);
+    int before = source_->reads();
+    int count = 0;
+    for(iter->SeekToFirst(); iter->Valid(); iter->Next()) count++;
+    ASSERT_EQ(1000, count);
+    delete iter;
+    const int blocks = source_->reads() - before;
+    ASSERT_GT(blocks, 10);
+    ASSERT_EQ(0u, cache->TotalCharge());
+
+    // 第一次扫描读文件并填充缓存, 第二次全部命中
+    for(int pass = 0; pass < 2; pass++) {
+        before = source_->reads();
+        iter = table_->NewIterator(ReadOptions());
+        for(iter->SeekToFirst(); iter->Valid(); iter->Next()) {}
+        ASSERT_TRUE(iter->status().ok());
+        delete iter;
+        ASSERT_EQ(pass == 0 ? blocks : 0, source_->reads() - before);
+    }
+    ASSERT_GT(cache->TotalCharge(), 0u);
+    Cache::Stats stats = cache->GetStats();
+    ASSERT_EQ(static_cast<uint64_t>(blocks), stats.hits);
+    ASSERT_EQ(static_cast<uint64_t>(blocks) * 2, stats.misses);
+
+    // 点查也走缓存
+    bool found = false;
+    before = source_->reads();
+    ASSERT_TRUE(table_->InternalGet(ReadOptions(), "k10500", &found,
+                                    [](void* arg, const Slice& k, const Slice&) {
+                                        *reinterpret_cast<bool*>(arg) = (k == Slice("k10500"));
+                                    }).ok());
+    ASSERT_TRUE(found);
+    ASSERT_EQ(0, source_->reads() - before);
+
+    // 缓存必须比使用它的表活得久
+    delete table_;
+    table_ = nullptr;
+    delete cache;
+}
+
+TEST_F(TableTest, ApproximateOffsetOf) {
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 100; i++) {
+        model["k" + std::to_string(100 + i)] = std::string(1000, 'x');
+    }
+    options_.block_size = 1000;
+    Build(model);
+
+    uint64_t prev = 0;
+    for(int i = 0; i < 100; i++) {
+        const uint64_t offset = table_->ApproximateOffsetOf("k" + std::to_string(100 + i));
+        ASSERT_GE(offset, prev);
+        // 每个值约 1000 字节, 每个值独占一个块
+        ASSERT_GE(offset, static_cast<uint64_t>(i) * 1000);
+        ASSERT_LE(offset, static_cast<uint64_t>(i) * 1100);
+        prev = offset;
+    }
+    ASSERT_EQ(0u, table_->ApproximateOffsetOf("a"));
+    ASSERT_GE(table_->ApproximateOffsetOf("z"), 100000u);
+}
+
+// 校验开启时, 数据块中的一个坏字节会报 Corruption
+TEST_F(TableTest, ChecksumMismatch) {
+    std::map<std::string, std::string> model;
+    for(int i = 0; i < 100; i++) model["k" + std::to_string(100 + i)] = "value";
+    Build(model);
+
+    (*source_->mutable_contents())[10] ^= 0x40;
+    ReadOptions verify;
+    verify.verify_checksums = true;
+    Iterator* iter = table_->NewIterator(verify);
+    iter->SeekToFirst();
+    ASSERT_TRUE(!iter->Valid());
+    ASSERT_TRUE(iter->status().IsCorruption());
+    delete iter;
+}
+
+// 通过 posix 环境写入真实文件, 分别用 pread 和 mmap 读回
+TEST_F(TableTest, PosixRoundTrip) {
+    Env* env = Env::Default();
+    const std::string fname = "/tmp/leveldb_table_test_" + std::to_string(getpid()) + ".ldb";
+    WritableFile* file;
+    ASSERT_TRUE(env->NewWritableFile(fname, &file).ok());
+    TableBuilder builder(options_, file);
+    for(int i = 0; i < 10000; i++) builder.Add("key" + std::to_string(100000 + i), std::to_string(i));
+    ASSERT_TRUE(builder.Finish().ok());
+    ASSERT_TRUE(file->Close().ok());
+    delete file;
+
+    uint64_t size;
+    ASSERT_TRUE(env->GetFileSize(fname, &size).ok());
+    ASSERT_EQ(builder.FileSize(), size);
+    options_.paranoid_checks = true;
+    RandomAccessFile* source;
+    for(int mmap_limit : {0, 1000}) {
+        SetReadOnlyMmapLimit(mmap_limit);
+        ASSERT_TRUE(env->NewRandomAccessFile(fname, &source).ok());
+        Table* table;
+        ASSERT_TRUE(Table::Open(options_, source, size, &table).ok());
+
+        ReadOptions verify;
+        verify.verify_checksums = true;
+        Iterator* iter = table->NewIterator(verify);
+        int i = 0;
+        for(iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+            ASSERT_EQ("key" + std::to_string(100000 + i), iter->key().ToString());
+            ASSERT_EQ(std::to_string(i), iter->value().ToString());
+        }
+        ASSERT_EQ(10000, i);
+        ASSERT_TRUE(iter->status().ok());
+        delete iter;
+        delete table;
+        delete source;
+    }
+    ASSERT_TRUE(env->RemoveFile(fname).ok());
+    ASSERT_TRUE(env->NewRandomAccessFile(fname, &source).IsNotFound());
+}
+
+}   // namespace leveldb
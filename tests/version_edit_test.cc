@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "version_edit.h"
+
+namespace leveldb {
+
+static void TestEncodeDecode(const VersionEdit& edit) {
+    std::string encoded, encoded2;
+    edit.EncodeTo(&encoded);
+    VersionEdit parsed;
+    Status s = parsed.DecodeFrom(encoded);
+    ASSERT_TRUE(s.ok()) << s.ToString();
+    parsed.EncodeTo(&encoded2);
+    ASSERT_EQ(encoded, encoded2);
+}
+
+TEST(VersionEditTest, EncodeDecode) {
+    static const uint64_t kBig = 1ull << 50;
+
+    VersionEdit edit;
+    for(int i = 0; i < 4; i++) {
+        TestEncodeDecode(edit);
+        edit.AddFile(3, kBig + 300 + i, kBig + 400 + i, InternalKey("foo", kBig + 500 + i, kTypeValue),
+                     InternalKey("zoo", kBig + 600 + i, kTypeDeletion));
+        edit.RemoveFile(4, kBig + 700 + i);
+        edit.SetCompactPointer(i, InternalKey("x", kBig + 900 + i, kTypeValue));
+    }
+
+    edit.SetComparatorName("foo");
+    edit.SetLogNumber(kBig + 100);
+    edit.SetNextFile(kBig + 200);
+    edit.SetLastSequence(kBig + 1000);
+    TestEncodeDecode(edit);
+}
+
+TEST(VersionEditTest, DecodeCorruption) {
+    VersionEdit edit;
+    edit.AddFile(1, 7, 100, InternalKey("a", 1, kTypeValue), InternalKey("b", 2, kTypeValue));
+    std::string encoded;
+    edit.EncodeTo(&encoded);
+
+    // 截断的记录
+    VersionEdit parsed;
+    ASSERT_TRUE(parsed.DecodeFrom(Slice(encoded.data(), encoded.size() - 1)).IsCorruption());
+
+    // 层号越界
+    std::string bad;
+    PutVarint32(&bad, 6);  // kDeletedFile
+    PutVarint32(&bad, config::kNumLevels);
+    PutVarint64(&bad, 1);
+    ASSERT_TRUE(parsed.DecodeFrom(bad).IsCorruption());
+
+    // 未知的 tag
+    bad.clear();
+    PutVarint32(&bad, 100);
+    ASSERT_TRUE(parsed.DecodeFrom(bad).IsCorruption());
+}
+
+}   // namespace leveldb
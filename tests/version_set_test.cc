@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include "version_set.h"
+
+namespace leveldb {
+
+class FindFileTest : public testing::Test {
+public:
+    FindFileTest() : icmp_(BytewiseComparator()), disjoint_sorted_files_(true) {}
+
+    ~FindFileTest() override {
+        for(size_t i = 0; i < files_.size(); i++) delete files_[i];
+    }
+
+    void Add(const char* smallest, const char* largest, SequenceNumber smallest_seq = 100,
+             SequenceNumber largest_seq = 100) {
+        FileMetaData* f = new FileMetaData;
+        f->number = files_.size() + 1;
+        f->smallest = InternalKey(smallest, smallest_seq, kTypeValue);
+        f->largest = InternalKey(largest, largest_seq, kTypeValue);
+        files_.push_back(f);
+    }
+
+    int Find(const char* key) {
+        InternalKey target(key, 100, kTypeValue);
+        return FindFile(icmp_, files_, target.Encode());
+    }
+
+    bool Overlaps(const char* smallest, const char* largest) {
+        Slice s(smallest != nullptr ? smallest : "");
+        Slice l(largest != nullptr ? largest : "");
+        return SomeFileOverlapsRange(icmp_, disjoint_sorted_files_, files_, (smallest != nullptr ? &s : nullptr),
+                                     (largest != nullptr ? &l : nullptr));
+    }
+
+protected:
+    InternalKeyComparator icmp_;
+    bool disjoint_sorted_files_;
+    std::vector<FileMetaData*> files_;
+};
+
+TEST_F(FindFileTest, Empty) {
+    ASSERT_EQ(0, Find("foo"));
+    ASSERT_TRUE(!Overlaps("a", "z"));
+    ASSERT_TRUE(!Overlaps(nullptr, "z"));
+    ASSERT_TRUE(!Overlaps("a", nullptr));
+    ASSERT_TRUE(!Overlaps(nullptr, nullptr));
+}
+
+TEST_F(FindFileTest, Single) {
+    Add("p", "q");
+    ASSERT_EQ(0, Find("a"));
+    ASSERT_EQ(0, Find("p"));
+    ASSERT_EQ(0, Find("q"));
+    ASSERT_EQ(1, Find("q1"));
+    ASSERT_EQ(1, Find("z"));
+
+    ASSERT_TRUE(!Overlaps("a", "b"));
+    ASSERT_TRUE(!Overlaps("z1", "z2"));
+    ASSERT_TRUE(Overlaps("a", "p"));
+    ASSERT_TRUE(Overlaps("a", "q"));
+    ASSERT_TRUE(Overlaps("p", "p1"));
+    ASSERT_TRUE(Overlaps("q", "q"));
+    ASSERT_TRUE(Overlaps("q", "q1"));
+
+    ASSERT_TRUE(!Overlaps(nullptr, "j"));
+    ASSERT_TRUE(!Overlaps("r", nullptr));
+    ASSERT_TRUE(Overlaps(nullptr, "p"));
+    ASSERT_TRUE(Overlaps("q", nullptr));
+    ASSERT_TRUE(Overlaps(nullptr, nullptr));
+}
+
+TEST_F(FindFileTest, Multiple) {
+    Add("150", "200");
+    Add("200", "250");
+    Add("300", "350");
+    Add("400", "450");
+    ASSERT_EQ(0, Find("100"));
+    ASSERT_EQ(0, Find("150"));
+    ASSERT_EQ(1, Find("201"));
+    ASSERT_EQ(2, Find("251"));
+    ASSERT_EQ(2, Find("300"));
+    ASSERT_EQ(3, Find("351"));
+    ASSERT_EQ(3, Find("450"));
+    ASSERT_EQ(4, Find("451"));
+
+    ASSERT_TRUE(!Overlaps("100", "149"));
+    ASSERT_TRUE(!Overlaps("251", "299"));
+    ASSERT_TRUE(!Overlaps("451", "500"));
+    ASSERT_TRUE(Overlaps("100", "150"));
+    ASSERT_TRUE(Overlaps("250", "300"));
+    ASSERT_TRUE(Overlaps("375", "400"));
+    ASSERT_TRUE(Overlaps("450", "500"));
+}
+
+// L0 的文件可能重叠, 不能二分查找
+TEST_F(FindFileTest, OverlappingFiles) {
+    Add("150", "600");
+    Add("400", "500");
+    disjoint_sorted_files_ = false;
+    ASSERT_TRUE(!Overlaps("100", "149"));
+    ASSERT_TRUE(!Overlaps("601", "700"));
+    ASSERT_TRUE(Overlaps("100", "150"));
+    ASSERT_TRUE(Overlaps("450", "700"));
+    ASSERT_TRUE(Overlaps("600", "700"));
+}
+
+// 同一个用户键的不同版本: 文件的最大键序列号较小, 查找较新的版本仍然落在这个文件
+TEST_F(FindFileTest, MultipleVersionsOfUserKey) {
+    Add("a", "b", 100, 100);
+    Add("b", "c", 50, 100);
+    ASSERT_EQ(0, Find("b"));
+    InternalKey older("b", 60, kTypeValue);
+    ASSERT_EQ(1, FindFile(icmp_, files_, older.Encode()));
+}
+
+}   // namespace leveldb
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "comparator.h"
+#include "memtable.h"
+#include "write_batch_internal.h"
+
+namespace leveldb {
+
+// 把批次内容按顺序打印成 "Put(k, v)@seq" 形式, 同时插入 memtable 检查 InsertInto
+static std::string PrintContents(WriteBatch* b) {
+    class Printer : public WriteBatch::Handler {
+    public:
+        explicit Printer(SequenceNumber seq) : seq_(seq) {}
+        void Put(const Slice& key, const Slice& value) override {
+            out_ += "Put(" + key.ToString() + ", " + value.ToString() + ")@" + std::to_string(seq_++);
+        }
+        void Delete(const Slice& key) override {
+            out_ += "Delete(" + key.ToString() + ")@" + std::to_string(seq_++);
+        }
+        std::string out_;
+
+    private:
+        SequenceNumber seq_;
+    };
+    Printer printer(WriteBatchInternal::Sequence(b));
+    Status s = b->Iterate(&printer);
+    if(!s.ok()) printer.out_ += "ParseError()";
+    return printer.out_;
+}
+
+TEST(WriteBatchTest, Empty) {
+    WriteBatch batch;
+    ASSERT_EQ("", PrintContents(&batch));
+    ASSERT_EQ(0, WriteBatchInternal::Count(&batch));
+}
+
+TEST(WriteBatchTest, Multiple) {
+    WriteBatch batch;
+    batch.Put(Slice("foo"), Slice("bar"));
+    batch.Delete(Slice("box"));
+    batch.Put(Slice("baz"), Slice("boo"));
+    WriteBatchInternal::SetSequence(&batch, 100);
+    ASSERT_EQ(100u, WriteBatchInternal::Sequence(&batch));
+    ASSERT_EQ(3, WriteBatchInternal::Count(&batch));
+    ASSERT_EQ("Put(foo, bar)@100Delete(box)@101Put(baz, boo)@102", PrintContents(&batch));
+}
+
+TEST(WriteBatchTest, Corruption) {
+    WriteBatch batch;
+    batch.Put(Slice("foo"), Slice("bar"));
+    batch.Delete(Slice("box"));
+    WriteBatchInternal::SetSequence(&batch, 200);
+    Slice contents = WriteBatchInternal::Contents(&batch);
+    WriteBatchInternal::SetContents(&batch, Slice(contents.data(), contents.size() - 1));
+    ASSERT_EQ("Put(foo, bar)@200ParseError()", PrintContents(&batch));
+}
+
+TEST(WriteBatchTest, Append) {
+    WriteBatch b1, b2;
+    WriteBatchInternal::SetSequence(&b1, 200);
+    WriteBatchInternal::SetSequence(&b2, 300);
+    b1.Append(b2);
+    ASSERT_EQ("", PrintContents(&b1));
+    b2.Put("a", "va");
+    b1.Append(b2);
+    ASSERT_EQ("Put(a, va)@200", PrintContents(&b1));
+    b2.Clear();
+    b2.Put("b", "vb");
+    b1.Append(b2);
+    ASSERT_EQ("Put(a, va)@200Put(b, vb)@201", PrintContents(&b1));
+    b2.Delete("foo");
+    b1.Append(b2);
+    ASSERT_EQ("Put(a, va)@200Put(b, vb)@201Put(b, vb)@202Delete(foo)@203", PrintContents(&b1));
+}
+
+// 新头部加上各批次的记录部分, 与逐个 Append 合并的结果逐字节相同
+TEST(WriteBatchTest, RecordsConcatenation) {
+    WriteBatch b1, b2, merged;
+    b1.Put("a", "1");
+    b1.Delete("b");
+    b2.Put("c", std::string(300, 'x'));
+    merged.Append(b1);
+    merged.Append(b2);
+    WriteBatchInternal::SetSequence(&merged, 7);
+
+    char header[WriteBatchInternal::kHeaderSize];
+    WriteBatchInternal::EncodeHeader(header, 7, 3);
+    std::string gathered(header, sizeof(header));
+    gathered += WriteBatchInternal::Records(&b1).ToString();
+    gathered += WriteBatchInternal::Records(&b2).ToString();
+    ASSERT_EQ(WriteBatchInternal::Contents(&merged).ToString(), gathered);
+}
+
+TEST(WriteBatchTest, ApproximateSize) {
+    WriteBatch batch;
+    size_t empty_size = batch.ApproximateSize();
+
+    batch.Put(Slice("foo"), Slice("bar"));
+    size_t one_key_size = batch.ApproximateSize();
+    ASSERT_LT(empty_size, one_key_size);
+
+    batch.Put(Slice("baz"), Slice("boo"));
+    size_t two_keys_size = batch.ApproximateSize();
+    ASSERT_LT(one_key_size, two_keys_size);
+
+    batch.Delete(Slice("box"));
+    size_t post_delete_size = batch.ApproximateSize();
+    ASSERT_LT(two_keys_size, post_delete_size);
+}
+
+TEST(WriteBatchTest, InsertIntoMemTable) {
+    InternalKeyComparator cmp(BytewiseComparator());
+    MemTable* mem = new MemTable(cmp);
+    mem->Ref();
+    WriteBatch batch;
+    batch.Put("k1", "v1");
+    batch.Put("k2", "v2");
+    batch.Delete("k1");
+    WriteBatchInternal::SetSequence(&batch, 10);
+    ASSERT_TRUE(WriteBatchInternal::InsertInto(&batch, mem, false).ok());
+
+    std::string value;
+    Status s;
+    ASSERT_TRUE(mem->Get(LookupKey("k1", 12), &value, &s));
+    ASSERT_TRUE(s.IsNotFound());
+    ASSERT_TRUE(mem->Get(LookupKey("k1", 11), &value, &s));
+    ASSERT_EQ("v1", value);
+    ASSERT_TRUE(mem->Get(LookupKey("k2", 12), &value, &s));
+    ASSERT_EQ("v2", value);
+    ASSERT_TRUE(!mem->Get(LookupKey("k2", 10), &value, &s));
+    mem->Unref();
+}
+
+}   // namespace leveldb